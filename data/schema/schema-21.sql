@@ -0,0 +1,12 @@
+CREATE TABLE IF NOT EXISTS lyrics_cache (
+  artist TEXT NOT NULL,
+  album TEXT NOT NULL,
+  title TEXT NOT NULL,
+  provider TEXT,
+  lyrics TEXT,
+  time INTEGER NOT NULL DEFAULT -1
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS idx_lyrics_cache ON lyrics_cache (artist, album, title);
+
+UPDATE schema_version SET version=21;
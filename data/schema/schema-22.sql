@@ -0,0 +1,3 @@
+CREATE INDEX IF NOT EXISTS idx_artist_title_nocase ON songs (artist COLLATE NOCASE, title COLLATE NOCASE);
+
+UPDATE schema_version SET version=22;
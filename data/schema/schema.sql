@@ -4,7 +4,7 @@ CREATE TABLE IF NOT EXISTS schema_version (
 
 DELETE FROM schema_version;
 
-INSERT INTO schema_version (version) VALUES (20);
+INSERT INTO schema_version (version) VALUES (22);
 
 CREATE TABLE IF NOT EXISTS directories (
   path TEXT NOT NULL,
@@ -1026,6 +1026,15 @@ CREATE TABLE IF NOT EXISTS radio_channels (
   thumbnail_url TEXT
 );
 
+CREATE TABLE IF NOT EXISTS lyrics_cache (
+  artist TEXT NOT NULL,
+  album TEXT NOT NULL,
+  title TEXT NOT NULL,
+  provider TEXT,
+  lyrics TEXT,
+  time INTEGER NOT NULL DEFAULT -1
+);
+
 CREATE INDEX IF NOT EXISTS idx_url ON songs (url);
 
 CREATE INDEX IF NOT EXISTS idx_comp_artist ON songs (compilation_effective, artist);
@@ -1038,4 +1047,8 @@ CREATE INDEX IF NOT EXISTS idx_album ON songs (album);
 
 CREATE INDEX IF NOT EXISTS idx_title ON songs (title);
 
+CREATE INDEX IF NOT EXISTS idx_artist_title_nocase ON songs (artist COLLATE NOCASE, title COLLATE NOCASE);
+
+CREATE UNIQUE INDEX IF NOT EXISTS idx_lyrics_cache ON lyrics_cache (artist, album, title);
+
 CREATE VIEW IF NOT EXISTS duplicated_songs as select artist dup_artist, album dup_album, title dup_title from songs as inner_songs where artist != '' and album != '' and title != '' and unavailable = 0 group by artist, album , title having count(*) > 1;
@@ -31,6 +31,7 @@
 #include <QMutex>
 #include <QSet>
 #include <QMap>
+#include <QHash>
 #include <QList>
 #include <QVariant>
 #include <QByteArray>
@@ -52,6 +53,7 @@
 #include "core/song.h"
 
 #include "collectiondirectory.h"
+#include "collectionplaystatistics.h"
 #include "collectionbackend.h"
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
@@ -59,6 +61,11 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Each URL is bound in four encodings, keep the number of bound values below SQLite's default limit of 999.
+constexpr qint64 kMaxUrlsPerQuery = 200;
+}  // namespace
+
 CollectionBackend::CollectionBackend(QObject *parent)
     : CollectionBackendInterface(parent),
       db_(nullptr),
@@ -516,17 +523,94 @@ SongList CollectionBackend::SongsWithMissingLoudnessCharacteristics(const int id
 
 void CollectionBackend::SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id) {
 
-  // Take a song and update its path
-  Song updated_song = song;
-  updated_song.set_source(source_);
-  updated_song.set_url(QUrl::fromLocalFile(QDir::cleanPath(new_file.filePath())));
-  updated_song.set_basefilename(new_file.fileName());
-  updated_song.InitArtManual();
-  if (updated_song.is_collection_song() && new_collection_directory_id) {
-    updated_song.set_directory_id(new_collection_directory_id.value());
+  SongPathsChanged(SongList() << song, QList<QFileInfo>() << new_file, new_collection_directory_id);
+
+}
+
+void CollectionBackend::SongPathsChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id) {
+
+  SongList updated_songs;
+  SongList new_songs;
+  updated_songs.reserve(songs.count());
+  for (qint64 i = 0; i < songs.count() && i < new_files.count(); ++i) {
+    // Take a song and update its path
+    Song updated_song = songs[i];
+    updated_song.set_source(source_);
+    updated_song.set_url(QUrl::fromLocalFile(QDir::cleanPath(new_files[i].filePath())));
+    updated_song.set_basefilename(new_files[i].fileName());
+    updated_song.InitArtManual();
+    if (updated_song.is_collection_song() && new_collection_directory_id) {
+      updated_song.set_directory_id(new_collection_directory_id.value());
+    }
+    if (updated_song.id() == -1) {
+      new_songs << updated_song;
+    }
+    else {
+      updated_songs << updated_song;
+    }
   }
 
-  AddOrUpdateSongs(SongList() << updated_song);
+  if (!updated_songs.isEmpty()) {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+
+    ScopedTransaction transaction(&db);
+
+    // Get the previous song data of the whole batch first, songs that were removed in the meantime are skipped.
+    QStringList ids;
+    ids.reserve(updated_songs.count());
+    for (const Song &song : std::as_const(updated_songs)) {
+      ids << QString::number(song.id());
+    }
+    QSet<int> existing_ids;
+    const SongList old_songs = GetSongsById(ids, db);
+    for (const Song &old_song : old_songs) {
+      if (old_song.is_valid()) existing_ids.insert(old_song.id());
+    }
+
+    // Make sure the directories still exist, a directory might be removed while the songs are moved.
+    QHash<int, bool> existing_dirs;
+
+    SongList changed_songs;
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+    for (const Song &song : std::as_const(updated_songs)) {
+      if (!existing_ids.contains(song.id())) continue;
+
+      if (!dirs_table_.isEmpty()) {
+        if (!existing_dirs.contains(song.directory_id())) {
+          SqlQuery check_dir(db);
+          check_dir.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
+          check_dir.BindValue(u":id"_s, song.directory_id());
+          if (!check_dir.Exec()) {
+            db_->ReportErrors(check_dir);
+            return;
+          }
+          existing_dirs.insert(song.directory_id(), check_dir.next());
+        }
+        if (!existing_dirs.value(song.directory_id())) continue;
+      }
+
+      song.BindToQuery(&q);
+      q.BindValue(u":id"_s, song.id());
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+      changed_songs << song;
+    }
+
+    transaction.Commit();
+
+    if (!changed_songs.isEmpty()) {
+      Q_EMIT SongsChanged(changed_songs);
+    }
+  }
+
+  // Songs that are not in the database yet are added.
+  if (!new_songs.isEmpty()) {
+    AddOrUpdateSongs(new_songs);
+  }
 
 }
 
@@ -833,6 +917,256 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
 }
 
+void CollectionBackend::UpdateSongsByAlbumIDAsync(const QStringList &album_ids, const SongMap &new_songs) {
+  QMetaObject::invokeMethod(this, "UpdateSongsByAlbumID", Qt::QueuedConnection, Q_ARG(QStringList, album_ids), Q_ARG(SongMap, new_songs));
+}
+
+void CollectionBackend::UpdateSongsByAlbumID(const QStringList &album_ids, const SongMap &new_songs) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  ScopedTransaction transaction(&db);
+
+  SongList added_songs;
+  SongList changed_songs;
+  SongList deleted_songs;
+
+  // Existing songs of the albums, and existing songs that were moved here from other albums.
+  SongMap old_songs;
+  for (const QString &album_id : album_ids) {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE album_id = :album_id").arg(Song::kRowIdColumnSpec, songs_table_));
+    q.BindValue(u":album_id"_s, album_id);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+    while (q.next()) {
+      Song song(source_);
+      song.InitFromQuery(q, true);
+      old_songs.insert(song.song_id(), song);
+    }
+  }
+  if (!new_songs.isEmpty()) {
+    const SongList songs = GetSongsBySongId(new_songs.keys(), db);
+    for (const Song &song : songs) {
+      old_songs.insert(song.song_id(), song);
+    }
+  }
+
+  if (!UpsertSongs(db, old_songs, new_songs, added_songs, changed_songs)) return;
+
+  for (const Song &old_song : std::as_const(old_songs)) {
+    if (new_songs.contains(old_song.song_id())) continue;
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
+    q.BindValue(u":id"_s, old_song.id());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+    deleted_songs << old_song;
+  }
+
+  transaction.Commit();
+
+  if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(deleted_songs);
+  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
+  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+
+  if (!deleted_songs.isEmpty() || !added_songs.isEmpty()) {
+    UpdateTotalSongCountAsync();
+    UpdateTotalArtistCountAsync();
+    UpdateTotalAlbumCountAsync();
+  }
+
+}
+
+void CollectionBackend::GetAlbumModificationTimesAsync() {
+  QMetaObject::invokeMethod(this, "GetAlbumModificationTimes", Qt::QueuedConnection);
+}
+
+void CollectionBackend::GetAlbumModificationTimes() {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  QMap<QString, qint64> album_mtimes;
+
+  SqlQuery q(db);
+  q.setForwardOnly(true);
+  q.prepare(QStringLiteral("SELECT album_id, MIN(mtime) FROM %1 WHERE album_id != '' GROUP BY album_id").arg(songs_table_));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    Q_EMIT GotAlbumModificationTimes(album_mtimes);
+    return;
+  }
+
+  while (q.next()) {
+    album_mtimes.insert(q.value(0).toString(), q.value(1).toLongLong());
+  }
+
+  Q_EMIT GotAlbumModificationTimes(album_mtimes);
+
+}
+
+void CollectionBackend::BeginSyncAsync() {
+  QMetaObject::invokeMethod(this, "BeginSync", Qt::QueuedConnection);
+}
+
+void CollectionBackend::BeginSync() {
+
+  synced_song_ids_.clear();
+
+}
+
+void CollectionBackend::UpsertSongsBySongIDAsync(const SongMap &new_songs) {
+  QMetaObject::invokeMethod(this, "UpsertSongsBySongID", Qt::QueuedConnection, Q_ARG(SongMap, new_songs));
+}
+
+void CollectionBackend::UpsertSongsBySongID(const SongMap &new_songs) {
+
+  if (new_songs.isEmpty()) return;
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  ScopedTransaction transaction(&db);
+
+  SongList added_songs;
+  SongList changed_songs;
+
+  // Only the existing rows of the songs in this page are loaded.
+  SongMap old_songs;
+  const SongList songs = GetSongsBySongId(new_songs.keys(), db);
+  for (const Song &song : songs) {
+    old_songs.insert(song.song_id(), song);
+  }
+
+  if (!UpsertSongs(db, old_songs, new_songs, added_songs, changed_songs)) return;
+
+  transaction.Commit();
+
+  for (SongMap::const_iterator it = new_songs.constBegin(); it != new_songs.constEnd(); ++it) {
+    synced_song_ids_.insert(it.key());
+  }
+
+  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
+  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+
+  if (!added_songs.isEmpty()) {
+    UpdateTotalSongCountAsync();
+    UpdateTotalArtistCountAsync();
+    UpdateTotalAlbumCountAsync();
+  }
+
+}
+
+void CollectionBackend::EndSyncAsync(const bool delete_unsynced) {
+  QMetaObject::invokeMethod(this, "EndSync", Qt::QueuedConnection, Q_ARG(bool, delete_unsynced));
+}
+
+void CollectionBackend::EndSync(const bool delete_unsynced) {
+
+  if (!delete_unsynced) {
+    synced_song_ids_.clear();
+    return;
+  }
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  ScopedTransaction transaction(&db);
+
+  // Only the song IDs are needed to find the unsynced songs, the full rows are loaded for the deleted songs.
+  QStringList deleted_ids;
+  {
+    SqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare(QStringLiteral("SELECT ROWID, song_id FROM %1").arg(songs_table_));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      synced_song_ids_.clear();
+      return;
+    }
+    while (q.next()) {
+      if (!synced_song_ids_.contains(q.value(1).toString())) {
+        deleted_ids << QString::number(q.value(0).toInt());
+      }
+    }
+  }
+
+  synced_song_ids_.clear();
+
+  if (deleted_ids.isEmpty()) return;
+
+  const SongList deleted_songs = GetSongsById(deleted_ids, db);
+
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
+  for (const Song &song : deleted_songs) {
+    q.BindValue(u":id"_s, song.id());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  transaction.Commit();
+
+  Q_EMIT SongsDeleted(deleted_songs);
+
+  UpdateTotalSongCountAsync();
+  UpdateTotalArtistCountAsync();
+  UpdateTotalAlbumCountAsync();
+
+}
+
+bool CollectionBackend::UpsertSongs(QSqlDatabase &db, const SongMap &old_songs, const SongMap &new_songs, SongList &added_songs, SongList &changed_songs) {
+
+  for (const Song &new_song : new_songs) {
+    if (old_songs.contains(new_song.song_id())) {
+      const Song old_song = old_songs.value(new_song.song_id());
+      // The modification time is compared too, services use it to detect changed albums.
+      if (new_song.IsAllMetadataEqual(old_song) && new_song.IsFingerprintEqual(old_song) && new_song.mtime() == old_song.mtime()) continue;
+      {
+        SqlQuery q(db);
+        q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+        new_song.BindToQuery(&q);
+        q.BindValue(u":id"_s, old_song.id());
+        if (!q.Exec()) {
+          db_->ReportErrors(q);
+          return false;
+        }
+      }
+      Song new_song_copy(new_song);
+      new_song_copy.set_id(old_song.id());
+      changed_songs << new_song_copy;
+    }
+    else {
+      int id = -1;
+      {
+        SqlQuery q(db);
+        q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+        new_song.BindToQuery(&q);
+        if (!q.Exec()) {
+          db_->ReportErrors(q);
+          return false;
+        }
+        id = q.lastInsertId().toInt();
+      }
+      if (id == -1) return false;
+      Song new_song_copy(new_song);
+      new_song_copy.set_id(id);
+      added_songs << new_song_copy;
+    }
+  }
+
+  return true;
+
+}
+
 void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
 
   QMutexLocker l(db_->Mutex());
@@ -932,6 +1266,32 @@ QStringList CollectionBackend::GetAll(const QString &column, const CollectionFil
 
 }
 
+QHash<int, QStringList> CollectionBackend::GetAllColumnValues(const QStringList &columns) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("SELECT ROWID, %1 FROM %2 WHERE unavailable = 0").arg(columns.join(", "_L1), songs_table_));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return QHash<int, QStringList>();
+  }
+
+  QHash<int, QStringList> values;
+  while (q.next()) {
+    QStringList song_values;
+    song_values.reserve(columns.count());
+    for (int i = 0; i < columns.count(); ++i) {
+      song_values << q.value(i + 1).toString();
+    }
+    values.insert(q.value(0).toInt(), song_values);
+  }
+
+  return values;
+
+}
+
 QStringList CollectionBackend::GetAllArtists(const CollectionFilterOptions &opt) {
 
   return GetAll(u"artist"_s, opt);
@@ -1245,6 +1605,50 @@ SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailabl
 }
 
 
+QHash<QUrl, SongList> CollectionBackend::GetSongsByUrls(const QList<QUrl> &urls) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  const QList<QUrl> unique_urls = QSet<QUrl>(urls.begin(), urls.end()).values();
+
+  QHash<QUrl, SongList> songs;
+  for (qint64 i = 0; i < unique_urls.count(); i += kMaxUrlsPerQuery) {
+    const QList<QUrl> batch_urls = unique_urls.mid(i, kMaxUrlsPerQuery);
+    QStringList placeholders;
+    placeholders.reserve(batch_urls.count() * 4);
+    for (qint64 j = 0; j < batch_urls.count(); ++j) {
+      for (int k = 0; k < 4; ++k) {
+        placeholders << u":url%1_%2"_s.arg(j).arg(k);
+      }
+    }
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE url IN (%3) AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_, placeholders.join(u',')));
+    // Map the stored URL back to the URL it matched.
+    QHash<QString, QUrl> batch_url_encodings;
+    for (qint64 j = 0; j < batch_urls.count(); ++j) {
+      const QUrl &url = batch_urls[j];
+      const QString url_encodings[] = { url.toString(), url.toString(QUrl::FullyEncoded), QString::fromUtf8(url.toEncoded(QUrl::FullyDecoded)), QString::fromUtf8(url.toEncoded(QUrl::FullyEncoded)) };
+      for (int k = 0; k < 4; ++k) {
+        q.BindValue(u":url%1_%2"_s.arg(j).arg(k), url_encodings[k]);
+        batch_url_encodings.insert(url_encodings[k], url);
+      }
+    }
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return QHash<QUrl, SongList>();
+    }
+    while (q.next()) {
+      Song song(source_);
+      song.InitFromQuery(q, true);
+      songs[batch_url_encodings.value(q.value(u"url"_s).toString(), song.url())] << song;
+    }
+  }
+
+  return songs;
+
+}
+
 Song CollectionBackend::GetSongBySongId(const QString &song_id) {
 
   QMutexLocker l(db_->Mutex());
@@ -1983,58 +2387,176 @@ SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &alb
 
 }
 
-void CollectionBackend::UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed) {
+bool CollectionBackend::CreateImportTable(QSqlDatabase &db, const QString &table, const QString &columns) {
 
-  const SongList songs = GetSongsBy(artist, album, title);
-  if (songs.isEmpty()) {
-    qLog(Debug) << "Could not find a matching song in the database for" << artist << album << title;
-    return;
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS %1 (artist TEXT NOT NULL, title TEXT NOT NULL, %2)").arg(table, columns));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("CREATE INDEX IF NOT EXISTS temp.idx_%1 ON %1 (artist COLLATE NOCASE, title COLLATE NOCASE)").arg(table));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
   }
 
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("DELETE FROM temp.%1").arg(table));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
+void CollectionBackend::UpdateLastPlayed(const CollectionLastPlayedList &lastplayed_list) {
+
+  if (lastplayed_list.isEmpty()) return;
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  for (const Song &song : songs) {
-    if (song.lastplayed() >= lastplayed) {
-      continue;
+  ScopedTransaction transaction(&db);
+
+  if (!CreateImportTable(db, u"import_lastplayed"_s, u"album TEXT NOT NULL, lastplayed INTEGER NOT NULL"_s)) return;
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"INSERT INTO temp.import_lastplayed (artist, album, title, lastplayed) VALUES (:artist, :album, :title, :lastplayed)"_s);
+    for (const CollectionLastPlayed &lastplayed : lastplayed_list) {
+      q.BindStringValue(u":artist"_s, lastplayed.artist);
+      q.BindStringValue(u":album"_s, lastplayed.album);
+      q.BindStringValue(u":title"_s, lastplayed.title);
+      q.BindValue(u":lastplayed"_s, lastplayed.lastplayed);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
     }
+  }
+
+  // An empty album matches the song on any album.
+  QMap<int, qint64> song_lastplayed;
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT songs.ROWID, MAX(import.lastplayed) FROM temp.import_lastplayed AS import INNER JOIN %1 AS songs ON songs.artist = import.artist COLLATE NOCASE AND songs.title = import.title COLLATE NOCASE AND (import.album = '' OR songs.album = import.album COLLATE NOCASE) GROUP BY songs.ROWID HAVING MAX(import.lastplayed) > songs.lastplayed").arg(songs_table_));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+    while (q.next()) {
+      song_lastplayed.insert(q.value(0).toInt(), q.value(1).toLongLong());
+    }
+  }
+
+  {
     SqlQuery q(db);
     q.prepare(QStringLiteral("UPDATE %1 SET lastplayed = :lastplayed WHERE ROWID = :id").arg(songs_table_));
-    q.BindValue(u":lastplayed"_s, lastplayed);
-    q.BindValue(u":id"_s, song.id());
+    for (QMap<int, qint64>::const_iterator it = song_lastplayed.constBegin(); it != song_lastplayed.constEnd(); ++it) {
+      q.BindValue(u":lastplayed"_s, it.value());
+      q.BindValue(u":id"_s, it.key());
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM temp.import_lastplayed"_s);
     if (!q.Exec()) {
       db_->ReportErrors(q);
-      continue;
     }
   }
 
-  Q_EMIT SongsStatisticsChanged(SongList() << songs);
+  transaction.Commit();
+
+  qLog(Debug) << "Updated last played for" << song_lastplayed.count() << "songs from" << lastplayed_list.count() << "imported tracks";
+
+  if (!song_lastplayed.isEmpty()) {
+    Q_EMIT SongsStatisticsChanged(GetSongsById(song_lastplayed.keys()));
+  }
 
 }
 
-void CollectionBackend::UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags) {
+void CollectionBackend::UpdatePlayCount(const CollectionPlayCountList &playcount_list, const bool save_tags) {
 
-  const SongList songs = GetSongsBy(artist, QString(), title);
-  if (songs.isEmpty()) {
-    qLog(Debug) << "Could not find a matching song in the database for" << artist << title;
-    return;
-  }
+  if (playcount_list.isEmpty()) return;
 
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  for (const Song &song : songs) {
+  ScopedTransaction transaction(&db);
+
+  if (!CreateImportTable(db, u"import_playcount"_s, u"playcount INTEGER NOT NULL"_s)) return;
+
+  {
     SqlQuery q(db);
-    q.prepare(QStringLiteral("UPDATE %1 SET playcount = :playcount WHERE ROWID = :id").arg(songs_table_));
-    q.BindValue(u":playcount"_s, playcount);
-    q.BindValue(u":id"_s, song.id());
+    q.prepare(u"INSERT INTO temp.import_playcount (artist, title, playcount) VALUES (:artist, :title, :playcount)"_s);
+    for (const CollectionPlayCount &playcount : playcount_list) {
+      q.BindStringValue(u":artist"_s, playcount.artist);
+      q.BindStringValue(u":title"_s, playcount.title);
+      q.BindValue(u":playcount"_s, playcount.playcount);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+  }
+
+  QMap<int, int> song_playcount;
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT songs.ROWID, MAX(import.playcount) FROM temp.import_playcount AS import INNER JOIN %1 AS songs ON songs.artist = import.artist COLLATE NOCASE AND songs.title = import.title COLLATE NOCASE GROUP BY songs.ROWID HAVING MAX(import.playcount) != songs.playcount").arg(songs_table_));
     if (!q.Exec()) {
       db_->ReportErrors(q);
       return;
     }
+    while (q.next()) {
+      song_playcount.insert(q.value(0).toInt(), q.value(1).toInt());
+    }
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("UPDATE %1 SET playcount = :playcount WHERE ROWID = :id").arg(songs_table_));
+    for (QMap<int, int>::const_iterator it = song_playcount.constBegin(); it != song_playcount.constEnd(); ++it) {
+      q.BindValue(u":playcount"_s, it.value());
+      q.BindValue(u":id"_s, it.key());
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
   }
 
-  Q_EMIT SongsStatisticsChanged(SongList() << songs, save_tags);
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM temp.import_playcount"_s);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+    }
+  }
+
+  transaction.Commit();
+
+  qLog(Debug) << "Updated play count for" << song_playcount.count() << "songs from" << playcount_list.count() << "imported tracks";
+
+  if (!song_playcount.isEmpty()) {
+    Q_EMIT SongsStatisticsChanged(GetSongsById(song_playcount.keys()), save_tags);
+  }
 
 }
 
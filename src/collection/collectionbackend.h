@@ -31,6 +31,9 @@
 #include <QObject>
 #include <QFileInfo>
 #include <QList>
+#include <QHash>
+#include <QMap>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -41,6 +44,7 @@
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
 #include "collectiondirectory.h"
+#include "collectionplaystatistics.h"
 
 class QThread;
 class TaskManager;
@@ -131,6 +135,9 @@ class CollectionBackendInterface : public QObject {
   // Using default beginning value is suitable when searching for single-section songs.
   virtual Song GetSongByUrl(const QUrl &url, const qint64 beginning = 0) = 0;
   virtual Song GetSongByUrlAndTrack(const QUrl &url, const int track) = 0;
+  // Returns all sections of the songs with the given filenames by the URL they were looked up with, using one query per batch of URLs.
+  // The collection can store the URL in another encoding, so don't look the sections up by their own URL. Filenames not in the collection are left out.
+  virtual QHash<QUrl, SongList> GetSongsByUrls(const QList<QUrl> &urls) = 0;
 
   virtual void AddDirectoryAsync(const QString &path) = 0;
   virtual void RemoveDirectoryAsync(const CollectionDirectory &dir) = 0;
@@ -180,6 +187,8 @@ class CollectionBackend : public CollectionBackendInterface {
   SongList GetAllSongs() override;
 
   QStringList GetAll(const QString &column, const CollectionFilterOptions &filter_options = CollectionFilterOptions());
+  // Returns the values of the given columns for each available song, keyed by song ID.
+  QHash<int, QStringList> GetAllColumnValues(const QStringList &columns);
   QStringList GetAllArtists(const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
   QStringList GetAllArtistsWithAlbums(const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
   SongList GetArtistSongs(const QString &effective_albumartist, const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
@@ -207,6 +216,7 @@ class CollectionBackend : public CollectionBackendInterface {
   SongList GetSongsByUrl(const QUrl &url, const bool unavailable = false) override;
   Song GetSongByUrl(const QUrl &url, qint64 beginning = 0) override;
   Song GetSongByUrlAndTrack(const QUrl &url, const int track) override;
+  QHash<QUrl, SongList> GetSongsByUrls(const QList<QUrl> &urls) override;
 
   void AddDirectoryAsync(const QString &path) override;
   void RemoveDirectoryAsync(const CollectionDirectory &dir) override;
@@ -230,6 +240,13 @@ class CollectionBackend : public CollectionBackendInterface {
 
   void AddOrUpdateSongsAsync(const SongList &songs);
   void UpdateSongsBySongIDAsync(const SongMap &new_songs);
+  void UpdateSongsByAlbumIDAsync(const QStringList &album_ids, const SongMap &new_songs);
+  void GetAlbumModificationTimesAsync();
+
+  // Writes the songs of a sync page by page, songs that were not written since the sync began are deleted when it ends.
+  void BeginSyncAsync();
+  void UpsertSongsBySongIDAsync(const SongMap &new_songs);
+  void EndSyncAsync(const bool delete_unsynced);
 
   void UpdateSongRatingAsync(const int id, const float rating, const bool save_tags = false);
   void UpdateSongsRatingAsync(const QList<int> &ids, const float rating, const bool save_tags = false);
@@ -245,6 +262,12 @@ class CollectionBackend : public CollectionBackendInterface {
   void RemoveDirectory(const CollectionDirectory &dir);
   void AddOrUpdateSongs(const SongList &songs);
   void UpdateSongsBySongID(const SongMap &new_songs);
+  // Replaces the songs of the given albums with the new songs, and adds or updates new songs not belonging to any of the albums.
+  void UpdateSongsByAlbumID(const QStringList &album_ids, const SongMap &new_songs);
+  void GetAlbumModificationTimes();
+  void BeginSync();
+  void UpsertSongsBySongID(const SongMap &new_songs);
+  void EndSync(const bool delete_unsynced);
   void UpdateMTimesOnly(const SongList &songs);
   void DeleteSongs(const SongList &songs);
   void MarkSongsUnavailable(const SongList &songs, const bool unavailable = true);
@@ -262,10 +285,12 @@ class CollectionBackend : public CollectionBackendInterface {
   bool ResetPlayStatistics(const QStringList &id_str_list);
   void DeleteAll();
   void SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id);
+  // Moves each song to the new file at the same index in one transaction, and emits SongsChanged once for all of them.
+  void SongPathsChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id);
 
   SongList GetSongsBy(const QString &artist, const QString &album, const QString &title);
-  void UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed);
-  void UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags = false);
+  void UpdateLastPlayed(const CollectionLastPlayedList &lastplayed_list);
+  void UpdatePlayCount(const CollectionPlayCountList &playcount_list, const bool save_tags = false);
 
   void UpdateSongRating(const int id, const float rating, const bool save_tags = false);
   void UpdateSongsRating(const QList<int> &id_list, const float rating, const bool save_tags = false);
@@ -278,6 +303,7 @@ class CollectionBackend : public CollectionBackendInterface {
   void DirectoryDeleted(const CollectionDirectory &dir);
 
   void GotSongs(const SongList &songs, const int id);
+  void GotAlbumModificationTimes(const QMap<QString, qint64> &album_mtimes);
   void SongsAdded(const SongList &songs);
   void SongsDeleted(const SongList &songs);
   void SongsChanged(const SongList &songs);
@@ -316,6 +342,9 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongBySongId(const QString &song_id, QSqlDatabase &db);
   SongList GetSongsBySongId(const QStringList &song_ids, QSqlDatabase &db);
 
+  bool UpsertSongs(QSqlDatabase &db, const SongMap &old_songs, const SongMap &new_songs, SongList &added_songs, SongList &changed_songs);
+  bool CreateImportTable(QSqlDatabase &db, const QString &table, const QString &columns);
+
  private:
   SharedPtr<Database> db_;
   SharedPtr<TaskManager> task_manager_;
@@ -324,6 +353,7 @@ class CollectionBackend : public CollectionBackendInterface {
   QString dirs_table_;
   QString subdirs_table_;
   QThread *original_thread_;
+  QSet<QString> synced_song_ids_;
 };
 
 #endif  // COLLECTIONBACKEND_H
@@ -22,10 +22,13 @@
 #include "config.h"
 
 #include <utility>
+#include <algorithm>
 #include <chrono>
 
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 #include <QIODevice>
 #include <QDir>
 #include <QDirIterator>
@@ -43,6 +46,7 @@
 #include <QUrl>
 #include <QImage>
 #include <QMutexLocker>
+#include <QScopeGuard>
 #include <QSettings>
 
 #include "core/filesystemwatcherinterface.h"
@@ -50,6 +54,7 @@
 #include "core/taskmanager.h"
 #include "core/settings.h"
 #include "utilities/imageutils.h"
+#include "utilities/fileutils.h"
 #include "constants/timeconstants.h"
 #include "tagreader/tagreaderclient.h"
 #include "collectiondirectory.h"
@@ -73,6 +78,13 @@
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+
+constexpr int kRemovableReadThreads = 2;
+constexpr int kMaxLocalReadThreads = 4;
+
+}  // namespace
+
 QStringList CollectionWatcher::sValidImages = QStringList() << u"jpg"_s << u"png"_s << u"gif"_s << u"jpeg"_s;
 
 CollectionWatcher::CollectionWatcher(const Song::Source source,
@@ -102,6 +114,7 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
       rescan_paused_(false),
       total_watches_(0),
       cue_parser_(new CueParser(tagreader_client, backend, this)),
+      read_threadpool_(new QThreadPool(this)),
       last_scan_time_(0) {
 
   setObjectName(source_ == Song::Source::Collection ? QLatin1String(metaObject()->className()) : QStringLiteral("%1%2").arg(Song::DescriptionForSource(source_), QLatin1String(metaObject()->className())));
@@ -264,6 +277,7 @@ CollectionWatcher::ScanTransaction::ScanTransaction(CollectionWatcher *watcher,
       ignores_mtime_(ignores_mtime),
       mark_songs_unavailable_(mark_songs_unavailable),
       expire_unavailable_songs_days_(60),
+      read_threads_(watcher->ReadThreadsForDirectory(dir)),
       watcher_(watcher),
       cached_songs_dirty_(true),
       cached_songs_missing_fingerprint_dirty_(true),
@@ -551,6 +565,9 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
   }
 
   // First we "quickly" get a list of the files in the directory that we think might be music.  While we're here, we also look for new subdirectories and possible album artwork.
+  // With parallel reads, the media files are checked after the whole directory has been listed.
+  const bool prefetch = t->read_threads() > 1;
+  QStringList candidate_files;
   QDirIterator it(path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
   while (it.hasNext()) {
 
@@ -580,6 +597,9 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
         album_art[dir_part] << child;
         t->AddToProgress(1);
       }
+      else if (prefetch) {
+        candidate_files << child;
+      }
       else if (tagreader_client_->IsMediaFileBlocking(child)) {
         files_on_disk << child;
       }
@@ -594,6 +614,14 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
   // Ask the database for a list of files in this directory
   SongList songs_in_db = t->FindSongsInSubdirectory(path);
 
+  // The prefetched songs are only for this subdirectory, also when the scan is stopped halfway.
+  const QScopeGuard clear_prefetched_songs = qScopeGuard([this]() { prefetched_songs_.clear(); });
+
+  if (!candidate_files.isEmpty()) {
+    files_on_disk << PrefetchMediaFiles(candidate_files, songs_in_db, t);
+    if (stop_or_abort_requested()) return;
+  }
+
   QSet<QString> cues_processed;
 
   // Now compare the list from the database with the list of files on disk
@@ -808,6 +836,90 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
 
 }
 
+QStringList CollectionWatcher::PrefetchMediaFiles(const QStringList &filenames, const SongList &songs_in_db, ScanTransaction *t) {
+
+  struct PrefetchedFile {
+    PrefetchedFile() : media_file(false), tags_read(false) {}
+    QString filename;
+    bool media_file;
+    bool tags_read;
+    Song song;
+  };
+
+  prefetched_songs_.clear();
+
+  QHash<QString, Song> songs_by_path;
+  songs_by_path.reserve(songs_in_db.count());
+  for (const Song &song : songs_in_db) {
+    const QString filename = song.url().toLocalFile();
+    if (!songs_by_path.contains(filename)) {
+      songs_by_path.insert(filename, song);
+    }
+  }
+
+  const bool ignores_mtime = t->ignores_mtime();
+
+  read_threadpool_->setMaxThreadCount(t->read_threads());
+  const QList<PrefetchedFile> prefetched_files = QtConcurrent::blockingMapped<QList<PrefetchedFile>>(read_threadpool_, filenames, [this, &songs_by_path, ignores_mtime](const QString &filename) {
+    PrefetchedFile prefetched_file;
+    prefetched_file.filename = filename;
+    if (stop_or_abort_requested()) return prefetched_file;
+
+    // Files with the same path, mtime and size as in the collection don't need to be opened.
+    if (!ignores_mtime && songs_by_path.contains(filename)) {
+      const QFileInfo fileinfo(filename);
+      const Song matching_song = songs_by_path.value(filename);
+      if (!matching_song.has_cue() && matching_song.mtime() == fileinfo.lastModified().toSecsSinceEpoch() && matching_song.filesize() == fileinfo.size()) {
+        prefetched_file.media_file = true;
+        return prefetched_file;
+      }
+    }
+
+    // Sections of CUE sheets are read from the sheet, not from the media file.
+    if (CueParser::FindCueFilename(filename).isEmpty()) {
+      Song song(source_);
+      const TagReaderResult result = tagreader_client_->ReadFileBlocking(filename, &song);
+      if (result.success() && song.is_valid()) {
+        prefetched_file.media_file = true;
+        prefetched_file.tags_read = true;
+        prefetched_file.song = song;
+        return prefetched_file;
+      }
+    }
+
+    prefetched_file.media_file = tagreader_client_->IsMediaFileBlocking(filename);
+
+    return prefetched_file;
+  });
+
+  QStringList media_files;
+  for (const PrefetchedFile &prefetched_file : prefetched_files) {
+    if (prefetched_file.media_file) {
+      media_files << prefetched_file.filename;
+    }
+    else {
+      t->AddToProgress(1);
+    }
+    if (prefetched_file.tags_read) {
+      prefetched_songs_.insert(prefetched_file.filename, prefetched_file.song);
+    }
+  }
+
+  return media_files;
+
+}
+
+TagReaderResult CollectionWatcher::ReadFileBlocking(const QString &filename, Song *song) const {
+
+  if (prefetched_songs_.contains(filename)) {
+    *song = prefetched_songs_.value(filename);
+    return TagReaderResult::ErrorCode::Success;
+  }
+
+  return tagreader_client_->ReadFileBlocking(filename, song);
+
+}
+
 void CollectionWatcher::UpdateCueAssociatedSongs(const QString &file,
                                                  const QString &path,
                                                  const QString &fingerprint,
@@ -879,7 +991,7 @@ void CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
   }
 
   Song song_on_disk(source_);
-  const TagReaderResult result = tagreader_client_->ReadFileBlocking(file, &song_on_disk);
+  const TagReaderResult result = ReadFileBlocking(file, &song_on_disk);
   if (result.success() && song_on_disk.is_valid()) {
     song_on_disk.set_source(source_);
     song_on_disk.set_directory_id(t->dir());
@@ -932,7 +1044,7 @@ SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path
   }
   else {  // It's a normal media file
     Song song(source_);
-    const TagReaderResult result = tagreader_client_->ReadFileBlocking(file, &song);
+    const TagReaderResult result = ReadFileBlocking(file, &song);
     if (result.success() && song.is_valid()) {
       song.set_source(source_);
       PerformEBUR128Analysis(song);
@@ -1278,6 +1390,19 @@ void CollectionWatcher::IncrementalScanNow() { PerformScan(true, false); }
 
 void CollectionWatcher::FullScanNow() { PerformScan(false, true); }
 
+int CollectionWatcher::ReadThreadsForDirectory(const int dir) const {
+
+  // The collection is scanned one file at a time in the background, devices are scanned when they are connected.
+  if (source_ == Song::Source::Collection || !watched_dirs_.contains(dir)) return 1;
+
+  if (Utilities::IsRemovableFilesystem(watched_dirs_[dir].path)) {
+    return kRemovableReadThreads;
+  }
+
+  return std::clamp(QThread::idealThreadCount(), kRemovableReadThreads, kMaxLocalReadThreads);
+
+}
+
 void CollectionWatcher::PerformScan(const bool incremental, const bool ignore_mtimes) {
 
   CancelStop();
@@ -38,8 +38,10 @@
 #include "collectiondirectory.h"
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "tagreader/tagreaderresult.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 
 class TaskManager;
@@ -125,6 +127,7 @@ class CollectionWatcher : public QObject {
     int dir() const { return dir_; }
     bool is_incremental() const { return incremental_; }
     bool ignores_mtime() const { return ignores_mtime_; }
+    int read_threads() const { return read_threads_; }
 
     SongList deleted_songs;
     SongList readded_songs;
@@ -156,6 +159,9 @@ class CollectionWatcher : public QObject {
     bool mark_songs_unavailable_;
     int expire_unavailable_songs_days_;
 
+    // Number of files to read tags from in parallel, 1 reads them one by one while comparing with the collection.
+    int read_threads_;
+
     CollectionWatcher *watcher_;
 
     QMultiMap<QString, Song> cached_songs_;
@@ -198,6 +204,12 @@ class CollectionWatcher : public QObject {
   void RemoveWatch(const CollectionDirectory &dir, const CollectionSubdirectory &subdir);
   static quint64 GetMtimeForCue(const QString &cue_path);
   void PerformScan(const bool incremental, const bool ignore_mtimes);
+  int ReadThreadsForDirectory(const int dir) const;
+
+  // Checks and reads the tags of new and changed media files in a directory in parallel, for devices where the reads are slower than the listing.
+  // Returns the media files, the tags are picked up by ReadFileBlocking() while comparing with the collection.
+  QStringList PrefetchMediaFiles(const QStringList &filenames, const SongList &songs_in_db, ScanTransaction *t);
+  TagReaderResult ReadFileBlocking(const QString &filename, Song *song) const;
 
   // Updates the sections of a cue associated and altered (according to mtime) media file during a scan.
   void UpdateCueAssociatedSongs(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, const QUrl &art_automatic, const SongList &old_cue_songs, ScanTransaction *t) const;
@@ -258,6 +270,9 @@ class CollectionWatcher : public QObject {
 
   CueParser *cue_parser_;
 
+  QThreadPool *read_threadpool_;
+  QHash<QString, Song> prefetched_songs_;
+
   static QStringList sValidImages;
 
   qint64 last_scan_time_;
@@ -39,6 +39,8 @@ constexpr char kVerifyCertificate[] = "verifycertificate";
 constexpr char kDownloadAlbumCovers[] = "downloadalbumcovers";
 constexpr char kServerSideScrobbling[] = "serversidescrobbling";
 constexpr char kAuthMethod[] = "authmethod";
+constexpr char kLastModified[] = "lastmodified";
+constexpr char kLastModifiedServer[] = "lastmodifiedserver";
 
 }  // namespace
 
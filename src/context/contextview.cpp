@@ -56,6 +56,9 @@
 #include "utilities/timeutils.h"
 #include "widgets/resizabletextedit.h"
 #include "collection/collectionview.h"
+#include "playlist/playlist.h"
+#include "playlist/playlistitem.h"
+#include "playlist/playlistmanager.h"
 #include "covermanager/albumcoverchoicecontroller.h"
 #include "lyrics/lyricsfetcher.h"
 #include "constants/contextsettings.h"
@@ -67,6 +70,7 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr int kWidgetSpacing = 50;
+constexpr int kPrefetchLyricsSongs = 3;
 }  // namespace
 
 ContextView::ContextView(QWidget *parent)
@@ -238,13 +242,15 @@ ContextView::ContextView(QWidget *parent)
 
 }
 
-void ContextView::Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers) {
+void ContextView::Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers, SharedPtr<LyricsCache> lyrics_cache, SharedPtr<PlaylistManager> playlist_manager) {
 
   collectionview_ = collectionview;
   album_cover_choice_controller_ = album_cover_choice_controller;
+  playlist_manager_ = playlist_manager;
 
   widget_album_->Init(this, album_cover_choice_controller_);
   lyrics_fetcher_ = new LyricsFetcher(lyrics_providers, this);
+  lyrics_fetcher_->set_lyrics_cache(lyrics_cache);
 
   QObject::connect(collectionview_, &CollectionView::TotalSongCountUpdated_, this, &ContextView::UpdateNoSong);
   QObject::connect(collectionview_, &CollectionView::TotalArtistCountUpdated_, this, &ContextView::UpdateNoSong);
@@ -361,6 +367,7 @@ void ContextView::SongChanged(const Song &song) {
     lyrics_id_ = -1;
     lyrics_tried_ = false;
     SetSong();
+    PrefetchLyrics();
   }
 
   SearchLyrics();
@@ -377,6 +384,25 @@ void ContextView::SearchLyrics() {
 
 }
 
+void ContextView::PrefetchLyrics() {
+
+  if (!action_show_lyrics_->isChecked() || !action_search_lyrics_->isChecked() || !playlist_manager_) return;
+
+  Playlist *playlist = playlist_manager_->active();
+  if (!playlist) return;
+
+  SongList songs;
+  const QList<int> rows = playlist->next_rows(kPrefetchLyricsSongs);
+  for (const int row : rows) {
+    if (playlist->has_item_at(row)) {
+      songs << playlist->item_at(row)->Metadata();
+    }
+  }
+
+  lyrics_fetcher_->Prefetch(songs);
+
+}
+
 void ContextView::FadeStopFinished() {
 
   widget_stacked_->setCurrentWidget(widget_stop_);
@@ -30,6 +30,7 @@
 #include <QImage>
 #include <QAction>
 
+#include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "contextalbum.h"
 
@@ -49,7 +50,9 @@ class ResizableTextEdit;
 class CollectionView;
 class AlbumCoverChoiceController;
 class LyricsProviders;
+class LyricsCache;
 class LyricsFetcher;
+class PlaylistManager;
 
 class ContextView : public QWidget {
   Q_OBJECT
@@ -57,7 +60,7 @@ class ContextView : public QWidget {
  public:
   explicit ContextView(QWidget *parent = nullptr);
 
-  void Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers);
+  void Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers, SharedPtr<LyricsCache> lyrics_cache, SharedPtr<PlaylistManager> playlist_manager);
 
   ContextAlbum *album_widget() const { return widget_album_; }
   bool album_enabled() const { return action_show_album_->isChecked(); }
@@ -78,6 +81,7 @@ class ContextView : public QWidget {
   void ResetSong();
   void GetCoverAutomatically();
   void SearchLyrics();
+  void PrefetchLyrics();
   void UpdateFonts();
 
  Q_SIGNALS:
@@ -104,6 +108,7 @@ class ContextView : public QWidget {
   CollectionView *collectionview_;
   AlbumCoverChoiceController *album_cover_choice_controller_;
   LyricsFetcher *lyrics_fetcher_;
+  SharedPtr<PlaylistManager> playlist_manager_;
 
   QMenu *menu_options_;
   QAction *action_show_album_;
@@ -58,6 +58,7 @@
 #include "covermanager/opentidalcoverprovider.h"
 
 #include "lyrics/lyricsproviders.h"
+#include "lyrics/lyricscache.h"
 #include "lyrics/geniuslyricsprovider.h"
 #include "lyrics/ovhlyricsprovider.h"
 #include "lyrics/lololyricsprovider.h"
@@ -180,6 +181,11 @@ class ApplicationImpl {
           lyrics_providers->ReloadSettings();
           return lyrics_providers;
         }),
+        lyrics_cache_([this, app]() {
+          LyricsCache *lyrics_cache = new LyricsCache(app->database());
+          app->MoveToThread(lyrics_cache, database_->thread());
+          return lyrics_cache;
+        }),
         streaming_services_([app]() {
           StreamingServices *streaming_services = new StreamingServices();
 #ifdef HAVE_SUBSONIC
@@ -199,9 +205,9 @@ class ApplicationImpl {
         radio_services_([app]() { return new RadioServices(app->task_manager(), app->network(), app->database(), app->albumcover_loader()); }),
         scrobbler_([app]() {
           AudioScrobbler *scrobbler = new AudioScrobbler(app);
-          scrobbler->AddService(make_shared<LastFMScrobbler>(scrobbler->settings(), app->network()));
-          scrobbler->AddService(make_shared<LibreFMScrobbler>(scrobbler->settings(), app->network()));
-          scrobbler->AddService(make_shared<ListenBrainzScrobbler>(scrobbler->settings(), app->network()));
+          scrobbler->AddService(make_shared<LastFMScrobbler>(scrobbler->settings(), app->task_manager(), app->network()));
+          scrobbler->AddService(make_shared<LibreFMScrobbler>(scrobbler->settings(), app->task_manager(), app->network()));
+          scrobbler->AddService(make_shared<ListenBrainzScrobbler>(scrobbler->settings(), app->task_manager(), app->network()));
 #ifdef HAVE_SUBSONIC
           scrobbler->AddService(make_shared<SubsonicScrobbler>(scrobbler->settings(), app->streaming_services()->Service<SubsonicService>(), app));
 #endif
@@ -229,6 +235,7 @@ class ApplicationImpl {
   Lazy<AlbumCoverLoader> albumcover_loader_;
   Lazy<CurrentAlbumCoverLoader> current_albumcover_loader_;
   Lazy<LyricsProviders> lyrics_providers_;
+  Lazy<LyricsCache> lyrics_cache_;
   Lazy<StreamingServices> streaming_services_;
   Lazy<RadioServices> radio_services_;
   Lazy<AudioScrobbler> scrobbler_;
@@ -292,6 +299,7 @@ void Application::Exit() {
   wait_for_exit_ << &*tagreader_client()
                  << &*collection()
                  << &*playlist_backend()
+                 << &*lyrics_cache()
                  << &*albumcover_loader()
                  << &*device_manager()
                  << &*streaming_services()
@@ -306,6 +314,9 @@ void Application::Exit() {
   QObject::connect(&*playlist_backend(), &PlaylistBackend::ExitFinished, this, &Application::ExitReceived);
   playlist_backend()->ExitAsync();
 
+  QObject::connect(&*lyrics_cache(), &LyricsCache::ExitFinished, this, &Application::ExitReceived);
+  lyrics_cache()->ExitAsync();
+
   QObject::connect(&*albumcover_loader(), &AlbumCoverLoader::ExitFinished, this, &Application::ExitReceived);
   albumcover_loader()->ExitAsync();
 
@@ -351,6 +362,7 @@ SharedPtr<AlbumCoverLoader> Application::albumcover_loader() const { return p_->
 SharedPtr<CoverProviders> Application::cover_providers() const { return p_->cover_providers_.ptr(); }
 SharedPtr<CurrentAlbumCoverLoader> Application::current_albumcover_loader() const { return p_->current_albumcover_loader_.ptr(); }
 SharedPtr<LyricsProviders> Application::lyrics_providers() const { return p_->lyrics_providers_.ptr(); }
+SharedPtr<LyricsCache> Application::lyrics_cache() const { return p_->lyrics_cache_.ptr(); }
 SharedPtr<PlaylistBackend> Application::playlist_backend() const { return p_->playlist_backend_.ptr(); }
 SharedPtr<PlaylistManager> Application::playlist_manager() const { return p_->playlist_manager_.ptr(); }
 SharedPtr<StreamingServices> Application::streaming_services() const { return p_->streaming_services_.ptr(); }
@@ -53,6 +53,7 @@ class AlbumCoverLoader;
 class CurrentAlbumCoverLoader;
 class CoverProviders;
 class LyricsProviders;
+class LyricsCache;
 class AudioScrobbler;
 class LastFMImport;
 class StreamingServices;
@@ -90,6 +91,7 @@ class Application : public QObject {
   SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader() const;
 
   SharedPtr<LyricsProviders> lyrics_providers() const;
+  SharedPtr<LyricsCache> lyrics_cache() const;
 
   SharedPtr<AudioScrobbler> scrobbler() const;
 
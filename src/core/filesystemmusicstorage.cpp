@@ -27,6 +27,8 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QString>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "core/logging.h"
 #include "utilities/fileutils.h"
@@ -34,8 +36,18 @@
 
 #include "filesystemmusicstorage.h"
 
+namespace {
+constexpr int kMaxConcurrentCopies = 4;
+}  // namespace
+
 FilesystemMusicStorage::FilesystemMusicStorage(const Song::Source source, const QString &root, const std::optional<int> collection_directory_id) : source_(source), root_(root), collection_directory_id_(collection_directory_id) {}
 
+int FilesystemMusicStorage::MaxConcurrentCopies() const {
+
+  return kMaxConcurrentCopies;
+
+}
+
 bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_text) {
 
   const QFileInfo src = QFileInfo(job.source_);
@@ -75,11 +87,17 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
     }
     else {
       result = QFile::rename(src.absoluteFilePath(), dest.absoluteFilePath());
+      if (!result && !QDir(dest.absolutePath()).exists()) {
+        // A concurrent job removed the directory after moving the last file out of it, create it again.
+        QMutexLocker l(&mutex_dirs_);
+        result = dir.mkpath(dest.absolutePath()) && QFile::rename(src.absoluteFilePath(), dest.absoluteFilePath());
+      }
     }
     if ((!cover_dest.exists() || job.overwrite_) && !cover_src.filePath().isEmpty() && !cover_dest.filePath().isEmpty()) {
       QFile::rename(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
     }
     // Remove empty directories.
+    QMutexLocker l(&mutex_dirs_);
     QDir remove_dir(src.absolutePath(), QString(), QDir::Name, QDir::NoDotAndDotDot);
     while (remove_dir.isEmpty()) {
       if (!QDir().rmdir(remove_dir.absolutePath())) break;
@@ -93,14 +111,14 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
       qLog(Error) << error_text;
     }
     else {
-      result = QFile::copy(src.absoluteFilePath(), dest.absoluteFilePath());
+      result = Utilities::CopyLocalFile(src.absoluteFilePath(), dest.absoluteFilePath());
       if (!result) {
         error_text = QObject::tr("Could not copy file %1 to %2.").arg(src.absoluteFilePath(), dest.absoluteFilePath());
         qLog(Error) << error_text;
       }
     }
     if ((!cover_dest.exists() || job.overwrite_) && !cover_src.filePath().isEmpty() && !cover_dest.filePath().isEmpty()) {
-      QFile::copy(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
+      Utilities::CopyLocalFile(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
     }
   }
 
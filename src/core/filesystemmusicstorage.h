@@ -27,6 +27,7 @@
 #include <optional>
 
 #include <QString>
+#include <QMutex>
 
 #include "song.h"
 #include "musicstorage.h"
@@ -39,6 +40,8 @@ class FilesystemMusicStorage : public virtual MusicStorage {
   QString LocalPath() const override { return root_; }
   std::optional<int> collection_directory_id() const override { return collection_directory_id_; }
 
+  int MaxConcurrentCopies() const override;
+
   bool CopyToStorage(const CopyJob &job, QString &error_text) override;
   bool DeleteFromStorage(const DeleteJob &job) override;
 
@@ -46,6 +49,7 @@ class FilesystemMusicStorage : public virtual MusicStorage {
   Song::Source source_;
   QString root_;
   std::optional<int> collection_directory_id_;
+  QMutex mutex_dirs_;
 
   Q_DISABLE_COPY(FilesystemMusicStorage)
 };
@@ -48,6 +48,7 @@
 #include "engine/enginebase.h"
 #include "engine/gstenginepipeline.h"
 #include "collection/collectiondirectory.h"
+#include "collection/collectionplaystatistics.h"
 #include "playlist/playlistitem.h"
 #include "playlist/playlistsequence.h"
 #include "covermanager/albumcoverloaderresult.h"
@@ -97,6 +98,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<QItemSelection>("QItemSelection");
   qRegisterMetaType<QMap<int, Qt::Alignment>>("ColumnAlignmentMap");
   qRegisterMetaType<QMap<int, int>>("ColumnAlignmentIntMap");
+  qRegisterMetaType<QMap<QString, qint64>>("QMap<QString, qint64>");
   qRegisterMetaType<Song>("Song");
   qRegisterMetaType<SongList>("SongList");
   qRegisterMetaType<SongMap>("SongMap");
@@ -115,6 +117,8 @@ void RegisterMetaTypes() {
   qRegisterMetaType<CollectionDirectoryList>("CollectionDirectoryList");
   qRegisterMetaType<CollectionSubdirectory>("CollectionSubdirectory");
   qRegisterMetaType<CollectionSubdirectoryList>("CollectionSubdirectoryList");
+  qRegisterMetaType<CollectionLastPlayedList>("CollectionLastPlayedList");
+  qRegisterMetaType<CollectionPlayCountList>("CollectionPlayCountList");
   qRegisterMetaType<CollectionModel::Grouping>("CollectionModel::Grouping");
   qRegisterMetaType<PlaylistItemPtr>("PlaylistItemPtr");
   qRegisterMetaType<PlaylistItemPtrList>("PlaylistItemPtrList");
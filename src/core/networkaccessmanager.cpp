@@ -21,26 +21,59 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <utility>
+
 #include <QtGlobal>
 #include <QCoreApplication>
 #include <QIODevice>
+#include <QList>
+#include <QMap>
+#include <QHash>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
+#include <QMutex>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 
 #include "networkaccessmanager.h"
+#include "networkcoalescedreply.h"
 #include "threadsafenetworkdiskcache.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Keep idle connections open longer than Qt does by default, so they are reused between searches and cover loads.
+constexpr int kConnectionCacheExpirySeconds = 300;
+}  // namespace
+
+QMutex NetworkAccessManager::sStatisticsMutex;
+QMap<QString, NetworkAccessManager::HostStatistics> NetworkAccessManager::sStatistics;
+
 NetworkAccessManager::NetworkAccessManager(QObject *parent)
     : QNetworkAccessManager(parent) {
 
   setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
   setCache(new ThreadSafeNetworkDiskCache(this));
 
+  clock_.start();
+
+}
+
+NetworkAccessManager::~NetworkAccessManager() {
+
+  // Replies are deleted by QNetworkAccessManager after our members, they should not call back into us.
+  for (QNetworkReply *reply : std::as_const(pending_replies_)) {
+    QObject::disconnect(reply, nullptr, this, nullptr);
+  }
+  for (const QList<NetworkCoalescedReply*> &replies : std::as_const(coalesced_replies_)) {
+    for (NetworkCoalescedReply *reply : replies) {
+      QObject::disconnect(reply, nullptr, this, nullptr);
+    }
+  }
+
 }
 
 QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) {
@@ -66,6 +99,142 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     new_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
   }
 
-  return QNetworkAccessManager::createRequest(op, new_request, outgoingData);
+  // Multiplex requests to the same host over one HTTP/2 connection where the server supports it, unless the caller decided otherwise.
+  if (!new_request.attribute(QNetworkRequest::Http2AllowedAttribute).isValid()) {
+    new_request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+  }
+  if (!new_request.attribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute).isValid()) {
+    new_request.setAttribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute, kConnectionCacheExpirySeconds);
+  }
+
+  if (op != QNetworkAccessManager::GetOperation || outgoingData) {
+    QNetworkReply *reply = QNetworkAccessManager::createRequest(op, new_request, outgoingData);
+    const qint64 started = clock_.elapsed();
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, started]() { RequestFinished(QByteArray(), reply, started); });
+    return reply;
+  }
+
+  // The same GET request is already in flight, the reply is finished with its result.
+  const QByteArray key = RequestKey(new_request);
+  if (pending_replies_.contains(key)) {
+    NetworkCoalescedReply *reply = new NetworkCoalescedReply(op, new_request, this);
+    coalesced_replies_[key] << reply;
+    QObject::connect(reply, &NetworkCoalescedReply::Aborted, this, [this, key, reply]() { RemoveCoalescedReply(key, reply); });
+    QObject::connect(reply, &QObject::destroyed, this, [this, key, reply]() { RemoveCoalescedReply(key, reply); });
+    QMutexLocker l(&sStatisticsMutex);
+    ++sStatistics[new_request.url().host()].coalesced;
+    return reply;
+  }
+
+  return SendRequest(key, new_request);
+
+}
+
+QByteArray NetworkAccessManager::RequestKey(const QNetworkRequest &request) {
+
+  QByteArray key = request.url().toEncoded();
+
+  QList<QByteArray> headers = request.rawHeaderList();
+  std::sort(headers.begin(), headers.end());
+  for (const QByteArray &header : std::as_const(headers)) {
+    key += '\n' + header + ':' + request.rawHeader(header);
+  }
+  key += '\n' + QByteArray::number(request.attribute(QNetworkRequest::CacheLoadControlAttribute).toInt());
+
+  return key;
+
+}
+
+QNetworkReply *NetworkAccessManager::SendRequest(const QByteArray &key, const QNetworkRequest &request) {
+
+  QNetworkReply *reply = QNetworkAccessManager::createRequest(QNetworkAccessManager::GetOperation, request, nullptr);
+  pending_replies_.insert(key, reply);
+
+  const qint64 started = clock_.elapsed();
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, key, reply, started]() { RequestFinished(key, reply, started); });
+  QObject::connect(reply, &QObject::destroyed, this, [this, key, reply]() {
+    // Deleted by its caller before it was finished.
+    if (pending_replies_.value(key) == reply) {
+      pending_replies_.remove(key);
+      ResendRequest(key);
+    }
+  });
+
+  return reply;
+
+}
+
+void NetworkAccessManager::ResendRequest(const QByteArray &key) {
+
+  if (!coalesced_replies_.contains(key) || coalesced_replies_.value(key).isEmpty()) return;
+
+  // Nobody else reads this reply, it only finishes the coalesced replies.
+  QNetworkReply *reply = SendRequest(key, coalesced_replies_.value(key).first()->request());
+  QObject::connect(reply, &QNetworkReply::finished, reply, &QNetworkReply::deleteLater);
+
+}
+
+void NetworkAccessManager::RequestFinished(const QByteArray &key, QNetworkReply *reply, const qint64 started) {
+
+  {
+    QMutexLocker l(&sStatisticsMutex);
+    HostStatistics &statistics = sStatistics[reply->url().host()];
+    ++statistics.requests;
+    if (reply->error() != QNetworkReply::NoError) ++statistics.errors;
+    if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) ++statistics.http2;
+    statistics.bytes += reply->bytesAvailable();
+    statistics.latency += clock_.elapsed() - started;
+  }
+
+  if (key.isEmpty() || pending_replies_.value(key) != reply) return;
+  pending_replies_.remove(key);
+
+  if (!coalesced_replies_.contains(key)) return;
+
+  // The caller aborted its own request, send it again for the others.
+  if (reply->error() == QNetworkReply::OperationCanceledError) {
+    ResendRequest(key);
+    return;
+  }
+
+  const QList<NetworkCoalescedReply*> replies = coalesced_replies_.take(key);
+  const QByteArray data = reply->peek(reply->bytesAvailable());
+  for (NetworkCoalescedReply *coalesced_reply : replies) {
+    QObject::disconnect(coalesced_reply, nullptr, this, nullptr);
+    coalesced_reply->Finish(reply, data);
+  }
+
+}
+
+void NetworkAccessManager::RemoveCoalescedReply(const QByteArray &key, NetworkCoalescedReply *reply) {
+
+  if (!coalesced_replies_.contains(key)) return;
+
+  QList<NetworkCoalescedReply*> &replies = coalesced_replies_[key];
+  replies.removeAll(reply);
+  if (replies.isEmpty()) {
+    coalesced_replies_.remove(key);
+  }
+
+}
+
+QString NetworkAccessManager::Statistics() {
+
+  QMutexLocker l(&sStatisticsMutex);
+
+  QStringList lines;
+  for (QMap<QString, HostStatistics>::const_iterator it = sStatistics.constBegin(); it != sStatistics.constEnd(); ++it) {
+    const HostStatistics &statistics = it.value();
+    lines << QStringLiteral("%1: %2 requests, %3 coalesced, %4 errors, %5 over HTTP/2, %6 KiB received, average latency %7 ms")
+             .arg(it.key().isEmpty() ? u"(local)"_s : it.key())
+             .arg(statistics.requests)
+             .arg(statistics.coalesced)
+             .arg(statistics.errors)
+             .arg(statistics.http2)
+             .arg(statistics.bytes / 1024)
+             .arg(statistics.requests > 0 ? statistics.latency / statistics.requests : 0);
+  }
+
+  return lines.join(u'\n');
 
 }
@@ -24,21 +24,61 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QObject>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QElapsedTimer>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 
 class QIODevice;
 class QNetworkReply;
+class NetworkCoalescedReply;
 
 class NetworkAccessManager : public QNetworkAccessManager {
   Q_OBJECT
 
  public:
   explicit NetworkAccessManager(QObject *parent = nullptr);
+  ~NetworkAccessManager() override;
+
+  // Requests, bytes and latency per host for all network access managers.
+  static QString Statistics();
 
  protected:
   QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override;
+
+ private:
+  class HostStatistics {
+   public:
+    HostStatistics() : requests(0), coalesced(0), errors(0), http2(0), bytes(0), latency(0) {}
+    qint64 requests;
+    qint64 coalesced;
+    qint64 errors;
+    qint64 http2;
+    qint64 bytes;
+    qint64 latency;
+  };
+
+  static QByteArray RequestKey(const QNetworkRequest &request);
+  QNetworkReply *SendRequest(const QByteArray &key, const QNetworkRequest &request);
+  void ResendRequest(const QByteArray &key);
+  void RequestFinished(const QByteArray &key, QNetworkReply *reply, const qint64 started);
+  void RemoveCoalescedReply(const QByteArray &key, NetworkCoalescedReply *reply);
+
+ private:
+  static QMutex sStatisticsMutex;
+  static QMap<QString, HostStatistics> sStatistics;
+
+  QElapsedTimer clock_;
+  // GET requests in flight, and the replies for identical requests waiting for them.
+  QHash<QByteArray, QNetworkReply*> pending_replies_;
+  QHash<QByteArray, QList<NetworkCoalescedReply*>> coalesced_replies_;
 };
 
 #endif  // NETWORKACCESSMANAGER_H
@@ -0,0 +1,118 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QIODevice>
+#include <QList>
+#include <QByteArray>
+#include <QVariant>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "networkcoalescedreply.h"
+
+namespace {
+const QList<QNetworkRequest::Attribute> kCopiedAttributes = QList<QNetworkRequest::Attribute>() << QNetworkRequest::HttpStatusCodeAttribute
+                                                                                                 << QNetworkRequest::HttpReasonPhraseAttribute
+                                                                                                 << QNetworkRequest::RedirectionTargetAttribute
+                                                                                                 << QNetworkRequest::SourceIsFromCacheAttribute
+                                                                                                 << QNetworkRequest::Http2WasUsedAttribute;
+}  // namespace
+
+NetworkCoalescedReply::NetworkCoalescedReply(const QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent)
+    : QNetworkReply(parent),
+      offset_(0) {
+
+  setOperation(operation);
+  setRequest(request);
+  setUrl(request.url());
+  open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+}
+
+void NetworkCoalescedReply::Finish(QNetworkReply *reply, const QByteArray &data) {
+
+  if (isFinished()) return;
+
+  setUrl(reply->url());
+  for (const QNetworkRequest::Attribute attribute : kCopiedAttributes) {
+    const QVariant value = reply->attribute(attribute);
+    if (value.isValid()) {
+      setAttribute(attribute, value);
+    }
+  }
+  const QList<QNetworkReply::RawHeaderPair> header_pairs = reply->rawHeaderPairs();
+  for (const QNetworkReply::RawHeaderPair &header_pair : header_pairs) {
+    setRawHeader(header_pair.first, header_pair.second);
+  }
+  data_ = data;
+
+  Q_EMIT metaDataChanged();
+
+  if (reply->error() != QNetworkReply::NoError) {
+    setError(reply->error(), reply->errorString());
+    Q_EMIT errorOccurred(reply->error());
+  }
+
+  setFinished(true);
+  if (!data_.isEmpty()) {
+    Q_EMIT readyRead();
+  }
+  Q_EMIT finished();
+
+}
+
+void NetworkCoalescedReply::abort() {
+
+  if (isFinished()) return;
+
+  setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+  setFinished(true);
+
+  Q_EMIT Aborted();
+  Q_EMIT errorOccurred(QNetworkReply::OperationCanceledError);
+  Q_EMIT finished();
+
+}
+
+qint64 NetworkCoalescedReply::bytesAvailable() const {
+
+  return (data_.size() - offset_) + QNetworkReply::bytesAvailable();
+
+}
+
+qint64 NetworkCoalescedReply::readData(char *data, const qint64 maxlen) {
+
+  if (offset_ >= data_.size()) {
+    return isFinished() ? -1 : 0;
+  }
+
+  const qint64 count = std::min(maxlen, data_.size() - offset_);
+  std::copy(data_.constData() + offset_, data_.constData() + offset_ + count, data);
+  offset_ += count;
+
+  return count;
+
+}
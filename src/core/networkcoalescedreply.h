@@ -0,0 +1,57 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NETWORKCOALESCEDREPLY_H
+#define NETWORKCOALESCEDREPLY_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+// Reply for a GET request that was identical to one already in flight.
+// No request is sent for it, it is finished with a copy of the status, headers and data of the reply that was sent.
+class NetworkCoalescedReply : public QNetworkReply {
+  Q_OBJECT
+
+ public:
+  explicit NetworkCoalescedReply(const QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent = nullptr);
+
+  void Finish(QNetworkReply *reply, const QByteArray &data);
+
+  void abort() override;
+  qint64 bytesAvailable() const override;
+  bool isSequential() const override { return true; }
+
+ Q_SIGNALS:
+  void Aborted();
+
+ protected:
+  qint64 readData(char *data, const qint64 maxlen) override;
+
+ private:
+  QByteArray data_;
+  qint64 offset_;
+};
+
+#endif  // NETWORKCOALESCEDREPLY_H
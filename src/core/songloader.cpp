@@ -22,10 +22,12 @@
 #include "config.h"
 
 #include <algorithm>
+#include <utility>
 
 #include <gst/gst.h>
 
 #include <QObject>
+#include <QtConcurrentMap>
 #include <QIODevice>
 #include <QBuffer>
 #include <QByteArray>
@@ -33,6 +35,8 @@
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QList>
+#include <QHash>
 #include <QSet>
 #include <QTimer>
 #include <QString>
@@ -313,10 +317,47 @@ SongLoader::Result SongLoader::LoadLocalAsync(const QString &filename) {
 
 void SongLoader::LoadMetadataBlocking() {
 
-  for (int i = 0; i < songs_.size(); i++) {
-    EffectiveSongLoad(&songs_[i]);
+  LoadMetadataBlocking(collection_backend_, tagreader_client_, songs_);
+
+}
+
+void SongLoader::LoadMetadataBlocking(const SharedPtr<CollectionBackendInterface> collection_backend, const SharedPtr<TagReaderClient> tagreader_client, SongList &songs) {
+
+  QList<Song*> pending_songs;
+  QList<QUrl> urls;
+  for (Song &song : songs) {
+    if (!song.url().isLocalFile()) continue;
+    // Maybe we loaded the metadata already, for example from a cuesheet.
+    if (song.init_from_file() && song.filetype() != Song::FileType::Unknown) continue;
+    pending_songs << &song;
+    urls << song.url();
+  }
+
+  if (pending_songs.isEmpty()) return;
+
+  // First, get the songs from the collection
+  const QHash<QUrl, SongList> collection_songs = collection_backend->GetSongsByUrls(urls);
+
+  QList<Song*> read_songs;
+  for (Song *song : std::as_const(pending_songs)) {
+    const SongList sections = collection_songs.value(song->url());
+    const SongList::const_iterator it = std::find_if(sections.begin(), sections.end(), [](const Song &section) { return section.beginning_nanosec() == 0; });
+    if (it != sections.end()) {
+      *song = *it;
+    }
+    else {
+      read_songs << song;
+    }
   }
 
+  // The rest are normal media files
+  QtConcurrent::blockingMap(read_songs, [tagreader_client](Song *song) {
+    const TagReaderResult result = tagreader_client->ReadFileBlocking(song->url().toLocalFile(), song);
+    if (!result.success()) {
+      qLog(Error) << "Could not read file" << song->url() << result.error_string();
+    }
+  });
+
 }
 
 void SongLoader::EffectiveSongLoad(Song *song) {
@@ -348,7 +389,11 @@ void SongLoader::LoadPlaylist(ParserBase *parser, const QString &filename) {
 
   QFile file(filename);
   if (file.open(QIODevice::ReadOnly)) {
-    songs_ = parser->Load(&file, filename, QFileInfo(filename).path());
+    songs_.clear();
+    parser->LoadFile(&file, true, [this](const SongList &songs) {
+      songs_ << songs;
+      return true;
+    });
     file.close();
   }
   else {
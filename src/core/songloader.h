@@ -84,6 +84,9 @@ class SongLoader : public QObject {
   // Completely load songs previously loaded with LoadFilenamesBlocking().
   // When finished, the Song objects in songs() contain metadata now. This method is blocking, do not call it from the UI thread.
   void LoadMetadataBlocking();
+  // Completely load the given songs. Songs in the collection are resolved with one lookup, the tags of the other files are read in parallel.
+  // This method is blocking, do not call it from the UI thread.
+  static void LoadMetadataBlocking(const SharedPtr<CollectionBackendInterface> collection_backend, const SharedPtr<TagReaderClient> tagreader_client, SongList &songs);
   Result LoadAudioCD();
 
   QStringList errors() { return errors_; }
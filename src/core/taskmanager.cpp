@@ -57,6 +57,19 @@ int TaskManager::StartTask(const QString &name) {
 
 }
 
+void TaskManager::SetTaskName(const int id, const QString &name) {
+
+  {
+    QMutexLocker l(&mutex_);
+    if (!tasks_.contains(id)) return;
+
+    tasks_[id].name = name;
+  }
+
+  Q_EMIT TasksChanged();
+
+}
+
 QList<TaskManager::Task> TaskManager::GetTasks() {
 
   QList<TaskManager::Task> ret;
@@ -63,6 +63,7 @@ class TaskManager : public QObject {
   QList<Task> GetTasks();
 
   int StartTask(const QString &name);
+  void SetTaskName(const int id, const QString &name);
   void SetTaskBlocksCollectionScans(const int id);
   void SetTaskProgress(const int id, const quint64 progress, const quint64 max = 0);
   void IncreaseTaskProgress(const int id, const quint64 progress, const quint64 max = 0);
@@ -67,6 +67,7 @@
 #include "core/iconloader.h"
 #include "core/settings.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/embeddedcovercache.h"
 #include "collection/collectionfilteroptions.h"
 #include "collection/collectionbackend.h"
 #include "streaming/streamingservices.h"
@@ -452,7 +453,7 @@ void AlbumCoverChoiceController::ShowCover(const Song &song, const QImage &image
       case AlbumCoverLoaderOptions::Type::Embedded:{
         if (song.art_embedded() && !song.url().isEmpty() && song.url().isValid() && song.url().isLocalFile()) {
           QImage image_embedded_cover;
-          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song.url().toLocalFile(), image_embedded_cover);
+          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song.url().toLocalFile(), image_embedded_cover, EmbeddedCoverCache::AlbumKey(song));
           if (result.success() && !image_embedded_cover.isNull()) {
             QPixmap pixmap = QPixmap::fromImage(image_embedded_cover);
             if (!pixmap.isNull()) {
@@ -77,6 +77,7 @@
 #include "widgets/forcescrollperpixel.h"
 #include "widgets/searchfield.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/embeddedcovercache.h"
 #include "collection/collectionbackend.h"
 #include "collection/collectionquery.h"
 #include "albumcovermanager.h"
@@ -767,7 +768,7 @@ void AlbumCoverManager::SaveCoverToFile() {
         return;
       case AlbumCoverLoaderOptions::Type::Embedded:
         if (song.art_embedded()) {
-          const TagReaderResult tagreaderclient_result = tagreader_client_->LoadCoverDataBlocking(song.url().toLocalFile(), result.image_data);
+          const TagReaderResult tagreaderclient_result = tagreader_client_->LoadCoverDataBlocking(song.url().toLocalFile(), result.image_data, EmbeddedCoverCache::AlbumKey(song));
           if (!tagreaderclient_result.success()) {
             qLog(Error) << "Could not load embedded art from" << song.url() << tagreaderclient_result.error_string();
           }
@@ -30,6 +30,7 @@
 
 #include "core/song.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/embeddedcovercache.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverexport.h"
 #include "coverexportrunnable.h"
@@ -79,7 +80,7 @@ void CoverExportRunnable::ProcessAndExportCover() {
         break;
       case AlbumCoverLoaderOptions::Type::Embedded:
         if (song_.art_embedded() && dialog_result_.export_embedded_) {
-          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song_.url().toLocalFile(), image);
+          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song_.url().toLocalFile(), image, EmbeddedCoverCache::AlbumKey(song_));
           if (result.success() && !image.isNull()) {
             extension = "jpg"_L1;
           }
@@ -171,7 +172,7 @@ void CoverExportRunnable::ExportCover() {
         break;
       case AlbumCoverLoaderOptions::Type::Embedded:
         if (song_.art_embedded() && dialog_result_.export_embedded_) {
-          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song_.url().toLocalFile(), image);
+          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song_.url().toLocalFile(), image, EmbeddedCoverCache::AlbumKey(song_));
           if (result.success() && !image.isNull()) {
             embedded_cover = true;
             extension = "jpg"_L1;
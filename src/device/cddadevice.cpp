@@ -21,11 +21,17 @@
 
 #include "config.h"
 
+#include <utility>
+
 #include <QString>
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
+#include "core/taskmanager.h"
 #include "collection/collectionmodel.h"
+#include "organize/organizeformat.h"
+#include "transcoder/transcoder.h"
+#include "ripper/ripper.h"
 #include "cddasongloader.h"
 #include "connecteddevice.h"
 #include "cddadevice.h"
@@ -45,11 +51,20 @@ CddaDevice::CddaDevice(const QUrl &url,
                        const bool first_time,
                        QObject *parent)
     : ConnectedDevice(url, lister, unique_id, device_manager, task_manager, database, tagreader_client, albumcover_loader, database_id, first_time, parent),
-      cdda_song_loader_(url) {
+      task_manager_(task_manager),
+      cdda_song_loader_(url),
+      ripper_(new Ripper(tagreader_client, this)),
+      rip_task_id_(-1) {
+
+  ripper_->set_device(url.path());
 
   QObject::connect(&cdda_song_loader_, &CddaSongLoader::SongsLoaded, this, &CddaDevice::SongsLoaded);
   QObject::connect(&cdda_song_loader_, &CddaSongLoader::SongsDurationLoaded, this, &CddaDevice::SongsLoaded);
   QObject::connect(&cdda_song_loader_, &CddaSongLoader::SongsMetadataLoaded, this, &CddaDevice::SongsLoaded);
+  QObject::connect(&cdda_song_loader_, &CddaSongLoader::SongsMetadataLoaded, ripper_, &Ripper::SetTracksMetadata);
+  QObject::connect(ripper_, &Ripper::Progress, this, &CddaDevice::RipProgress);
+  QObject::connect(ripper_, &Ripper::Finished, this, &CddaDevice::RipFinished);
+  QObject::connect(ripper_, &Ripper::Cancelled, this, &CddaDevice::RipFinished);
   QObject::connect(this, &CddaDevice::SongsDiscovered, collection_model_, &CollectionModel::AddReAddOrUpdate);
 
 }
@@ -57,6 +72,10 @@ CddaDevice::CddaDevice(const QUrl &url,
 bool CddaDevice::Init() {
 
   song_count_ = 0;  // Reset song count, in case it was already set
+  // A different disc might be loaded, the tracks of the previous one can't be ripped anymore.
+  if (ripper_->running()) ripper_->Cancel();
+  ripper_->ClearTracks();
+  songs_.clear();
   cdda_song_loader_.LoadSongs();
   return true;
 
@@ -73,8 +92,45 @@ void CddaDevice::Refresh() {
 
 void CddaDevice::SongsLoaded(const SongList &songs) {
 
+  songs_ = songs;
   collection_model_->Reset();
   Q_EMIT SongsDiscovered(songs);
   song_count_ = songs.size();
 
 }
+
+bool CddaDevice::Rip(const QString &destination, const OrganizeFormat &format, const TranscoderPreset &preset) {
+
+  if (ripper_->running() || songs_.isEmpty() || destination.isEmpty() || !format.IsValid()) return false;
+
+  ripper_->ClearTracks();
+  for (const Song &song : std::as_const(songs_)) {
+    const OrganizeFormat::GetFilenameForSongResult result = format.GetFilenameForSong(song, preset.extension_);
+    if (result.filename.isEmpty()) continue;
+    ripper_->AddTrack(song, destination + u'/' + result.filename, preset);
+  }
+  if (ripper_->TracksCount() == 0) return false;
+
+  rip_task_id_ = task_manager_->StartTask(tr("Ripping audio CD"));
+  ripper_->Start();
+
+  return true;
+
+}
+
+void CddaDevice::RipProgress(const int percent) {
+
+  if (rip_task_id_ != -1) {
+    task_manager_->SetTaskProgress(rip_task_id_, percent, 100);
+  }
+
+}
+
+void CddaDevice::RipFinished() {
+
+  if (rip_task_id_ != -1) {
+    task_manager_->SetTaskFinished(rip_task_id_);
+    rip_task_id_ = -1;
+  }
+
+}
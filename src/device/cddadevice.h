@@ -44,6 +44,9 @@ class TaskManager;
 class Database;
 class TagReaderClient;
 class AlbumCoverLoader;
+class OrganizeFormat;
+class Ripper;
+struct TranscoderPreset;
 
 class CddaDevice : public ConnectedDevice {
   Q_OBJECT
@@ -68,14 +71,26 @@ class CddaDevice : public ConnectedDevice {
 
   static QStringList url_schemes() { return QStringList() << QStringLiteral("cdda"); }
 
+  // Rips the tracks of this disc, tags from a MusicBrainz lookup that finishes while ripping are passed on to it.
+  Ripper *ripper() const { return ripper_; }
+
+  // Rips all tracks into the directory, named by the format. Returns false if there is nothing to rip or a rip is running.
+  bool Rip(const QString &destination, const OrganizeFormat &format, const TranscoderPreset &preset);
+
  Q_SIGNALS:
   void SongsDiscovered(const SongList &songs);
 
  private Q_SLOTS:
   void SongsLoaded(const SongList &songs);
+  void RipProgress(const int percent);
+  void RipFinished();
 
  private:
+  const SharedPtr<TaskManager> task_manager_;
   CddaSongLoader cdda_song_loader_;
+  Ripper *ripper_;
+  SongList songs_;
+  int rip_task_id_;
 };
 
 #endif  // CDDADEVICE_H
@@ -46,6 +46,7 @@
 #include <QFlags>
 #include <QPushButton>
 #include <QMessageBox>
+#include <QInputDialog>
 #include <QtEvents>
 
 #include "includes/shared_ptr.h"
@@ -58,6 +59,7 @@
 #include "utilities/colorutils.h"
 #include "organize/organizedialog.h"
 #include "organize/organizeerrordialog.h"
+#include "transcoder/transcoder.h"
 #include "collection/collectiondirectorymodel.h"
 #include "collection/collectionmodel.h"
 #include "collection/collectionitemdelegate.h"
@@ -66,6 +68,9 @@
 #include "devicemanager.h"
 #include "deviceproperties.h"
 #include "deviceview.h"
+#ifdef HAVE_AUDIOCD
+#  include "cddadevice.h"
+#endif
 
 using namespace Qt::Literals::StringLiterals;
 using std::make_unique;
@@ -175,6 +180,7 @@ void DeviceItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &op
 
 DeviceView::DeviceView(QWidget *parent)
     : AutoExpandingTreeView(parent),
+      collection_directory_model_(nullptr),
       merged_model_(nullptr),
       sort_model_(nullptr),
       properties_dialog_(new DeviceProperties),
@@ -182,6 +188,7 @@ DeviceView::DeviceView(QWidget *parent)
       eject_action_(nullptr),
       forget_action_(nullptr),
       properties_action_(nullptr),
+      rip_action_(nullptr),
       collection_menu_(nullptr),
       load_action_(nullptr),
       add_to_playlist_action_(nullptr),
@@ -209,6 +216,7 @@ void DeviceView::Init(const SharedPtr<TaskManager> task_manager,
   task_manager_ = task_manager;
   tagreader_client_ = tagreader_client;
   device_manager_ = device_manager;
+  collection_directory_model_ = collection_directory_model;
 
   QObject::connect(&*device_manager_, &DeviceManager::DeviceConnected, this, &DeviceView::DeviceConnected);
   QObject::connect(&*device_manager_, &DeviceManager::DeviceDisconnected, this, &DeviceView::DeviceDisconnected);
@@ -243,6 +251,7 @@ void DeviceView::contextMenuEvent(QContextMenuEvent *e) {
     forget_action_ = device_menu_->addAction(IconLoader::Load(u"list-remove"_s), tr("Forget device"), this, &DeviceView::Forget);
     device_menu_->addSeparator();
     properties_action_ = device_menu_->addAction(IconLoader::Load(u"configure"_s), tr("Device properties..."), this, &DeviceView::Properties);
+    rip_action_ = device_menu_->addAction(IconLoader::Load(u"media-optical"_s), tr("Rip to collection..."), this, &DeviceView::Rip);
 
     // Collection menu
     add_to_playlist_action_ = collection_menu_->addAction(IconLoader::Load(u"media-playback-start"_s), tr("Append to current playlist"), this, &DeviceView::AddToPlaylist);
@@ -266,6 +275,12 @@ void DeviceView::contextMenuEvent(QContextMenuEvent *e) {
     forget_action_->setEnabled(is_remembered);
     eject_action_->setEnabled(is_plugged_in);
 
+    bool is_cdda_device = false;
+#ifdef HAVE_AUDIOCD
+    is_cdda_device = std::dynamic_pointer_cast<CddaDevice>(device_manager_->GetConnectedDevice(device_index)) != nullptr;
+#endif
+    rip_action_->setVisible(is_cdda_device);
+
     device_menu_->popup(e->globalPos());
   }
   else if (collection_index.isValid()) {
@@ -360,6 +375,33 @@ void DeviceView::Forget() {
 
 }
 
+void DeviceView::Rip() {
+
+#ifdef HAVE_AUDIOCD
+  SharedPtr<CddaDevice> device = std::dynamic_pointer_cast<CddaDevice>(device_manager_->GetConnectedDevice(MapToDevice(menu_index_)));
+  if (!device) return;
+
+  const QStringList paths = collection_directory_model_->paths();
+  if (paths.isEmpty()) {
+    QMessageBox::warning(this, tr("Rip to collection"), tr("There are no collection directories to rip into, add one in the collection settings."));
+    return;
+  }
+
+  QString destination = paths.first();
+  if (paths.count() > 1) {
+    bool ok = false;
+    destination = QInputDialog::getItem(this, tr("Rip to collection"), tr("Collection directory:"), paths, 0, false, &ok);
+    if (!ok) return;
+  }
+
+  // Name the files like copying to the collection does.
+  if (!device->Rip(destination, OrganizeDialog::SavedFormat(), Transcoder::PresetForFileType(Song::FileType::FLAC))) {
+    QMessageBox::warning(this, tr("Rip to collection"), tr("The disc is already being ripped, or its tracks are not loaded yet."));
+  }
+#endif
+
+}
+
 void DeviceView::Properties() {
   properties_dialog_->ShowDevice(MapToDevice(menu_index_));
 }
@@ -89,6 +89,7 @@ class DeviceView : public AutoExpandingTreeView {
   void Unmount();
   void Forget();
   void Properties();
+  void Rip();
 
   // Collection menu actions
   void Load();
@@ -112,6 +113,7 @@ class DeviceView : public AutoExpandingTreeView {
   SharedPtr<TaskManager> task_manager_;
   SharedPtr<TagReaderClient> tagreader_client_;
   SharedPtr<DeviceManager> device_manager_;
+  CollectionDirectoryModel *collection_directory_model_;
   MergedProxyModel *merged_model_;
   QSortFilterProxyModel *sort_model_;
 
@@ -122,6 +124,7 @@ class DeviceView : public AutoExpandingTreeView {
   QAction *eject_action_;
   QAction *forget_action_;
   QAction *properties_action_;
+  QAction *rip_action_;
 
   QMenu *collection_menu_;
   QAction *load_action_;
@@ -36,6 +36,7 @@
 #include "collection/collectionwatcher.h"
 
 #include "covermanager/albumcoverloader.h"
+#include "utilities/fileutils.h"
 
 #include "connecteddevice.h"
 #include "devicemanager.h"
@@ -43,6 +44,10 @@
 
 class DeviceLister;
 
+namespace {
+constexpr int kMaxRemovableCopies = 2;
+}  // namespace
+
 FilesystemDevice::FilesystemDevice(const QUrl &url,
                                    DeviceLister *lister,
                                    const QString &unique_id,
@@ -90,6 +95,16 @@ FilesystemDevice::~FilesystemDevice() {
 
 }
 
+int FilesystemDevice::MaxConcurrentCopies() const {
+
+  if (Utilities::IsRemovableFilesystem(url_.toLocalFile())) {
+    return kMaxRemovableCopies;
+  }
+
+  return FilesystemMusicStorage::MaxConcurrentCopies();
+
+}
+
 bool FilesystemDevice::Init() {
 
   InitBackendDirectory(url_.toLocalFile(), first_time_);
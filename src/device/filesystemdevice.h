@@ -63,6 +63,8 @@ class FilesystemDevice : public ConnectedDevice, public virtual FilesystemMusicS
 
   Song::Source source() const final { return Song::Source::Device; }
 
+  int MaxConcurrentCopies() const override;
+
   bool Init() override;
   void CloseAsync();
 
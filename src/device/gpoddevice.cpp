@@ -33,6 +33,8 @@
 #include <QDir>
 #include <QFile>
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QUrl>
 #include <QImage>
@@ -56,6 +58,12 @@ class DeviceManager;
 using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Write the database every this many copied tracks, so tracks copied before an interrupted session are kept.
+constexpr int kCheckpointTracks = 500;
+constexpr char kDatabaseBackupSuffix[] = ".strawberry-backup";
+}  // namespace
+
 GPodDevice::GPodDevice(const QUrl &url,
                        DeviceLister *lister,
                        const QString &unique_id,
@@ -72,7 +80,8 @@ GPodDevice::GPodDevice(const QUrl &url,
       loader_(nullptr),
       loader_thread_(nullptr),
       db_(nullptr),
-      closing_(false) {}
+      closing_(false),
+      tracks_since_checkpoint_(0) {}
 
 bool GPodDevice::Init() {
 
@@ -152,6 +161,28 @@ void GPodDevice::LoaderError(const QString &message) {
   Q_EMIT Error(message);
 }
 
+QString GPodDevice::DatabasePath(const QString &mount_point) {
+
+  const QByteArray mountpoint = QDir::toNativeSeparators(mount_point).toLocal8Bit();
+  gchar *path = itdb_get_itunesdb_path(mountpoint.constData());
+  if (!path) return QString();
+
+  const QString ret = QString::fromLocal8Bit(path);
+  g_free(path);
+
+  return ret;
+
+}
+
+QString GPodDevice::DatabaseBackupPath(const QString &mount_point) {
+
+  const QString path = DatabasePath(mount_point);
+  if (path.isEmpty()) return QString();
+
+  return path + QLatin1String(kDatabaseBackupSuffix);
+
+}
+
 void GPodDevice::Start() {
 
   {
@@ -283,16 +314,48 @@ bool GPodDevice::CopyToStorage(const CopyJob &job, QString &error_text) {
     QFile::remove(job.source_);
   }
 
+  // Write the database now and then during long sessions, the collection model is still updated when the session finishes.
+  if (++tracks_since_checkpoint_ >= kCheckpointTracks) {
+    QString checkpoint_error_text;
+    if (!WriteDatabase(checkpoint_error_text)) {
+      // The copied track is still in the database in memory, it is written again when the session finishes.
+      qLog(Error) << "Checkpoint failed:" << checkpoint_error_text;
+    }
+  }
+
   return true;
 
 }
 
 bool GPodDevice::WriteDatabase(QString &error_text) {
 
+  RemoveStagedTracks();
+
+  // Keep a copy of the current database until the new one is completely written.
+  const QString database_path = DatabasePath(url_.path());
+  const QString backup_path = DatabaseBackupPath(url_.path());
+  bool backup = false;
+  if (!database_path.isEmpty()) {
+    QFile::remove(backup_path);
+    backup = QFile::copy(database_path, backup_path);
+  }
+
   // Write the itunes database
   GError *error = nullptr;
   const bool success = itdb_write(db_, &error);
   cover_files_.clear();
+  tracks_since_checkpoint_ = 0;
+
+  if (backup) {
+    if (!success) {
+      QFile::remove(database_path);
+      QFile::rename(backup_path, database_path);
+    }
+    else {
+      QFile::remove(backup_path);
+    }
+  }
+
   if (!success) {
     if (error) {
       error_text = tr("Writing database failed: %1").arg(QString::fromUtf8(error->message));
@@ -310,6 +373,9 @@ bool GPodDevice::WriteDatabase(QString &error_text) {
 
 void GPodDevice::Finish(const bool success) {
 
+  // Keep the database in memory in line with the files that were deleted, even if it isn't written.
+  RemoveStagedTracks();
+
   // Update the collection model
   if (success) {
     if (!songs_to_add_.isEmpty()) collection_backend_->AddOrUpdateSongs(songs_to_add_);
@@ -322,6 +388,9 @@ void GPodDevice::Finish(const bool success) {
   songs_to_add_.clear();
   songs_to_remove_.clear();
   cover_files_.clear();
+  tracks_by_path_.clear();
+  tracks_to_remove_.clear();
+  tracks_since_checkpoint_ = 0;
 
   db_busy_.unlock();
 
@@ -337,7 +406,7 @@ bool GPodDevice::FinishCopy(bool success, QString &error_text) {
 
 void GPodDevice::StartDelete() { Start(); }
 
-bool GPodDevice::RemoveTrackFromITunesDb(const QString &path, const QString &relative_to) {
+bool GPodDevice::StageTrackRemoval(const QString &path, const QString &relative_to) {
 
   QString ipod_filename = path;
   if (!relative_to.isEmpty() && path.startsWith(relative_to)) {
@@ -347,34 +416,56 @@ bool GPodDevice::RemoveTrackFromITunesDb(const QString &path, const QString &rel
   ipod_filename.replace(u'/', u':');
 
   // Find the track in the itdb, identify it by its filename
-  Itdb_Track *track = nullptr;
-  for (GList *tracks = db_->tracks; tracks != nullptr; tracks = tracks->next) {
-    Itdb_Track *t = static_cast<Itdb_Track*>(tracks->data);
-
-    if (QString::fromUtf8(t->ipod_path) == ipod_filename) {
-      track = t;
-      break;
+  if (tracks_by_path_.isEmpty()) {
+    for (GList *tracks = db_->tracks; tracks != nullptr; tracks = tracks->next) {
+      Itdb_Track *t = static_cast<Itdb_Track*>(tracks->data);
+      tracks_by_path_.insert(QString::fromUtf8(t->ipod_path), t);
     }
   }
 
+  Itdb_Track *track = tracks_by_path_.take(ipod_filename);
   if (track == nullptr) {
     qLog(Warning) << "Couldn't find song" << path << "in iTunesDB";
     return false;
   }
 
-  // Remove the track from all playlists
+  tracks_to_remove_ << track;
+
+  return true;
+
+}
+
+void GPodDevice::RemoveStagedTracks() {
+
+  if (tracks_to_remove_.isEmpty()) return;
+
+  // Remove the tracks from all playlists
   for (GList *playlists = db_->playlists; playlists != nullptr; playlists = playlists->next) {
     Itdb_Playlist *playlist = static_cast<Itdb_Playlist*>(playlists->data);
-
-    if (itdb_playlist_contains_track(playlist, track)) {
-      itdb_playlist_remove_track(playlist, track);
+    GList *members = playlist->members;
+    while (members != nullptr) {
+      GList *next = members->next;
+      if (tracks_to_remove_.contains(static_cast<Itdb_Track*>(members->data))) {
+        playlist->members = g_list_delete_link(playlist->members, members);
+      }
+      members = next;
     }
+    playlist->num = g_list_length(playlist->members);
   }
 
-  // Remove the track from the database, this frees the struct too
-  itdb_track_remove(track);
+  // Remove the tracks from the database and free them
+  GList *tracks = db_->tracks;
+  while (tracks != nullptr) {
+    GList *next = tracks->next;
+    Itdb_Track *track = static_cast<Itdb_Track*>(tracks->data);
+    if (tracks_to_remove_.contains(track)) {
+      db_->tracks = g_list_delete_link(db_->tracks, tracks);
+      itdb_track_free(track);
+    }
+    tracks = next;
+  }
 
-  return true;
+  tracks_to_remove_.clear();
 
 }
 
@@ -382,7 +473,7 @@ bool GPodDevice::DeleteFromStorage(const DeleteJob &job) {
 
   Q_ASSERT(db_);
 
-  if (!RemoveTrackFromITunesDb(job.metadata_.url().toLocalFile(), url_.path())) {
+  if (!StageTrackRemoval(job.metadata_.url().toLocalFile(), url_.path())) {
     return false;
   }
 
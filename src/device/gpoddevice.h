@@ -30,6 +30,8 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -75,6 +77,10 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
 
   static QStringList url_schemes() { return QStringList() << QStringLiteral("ipod"); }
 
+  // The iTunesDB is copied to the backup path while a new one is written, and restored from it if writing fails.
+  static QString DatabasePath(const QString &mount_point);
+  static QString DatabaseBackupPath(const QString &mount_point);
+
   bool GetSupportedFiletypes(QList<Song::FileType> *ret) override;
 
   bool StartCopy(QList<Song::FileType> *supported_filetypes) override;
@@ -92,7 +98,8 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
  protected:
   Itdb_Track *AddTrackToITunesDb(const Song &metadata);
   void AddTrackToModel(Itdb_Track *track, const QString &prefix);
-  bool RemoveTrackFromITunesDb(const QString &path, const QString &relative_to = QString());
+  bool StageTrackRemoval(const QString &path, const QString &relative_to = QString());
+  void RemoveStagedTracks();
 
  private:
   void Start();
@@ -113,6 +120,12 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
   SongList songs_to_add_;
   SongList songs_to_remove_;
   QList<SharedPtr<TemporaryFile>> cover_files_;
+
+  // Tracks by iPod path, built on the first removal in a session.
+  QHash<QString, Itdb_Track*> tracks_by_path_;
+  // Tracks removed in this session, they are taken out of the playlists and the database in one pass before it's written.
+  QSet<Itdb_Track*> tracks_to_remove_;
+  int tracks_since_checkpoint_;
 };
 
 #endif  // GPODDEVICE_H
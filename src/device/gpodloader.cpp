@@ -26,6 +26,7 @@
 
 #include <QObject>
 #include <QDir>
+#include <QFile>
 #include <QByteArray>
 #include <QString>
 
@@ -34,6 +35,7 @@
 #include "core/song.h"
 #include "core/taskmanager.h"
 #include "collection/collectionbackend.h"
+#include "gpoddevice.h"
 #include "gpodloader.h"
 
 GPodLoader::GPodLoader(const QString &mount_point,
@@ -74,6 +76,21 @@ Itdb_iTunesDB *GPodLoader::TryLoad() {
   GError *error = nullptr;
   Itdb_iTunesDB *db = itdb_parse(mountpoint.constData(), &error);
 
+  // The last write was interrupted if the backup is still there, go back to it when the written database can't be read.
+  const QString backup_path = GPodDevice::DatabaseBackupPath(mount_point_);
+  if (!db && !backup_path.isEmpty() && QFile::exists(backup_path)) {
+    qLog(Warning) << "Restoring iTunes database from" << backup_path;
+    const QString database_path = GPodDevice::DatabasePath(mount_point_);
+    QFile::remove(database_path);
+    if (QFile::rename(backup_path, database_path)) {
+      if (error) {
+        g_error_free(error);
+        error = nullptr;
+      }
+      db = itdb_parse(mountpoint.constData(), &error);
+    }
+  }
+
   // Check for errors
   if (!db) {
     if (error) {
@@ -24,8 +24,13 @@
 #include <libmtp.h>
 
 #include <memory>
+#include <utility>
 
 #include <QObject>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
@@ -37,6 +42,34 @@
 
 using std::make_unique;
 
+namespace {
+
+// Above this many new or changed objects, all track metadata is loaded in one listing instead of per object.
+constexpr int kMaxTrackMetadataRequests = 500;
+constexpr int kSongsBatchSize = 500;
+
+// The file types Song::InitFromMTP accepts.
+bool IsSupportedFileType(const LIBMTP_filetype_t filetype) {
+
+  switch (filetype) {
+    case LIBMTP_FILETYPE_WAV:
+    case LIBMTP_FILETYPE_OGG:
+    case LIBMTP_FILETYPE_FLAC:
+    case LIBMTP_FILETYPE_MP2:
+    case LIBMTP_FILETYPE_MP3:
+    case LIBMTP_FILETYPE_M4A:
+    case LIBMTP_FILETYPE_MP4:
+    case LIBMTP_FILETYPE_AAC:
+    case LIBMTP_FILETYPE_WMA:
+      return true;
+    default:
+      return false;
+  }
+
+}
+
+}  // namespace
+
 MtpLoader::MtpLoader(const QUrl &url, const SharedPtr<TaskManager> task_manager, const SharedPtr<CollectionBackend> backend, QObject *parent)
     : QObject(parent),
       url_(url),
@@ -78,32 +111,109 @@ bool MtpLoader::TryLoad() {
     return false;
   }
 
-  // Load the list of songs on the device
-  SongList songs;
-  LIBMTP_track_t *tracks = LIBMTP_Get_Tracklisting_With_Callback(connection_->device(), nullptr, nullptr);
-  while (tracks) {
+  // The songs from the last time the device was connected are still in the database, keyed by MTP object ID.
+  // Only objects that are new, or that changed size or modification date since then have their metadata loaded again.
+  QHash<uint32_t, Song> cached_songs;
+  const SongList cached_songs_list = backend_->FindSongsInDirectory(1);
+  for (const Song &song : cached_songs_list) {
+    cached_songs.insert(song.basefilename().toUInt(), song);
+  }
+
+  // The file listing doesn't include the track metadata, so it is much faster than the track listing.
+  QSet<uint32_t> object_ids;
+  QSet<uint32_t> load_object_ids;
+  SongList moved_songs;
+  LIBMTP_file_t *files = LIBMTP_Get_Filelisting_With_Callback(connection_->device(), nullptr, nullptr);
+  while (files) {
+    LIBMTP_file_t *file = files;
+    if (!abort_ && IsSupportedFileType(file->filetype)) {
+      object_ids.insert(file->item_id);
+      QHash<uint32_t, Song>::const_iterator it = cached_songs.constFind(file->item_id);
+      if (it == cached_songs.constEnd() || it->mtime() != static_cast<qint64>(file->modificationdate) || it->filesize() != static_cast<qint64>(file->filesize)) {
+        load_object_ids.insert(file->item_id);
+      }
+      else {
+        const QUrl url(QStringLiteral("mtp://%1/%2").arg(url_.host(), QString::number(file->item_id)));
+        if (it->url() != url) {
+          Song song = it.value();
+          song.set_url(url);
+          moved_songs << song;
+        }
+      }
+    }
+    files = files->next;
+    LIBMTP_destroy_file_t(file);
+  }
 
-    if (abort_) break;
+  if (abort_) {
+    backend_->Close();
+    return false;
+  }
 
-    LIBMTP_track_t *track = tracks;
+  // Remove the songs that are no longer on the device
+  SongList deleted_songs;
+  for (QHash<uint32_t, Song>::const_iterator it = cached_songs.constBegin(); it != cached_songs.constEnd(); ++it) {
+    if (!object_ids.contains(it.key())) {
+      deleted_songs << it.value();
+    }
+  }
+  if (!deleted_songs.isEmpty()) {
+    backend_->DeleteSongs(deleted_songs);
+    deleted_songs.clear();
+  }
+  if (!moved_songs.isEmpty()) {
+    backend_->AddOrUpdateSongs(moved_songs);
+  }
 
+  // Load the metadata of the new and changed objects, the songs are added in batches so the device can be browsed while this continues.
+  SongList songs;
+  const auto add_track = [this, &cached_songs, &songs, &deleted_songs](LIBMTP_track_t *track) {
     Song song(Song::Source::Device);
     song.InitFromMTP(track, url_.host());
+    QHash<uint32_t, Song>::const_iterator it = cached_songs.constFind(track->item_id);
     if (song.is_valid() && !song.title().isEmpty()) {
       song.set_directory_id(1);
+      if (it != cached_songs.constEnd()) {
+        song.set_id(it->id());
+      }
       songs << song;
     }
-    tracks = tracks->next;
-    LIBMTP_destroy_track_t(track);
+    else if (it != cached_songs.constEnd()) {
+      deleted_songs << it.value();
+    }
+    if (songs.count() >= kSongsBatchSize) {
+      backend_->AddOrUpdateSongs(songs);
+      songs.clear();
+    }
+  };
+
+  if (load_object_ids.count() > kMaxTrackMetadataRequests) {
+    LIBMTP_track_t *tracks = LIBMTP_Get_Tracklisting_With_Callback(connection_->device(), nullptr, nullptr);
+    while (tracks) {
+      LIBMTP_track_t *track = tracks;
+      if (!abort_ && load_object_ids.contains(track->item_id)) {
+        add_track(track);
+      }
+      tracks = tracks->next;
+      LIBMTP_destroy_track_t(track);
+    }
+  }
+  else {
+    for (const uint32_t object_id : std::as_const(load_object_ids)) {
+      if (abort_) break;
+      LIBMTP_track_t *track = LIBMTP_Get_Trackmetadata(connection_->device(), object_id);
+      if (!track) continue;
+      add_track(track);
+      LIBMTP_destroy_track_t(track);
+    }
   }
 
-  if (!abort_) {
-    // Need to remove all the existing songs in the database first
-    backend_->DeleteSongs(backend_->FindSongsInDirectory(1));
-
-    // Add the songs we've just loaded
+  if (!songs.isEmpty()) {
     backend_->AddOrUpdateSongs(songs);
   }
+  if (!deleted_songs.isEmpty()) {
+    backend_->DeleteSongs(deleted_songs);
+  }
 
   // This is done in the loader thread so close the unique DB connection.
   backend_->Close();
@@ -40,6 +40,7 @@
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/database.h"
+#include "core/networkaccessmanager.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -50,6 +51,7 @@ Console::Console(const SharedPtr<Database> database, QWidget *parent) : QDialog(
   setWindowFlags(windowFlags() | Qt::WindowMaximizeButtonHint);
 
   QObject::connect(ui_.run, &QPushButton::clicked, this, &Console::RunQuery);
+  QObject::connect(ui_.network_statistics, &QPushButton::clicked, this, &Console::ShowNetworkStatistics);
 
   QFont font(u"Monospace"_s);
   font.setStyleHint(QFont::TypeWriter);
@@ -91,3 +93,13 @@ void Console::RunQuery() {
   ui_.output->verticalScrollBar()->setValue(ui_.output->verticalScrollBar()->maximum());
 
 }
+
+void Console::ShowNetworkStatistics() {
+
+  ui_.output->append(u"<b>&gt; "_s + tr("Network statistics") + u"</b>"_s);
+  const QString statistics = NetworkAccessManager::Statistics();
+  ui_.output->append(statistics.isEmpty() ? tr("No requests sent.") : statistics.toHtmlEscaped().replace(u'\n', "<br>"_L1));
+
+  ui_.output->verticalScrollBar()->setValue(ui_.output->verticalScrollBar()->maximum());
+
+}
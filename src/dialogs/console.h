@@ -43,6 +43,7 @@ class Console : public QDialog {
 
  private Q_SLOTS:
   void RunQuery();
+  void ShowNetworkStatistics();
 
  Q_SIGNALS:
   void Error(const QString &error);
@@ -84,13 +84,13 @@ void ChartLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id,
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
-    Q_EMIT SearchFinished(id);
+    Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
   if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QStringLiteral("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
-    Q_EMIT SearchFinished(id);
+    Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
@@ -129,6 +129,12 @@ void ChartLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id,
     }
   }
 
+  if (reader.hasError() && results.isEmpty()) {
+    Error(QStringLiteral("Failed to parse reply: %1").arg(reader.errorString()));
+    Q_EMIT SearchFinished(id, results, false);
+    return;
+  }
+
   if (results.isEmpty()) {
     qLog(Debug) << "ChartLyrics: No lyrics for" << request.artist << request.title;
   }
@@ -327,6 +327,7 @@ void GeniusLyricsProvider::StartSearch(const int id, const LyricsSearchRequest &
   requests_search_.insert(id, search);
 
   if (access_token().isEmpty()) {
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -359,23 +360,27 @@ void GeniusLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id)
 
   QJsonObject json_obj = ExtractJsonObj(reply);
   if (json_obj.isEmpty()) {
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("meta"_L1)) {
     Error(u"Json reply is missing meta object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["meta"_L1].isObject()) {
     Error(u"Json reply meta is not an object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   QJsonObject obj_meta = json_obj["meta"_L1].toObject();
   if (!obj_meta.contains("status"_L1)) {
     Error(u"Json reply meta object is missing status."_s, obj_meta);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -387,28 +392,33 @@ void GeniusLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id)
     else {
       Error(QStringLiteral("Received error %1.").arg(status));
     }
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("response"_L1)) {
     Error(u"Json reply is missing response."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["response"_L1].isObject()) {
     Error(u"Json response is not an object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   QJsonObject obj_response = json_obj["response"_L1].toObject();
   if (!obj_response.contains("hits"_L1)) {
     Error(u"Json response is missing hits."_s, obj_response);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_response["hits"_L1].isArray()) {
     Error(u"Json hits is not an array."_s, obj_response);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -486,11 +496,13 @@ void GeniusLyricsProvider::HandleLyricReply(QNetworkReply *reply, const int sear
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
   else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QStringLiteral("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
@@ -498,6 +510,7 @@ void GeniusLyricsProvider::HandleLyricReply(QNetworkReply *reply, const int sear
   const QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     Error(u"Empty reply received from server."_s);
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
@@ -553,7 +566,7 @@ void GeniusLyricsProvider::EndSearch(GeniusLyricsSearchContextPtr search, const
     else {
       qLog(Debug) << "GeniusLyrics: Got lyrics for" << search->request.artist << search->request.title;
     }
-    Q_EMIT SearchFinished(search->id, search->results);
+    Q_EMIT SearchFinished(search->id, search->results, !search->failed);
   }
 
 }
@@ -90,24 +90,25 @@ void HtmlLyricsProvider::HandleLyricsReply(QNetworkReply *reply, const int id, c
   if (reply->error() != QNetworkReply::NoError) {
     if (reply->error() == QNetworkReply::ContentNotFoundError) {
       qLog(Debug) << name_ << "No lyrics for" << request.artist << request.album << request.title;
+      Q_EMIT SearchFinished(id);
     }
     else {
       qLog(Error) << name_ << reply->errorString() << reply->error();
+      Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
     }
-    Q_EMIT SearchFinished(id);
     return;
   }
 
   if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     qLog(Error) << name_ << "Received HTTP code" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    Q_EMIT SearchFinished(id);
+    Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
   QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     qLog(Error) << name_ << "Empty reply received from server.";
-    Q_EMIT SearchFinished(id);
+    Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
@@ -87,7 +87,7 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
     failure_reason = QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error());
     if (reply->error() < 200) {
       Error(failure_reason);
-      Q_EMIT SearchFinished(id);
+      Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
       return;
     }
   }
@@ -97,6 +97,7 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
 
   QByteArray data = reply->readAll();
   LyricsSearchResults results;
+  bool got_status = false;
 
   if (!data.isEmpty()) {
     QXmlStreamReader reader(data);
@@ -112,6 +113,7 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
         }
         else if (name == "status"_L1) {
           status = reader.readElementText();
+          got_status = true;
         }
         else if (name == "response"_L1) {
           if (status == "OK"_L1) {
@@ -142,7 +144,8 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
     qLog(Debug) << "LoloLyrics: Got lyrics for" << request.artist << request.title;
   }
 
-  Q_EMIT SearchFinished(id, results);
+  // Only a reply with a status is an answer, anything else is a server error.
+  Q_EMIT SearchFinished(id, results, !results.isEmpty() || got_status);
 
 }
 
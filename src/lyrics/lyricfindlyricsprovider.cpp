@@ -106,7 +106,8 @@ void LyricFindLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int
   reply->deleteLater();
 
   LyricsSearchResults results;
-  const QScopeGuard end_search = qScopeGuard([this, id, request, &results]() { EndSearch(id, request, results); });
+  bool success = false;
+  const QScopeGuard end_search = qScopeGuard([this, id, request, &results, &success]() { EndSearch(id, request, results, success); });
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
@@ -196,6 +197,7 @@ void LyricFindLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int
   result.title = obj_track["title"_L1].toString();
   result.lyrics = obj_track["lyrics"_L1].toString();
   results << result;
+  success = true;
 
 }
 
@@ -206,7 +208,7 @@ void LyricFindLyricsProvider::Error(const QString &error, const QVariant &debug)
 
 }
 
-void LyricFindLyricsProvider::EndSearch(const int id, const LyricsSearchRequest &request, const LyricsSearchResults &results) {
+void LyricFindLyricsProvider::EndSearch(const int id, const LyricsSearchRequest &request, const LyricsSearchResults &results, const bool success) {
 
   if (results.isEmpty()) {
     qLog(Debug) << "LyricFind: No lyrics for" << request.artist << request.title;
@@ -215,6 +217,6 @@ void LyricFindLyricsProvider::EndSearch(const int id, const LyricsSearchRequest
     qLog(Debug) << "LyricFind: Got lyrics for" << request.artist << request.title;
   }
 
-  Q_EMIT SearchFinished(id, results);
+  Q_EMIT SearchFinished(id, results, success);
 
 }
@@ -0,0 +1,169 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QApplication>
+#include <QThread>
+#include <QMutex>
+#include <QChar>
+#include <QString>
+#include <QDateTime>
+#include <QSqlDatabase>
+
+#include "includes/shared_ptr.h"
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "lyricssearchrequest.h"
+#include "lyricscache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+// Providers might add lyrics later, or have failed to reply, so searches without results are retried after a while.
+constexpr qint64 kNotFoundMaxAgeSecs = 3LL * 24LL * 60LL * 60LL;
+}  // namespace
+
+LyricsCache::LyricsCache(const SharedPtr<Database> database, QObject *parent)
+    : QObject(parent),
+      database_(database),
+      original_thread_(nullptr) {
+
+  setObjectName(QLatin1String(metaObject()->className()));
+
+  original_thread_ = thread();
+
+}
+
+void LyricsCache::Close() {
+
+  if (database_) {
+    QMutexLocker l(database_->Mutex());
+    database_->Close();
+  }
+
+}
+
+void LyricsCache::ExitAsync() {
+  QMetaObject::invokeMethod(this, &LyricsCache::Exit, Qt::QueuedConnection);
+}
+
+void LyricsCache::Exit() {
+
+  Q_ASSERT(QThread::currentThread() == thread());
+
+  moveToThread(original_thread_);
+  Q_EMIT ExitFinished();
+
+}
+
+QString LyricsCache::NormalizeKey(const QString &text) {
+
+  // Compare without case, accents and punctuation, so "Don't Stop" and "Dont stop" share an entry.
+  const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+
+  QString key;
+  key.reserve(decomposed.length());
+  for (const QChar c : decomposed) {
+    if (c.isMark()) continue;
+    if (c.isLetterOrNumber()) {
+      key.append(c.toCaseFolded());
+    }
+    else if (c.isSpace() && !key.isEmpty() && !key.endsWith(u' ')) {
+      key.append(u' ');
+    }
+  }
+
+  return key.trimmed();
+
+}
+
+QString LyricsCache::Key(const LyricsSearchRequest &request) {
+
+  return NormalizeKey(request.artist) + u'\n' + NormalizeKey(request.album) + u'\n' + NormalizeKey(request.title);
+
+}
+
+LyricsCache::Entry LyricsCache::Lookup(const LyricsSearchRequest &request) {
+
+  Entry entry;
+
+  {
+    QMutexLocker l(database_->Mutex());
+    QSqlDatabase db(database_->Connect());
+
+    SqlQuery q(db);
+    q.prepare(u"SELECT provider, lyrics, time FROM lyrics_cache WHERE artist = :artist AND album = :album AND title = :title"_s);
+    q.BindValue(u":artist"_s, NormalizeKey(request.artist));
+    q.BindValue(u":album"_s, NormalizeKey(request.album));
+    q.BindValue(u":title"_s, NormalizeKey(request.title));
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+    }
+    else if (q.next()) {
+      const QString lyrics = q.value(1).toString();
+      if (!lyrics.isEmpty()) {
+        entry.status = Status::Found;
+        entry.provider = q.value(0).toString();
+        entry.lyrics = lyrics;
+      }
+      else if (QDateTime::currentSecsSinceEpoch() - q.value(2).toLongLong() < kNotFoundMaxAgeSecs) {
+        entry.status = Status::NotFound;
+      }
+    }
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != qApp->thread()) {
+    Close();
+  }
+
+  return entry;
+
+}
+
+void LyricsCache::InsertAsync(const LyricsSearchRequest &request, const QString &provider, const QString &lyrics) {
+
+  QMetaObject::invokeMethod(this, "Insert", Qt::QueuedConnection, Q_ARG(LyricsSearchRequest, request), Q_ARG(QString, provider), Q_ARG(QString, lyrics));
+
+}
+
+void LyricsCache::Insert(const LyricsSearchRequest &request, const QString &provider, const QString &lyrics) {
+
+  const QString artist = NormalizeKey(request.artist);
+  const QString title = NormalizeKey(request.title);
+  if (artist.isEmpty() || title.isEmpty()) return;
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  SqlQuery q(db);
+  q.prepare(u"INSERT OR REPLACE INTO lyrics_cache (artist, album, title, provider, lyrics, time) VALUES (:artist, :album, :title, :provider, :lyrics, :time)"_s);
+  q.BindValue(u":artist"_s, artist);
+  q.BindValue(u":album"_s, NormalizeKey(request.album));
+  q.BindValue(u":title"_s, title);
+  q.BindStringValue(u":provider"_s, provider);
+  q.BindStringValue(u":lyrics"_s, lyrics);
+  q.BindLongLongValue(u":time"_s, QDateTime::currentSecsSinceEpoch());
+  if (!q.Exec()) {
+    database_->ReportErrors(q);
+  }
+
+}
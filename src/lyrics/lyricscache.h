@@ -0,0 +1,82 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LYRICSCACHE_H
+#define LYRICSCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "lyricssearchrequest.h"
+
+class QThread;
+class Database;
+
+// Lyrics found by the lyrics providers, stored in the database by normalized artist, album and title.
+// Searches that found nothing are also stored, so they are not repeated until the entry expires.
+class LyricsCache : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit LyricsCache(const SharedPtr<Database> database, QObject *parent = nullptr);
+
+  enum class Status {
+    Miss,
+    Found,
+    NotFound
+  };
+
+  struct Entry {
+    Entry() : status(Status::Miss) {}
+    Status status;
+    QString provider;
+    QString lyrics;
+  };
+
+  void Close();
+  void ExitAsync();
+
+  static QString NormalizeKey(const QString &text);
+  static QString Key(const LyricsSearchRequest &request);
+
+  // Can be called from any thread.
+  Entry Lookup(const LyricsSearchRequest &request);
+
+  // Empty lyrics store that nothing was found.
+  void InsertAsync(const LyricsSearchRequest &request, const QString &provider, const QString &lyrics);
+
+ public Q_SLOTS:
+  void Insert(const LyricsSearchRequest &request, const QString &provider, const QString &lyrics);
+
+ private Q_SLOTS:
+  void Exit();
+
+ Q_SIGNALS:
+  void ExitFinished();
+
+ private:
+  const SharedPtr<Database> database_;
+  QThread *original_thread_;
+};
+
+#endif  // LYRICSCACHE_H
@@ -23,6 +23,10 @@
 
 #include <QtGlobal>
 #include <QTimer>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
 #include <QString>
 
 #include "includes/shared_ptr.h"
@@ -31,6 +35,7 @@
 #include "lyricsfetchersearch.h"
 #include "lyricssearchrequest.h"
 #include "lyricssearchresult.h"
+#include "lyricscache.h"
 
 using namespace std::chrono_literals;
 
@@ -42,6 +47,8 @@ LyricsFetcher::LyricsFetcher(const SharedPtr<LyricsProviders> lyrics_providers,
     : QObject(parent),
       lyrics_providers_(lyrics_providers),
       next_id_(0),
+      prefetch_search_(nullptr),
+      prefetch_lookup_pending_(false),
       request_starter_(new QTimer(this)) {
 
   request_starter_->setInterval(500ms);
@@ -49,7 +56,7 @@ LyricsFetcher::LyricsFetcher(const SharedPtr<LyricsProviders> lyrics_providers,
 
 }
 
-quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title) {
+LyricsSearchRequest LyricsFetcher::CreateSearchRequest(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title) {
 
   LyricsSearchRequest search_request;
   search_request.albumartist = effective_albumartist;
@@ -57,15 +64,151 @@ quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QStrin
   search_request.album = Song::AlbumRemoveDiscMisc(album);
   search_request.title = Song::TitleRemoveMisc(title);
 
+  return search_request;
+
+}
+
+quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title) {
+
   Request request;
   request.id = ++next_id_;
-  request.search_request = search_request;
-  AddRequest(request);
+  request.search_request = CreateSearchRequest(effective_albumartist, artist, album, title);
+  if (lyrics_cache_) {
+    LookupCache(request, false);
+  }
+  else {
+    AddRequest(request);
+  }
 
   return request.id;
 
 }
 
+void LyricsFetcher::Prefetch(const SongList &songs) {
+
+  if (!lyrics_cache_) return;
+
+  prefetch_requests_.clear();
+  for (const Song &song : songs) {
+    if (!song.lyrics().isEmpty() || song.artist().isEmpty() || song.title().isEmpty()) continue;
+    Request request;
+    request.id = ++next_id_;
+    request.search_request = CreateSearchRequest(song.effective_albumartist(), song.artist(), song.album(), song.title());
+    prefetch_requests_.enqueue(request);
+  }
+
+  StartPrefetch();
+
+}
+
+void LyricsFetcher::LookupCache(const Request &request, const bool prefetch) {
+
+  if (prefetch) {
+    prefetch_lookup_pending_ = true;
+  }
+  else {
+    pending_lookups_.insert(request.id);
+  }
+
+  QFuture<LyricsCache::Entry> future = QtConcurrent::run(&LyricsCache::Lookup, lyrics_cache_, request.search_request);
+  QFutureWatcher<LyricsCache::Entry> *watcher = new QFutureWatcher<LyricsCache::Entry>();
+  QObject::connect(watcher, &QFutureWatcher<LyricsCache::Entry>::finished, this, [this, watcher, request, prefetch]() {
+    const LyricsCache::Entry entry = watcher->result();
+    watcher->deleteLater();
+    CacheLookupFinished(request, prefetch, entry);
+  });
+  watcher->setFuture(future);
+
+}
+
+void LyricsFetcher::CacheLookupFinished(const Request &request, const bool prefetch, const LyricsCache::Entry &entry) {
+
+  if (prefetch) {
+    prefetch_lookup_pending_ = false;
+    if (entry.status == LyricsCache::Status::Miss) {
+      StartPrefetchSearch(request);
+    }
+    else {
+      StartPrefetch();
+    }
+    return;
+  }
+
+  // Cleared while looking up.
+  if (!pending_lookups_.remove(request.id)) return;
+
+  switch (entry.status) {
+    case LyricsCache::Status::Found: {
+      LyricsSearchResult result(entry.lyrics);
+      result.provider = entry.provider;
+      Q_EMIT LyricsFetched(request.id, entry.provider, entry.lyrics);
+      Q_EMIT SearchFinished(request.id, LyricsSearchResults() << result);
+      return;
+    }
+    case LyricsCache::Status::NotFound:
+      Q_EMIT LyricsFetched(request.id, QString(), QString());
+      Q_EMIT SearchFinished(request.id, LyricsSearchResults());
+      return;
+    case LyricsCache::Status::Miss:
+      break;
+  }
+
+  if (prefetch_search_ && LyricsCache::Key(prefetch_request_.search_request) == LyricsCache::Key(request.search_request)) {
+    prefetch_waiting_ << request.id;
+    return;
+  }
+
+  AddRequest(request);
+
+}
+
+void LyricsFetcher::CacheResult(const LyricsFetcherSearch *search, const QString &provider, const QString &lyrics) {
+
+  if (!lyrics_cache_) return;
+
+  // Only remember that nothing was found when every provider answered, not when one failed or the search timed out.
+  if (lyrics.isEmpty() && !search->all_providers_replied()) return;
+
+  lyrics_cache_->InsertAsync(search->request(), provider, lyrics);
+
+}
+
+void LyricsFetcher::StartPrefetch() {
+
+  if (prefetch_search_ || prefetch_lookup_pending_ || prefetch_requests_.isEmpty()) return;
+
+  LookupCache(prefetch_requests_.dequeue(), true);
+
+}
+
+void LyricsFetcher::StartPrefetchSearch(const Request &request) {
+
+  prefetch_request_ = request;
+  prefetch_search_ = new LyricsFetcherSearch(request.id, request.search_request, this);
+  QObject::connect(prefetch_search_, &LyricsFetcherSearch::LyricsFetched, this, &LyricsFetcher::PrefetchLyricsFetched);
+  prefetch_search_->Start(lyrics_providers_);
+
+}
+
+void LyricsFetcher::PrefetchLyricsFetched(const quint64 request_id, const QString &provider, const QString &lyrics) {
+
+  if (!prefetch_search_ || request_id != prefetch_request_.id) return;
+
+  LyricsFetcherSearch *search = prefetch_search_;
+  prefetch_search_ = nullptr;
+  CacheResult(search, provider, lyrics);
+  search->deleteLater();
+
+  const QList<quint64> waiting_ids = prefetch_waiting_;
+  prefetch_waiting_.clear();
+  for (const quint64 id : waiting_ids) {
+    Q_EMIT LyricsFetched(id, provider, lyrics);
+  }
+
+  StartPrefetch();
+
+}
+
 void LyricsFetcher::AddRequest(const Request &request) {
 
   queued_requests_.enqueue(request);
@@ -79,6 +222,8 @@ void LyricsFetcher::AddRequest(const Request &request) {
 void LyricsFetcher::Clear() {
 
   queued_requests_.clear();
+  pending_lookups_.clear();
+  prefetch_waiting_.clear();
 
   const QList<LyricsFetcherSearch*> searches = active_requests_.values();
   for (LyricsFetcherSearch *search : searches) {
@@ -126,6 +271,7 @@ void LyricsFetcher::SingleLyricsFetched(const quint64 request_id, const QString
   if (!active_requests_.contains(request_id)) return;
 
   LyricsFetcherSearch *search = active_requests_.take(request_id);
+  CacheResult(search, provider, lyrics);
   search->deleteLater();
   Q_EMIT LyricsFetched(request_id, provider, lyrics);
 
@@ -33,8 +33,10 @@
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
+#include "core/song.h"
 #include "lyricssearchrequest.h"
 #include "lyricssearchresult.h"
+#include "lyricscache.h"
 
 class QTimer;
 class LyricsProviders;
@@ -53,11 +55,21 @@ class LyricsFetcher : public QObject {
     LyricsSearchRequest search_request;
   };
 
+  void set_lyrics_cache(const SharedPtr<LyricsCache> lyrics_cache) { lyrics_cache_ = lyrics_cache; }
+
   quint64 Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title);
+  // Searches lyrics for the songs one by one in the background and stores them in the lyrics cache.
+  void Prefetch(const SongList &songs);
   void Clear();
 
  private:
+  static LyricsSearchRequest CreateSearchRequest(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title);
   void AddRequest(const Request &request);
+  void LookupCache(const Request &request, const bool prefetch);
+  void CacheLookupFinished(const Request &request, const bool prefetch, const LyricsCache::Entry &entry);
+  void CacheResult(const LyricsFetcherSearch *search, const QString &provider, const QString &lyrics);
+  void StartPrefetch();
+  void StartPrefetchSearch(const Request &request);
 
  Q_SIGNALS:
   void LyricsFetched(const quint64 request_id, const QString &provider, const QString &lyrics);
@@ -67,13 +79,23 @@ class LyricsFetcher : public QObject {
   void SingleSearchFinished(const quint64 request_id, const LyricsSearchResults &results);
   void SingleLyricsFetched(const quint64 request_id, const QString &provider, const QString &lyrics);
   void StartRequests();
+  void PrefetchLyricsFetched(const quint64 request_id, const QString &provider, const QString &lyrics);
 
  private:
   const SharedPtr<LyricsProviders> lyrics_providers_;
+  SharedPtr<LyricsCache> lyrics_cache_;
   quint64 next_id_;
 
   QQueue<Request> queued_requests_;
   QHash<quint64, LyricsFetcherSearch*> active_requests_;
+  QSet<quint64> pending_lookups_;
+
+  QQueue<Request> prefetch_requests_;
+  Request prefetch_request_;
+  LyricsFetcherSearch *prefetch_search_;
+  bool prefetch_lookup_pending_;
+  // Searches for the same song as the running prefetch, answered when it finishes.
+  QList<quint64> prefetch_waiting_;
 
   QTimer *request_starter_;
 };
@@ -45,6 +45,8 @@ LyricsFetcherSearch::LyricsFetcherSearch(const quint64 id, const LyricsSearchReq
     : QObject(parent),
       id_(id),
       request_(request),
+      providers_finished_(0),
+      providers_failed_(0),
       cancel_requested_(false) {
 
   QTimer::singleShot(kSearchTimeoutMs, this, &LyricsFetcherSearch::TerminateSearch);
@@ -54,6 +56,7 @@ LyricsFetcherSearch::LyricsFetcherSearch(const quint64 id, const LyricsSearchReq
 void LyricsFetcherSearch::TerminateSearch() {
 
   const QList<int> keys = pending_requests_.keys();
+  providers_failed_ += static_cast<int>(keys.count());
   for (const int id : keys) {
     pending_requests_.take(id)->CancelSearchAsync(id);
   }
@@ -86,10 +89,12 @@ void LyricsFetcherSearch::Start(SharedPtr<LyricsProviders> lyrics_providers) {
 
 }
 
-void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearchResults &results) {
+void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearchResults &results, const bool success) {
 
   if (!pending_requests_.contains(id)) return;
   LyricsProvider *provider = pending_requests_.take(id);
+  ++providers_finished_;
+  if (!success) ++providers_failed_;
 
   LyricsSearchResults results_copy(results);
   float higest_score = 0.0;
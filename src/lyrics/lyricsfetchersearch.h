@@ -43,12 +43,16 @@ class LyricsFetcherSearch : public QObject {
   void Start(SharedPtr<LyricsProviders> lyrics_providers);
   void Cancel();
 
+  const LyricsSearchRequest &request() const { return request_; }
+  // True when every provider answered and none of them failed or timed out, so an empty result can be trusted.
+  bool all_providers_replied() const { return providers_finished_ > 0 && providers_failed_ == 0; }
+
  Q_SIGNALS:
   void SearchFinished(const quint64 id, const LyricsSearchResults &results);
   void LyricsFetched(const quint64 id, const QString &provider, const QString &lyrics);
 
  private Q_SLOTS:
-  void ProviderSearchFinished(const int id, const LyricsSearchResults &results);
+  void ProviderSearchFinished(const int id, const LyricsSearchResults &results, const bool success);
   void TerminateSearch();
 
  private:
@@ -61,6 +65,8 @@ class LyricsFetcherSearch : public QObject {
   const LyricsSearchRequest request_;
   LyricsSearchResults results_;
   QMap<int, LyricsProvider*> pending_requests_;
+  int providers_finished_;
+  int providers_failed_;
   bool cancel_requested_;
 };
 
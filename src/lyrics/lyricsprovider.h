@@ -63,7 +63,8 @@ class LyricsProvider : public QObject {
   void AuthenticationComplete(const bool success, const QStringList &errors = QStringList());
   void AuthenticationSuccess();
   void AuthenticationFailure(const QStringList &errors);
-  void SearchFinished(const int id, const LyricsSearchResults &results = LyricsSearchResults());
+  // success is false when the provider could not answer (network or server errors), so no lyrics found is not remembered.
+  void SearchFinished(const int id, const LyricsSearchResults &results = LyricsSearchResults(), const bool success = true);
 
  protected:
   const SharedPtr<NetworkAccessManager> network_;
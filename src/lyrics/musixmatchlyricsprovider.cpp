@@ -118,6 +118,7 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
       return;
     }
     Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -130,6 +131,7 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
       return;
     }
     Error(QStringLiteral("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -137,17 +139,20 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
   QByteArray data = reply->readAll();
   QJsonObject json_obj = ExtractJsonObj(data);
   if (json_obj.isEmpty()) {
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("message"_L1)) {
     Error(u"Json reply is missing message object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["message"_L1].isObject()) {
     Error(u"Json reply message is not an object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -155,11 +160,13 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_message.contains("header"_L1)) {
     Error(u"Json reply message object is missing header."_s, obj_message);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_message["header"_L1].isObject()) {
     Error(u"Json reply message header is not an object."_s, obj_message);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -175,11 +182,13 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_message.contains("body"_L1)) {
     Error(u"Json reply is missing body."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_message["body"_L1].isObject()) {
     Error(u"Json body is not an object."_s, json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -187,11 +196,13 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_body.contains("track_list"_L1)) {
     Error(u"Json response is missing body."_s, obj_body);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_body["track_list"_L1].isArray()) {
     Error(u"Json hits is not an array."_s, obj_body);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -288,11 +299,13 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
   if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QStringLiteral("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -300,6 +313,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
   const QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     Error(u"Empty reply received from server."_s);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -318,24 +332,28 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
   }
 
   if (content_json.isEmpty()) {
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   static const QRegularExpression regex_html_tag(u"<[^>]*>"_s);
   if (content_json.contains(regex_html_tag)) {  // Make sure it's not HTML code.
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   QJsonObject obj_data = ExtractJsonObj(content_json.toUtf8());
   if (obj_data.isEmpty()) {
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   if (!obj_data.contains("props"_L1) || !obj_data["props"_L1].isObject()) {
     Error(u"Json reply is missing props."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -343,6 +361,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("pageProps"_L1) || !obj_data["pageProps"_L1].isObject()) {
     Error(u"Json props is missing pageProps."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -350,6 +369,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("data"_L1) || !obj_data["data"_L1].isObject()) {
     Error(u"Json pageProps is missing data."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -358,6 +378,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("trackInfo"_L1) || !obj_data["trackInfo"_L1].isObject()) {
     Error(u"Json data is missing trackInfo."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -365,6 +386,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("data"_L1) || !obj_data["data"_L1].isObject()) {
     Error(u"Json trackInfo reply is missing data."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -372,6 +394,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("track"_L1) || !obj_data["track"_L1].isObject()) {
     Error(u"Json data is missing track."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -380,6 +403,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_track.contains("hasLyrics"_L1) || !obj_track["hasLyrics"_L1].isBool()) {
     Error(u"Json track is missing hasLyrics."_s, obj_track);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -403,6 +427,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_data.contains("lyrics"_L1) || !obj_data["lyrics"_L1].isObject()) {
     Error(u"Json data is missing lyrics."_s, obj_data);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -410,6 +435,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_lyrics.contains("body"_L1) || !obj_lyrics["body"_L1].isString()) {
     Error(u"Json lyrics reply is missing body."_s, obj_lyrics);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -438,7 +464,7 @@ void MusixmatchLyricsProvider::EndSearch(LyricsSearchContextPtr search, const QU
     else {
       qLog(Debug) << "MusixmatchLyrics: Got lyrics for" << search->request.artist << search->request.title;
     }
-    Q_EMIT SearchFinished(search->id, search->results);
+    Q_EMIT SearchFinished(search->id, search->results, !search->failed);
   }
 
 }
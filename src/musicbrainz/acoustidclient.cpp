@@ -26,8 +26,11 @@
 
 #include <QtGlobal>
 #include <QObject>
+#include <QTimer>
 #include <QPair>
 #include <QList>
+#include <QMap>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -55,12 +58,24 @@ namespace {
 constexpr char kClientId[] = "0qjUoxbowg";
 constexpr char kUrl[] = "https://api.acoustid.org/v2/lookup";
 constexpr int kDefaultTimeout = 5000;  // msec
+// Wait this long for more fingerprints before sending a batch that is not full.
+constexpr int kBatchDelay = 500;
+constexpr int kMaxBatchSize = 20;
+// AcoustID allows 3 requests per second.
+constexpr int kRequestsDelay = 334;
 }  // namespace
 
 AcoustidClient::AcoustidClient(SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
       network_(network),
-      timeouts_(new NetworkTimeouts(kDefaultTimeout, this)) {}
+      timeouts_(new NetworkTimeouts(kDefaultTimeout, this)),
+      timer_flush_requests_(new QTimer(this)),
+      url_(QString::fromLatin1(kUrl)) {
+
+  timer_flush_requests_->setSingleShot(true);
+  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &AcoustidClient::FlushRequests);
+
+}
 
 AcoustidClient::~AcoustidClient() {
 
@@ -72,41 +87,102 @@ void AcoustidClient::SetTimeout(const int msec) { timeouts_->SetTimeout(msec); }
 
 void AcoustidClient::Start(const int id, const QString &fingerprint, int duration_msec) {
 
+  Request request;
+  request.id = id;
+  request.fingerprint = fingerprint;
+  request.duration_msec = duration_msec;
+  requests_pending_.enqueue(request);
+
+  if (requests_pending_.count() >= kMaxBatchSize) {
+    FlushRequests();
+  }
+  else if (!timer_flush_requests_->isActive()) {
+    timer_flush_requests_->start(kBatchDelay);
+  }
+
+}
+
+void AcoustidClient::FlushRequests() {
+
+  if (requests_pending_.isEmpty()) return;
+
+  if (last_request_.isValid() && last_request_.elapsed() < kRequestsDelay) {
+    timer_flush_requests_->start(static_cast<int>(kRequestsDelay - last_request_.elapsed()));
+    return;
+  }
+
   using Param = QPair<QString, QString>;
   using ParamList = QList<Param>;
 
-  const ParamList params = ParamList() << Param(u"format"_s, u"json"_s)
-                                       << Param(u"client"_s, QLatin1String(kClientId))
-                                       << Param(u"duration"_s, QString::number(duration_msec / kMsecPerSec))
-                                       << Param(u"meta"_s, u"recordingids+sources"_s)
-                                       << Param(u"fingerprint"_s, fingerprint);
+  ParamList params = ParamList() << Param(u"format"_s, u"json"_s)
+                                 << Param(u"client"_s, QLatin1String(kClientId))
+                                 << Param(u"meta"_s, u"recordingids sources"_s);
+
+  // A single fingerprint is sent without index, the response then has the results directly instead of a list of fingerprints.
+  QList<int> ids;
+  const bool batch = requests_pending_.count() > 1;
+  while (!requests_pending_.isEmpty() && ids.count() < kMaxBatchSize) {
+    const Request request = requests_pending_.dequeue();
+    const QString suffix = batch ? u"."_s + QString::number(ids.count()) : QString();
+    params << Param(u"duration"_s + suffix, QString::number(request.duration_msec / kMsecPerSec))
+           << Param(u"fingerprint"_s + suffix, request.fingerprint);
+    ids << request.id;
+  }
 
   QUrlQuery url_query;
   url_query.setQueryItems(params);
-  QUrl url(QString::fromLatin1(kUrl));
-  url.setQuery(url_query);
 
-  QNetworkRequest req(url);
+  QNetworkRequest req(url_);
   req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-  QNetworkReply *reply = network_->get(req);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, id]() { RequestFinished(reply, id); });
-  requests_[id] = reply;
+  req.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
+  QNetworkReply *reply = network_->post(req, url_query.toString(QUrl::FullyEncoded).toUtf8());
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, ids]() { RequestFinished(reply, ids); });
+  for (const int id : std::as_const(ids)) {
+    requests_[id] = reply;
+  }
 
   timeouts_->AddReply(reply);
+  last_request_.start();
+
+  if (!requests_pending_.isEmpty()) {
+    timer_flush_requests_->start(kRequestsDelay);
+  }
 
 }
 
 void AcoustidClient::Cancel(const int id) {
 
-  if (requests_.contains(id)) delete requests_.take(id);
+  for (QQueue<Request>::iterator it = requests_pending_.begin(); it != requests_pending_.end();) {
+    if (it->id == id) {
+      it = requests_pending_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  if (!requests_.contains(id)) return;
+
+  // The reply is only aborted when no other fingerprint in the batch is waiting for it.
+  QNetworkReply *reply = requests_.take(id);
+  if (!requests_.values().contains(reply)) {
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    delete reply;
+  }
 
 }
 
 void AcoustidClient::CancelAll() {
 
-  QList<QNetworkReply*> replies = requests_.values();
-  qDeleteAll(replies);
+  timer_flush_requests_->stop();
+  requests_pending_.clear();
+
+  const QList<QNetworkReply*> replies = QSet<QNetworkReply*>(requests_.begin(), requests_.end()).values();
   requests_.clear();
+  for (QNetworkReply *reply : replies) {
+    QObject::disconnect(reply, nullptr, this, nullptr);
+  }
+  qDeleteAll(replies);
 
 }
 
@@ -126,11 +202,19 @@ struct IdSource {
 
 }  // namespace
 
-void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id) {
+void AcoustidClient::RequestFinished(QNetworkReply *reply, const QList<int> &ids) {
 
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
-  requests_.remove(request_id);
+
+  // Index of the fingerprint in the batch to request ID, without the requests that were cancelled.
+  QMap<int, int> request_ids;
+  for (int i = 0; i < ids.count(); ++i) {
+    if (requests_.value(ids[i]) == reply) {
+      requests_.remove(ids[i]);
+      request_ids.insert(i, ids[i]);
+    }
+  }
 
   if (reply->error() != QNetworkReply::NoError || reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     if (reply->error() != QNetworkReply::NoError) {
@@ -139,7 +223,9 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
     else {
       qLog(Error) << QStringLiteral("Acoustid: Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
     }
-    Q_EMIT Finished(request_id, QStringList());
+    for (const int id : std::as_const(request_ids)) {
+      Q_EMIT Finished(id, QStringList());
+    }
     return;
   }
 
@@ -147,7 +233,9 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
   QJsonDocument json_document = QJsonDocument::fromJson(reply->readAll(), &error);
 
   if (error.error != QJsonParseError::NoError) {
-    Q_EMIT Finished(request_id, QStringList());
+    for (const int id : std::as_const(request_ids)) {
+      Q_EMIT Finished(id, QStringList());
+    }
     return;
   }
 
@@ -155,16 +243,39 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
 
   QString status = json_object["status"_L1].toString();
   if (status != "ok"_L1) {
-    Q_EMIT Finished(request_id, QStringList(), status);
+    for (const int id : std::as_const(request_ids)) {
+      Q_EMIT Finished(id, QStringList(), status);
+    }
     return;
   }
 
+  if (json_object.contains("fingerprints"_L1)) {
+    const QJsonArray json_fingerprints = json_object["fingerprints"_L1].toArray();
+    for (const QJsonValue &value_fingerprint : json_fingerprints) {
+      const QJsonObject json_fingerprint = value_fingerprint.toObject();
+      const int index = json_fingerprint["index"_L1].toVariant().toInt();
+      if (!request_ids.contains(index)) continue;
+      Q_EMIT Finished(request_ids.take(index), ParseRecordingIds(json_fingerprint["results"_L1].toArray()));
+    }
+  }
+  else if (request_ids.contains(0)) {
+    Q_EMIT Finished(request_ids.take(0), ParseRecordingIds(json_object["results"_L1].toArray()));
+  }
+
+  // Fingerprints missing from the response have no match.
+  for (const int id : std::as_const(request_ids)) {
+    Q_EMIT Finished(id, QStringList());
+  }
+
+}
+
+QStringList AcoustidClient::ParseRecordingIds(const QJsonArray &json_results) {
+
   // Get the results:
   // -in a first step, gather ids and their corresponding number of sources
   // -then sort results by number of sources (the results are originally
   //  unsorted but results with more sources are likely to be more accurate)
   // -keep only the ids, as sources where useful only to sort the results
-  const QJsonArray json_results = json_object["results"_L1].toArray();
 
   // List of <id, nb of sources> pairs
   QList<IdSource> id_source_list;
@@ -190,6 +301,6 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
     id_list << is.id_;
   }
 
-  Q_EMIT Finished(request_id, id_list);
+  return id_list;
 
 }
@@ -24,14 +24,21 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QObject>
+#include <QList>
 #include <QMap>
+#include <QQueue>
 #include <QString>
 #include <QStringList>
+#include <QUrl>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 
+class QTimer;
 class QNetworkReply;
+class QJsonArray;
 class NetworkAccessManager;
 class NetworkTimeouts;
 
@@ -43,6 +50,7 @@ class AcoustidClient : public QObject {
   // An MBID identifies the actual song and can be passed to Musicbrainz to get metadata.
   // You can create one AcoustidClient and make multiple requests using it.
   // IDs are provided by the caller when a request is started and included in the Finished signal - they have no meaning to AcoustidClient.
+  // Fingerprints started close together are looked up in batches, several fingerprints per request.
 
  public:
   explicit AcoustidClient(SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
@@ -51,6 +59,9 @@ class AcoustidClient : public QObject {
   // Network requests will be aborted after this interval.
   void SetTimeout(const int msec);
 
+  // Used by tests to send the requests to a local server.
+  void SetUrl(const QUrl &url) { url_ = url; }
+
   // Starts a request and returns immediately.  Finished() will be emitted later with the same ID.
   void Start(const int id, const QString &fingerprint, int duration_msec);
 
@@ -64,11 +75,25 @@ class AcoustidClient : public QObject {
   void Finished(const int id, const QStringList &mbid_list, const QString &error = QString());
 
  private Q_SLOTS:
-  void RequestFinished(QNetworkReply *reply, const int id);
+  void FlushRequests();
+  void RequestFinished(QNetworkReply *reply, const QList<int> &ids);
 
  private:
+  struct Request {
+    Request() : id(0), duration_msec(0) {}
+    int id;
+    QString fingerprint;
+    int duration_msec;
+  };
+
+  static QStringList ParseRecordingIds(const QJsonArray &json_results);
+
   SharedPtr<NetworkAccessManager> network_;
   NetworkTimeouts *timeouts_;
+  QTimer *timer_flush_requests_;
+  QUrl url_;
+  QElapsedTimer last_request_;
+  QQueue<Request> requests_pending_;
   QMap<int, QNetworkReply*> requests_;
 };
 
@@ -26,6 +26,9 @@
 
 #include <QObject>
 #include <QSet>
+#include <QHash>
+#include <QMultiHash>
+#include <QQueue>
 #include <QList>
 #include <QVariant>
 #include <QString>
@@ -42,6 +45,7 @@
 #include <QJsonObject>
 #include <QXmlStreamReader>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -53,21 +57,24 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr char kTrackUrl[] = "https://musicbrainz.org/ws/2/recording/";
-constexpr char kDiscUrl[] = "https://musicbrainz.org/ws/2/discid/";
+constexpr char kUrl[] = "https://musicbrainz.org/ws/2/";
 constexpr char kDateRegex[] = "^[12]\\d{3}";
-constexpr int kRequestsDelay = 1200;
+// MusicBrainz allows one request per second, requests are started at that rate without waiting for the replies.
+constexpr int kRequestsDelay = 1000;
+constexpr int kMaxConcurrentRequests = 4;
 constexpr int kDefaultTimeout = 8000;
 constexpr int kMaxRequestPerTrack = 3;
+// Timeouts and server errors (e.g. 503 when rate limited) are retried with an increasing delay before giving up.
+constexpr int kMaxRetries = 3;
 }  // namespace
 
 MusicBrainzClient::MusicBrainzClient(SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
       network_(network),
       timeouts_(new NetworkTimeouts(kDefaultTimeout, this)),
-      timer_flush_requests_(new QTimer(this)) {
+      timer_flush_requests_(new QTimer(this)),
+      url_(QString::fromLatin1(kUrl)) {
 
-  timer_flush_requests_->setInterval(kRequestsDelay);
   timer_flush_requests_->setSingleShot(true);
   QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &MusicBrainzClient::FlushRequests);
 
@@ -122,34 +129,73 @@ QByteArray MusicBrainzClient::GetReplyData(QNetworkReply *reply, QString &error)
 
 void MusicBrainzClient::Cancel(int id) {
 
-  while (!requests_.isEmpty() && requests_.contains(id)) {
-    QNetworkReply *reply = requests_.take(id);
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
+  RemoveTrack(id);
 
 }
 
 void MusicBrainzClient::CancelAll() {
 
-  qDeleteAll(requests_);
+  timer_flush_requests_->stop();
+  tracks_.clear();
+  mbid_tracks_.clear();
+  mbid_queue_.clear();
+  errors_.clear();
+  failed_.clear();
+  retries_.clear();
+
+  const QList<QNetworkReply*> replies = requests_.values();
   requests_.clear();
+  for (QNetworkReply *reply : replies) {
+    QObject::disconnect(reply, nullptr, this, nullptr);
+  }
+  qDeleteAll(replies);
 
 }
 
 void MusicBrainzClient::Start(const int id, const QStringList &mbid_list) {
 
-  int request_number = 0;
+  RemoveTrack(id);
+
+  QStringList mbids;
   for (const QString &mbid : mbid_list) {
-    ++request_number;
-    if (request_number > kMaxRequestPerTrack) break;
-    Request request(id, mbid, request_number);
-    requests_pending_.insert(id, request);
+    if (mbids.count() >= kMaxRequestPerTrack) break;
+    if (mbids.contains(mbid)) continue;
+    mbids << mbid;
+    mbid_tracks_.insert(mbid, id);
+    // Only look up recordings that are not cached, queued or already being looked up for another track.
+    if (!results_.contains(mbid) && !errors_.contains(mbid) && !failed_.contains(mbid) && !retries_.contains(mbid) && !requests_.contains(mbid) && !mbid_queue_.contains(mbid)) {
+      mbid_queue_.enqueue(mbid);
+    }
   }
+  tracks_.insert(id, mbids);
 
   if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
+    FlushRequests();
+  }
+
+  // All results might be cached already.
+  QMetaObject::invokeMethod(this, [this, id]() { FinishCheck(id); }, Qt::QueuedConnection);
+
+}
+
+void MusicBrainzClient::RemoveTrack(const int id) {
+
+  if (!tracks_.contains(id)) return;
+
+  const QStringList mbids = tracks_.take(id);
+  for (const QString &mbid : mbids) {
+    mbid_tracks_.remove(mbid, id);
+    if (mbid_tracks_.contains(mbid)) continue;
+    // No other track is waiting for this recording.
+    mbid_queue_.removeAll(mbid);
+    failed_.remove(mbid);
+    retries_.remove(mbid);
+    if (requests_.contains(mbid)) {
+      QNetworkReply *reply = requests_.take(mbid);
+      QObject::disconnect(reply, nullptr, this, nullptr);
+      if (reply->isRunning()) reply->abort();
+      reply->deleteLater();
+    }
   }
 
 }
@@ -160,7 +206,7 @@ void MusicBrainzClient::StartDiscIdRequest(const QString &discid) {
 
   QUrlQuery url_query;
   url_query.setQueryItems(params);
-  QUrl url(QString::fromLatin1(kDiscUrl) + discid);
+  QUrl url(url_.toString() + u"discid/"_s + discid);
   url.setQuery(url_query);
 
   QNetworkRequest req(url);
@@ -174,44 +220,68 @@ void MusicBrainzClient::StartDiscIdRequest(const QString &discid) {
 
 void MusicBrainzClient::FlushRequests() {
 
-  if (!requests_.isEmpty() || requests_pending_.isEmpty()) return;
+  if (mbid_queue_.isEmpty() || requests_.count() >= kMaxConcurrentRequests) return;
 
-  Request request = requests_pending_.take(requests_pending_.firstKey());
+  if (last_request_.isValid() && last_request_.elapsed() < kRequestsDelay) {
+    timer_flush_requests_->start(static_cast<int>(kRequestsDelay - last_request_.elapsed()));
+    return;
+  }
+
+  const QString mbid = mbid_queue_.dequeue();
 
   const ParamList params = ParamList() << Param(u"inc"_s, u"artists+releases+media"_s);
 
   QUrlQuery url_query;
   url_query.setQueryItems(params);
-  QUrl url(QString::fromLatin1(kTrackUrl) + request.mbid);
+  QUrl url(url_.toString() + u"recording/"_s + mbid);
   url.setQuery(url_query);
 
   QNetworkRequest req(url);
   req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
   QNetworkReply *reply = network_->get(req);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { RequestFinished(reply, request.id, request.number); });
-  requests_.insert(request.id, reply);
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, mbid]() { RequestFinished(reply, mbid); });
+  requests_.insert(mbid, reply);
 
   timeouts_->AddReply(reply);
+  last_request_.start();
+
+  if (!mbid_queue_.isEmpty()) {
+    timer_flush_requests_->start(kRequestsDelay);
+  }
 
 }
 
-void MusicBrainzClient::RequestFinished(QNetworkReply *reply, const int id, const int request_number) {
+void MusicBrainzClient::RequestFinished(QNetworkReply *reply, const QString &mbid) {
 
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
-  const qint64 nb_removed = requests_.remove(id, reply);
-  if (nb_removed != 1) {
-    qLog(Debug) << "MusicBrainz: Unknown reply received:" << nb_removed << "requests removed, while only one was supposed to be removed";
-  }
+  if (requests_.value(mbid) != reply) return;
+  requests_.remove(mbid);
 
-  if (!timer_flush_requests_->isActive() && requests_.isEmpty() && !requests_pending_.isEmpty()) {
-    timer_flush_requests_->start();
+  if (!timer_flush_requests_->isActive()) {
+    FlushRequests();
   }
 
   QString error;
   QByteArray data = GetReplyData(reply, error);
-  if (!data.isEmpty()) {
+  if (data.isEmpty()) {
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 404) {
+      // The recording does not exist, there is no point in asking again.
+      errors_.insert(mbid, error);
+    }
+    else if (retries_.value(mbid) < kMaxRetries) {
+      RetryLater(mbid);
+      return;
+    }
+    else {
+      // Only reported to the tracks waiting now, the recording is looked up again next time.
+      retries_.remove(mbid);
+      failed_.insert(mbid, error);
+    }
+  }
+  else {
+    retries_.remove(mbid);
     QXmlStreamReader reader(data);
     ResultList res;
     while (!reader.atEnd()) {
@@ -224,21 +294,65 @@ void MusicBrainzClient::RequestFinished(QNetworkReply *reply, const int id, cons
         }
       }
     }
-    pending_results_[id] << PendingResults(request_number, res);
+    results_.insert(mbid, res);
+  }
+
+  const QList<int> ids = mbid_tracks_.values(mbid);
+  for (const int id : ids) {
+    FinishCheck(id);
   }
 
-  // No more pending requests for this id: emit the results we have.
-  if (!requests_.contains(id) && !requests_pending_.contains(id)) {
-    // Merge the results we have
-    ResultList ret;
-    QList<PendingResults> result_list_list = pending_results_.take(id);
-    std::sort(result_list_list.begin(), result_list_list.end());
-    for (const PendingResults &result_list : std::as_const(result_list_list)) {
-      ret << result_list.results_;
+}
+
+void MusicBrainzClient::RetryLater(const QString &mbid) {
+
+  const int retry = retries_.value(mbid) + 1;
+  retries_.insert(mbid, retry);
+
+  qLog(Debug) << "MusicBrainz request for" << mbid << "failed, retrying in" << (kRequestsDelay << retry) << "ms";
+
+  QTimer::singleShot(kRequestsDelay << retry, this, [this, mbid]() {
+    // The tracks might have been cancelled in the meantime.
+    if (!retries_.contains(mbid) || !mbid_tracks_.contains(mbid) || requests_.contains(mbid) || mbid_queue_.contains(mbid)) return;
+    mbid_queue_.enqueue(mbid);
+    if (!timer_flush_requests_->isActive()) {
+      FlushRequests();
+    }
+  });
+
+}
+
+void MusicBrainzClient::FinishCheck(const int id) {
+
+  if (!tracks_.contains(id)) return;
+
+  const QStringList mbids = tracks_.value(id);
+  for (const QString &mbid : mbids) {
+    if (!results_.contains(mbid) && !errors_.contains(mbid) && !failed_.contains(mbid)) return;
+  }
+
+  // Merge the results in the order of the MBIDs.
+  ResultList ret;
+  QString error;
+  for (const QString &mbid : mbids) {
+    if (results_.contains(mbid)) {
+      ret << results_.value(mbid);
+    }
+    else {
+      error = errors_.contains(mbid) ? errors_.value(mbid) : failed_.value(mbid);
+    }
+  }
+
+  tracks_.remove(id);
+  for (const QString &mbid : mbids) {
+    mbid_tracks_.remove(mbid, id);
+    if (!mbid_tracks_.contains(mbid)) {
+      failed_.remove(mbid);
     }
-    Q_EMIT Finished(id, UniqueResults(ret, UniqueResultsSortOption::KeepOriginalOrder), error);
   }
 
+  Q_EMIT Finished(id, UniqueResults(ret, UniqueResultsSortOption::KeepOriginalOrder), error);
+
 }
 
 void MusicBrainzClient::DiscIdRequestFinished(const QString &discid, QNetworkReply *reply) {
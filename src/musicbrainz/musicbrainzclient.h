@@ -29,9 +29,14 @@
 #include <QList>
 #include <QMap>
 #include <QMultiMap>
+#include <QHash>
+#include <QMultiHash>
+#include <QQueue>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
+#include <QUrl>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 
@@ -48,6 +53,7 @@ class MusicBrainzClient : public QObject {
   // An MBID is created from a fingerprint using MusicDnsClient.
   // You can create one MusicBrainzClient and make multiple requests using it.
   // IDs are provided by the caller when a request is started and included in the Finished signal - they have no meaning to MusicBrainzClient.
+  // Recordings are looked up once, even when several tracks have the same MBID, and the results are kept as long as the client exists.
 
  public:
   // The second argument allows for specifying a custom network access manager.
@@ -91,6 +97,9 @@ class MusicBrainzClient : public QObject {
   };
   using ResultList = QList<Result>;
 
+  // Used by tests to send the requests to a local server.
+  void SetUrl(const QUrl &url) { url_ = url; }
+
   // Starts a request and returns immediately.  Finished() will be emitted later with the same ID.
   void Start(const int id, const QStringList &mbid);
   void StartDiscIdRequest(const QString &discid);
@@ -109,22 +118,13 @@ class MusicBrainzClient : public QObject {
 
  private Q_SLOTS:
   void FlushRequests();
-  // id identifies the track, and request_number means it's the 'request_number'th request for this track
-  void RequestFinished(QNetworkReply *reply, const int id, const int request_number);
+  void RequestFinished(QNetworkReply *reply, const QString &mbid);
   void DiscIdRequestFinished(const QString &discid, QNetworkReply *reply);
 
  private:
   using Param = QPair<QString, QString>;
   using ParamList = QList<Param>;
 
-  struct Request {
-    Request() : id(0), number(0) {}
-    Request(const int _id, const QString &_mbid, const int _number) : id(_id), mbid(_mbid), number(_number) {}
-    int id;
-    QString mbid;
-    int number;
-  };
-
   // Used as parameter for UniqueResults
   enum class UniqueResultsSortOption {
     SortResults = 0,
@@ -180,17 +180,6 @@ class MusicBrainzClient : public QObject {
     Status status_;
   };
 
-  struct PendingResults {
-    PendingResults(int sort_id, const ResultList &results) : sort_id_(sort_id), results_(results) {}
-
-    bool operator<(const PendingResults &other) const {
-      return sort_id_ < other.sort_id_;
-    }
-
-    int sort_id_;
-    ResultList results_;
-  };
-
   static QByteArray GetReplyData(QNetworkReply *reply, QString &error);
   static bool MediumHasDiscid(const QString &discid, QXmlStreamReader *reader);
   static ResultList ParseMedium(QXmlStreamReader *reader);
@@ -201,14 +190,28 @@ class MusicBrainzClient : public QObject {
   static ResultList UniqueResults(const ResultList &results, UniqueResultsSortOption opt = UniqueResultsSortOption::SortResults);
   static void Error(const QString &error, const QVariant &debug = QVariant());
 
+  void RetryLater(const QString &mbid);
+  void FinishCheck(const int id);
+  void RemoveTrack(const int id);
+
  private:
   SharedPtr<NetworkAccessManager> network_;
   NetworkTimeouts *timeouts_;
-  QMultiMap<int, Request> requests_pending_;
-  QMultiMap<int, QNetworkReply*> requests_;
-  // Results we received so far, kept here until all the replies are finished
-  QMap<int, QList<PendingResults>> pending_results_;
   QTimer *timer_flush_requests_;
+  QUrl url_;
+  QElapsedTimer last_request_;
+
+  // MBIDs of the tracks waiting for results, in the order the results are returned.
+  QMap<int, QStringList> tracks_;
+  QMultiHash<QString, int> mbid_tracks_;
+  QQueue<QString> mbid_queue_;
+  QHash<QString, QNetworkReply*> requests_;
+  // Results and definitive errors are cached for the rest of the session.
+  QHash<QString, ResultList> results_;
+  QHash<QString, QString> errors_;
+  // Transient errors are only kept while tracks are waiting for them.
+  QHash<QString, QString> failed_;
+  QHash<QString, int> retries_;
 
 };
 
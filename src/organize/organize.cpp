@@ -21,19 +21,23 @@
 
 #include <QtGlobal>
 
+#include <algorithm>
 #include <functional>
 #include <utility>
-#include <chrono>
 
+#include <QtConcurrentRun>
 #include <QThread>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QFile>
 #include <QFileInfo>
-#include <QTimer>
 #include <QDateTime>
 #include <QList>
 #include <QString>
 #include <QUrl>
 #include <QImage>
+#include <QMutexLocker>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -42,16 +46,16 @@
 #include "core/song.h"
 #include "utilities/strutils.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/embeddedcovercache.h"
 #include "organize.h"
 #include "transcoder/transcoder.h"
 
-using namespace std::chrono_literals;
-
 class OrganizeFormat;
 
 namespace {
-constexpr int kBatchSize = 10;
-constexpr int kTranscodeProgressInterval = 500;
+constexpr int kProgressInterval = 500;
+constexpr int kMaxTranscodedFilesPerThread = 2;
+constexpr int kPathChangesBatchSize = 1000;
 }  // namespace
 
 Organize::Organize(const SharedPtr<TaskManager> task_manager,
@@ -71,7 +75,7 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
       task_manager_(task_manager),
       tagreader_client_(tagreader_client),
       transcoder_(new Transcoder(this)),
-      process_files_timer_(new QTimer(this)),
+      copy_threadpool_(new QThreadPool(this)),
       destination_(destination),
       format_(format),
       copy_(copy),
@@ -80,17 +84,16 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
       eject_after_(eject_after),
       task_count_(songs_info.count()),
       playlist_(playlist),
+      tasks_copying_(0),
       tasks_complete_(0),
       started_(false),
       task_id_(0),
-      current_copy_progress_(0),
+      next_copy_id_(0),
       finished_(false) {
 
   original_thread_ = thread();
 
-  process_files_timer_->setSingleShot(true);
-  process_files_timer_->setInterval(100ms);
-  QObject::connect(process_files_timer_, &QTimer::timeout, this, &Organize::ProcessSomeFiles);
+  copy_threadpool_->setMaxThreadCount(std::max(1, destination_->MaxConcurrentCopies()));
 
   tasks_pending_.reserve(songs_info.count());
   for (const NewSongInfo &song_info : songs_info) {
@@ -121,6 +124,8 @@ void Organize::Start() {
   QObject::connect(transcoder_, &Transcoder::JobComplete, this, &Organize::FileTranscoded);
   QObject::connect(transcoder_, &Transcoder::LogLine, this, &Organize::LogLine);
 
+  elapsed_.start();
+
   moveToThread(thread_);
   thread_->start();
 
@@ -141,154 +146,245 @@ void Organize::ProcessSomeFiles() {
     started_ = true;
   }
 
-  // None left?
-  if (tasks_pending_.isEmpty()) {
-    if (!tasks_transcoding_.isEmpty()) {
-      // Just wait - FileTranscoded will start us off again in a little while
-      qLog(Debug) << "Waiting for transcoding jobs";
-      transcode_progress_timer_.start(kTranscodeProgressInterval, this);
-      return;
-    }
+  // Files go through the transcoder and the copy jobs as separate stages, each stage is kept busy up to its own limit.
+  // Transcoded files are copied first, so the temporary files don't pile up.
+  const int max_copies = copy_threadpool_->maxThreadCount();
+  while (!tasks_transcoded_.isEmpty() && tasks_copying_ < max_copies) {
+    StartCopy(tasks_transcoded_.takeFirst());
+  }
 
-    UpdateProgress();
+  const int max_transcoded = transcoder_->max_threads() * kMaxTranscodedFilesPerThread;
+  while (!tasks_pending_.isEmpty()) {
+    const Song &song = tasks_pending_.first().song_info_.song_;
+    if (!song.is_valid()) {
+      tasks_pending_.removeFirst();
+      continue;
+    }
 
-    QString error_text;
-    if (!destination_->FinishCopy(files_with_errors_.isEmpty(), error_text) && !error_text.isEmpty()) {
-      log_ << error_text;
+    // Figure out if we need to transcode it
+    const Song::FileType dest_type = CheckTranscode(song.filetype());
+    if (dest_type == Song::FileType::Unknown) {
+      if (tasks_copying_ >= max_copies) break;
+      StartCopy(tasks_pending_.takeFirst());
     }
-    if (eject_after_) destination_->Eject();
+    else {
+      if (tasks_transcoding_.count() + tasks_transcoded_.count() >= max_transcoded) break;
+      StartTranscode(tasks_pending_.takeFirst(), dest_type);
+    }
+  }
 
-    task_manager_->SetTaskFinished(task_id_);
+  // None left?
+  if (tasks_pending_.isEmpty() && tasks_transcoding_.isEmpty() && tasks_transcoded_.isEmpty() && tasks_copying_ == 0) {
+    FinishOrganize();
+    return;
+  }
 
-    Q_EMIT Finished(files_with_errors_, log_);
+  UpdateProgress();
+  if (!progress_timer_.isActive()) {
+    progress_timer_.start(kProgressInterval, this);
+  }
 
-    // Move back to the original thread so deleteLater() can get called in the main thread's event loop
-    moveToThread(original_thread_);
-    deleteLater();
+}
 
-    // Stop this thread
-    thread_->quit();
-    finished_ = true;
-    return;
-  }
+void Organize::StartTranscode(Task task, const Song::FileType dest_type) {
 
-  // We process files in batches so we can be cancelled part-way through.
-  for (int i = 0; i < kBatchSize; ++i) {
-    SetSongProgress(0);
+  const QString filename = task.song_info_.song_.url().toLocalFile();
+  qLog(Info) << "Processing" << filename;
 
-    if (tasks_pending_.isEmpty()) break;
+  // Get the preset
+  const TranscoderPreset preset = Transcoder::PresetForFileType(dest_type);
+  qLog(Debug) << "Transcoding with" << preset.name_;
 
-    Task task = tasks_pending_.takeFirst();
-    qLog(Info) << "Processing" << task.song_info_.song_.url().toLocalFile();
+  task.transcoded_filename_ = transcoder_->GetFile(filename, preset);
+  task.new_extension_ = preset.extension_;
+  task.new_filetype_ = dest_type;
+  tasks_transcoding_[filename] = task;
+  qLog(Debug) << "Transcoding to" << task.transcoded_filename_;
 
-    // Use a Song instead of a tag reader
-    Song song = task.song_info_.song_;
-    if (!song.is_valid()) continue;
+  StageStarted(&transcode_statistics_);
 
-    // Maybe this file is one that's been transcoded already?
-    if (!task.transcoded_filename_.isEmpty()) {
-      qLog(Debug) << "This file has already been transcoded";
+  // Start the transcoding - this will happen in the background and FileTranscoded() will get called when it's done.
+  // At that point the task will get queued for copying with the new filename.
+  transcoder_->AddJob(filename, preset, task.transcoded_filename_);
+  transcoder_->Start();
 
-      // Set the new filetype on the song so the formatter gets it right
-      song.set_filetype(task.new_filetype_);
+}
 
-      // Fiddle the filename extension as well to match the new type
-      song.set_url(QUrl::fromLocalFile(Utilities::FiddleFileExtension(song.basefilename(), task.new_extension_)));
-      song.set_basefilename(Utilities::FiddleFileExtension(song.basefilename(), task.new_extension_));
-      task.song_info_.new_filename_ = Utilities::FiddleFileExtension(task.song_info_.new_filename_, task.new_extension_);
+void Organize::StartCopy(Task task) {
 
-      // Have to set this to the size of the new file or else funny stuff happens
-      song.set_filesize(QFileInfo(task.transcoded_filename_).size());
-    }
-    else {
-      // Figure out if we need to transcode it
-      Song::FileType dest_type = CheckTranscode(song.filetype());
-      if (dest_type != Song::FileType::Unknown) {
-        // Get the preset
-        TranscoderPreset preset = Transcoder::PresetForFileType(dest_type);
-        qLog(Debug) << "Transcoding with" << preset.name_;
-
-        task.transcoded_filename_ = transcoder_->GetFile(task.song_info_.song_.url().toLocalFile(), preset);
-        task.new_extension_ = preset.extension_;
-        task.new_filetype_ = dest_type;
-        tasks_transcoding_[task.song_info_.song_.url().toLocalFile()] = task;
-        qLog(Debug) << "Transcoding to" << task.transcoded_filename_;
-
-        // Start the transcoding - this will happen in the background and FileTranscoded() will get called when it's done.
-        // At that point the task will get re-added to the pending queue with the new filename.
-        transcoder_->AddJob(task.song_info_.song_.url().toLocalFile(), preset, task.transcoded_filename_);
-        transcoder_->Start();
-        continue;
-      }
-    }
+  qLog(Info) << "Copying" << task.song_info_.song_.url().toLocalFile();
 
-    MusicStorage::CopyJob job;
-    job.source_ = task.transcoded_filename_.isEmpty() ? task.song_info_.song_.url().toLocalFile() : task.transcoded_filename_;
-    job.destination_ = task.song_info_.new_filename_;
-    job.metadata_ = song;
-    job.overwrite_ = overwrite_;
-    job.albumcover_ = albumcover_;
-    job.remove_original_ = !copy_;
-    job.playlist_ = playlist_;
-
-    if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.art_unset()) {
-      if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().path();
-      }
+  // Use a Song instead of a tag reader
+  Song song = task.song_info_.song_;
+
+  // Maybe this file is one that's been transcoded already?
+  const bool transcoded = !task.transcoded_filename_.isEmpty();
+  if (transcoded) {
+    // Set the new filetype on the song so the formatter gets it right
+    song.set_filetype(task.new_filetype_);
+
+    // Fiddle the filename extension as well to match the new type
+    song.set_url(QUrl::fromLocalFile(Utilities::FiddleFileExtension(song.basefilename(), task.new_extension_)));
+    song.set_basefilename(Utilities::FiddleFileExtension(song.basefilename(), task.new_extension_));
+    task.song_info_.new_filename_ = Utilities::FiddleFileExtension(task.song_info_.new_filename_, task.new_extension_);
+
+    // Have to set this to the size of the new file or else funny stuff happens
+    song.set_filesize(QFileInfo(task.transcoded_filename_).size());
+  }
+
+  MusicStorage::CopyJob job;
+  job.source_ = transcoded ? task.transcoded_filename_ : task.song_info_.song_.url().toLocalFile();
+  job.destination_ = task.song_info_.new_filename_;
+  job.metadata_ = song;
+  job.overwrite_ = overwrite_;
+  job.albumcover_ = albumcover_;
+  job.remove_original_ = !copy_;
+  job.playlist_ = playlist_;
+
+  bool load_embedded_cover = false;
+  if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.art_unset()) {
+    if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
     }
-    else if (task.song_info_.song_.art_automatic_is_valid()) {
-      if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().path();
-      }
+    else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().path();
     }
-    else if (destination_->source() == Song::Source::Device) {
-      const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(task.song_info_.song_.url().toLocalFile(), job.cover_image_);
-      if (!result.success()) {
-        qLog(Error) << "Could not load embedded art from" << task.song_info_.song_.url() << result.error_string();
-      }
+  }
+  else if (task.song_info_.song_.art_automatic_is_valid()) {
+    if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
+    }
+    else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().path();
     }
+  }
+  else if (destination_->source() == Song::Source::Device) {
+    load_embedded_cover = true;
+  }
+
+  if (!job.cover_source_.isEmpty()) {
+    job.cover_dest_ = QFileInfo(job.destination_).path() + QLatin1Char('/') + QFileInfo(job.cover_source_).fileName();
+  }
+
+  const int copy_id = next_copy_id_++;
+  {
+    QMutexLocker l(&mutex_copy_progress_);
+    copy_progress_.insert(copy_id, transcoded ? 50 : 0);
+  }
+  job.progress_ = std::bind(&Organize::SetSongProgress, this, copy_id, std::placeholders::_1, transcoded);
+
+  ++tasks_copying_;
+  StageStarted(&copy_statistics_);
+
+  QFuture<CopyResult> future = QtConcurrent::run(copy_threadpool_, &Organize::RunCopyJob, this, job, task.song_info_.song_, load_embedded_cover, task.transcoded_filename_);
+  QFutureWatcher<CopyResult> *watcher = new QFutureWatcher<CopyResult>();
+  QObject::connect(watcher, &QFutureWatcher<CopyResult>::finished, this, [this, watcher, copy_id, task, song]() {
+    const CopyResult result = watcher->result();
+    watcher->deleteLater();
+    CopyFinished(copy_id, task, song, result);
+  });
+  watcher->setFuture(future);
+
+}
 
-    if (!job.cover_source_.isEmpty()) {
-      job.cover_dest_ = QFileInfo(job.destination_).path() + QLatin1Char('/') + QFileInfo(job.cover_source_).fileName();
+Organize::CopyResult Organize::RunCopyJob(MusicStorage::CopyJob job, const Song &original_song, const bool load_embedded_cover, const QString &transcoded_filename) {
+
+  // Runs in the copy thread pool, at most MaxConcurrentCopies() of these run at the same time.
+  if (load_embedded_cover) {
+    const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(original_song.url().toLocalFile(), job.cover_image_, EmbeddedCoverCache::AlbumKey(original_song));
+    if (!result.success()) {
+      qLog(Error) << "Could not load embedded art from" << original_song.url() << result.error_string();
     }
+  }
+
+  CopyResult result;
+  result.success_ = destination_->CopyToStorage(job, result.error_text_);
+  if (result.success_) {
+    result.bytes_ = job.metadata_.filesize();
+  }
+
+  // Clean up the temporary transcoded file
+  if (!transcoded_filename.isEmpty()) {
+    QFile::remove(transcoded_filename);
+  }
 
-    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
+  return result;
 
-    QString error_text;
-    if (destination_->CopyToStorage(job, error_text)) {
-      if (job.remove_original_ && song.is_collection_song() && destination_->source() == Song::Source::Collection) {
-        // Notify other aspects of system that song has been invalidated
-        QString root = destination_->LocalPath();
-        QFileInfo new_file = QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
-        Q_EMIT SongPathChanged(song, new_file, destination_->collection_directory_id());
+}
+
+void Organize::CopyFinished(const int copy_id, const Task &task, const Song &song, const CopyResult &result) {
+
+  --tasks_copying_;
+  {
+    QMutexLocker l(&mutex_copy_progress_);
+    copy_progress_.remove(copy_id);
+  }
+
+  if (result.success_) {
+    StageFinished(&copy_statistics_, 1, result.bytes_);
+    if (!copy_ && song.is_collection_song() && destination_->source() == Song::Source::Collection) {
+      // Notify other aspects of system that song has been invalidated, the new paths are sent to the collection in batches.
+      StageStarted(&path_statistics_);
+      QString root = destination_->LocalPath();
+      moved_songs_ << song;
+      moved_files_ << QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
+      if (moved_songs_.count() >= kPathChangesBatchSize) {
+        FlushPathChanges();
       }
     }
-    else {
-      files_with_errors_ << task.song_info_.song_.basefilename();
-      if (!error_text.isEmpty()) {
-        log_ << error_text;
-      }
+  }
+  else {
+    files_with_errors_ << task.song_info_.song_.basefilename();
+    if (!result.error_text_.isEmpty()) {
+      log_ << result.error_text_;
     }
+  }
 
-    // Clean up the temporary transcoded file
-    if (!task.transcoded_filename_.isEmpty()) {
-      QFile::remove(task.transcoded_filename_);
-    }
+  tasks_complete_++;
 
-    tasks_complete_++;
-  }
-  SetSongProgress(0);
+  ProcessSomeFiles();
+
+}
+
+void Organize::FlushPathChanges() {
+
+  if (moved_songs_.isEmpty()) return;
+
+  StageFinished(&path_statistics_, static_cast<int>(moved_songs_.count()), 0);
+  Q_EMIT SongPathsChanged(moved_songs_, moved_files_, destination_->collection_directory_id());
+  moved_songs_.clear();
+  moved_files_.clear();
+
+}
+
+void Organize::FinishOrganize() {
 
-  if (!process_files_timer_->isActive()) {
-    process_files_timer_->start();
+  FlushPathChanges();
+
+  progress_timer_.stop();
+  UpdateProgress();
+
+  QString error_text;
+  if (!destination_->FinishCopy(files_with_errors_.isEmpty(), error_text) && !error_text.isEmpty()) {
+    log_ << error_text;
   }
+  if (eject_after_) destination_->Eject();
+
+  LogStageStatistics("Transcoded", transcode_statistics_);
+  LogStageStatistics("Copied", copy_statistics_);
+  LogStageStatistics("Updated paths of", path_statistics_);
+
+  task_manager_->SetTaskFinished(task_id_);
+
+  Q_EMIT Finished(files_with_errors_, log_);
 
+  // Move back to the original thread so deleteLater() can get called in the main thread's event loop
+  moveToThread(original_thread_);
+  deleteLater();
+
+  // Stop this thread
+  thread_->quit();
+  finished_ = true;
 
 }
 
@@ -319,11 +415,12 @@ Song::FileType Organize::CheckTranscode(Song::FileType original_type) const {
 
 }
 
-void Organize::SetSongProgress(float progress, bool transcoded) {
+void Organize::SetSongProgress(const int copy_id, const float progress, const bool transcoded) {
 
+  // Called from the copy threads, the progress is picked up by UpdateProgress().
   const int max = transcoded ? 50 : 100;
-  current_copy_progress_ = (transcoded ? 50 : 0) + qBound(0, static_cast<int>(progress * static_cast<float>(max)), max - 1);
-  UpdateProgress();
+  QMutexLocker l(&mutex_copy_progress_);
+  copy_progress_[copy_id] = (transcoded ? 50 : 0) + qBound(0, static_cast<int>(progress * static_cast<float>(max)), max - 1);
 
 }
 
@@ -343,17 +440,20 @@ void Organize::UpdateProgress() {
   // Files that need transcoding total 50 for the transcode and 50 for the copy, files that only need to be copied total 100.
   int progress = tasks_complete_ * 100;
 
-  for (const Task &task : std::as_const(tasks_pending_)) {
-    progress += qBound(0, static_cast<int>(task.transcode_progress_ * 50), 50);
-  }
-
   const QList<Task> tasks_transcoding = tasks_transcoding_.values();
   for (const Task &task : tasks_transcoding) {
     progress += qBound(0, static_cast<int>(task.transcode_progress_ * 50), 50);
   }
 
-  // Add the progress of the track that's currently copying
-  progress += current_copy_progress_;
+  progress += static_cast<int>(tasks_transcoded_.count()) * 50;
+
+  // Add the progress of the tracks that are currently copying
+  {
+    QMutexLocker l(&mutex_copy_progress_);
+    for (const int copy_progress : std::as_const(copy_progress_)) {
+      progress += copy_progress;
+    }
+  }
 
   task_manager_->SetTaskProgress(task_id_, progress, total);
 
@@ -361,22 +461,18 @@ void Organize::UpdateProgress() {
 
 void Organize::FileTranscoded(const QString &input, const QString &output, bool success) {
 
-  Q_UNUSED(output);
-
   qLog(Info) << "File finished" << input << success;
-  transcode_progress_timer_.stop();
 
   Task task = tasks_transcoding_.take(input);
-  if (!success) {
-    files_with_errors_ << input;
+  if (success) {
+    StageFinished(&transcode_statistics_, 1, QFileInfo(output).size());
+    tasks_transcoded_ << task;
   }
   else {
-    tasks_pending_ << task;
+    files_with_errors_ << input;
   }
 
-  if (!process_files_timer_->isActive()) {
-    process_files_timer_->start();
-  }
+  ProcessSomeFiles();
 
 }
 
@@ -384,12 +480,38 @@ void Organize::timerEvent(QTimerEvent *e) {
 
   QObject::timerEvent(e);
 
-  if (e->timerId() == transcode_progress_timer_.timerId()) {
+  if (e->timerId() == progress_timer_.timerId()) {
     UpdateProgress();
   }
 
 }
 
+void Organize::StageStarted(StageStatistics *stage) const {
+
+  if (stage->start_msec_ < 0) {
+    stage->start_msec_ = elapsed_.elapsed();
+  }
+
+}
+
+void Organize::StageFinished(StageStatistics *stage, const int files, const qint64 bytes) const {
+
+  stage->files_ += files;
+  stage->bytes_ += bytes;
+  stage->end_msec_ = elapsed_.elapsed();
+
+}
+
+void Organize::LogStageStatistics(const char *name, const StageStatistics &stage) {
+
+  if (stage.files_ == 0) return;
+
+  const double seconds = static_cast<double>(std::max(1LL, static_cast<long long>(stage.end_msec_ - stage.start_msec_))) / 1000.0;
+  const double megabytes = static_cast<double>(stage.bytes_) / 1048576.0;
+  qLog(Info) << name << stage.files_ << "files," << megabytes << "MB in" << seconds << "seconds:" << static_cast<double>(stage.files_) / seconds << "files/s," << megabytes / seconds << "MB/s";
+
+}
+
 void Organize::LogLine(const QString &message) {
 
   QString date(QDateTime::currentDateTime().toString(Qt::TextDate));
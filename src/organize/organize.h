@@ -28,24 +28,26 @@
 
 #include <QObject>
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QSet>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/musicstorage.h"
 #include "organizeformat.h"
 
 class QThread;
-class QTimer;
+class QThreadPool;
 class QTimerEvent;
 
 class TaskManager;
 class TagReaderClient;
-class MusicStorage;
 class Transcoder;
 
 class Organize : public QObject {
@@ -80,7 +82,7 @@ class Organize : public QObject {
  Q_SIGNALS:
   void Finished(const QStringList &files_with_errors, const QStringList&);
   void FileCopied(const int database_id);
-  void SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id);
+  void SongPathsChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id);
 
  protected:
   void timerEvent(QTimerEvent *e) override;
@@ -90,11 +92,6 @@ class Organize : public QObject {
   void FileTranscoded(const QString &input, const QString &output, bool success);
   void LogLine(const QString &message);
 
- private:
-  void SetSongProgress(float progress, bool transcoded = false);
-  void UpdateProgress();
-  Song::FileType CheckTranscode(Song::FileType original_type) const;
-
  private:
   struct Task {
     explicit Task(const NewSongInfo &song_info = NewSongInfo())
@@ -108,12 +105,41 @@ class Organize : public QObject {
     Song::FileType new_filetype_;
   };
 
+  struct CopyResult {
+    CopyResult() : success_(false), bytes_(0) {}
+    bool success_;
+    QString error_text_;
+    qint64 bytes_;
+  };
+
+  // Files and bytes that went through a stage of the pipeline, and when the stage was first started and last finished.
+  struct StageStatistics {
+    StageStatistics() : files_(0), bytes_(0), start_msec_(-1), end_msec_(0) {}
+    int files_;
+    qint64 bytes_;
+    qint64 start_msec_;
+    qint64 end_msec_;
+  };
+
+  void StartTranscode(Task task, const Song::FileType dest_type);
+  void StartCopy(Task task);
+  CopyResult RunCopyJob(MusicStorage::CopyJob job, const Song &original_song, const bool load_embedded_cover, const QString &transcoded_filename);
+  void CopyFinished(const int copy_id, const Task &task, const Song &song, const CopyResult &result);
+  void FlushPathChanges();
+  void FinishOrganize();
+  void SetSongProgress(const int copy_id, const float progress, const bool transcoded);
+  void UpdateProgress();
+  Song::FileType CheckTranscode(Song::FileType original_type) const;
+  void StageStarted(StageStatistics *stage) const;
+  void StageFinished(StageStatistics *stage, const int files, const qint64 bytes) const;
+  static void LogStageStatistics(const char *name, const StageStatistics &stage);
+
   QThread *thread_;
   QThread *original_thread_;
   const SharedPtr<TaskManager> task_manager_;
   const SharedPtr<TagReaderClient> tagreader_client_;
   Transcoder *transcoder_;
-  QTimer *process_files_timer_;
+  QThreadPool *copy_threadpool_;
   const SharedPtr<MusicStorage> destination_;
   QList<Song::FileType> supported_filetypes_;
 
@@ -125,17 +151,29 @@ class Organize : public QObject {
   quint64 task_count_;
   const QString playlist_;
 
-  QBasicTimer transcode_progress_timer_;
+  QBasicTimer progress_timer_;
   QList<Task> tasks_pending_;
   QMap<QString, Task> tasks_transcoding_;
+  QList<Task> tasks_transcoded_;
+  int tasks_copying_;
   int tasks_complete_;
 
   bool started_;
 
   int task_id_;
-  int current_copy_progress_;
+  int next_copy_id_;
+  QMutex mutex_copy_progress_;
+  QMap<int, int> copy_progress_;
   bool finished_;
 
+  QElapsedTimer elapsed_;
+  StageStatistics transcode_statistics_;
+  StageStatistics copy_statistics_;
+  StageStatistics path_statistics_;
+
+  SongList moved_songs_;
+  QList<QFileInfo> moved_files_;
+
   QStringList files_with_errors_;
   QStringList log_;
 };
@@ -204,7 +204,7 @@ void OrganizeDialog::accept() {
   QObject::connect(organize, &Organize::Finished, this, &OrganizeDialog::OrganizeFinished);
   QObject::connect(organize, &Organize::FileCopied, this, &OrganizeDialog::FileCopied);
   if (collection_backend_) {
-    QObject::connect(organize, &Organize::SongPathChanged, &*collection_backend_, &CollectionBackend::SongPathChanged);
+    QObject::connect(organize, &Organize::SongPathsChanged, &*collection_backend_, &CollectionBackend::SongPathsChanged);
   }
 
   organize->Start();
@@ -321,6 +321,23 @@ void OrganizeDialog::LoadSettings() {
 
 }
 
+OrganizeFormat OrganizeDialog::SavedFormat() {
+
+  Settings s;
+  s.beginGroup(kSettingsGroup);
+  OrganizeFormat format;
+  format.set_format(s.value("format", QLatin1String(kDefaultFormat)).toString());
+  format.set_remove_problematic(s.value("remove_problematic", true).toBool());
+  format.set_remove_non_fat(s.value("remove_non_fat", false).toBool());
+  format.set_remove_non_ascii(s.value("remove_non_ascii", false).toBool());
+  format.set_allow_ascii_ext(s.value("allow_ascii_ext", false).toBool());
+  format.set_replace_spaces(s.value("replace_spaces", true).toBool());
+  s.endGroup();
+
+  return format;
+
+}
+
 void OrganizeDialog::SaveSettings() {
 
   Settings s;
@@ -76,6 +76,9 @@ class OrganizeDialog : public QDialog {
 
   static Organize::NewSongInfoList ComputeNewSongsFilenames(const SongList &songs, const OrganizeFormat &format, const QString &extension = QString());
 
+  // The naming options last used in the dialog.
+  static OrganizeFormat SavedFormat();
+
   void SetPlaylist(const QString &playlist);
 
  protected:
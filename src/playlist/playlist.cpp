@@ -29,6 +29,8 @@
 #include <unordered_map>
 #include <random>
 #include <chrono>
+#include <optional>
+#include <vector>
 
 #include <QObject>
 #include <QCoreApplication>
@@ -57,6 +59,9 @@
 #include <QFlags>
 #include <QSettings>
 #include <QTimer>
+#include <QCache>
+#include <QCollator>
+#include <QCollatorSortKey>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -122,6 +127,92 @@ constexpr qint64 kMaxScrobblePointNsecs = 240LL * kNsecPerSec;
 
 constexpr int kMaxPlayedIndexes = 100;
 
+// Rows with cached display values, enough for several screens of scrolling.
+constexpr int kDisplayCacheSize = 2000;
+
+// Playlists larger than this are sorted in a background thread.
+constexpr int kAsyncSortMinItems = 5000;
+
+// Snapshot of an item's metadata, taken in the GUI thread so sorting in another thread doesn't read items that are being changed.
+class PlaylistSortItem {
+ public:
+  explicit PlaylistSortItem(PlaylistItemPtr _item) : item(_item), metadata(_item->Metadata()), url(_item->Url()) {}
+  PlaylistItemPtr item;
+  Song metadata;
+  QUrl url;
+  std::optional<QCollatorSortKey> sort_key;
+};
+
+using PlaylistSortItems = std::vector<PlaylistSortItem>;
+
+PlaylistSortItems CreatePlaylistSortItems(const PlaylistItemPtrList &items) {
+
+  PlaylistSortItems sort_items;
+  sort_items.reserve(static_cast<size_t>(items.count()));
+  for (const PlaylistItemPtr &item : items) {
+    sort_items.emplace_back(item);
+  }
+
+  return sort_items;
+
+}
+
+// Only uses the snapshot, safe to call from any thread.
+PlaylistItemPtrList SortPlaylistItems(PlaylistSortItems sort_items, const Playlist::Column column, const Qt::SortOrder order) {
+
+  using Column = Playlist::Column;
+
+  QCollator collator;
+  collator.setCaseSensitivity(column == Column::Filename ? Qt::CaseSensitive : Qt::CaseInsensitive);
+
+  for (PlaylistSortItem &sort_item : sort_items) {
+    // Compute the collation key for the sort column once per item instead of lowering and comparing strings for every comparison.
+    switch (column) {
+      case Column::Title:       sort_item.sort_key = collator.sortKey(sort_item.metadata.title_sortable()); break;
+      case Column::Artist:      sort_item.sort_key = collator.sortKey(sort_item.metadata.artist_sortable()); break;
+      case Column::Album:       sort_item.sort_key = collator.sortKey(sort_item.metadata.album_sortable()); break;
+      case Column::Genre:       sort_item.sort_key = collator.sortKey(sort_item.metadata.genre()); break;
+      case Column::AlbumArtist: sort_item.sort_key = collator.sortKey(sort_item.metadata.playlist_albumartist_sortable()); break;
+      case Column::Composer:    sort_item.sort_key = collator.sortKey(sort_item.metadata.composer()); break;
+      case Column::Performer:   sort_item.sort_key = collator.sortKey(sort_item.metadata.performer()); break;
+      case Column::Grouping:    sort_item.sort_key = collator.sortKey(sort_item.metadata.grouping()); break;
+      case Column::Comment:     sort_item.sort_key = collator.sortKey(sort_item.metadata.comment()); break;
+      case Column::Filename:    sort_item.sort_key = collator.sortKey(sort_item.url.path()); break;
+      default:
+        break;
+    }
+  }
+
+  const auto less_than = [column](const PlaylistSortItem &a, const PlaylistSortItem &b) {
+    if (a.sort_key.has_value() && b.sort_key.has_value()) {
+      const int result = a.sort_key->compare(*b.sort_key);
+      // When sorting by album, also take into account discs and tracks.
+      if (result == 0 && column == Column::Album) {
+        if (a.metadata.disc() != b.metadata.disc()) return a.metadata.disc() < b.metadata.disc();
+        return a.metadata.track() < b.metadata.track();
+      }
+      return result < 0;
+    }
+    return Playlist::CompareSongs(column, a.metadata, b.metadata);
+  };
+
+  if (order == Qt::AscendingOrder) {
+    std::stable_sort(sort_items.begin(), sort_items.end(), less_than);
+  }
+  else {
+    std::stable_sort(sort_items.begin(), sort_items.end(), [less_than](const PlaylistSortItem &a, const PlaylistSortItem &b) { return less_than(b, a); });
+  }
+
+  PlaylistItemPtrList sorted_items;
+  sorted_items.reserve(static_cast<qsizetype>(sort_items.size()));
+  for (const PlaylistSortItem &sort_item : sort_items) {
+    sorted_items << sort_item.item;
+  }
+
+  return sorted_items;
+
+}
+
 } // namespace
 
 Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
@@ -156,13 +247,19 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       scrobble_point_(-1),
       auto_sort_(false),
       sort_column_(Column::Title),
-      sort_order_(Qt::AscendingOrder) {
+      sort_order_(Qt::AscendingOrder),
+      sort_id_(0),
+      display_cache_(kDisplayCacheSize),
+      display_cache_serial_(0) {
 
   undo_stack_->setUndoLimit(kUndoStackSize);
 
   QObject::connect(this, &Playlist::rowsInserted, this, &Playlist::PlaylistChanged);
   QObject::connect(this, &Playlist::rowsRemoved, this, &Playlist::PlaylistChanged);
 
+  QObject::connect(this, &Playlist::dataChanged, this, &Playlist::InvalidateDisplayCache);
+  QObject::connect(this, &Playlist::modelReset, this, &Playlist::ClearDisplayCache);
+
   Restore();
 
   filter_->setSourceModel(this);
@@ -288,6 +385,101 @@ bool Playlist::set_column_value(Song &song, const Playlist::Column column, const
 
 }
 
+QVariant Playlist::DisplayValue(const Song &song, const Column column, const int role) {
+
+  // Don't forget to change Playlist::CompareItems when adding new columns
+  switch (column) {
+    case Column::Title:              return song.PrettyTitle();
+    case Column::Artist:             return song.artist();
+    case Column::Album:              return song.album();
+    case Column::Length:             return song.length_nanosec();
+    case Column::Track:              return song.track();
+    case Column::Disc:               return song.disc();
+    case Column::Year:               return song.year();
+    case Column::OriginalYear:       return song.effective_originalyear();
+    case Column::Genre:              return song.genre();
+    case Column::AlbumArtist:        return song.playlist_albumartist();
+    case Column::Composer:           return song.composer();
+    case Column::Performer:          return song.performer();
+    case Column::Grouping:           return song.grouping();
+
+    case Column::PlayCount:          return song.playcount();
+    case Column::SkipCount:          return song.skipcount();
+    case Column::LastPlayed:         return song.lastplayed();
+
+    case Column::Samplerate:         return song.samplerate();
+    case Column::Bitdepth:           return song.bitdepth();
+    case Column::Bitrate:            return song.bitrate();
+
+    case Column::Filename:           return song.effective_stream_url();
+    case Column::BaseFilename:       return song.basefilename();
+    case Column::Filesize:           return song.filesize();
+    case Column::Filetype:           return QVariant::fromValue(song.filetype());
+    case Column::DateModified:       return song.mtime();
+    case Column::DateCreated:        return song.ctime();
+
+    case Column::Comment:
+      if (role == Qt::DisplayRole)  return song.comment().simplified();
+      return song.comment();
+
+    case Column::EBUR128IntegratedLoudness: return song.ebur128_integrated_loudness_lufs().has_value() ? song.ebur128_integrated_loudness_lufs().value() : QVariant();
+
+    case Column::EBUR128LoudnessRange: return song.ebur128_loudness_range_lu().has_value() ? song.ebur128_loudness_range_lu().value() : QVariant();
+
+    case Column::Source:             return QVariant::fromValue(song.source());
+
+    case Column::Rating:             return song.rating();
+
+    case Column::HasCUE:             return song.has_cue();
+
+    case Column::Mood:
+    case Column::ColumnCount:
+      break;
+
+  }
+
+  return QVariant();
+
+}
+
+const Playlist::DisplayCacheEntry *Playlist::DisplayCache(const int row) const {
+
+  const PlaylistItemPtr &item = items_[row];
+  DisplayCacheEntry *entry = display_cache_.object(&*item);
+  if (entry) return entry;
+
+  // Copy the metadata once for all columns of the row.
+  const Song song = item->Metadata();
+
+  entry = new DisplayCacheEntry;
+  entry->item = item;
+  entry->key = ++display_cache_serial_;
+  entry->values.reserve(ColumnCount);
+  for (int column = 0; column < ColumnCount; ++column) {
+    entry->values << DisplayValue(song, static_cast<Column>(column), Qt::DisplayRole);
+  }
+  display_cache_.insert(&*item, entry);
+
+  return entry;
+
+}
+
+void Playlist::InvalidateDisplayCache(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+
+  if (!top_left.isValid() || !bottom_right.isValid()) return;
+
+  for (int row = top_left.row(); row <= bottom_right.row() && row < items_.count(); ++row) {
+    display_cache_.remove(&*items_[row]);
+  }
+
+}
+
+void Playlist::ClearDisplayCache() {
+
+  display_cache_.clear();
+
+}
+
 QVariant Playlist::data(const QModelIndex &idx, const int role) const {
 
   if (!idx.isValid()) {
@@ -310,65 +502,15 @@ QVariant Playlist::data(const QModelIndex &idx, const int role) const {
     case Role_CanSetRating:
       return static_cast<Column>(idx.column()) == Column::Rating && items_[idx.row()]->IsLocalCollectionItem() && items_[idx.row()]->Metadata().id() != -1;
 
-    case Qt::EditRole:
-    case Qt::ToolTipRole:
-    case Qt::DisplayRole:{
-      PlaylistItemPtr item = items_[idx.row()];
-      Song song = item->Metadata();
-
-      // Don't forget to change Playlist::CompareItems when adding new columns
-      switch (static_cast<Column>(idx.column())) {
-        case Column::Title:              return song.PrettyTitle();
-        case Column::Artist:             return song.artist();
-        case Column::Album:              return song.album();
-        case Column::Length:             return song.length_nanosec();
-        case Column::Track:              return song.track();
-        case Column::Disc:               return song.disc();
-        case Column::Year:               return song.year();
-        case Column::OriginalYear:       return song.effective_originalyear();
-        case Column::Genre:              return song.genre();
-        case Column::AlbumArtist:        return song.playlist_albumartist();
-        case Column::Composer:           return song.composer();
-        case Column::Performer:          return song.performer();
-        case Column::Grouping:           return song.grouping();
-
-        case Column::PlayCount:          return song.playcount();
-        case Column::SkipCount:          return song.skipcount();
-        case Column::LastPlayed:         return song.lastplayed();
-
-        case Column::Samplerate:         return song.samplerate();
-        case Column::Bitdepth:           return song.bitdepth();
-        case Column::Bitrate:            return song.bitrate();
-
-        case Column::Filename:           return song.effective_stream_url();
-        case Column::BaseFilename:       return song.basefilename();
-        case Column::Filesize:           return song.filesize();
-        case Column::Filetype:           return QVariant::fromValue(song.filetype());
-        case Column::DateModified:       return song.mtime();
-        case Column::DateCreated:        return song.ctime();
-
-        case Column::Comment:
-          if (role == Qt::DisplayRole)  return song.comment().simplified();
-          return song.comment();
-
-        case Column::EBUR128IntegratedLoudness: return song.ebur128_integrated_loudness_lufs().has_value() ? song.ebur128_integrated_loudness_lufs().value() : QVariant();
-
-        case Column::EBUR128LoudnessRange: return song.ebur128_loudness_range_lu().has_value() ? song.ebur128_loudness_range_lu().value() : QVariant();
-
-        case Column::Source:             return QVariant::fromValue(song.source());
-
-        case Column::Rating:             return song.rating();
-
-        case Column::HasCUE:             return song.has_cue();
-
-        case Column::Mood:
-        case Column::ColumnCount:
-          break;
+    case Role_DisplayCacheKey:
+      return static_cast<qulonglong>(DisplayCache(idx.row())->key);
 
-      }
+    case Qt::DisplayRole:
+      return DisplayCache(idx.row())->values.value(idx.column());
 
-      return QVariant();
-    }
+    case Qt::EditRole:
+    case Qt::ToolTipRole:
+      return DisplayValue(items_[idx.row()]->Metadata(), static_cast<Column>(idx.column()), role);
 
     case Qt::TextAlignmentRole:
       return QVariant(column_alignments_.value(idx.column(), (Qt::AlignLeft | Qt::AlignVCenter)));
@@ -438,6 +580,7 @@ bool Playlist::setData(const QModelIndex &idx, const QVariant &value, const int
   }
   else if (song.is_radio()) {
     item->SetMetadata(song);
+    Q_EMIT dataChanged(idx.sibling(row, 0), idx.sibling(row, ColumnCount - 1));
     ScheduleSave();
   }
 
@@ -642,6 +785,26 @@ int Playlist::next_row(const bool ignore_repeat_track) {
 
 }
 
+QList<int> Playlist::next_rows(const int count) const {
+
+  QList<int> rows;
+
+  for (int i = 0; i < queue_->rowCount() && rows.count() < count; ++i) {
+    rows << queue_->mapToSource(queue_->index(i, 0)).row();
+  }
+
+  int virtual_index = current_virtual_index_;
+  while (rows.count() < count) {
+    virtual_index = NextVirtualIndex(virtual_index, true);
+    if (virtual_index < 0 || virtual_index >= virtual_items_.count()) break;
+    const int row = virtual_items_.value(virtual_index);
+    if (!rows.contains(row)) rows << row;
+  }
+
+  return rows;
+
+}
+
 int Playlist::previous_row(const bool ignore_repeat_track) {
 
   while (!played_indexes_.isEmpty()) {
@@ -1231,51 +1394,54 @@ void Playlist::UpdateItems(SongList songs) {
 
   qLog(Debug) << "Updating playlist with new tracks' info";
 
-  // We first convert our songs list into a linked list (a 'real' list), because removals are faster with QLinkedList.
-  // Next, we walk through the list of playlist's items then the list of songs
-  // we want to update: if an item corresponds to the song (we rely on URL for this), we update the item with the new metadata,
-  // then we remove song from our list because we will not need to check it again.
+  // We first index the songs we want to update by URL, so that updating is a single walk through the list of playlist's items,
+  // even when the songs arrive in many small batches: if an item corresponds to a song (we rely on URL for this),
+  // we update the item with the new metadata, then we take the song out of the index because we will not need to check it again.
   // And we also update undo actions.
 
-  for (int i = 0; i < items_.size(); i++) {
+  QHash<QUrl, SongList> songs_by_url;
+  for (const Song &song : std::as_const(songs)) {
+    songs_by_url[song.url()] << song;
+  }
+
+  for (int i = 0; i < items_.size() && !songs_by_url.isEmpty(); i++) {
     // Update current items list
-    QMutableListIterator<Song> it(songs);
-    while (it.hasNext()) {
-      const Song &song = it.next();
-      const PlaylistItemPtr item = items_.value(i);
-      if (item->Metadata().url() == song.url() && (item->Metadata().filetype() == Song::FileType::Unknown || item->Metadata().filetype() == Song::FileType::Stream || item->Metadata().filetype() == Song::FileType::CDDA || !item->Metadata().init_from_file())) {
-        PlaylistItemPtr new_item;
-        if (song.url().isLocalFile()) {
-          if (song.is_collection_song()) {
-            new_item = make_shared<CollectionPlaylistItem>(song);
-            if (collection_items_by_id_.contains(song.id(), item)) collection_items_by_id_.remove(song.id(), item);
-            collection_items_by_id_.insert(song.id(), new_item);
-          }
-          else {
-            new_item = make_shared<SongPlaylistItem>(song);
-          }
-        }
-        else {
-          if (song.is_radio()) {
-            new_item = make_shared<RadioPlaylistItem>(song);
-          }
-          else {
-            new_item = make_shared<StreamPlaylistItem>(song);
-          }
-        }
-        items_[i] = new_item;
-        Q_EMIT dataChanged(index(i, 0), index(i, ColumnCount - 1));
-        // Also update undo actions
-        for (int y = 0; y < undo_stack_->count(); y++) {
-          QUndoCommand *undo_action = const_cast<QUndoCommand*>(undo_stack_->command(i));
-          PlaylistUndoCommandInsertItems *undo_action_insert = dynamic_cast<PlaylistUndoCommandInsertItems*>(undo_action);
-          if (undo_action_insert) {
-            bool found_and_updated = undo_action_insert->UpdateItem(new_item);
-            if (found_and_updated) break;
-          }
-        }
-        it.remove();
-        break;
+    const PlaylistItemPtr item = items_.value(i);
+    if (!(item->Metadata().filetype() == Song::FileType::Unknown || item->Metadata().filetype() == Song::FileType::Stream || item->Metadata().filetype() == Song::FileType::CDDA || !item->Metadata().init_from_file())) {
+      continue;
+    }
+    QHash<QUrl, SongList>::iterator it = songs_by_url.find(item->Metadata().url());
+    if (it == songs_by_url.end()) continue;
+    const Song song = it.value().takeFirst();
+    if (it.value().isEmpty()) songs_by_url.erase(it);
+    PlaylistItemPtr new_item;
+    if (song.url().isLocalFile()) {
+      if (song.is_collection_song()) {
+        new_item = make_shared<CollectionPlaylistItem>(song);
+        if (collection_items_by_id_.contains(song.id(), item)) collection_items_by_id_.remove(song.id(), item);
+        collection_items_by_id_.insert(song.id(), new_item);
+      }
+      else {
+        new_item = make_shared<SongPlaylistItem>(song);
+      }
+    }
+    else {
+      if (song.is_radio()) {
+        new_item = make_shared<RadioPlaylistItem>(song);
+      }
+      else {
+        new_item = make_shared<StreamPlaylistItem>(song);
+      }
+    }
+    items_[i] = new_item;
+    Q_EMIT dataChanged(index(i, 0), index(i, ColumnCount - 1));
+    // Also update undo actions
+    for (int y = 0; y < undo_stack_->count(); y++) {
+      QUndoCommand *undo_action = const_cast<QUndoCommand*>(undo_stack_->command(i));
+      PlaylistUndoCommandInsertItems *undo_action_insert = dynamic_cast<PlaylistUndoCommandInsertItems*>(undo_action);
+      if (undo_action_insert) {
+        bool found_and_updated = undo_action_insert->UpdateItem(new_item);
+        if (found_and_updated) break;
       }
     }
   }
@@ -1331,8 +1497,18 @@ bool Playlist::CompareItems(const Column column, const Qt::SortOrder order, Play
   PlaylistItemPtr a = order == Qt::AscendingOrder ? _a : _b;
   PlaylistItemPtr b = order == Qt::AscendingOrder ? _b : _a;
 
-#define cmp(field) return a->Metadata().field() < b->Metadata().field()
-#define strcmp(field) return QString::localeAwareCompare(a->Metadata().field().toLower(), b->Metadata().field().toLower()) < 0;
+  if (column == Column::Filename) {
+    return QString::localeAwareCompare(a->Url().path(), b->Url().path()) < 0;
+  }
+
+  return CompareSongs(column, a->Metadata(), b->Metadata());
+
+}
+
+bool Playlist::CompareSongs(const Column column, const Song &a, const Song &b) {
+
+#define cmp(field) return a.field() < b.field()
+#define strcmp(field) return QString::localeAwareCompare(a.field().toLower(), b.field().toLower()) < 0;
 
   switch (column) {
     case Column::Title:        strcmp(title_sortable);
@@ -1357,7 +1533,7 @@ bool Playlist::CompareItems(const Column column, const Qt::SortOrder order, Play
     case Column::Samplerate:   cmp(samplerate);
     case Column::Bitdepth:     cmp(bitdepth);
     case Column::Filename:
-      return QString::localeAwareCompare(a->Url().path(), b->Url().path()) < 0;
+      return QString::localeAwareCompare(a.url().path(), b.url().path()) < 0;
     case Column::BaseFilename: cmp(basefilename);
     case Column::Filesize:     cmp(filesize);
     case Column::Filetype:     cmp(filetype);
@@ -1453,6 +1629,12 @@ QString Playlist::abbreviated_column_name(const Column column) {
 
 }
 
+PlaylistItemPtrList Playlist::SortItems(const PlaylistItemPtrList &items, const Column column, const Qt::SortOrder order) {
+
+  return SortPlaylistItems(CreatePlaylistSortItems(items), column, order);
+
+}
+
 void Playlist::sort(const int column_number, const Qt::SortOrder order) {
 
   const Column column = static_cast<Column>(column_number);
@@ -1462,23 +1644,34 @@ void Playlist::sort(const int column_number, const Qt::SortOrder order) {
 
   if (ignore_sorting_) return;
 
-  PlaylistItemPtrList new_items(items_);
-  PlaylistItemPtrList::iterator begin = new_items.begin();
+  // Any sort still running in the background is superseded by this one.
+  const int sort_id = ++sort_id_;
 
-  if (dynamic_playlist_ && current_item_index_.isValid())
-    begin += current_item_index_.row() + 1;
+  const PlaylistItemPtrList old_items = items_;
+  const qint64 sort_begin = dynamic_playlist_ && current_item_index_.isValid() ? current_item_index_.row() + 1 : 0;
+  const PlaylistItemPtrList fixed_items = old_items.mid(0, sort_begin);
+  const PlaylistItemPtrList unsorted_items = old_items.mid(sort_begin);
 
-  if (column == Column::Album) {
-    // When sorting by album, also take into account discs and tracks.
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Track, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Disc, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Album, order, std::placeholders::_1, std::placeholders::_2));
-  }
-  else {
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, column, order, std::placeholders::_1, std::placeholders::_2));
+  if (unsorted_items.count() < kAsyncSortMinItems) {
+    undo_stack_->push(new PlaylistUndoCommandSortItems(this, column, order, fixed_items + SortItems(unsorted_items, column, order)));
+    return;
   }
 
-  undo_stack_->push(new PlaylistUndoCommandSortItems(this, column, order, new_items));
+  // Only the snapshot of the metadata is passed to the sorting thread, the items themselves can be changed meanwhile.
+  QFuture<PlaylistItemPtrList> future = QtConcurrent::run(&SortPlaylistItems, CreatePlaylistSortItems(unsorted_items), column, order);
+  QFutureWatcher<PlaylistItemPtrList> *watcher = new QFutureWatcher<PlaylistItemPtrList>();
+  QObject::connect(watcher, &QFutureWatcher<PlaylistItemPtrList>::finished, this, [this, watcher, sort_id, old_items, fixed_items, column, order]() {
+    const PlaylistItemPtrList sorted_items = watcher->result();
+    watcher->deleteLater();
+    if (sort_id != sort_id_) return;
+    if (items_ != old_items) {
+      // The playlist changed while sorting, start over with the current items.
+      sort(static_cast<int>(column), order);
+      return;
+    }
+    undo_stack_->push(new PlaylistUndoCommandSortItems(this, column, order, fixed_items + sorted_items));
+  });
+  watcher->setFuture(future);
 
 }
 
@@ -31,10 +31,12 @@
 #include <QPersistentModelIndex>
 #include <QFuture>
 #include <QList>
+#include <QCache>
 #include <QMap>
 #include <QMultiMap>
 #include <QMetaType>
 #include <QVariant>
+#include <QVariantList>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -143,6 +145,7 @@ class Playlist : public QAbstractListModel {
     Role_StopAfter,
     Role_QueuePosition,
     Role_CanSetRating,
+    Role_DisplayCacheKey,
   };
 
   enum class AutoScroll {
@@ -158,6 +161,9 @@ class Playlist : public QAbstractListModel {
   static const int kUndoItemLimit;
 
   static bool CompareItems(const Column column, const Qt::SortOrder order, PlaylistItemPtr a, PlaylistItemPtr b);
+  static bool CompareSongs(const Column column, const Song &a, const Song &b);
+  // Sorts items using precomputed collation keys.
+  static PlaylistItemPtrList SortItems(const PlaylistItemPtrList &items, const Column column, const Qt::SortOrder order);
 
   static QString column_name(const Column column);
   static QString abbreviated_column_name(const Column column);
@@ -184,6 +190,8 @@ class Playlist : public QAbstractListModel {
   void reset_last_played() { last_played_item_index_ = QPersistentModelIndex(); }
   void reset_played_indexes() { played_indexes_.clear(); }
   int next_row(const bool ignore_repeat_track = false);
+  // Rows of up to count songs expected to play after the current one, without changing the shuffle order.
+  QList<int> next_rows(const int count) const;
   int previous_row(const bool ignore_repeat_track = false);
 
   QModelIndex current_index() const;
@@ -354,6 +362,19 @@ class Playlist : public QAbstractListModel {
   void TurnOnDynamicPlaylist(PlaylistGeneratorPtr gen);
   void InsertDynamicItems(const int count);
 
+  static QVariant DisplayValue(const Song &song, const Column column, const int role);
+
+  // Display values of a row, kept until the row is changed.
+  class DisplayCacheEntry {
+   public:
+    DisplayCacheEntry() : key(0) {}
+    // Holds on to the item, so that its address is never reused while it is cached.
+    PlaylistItemPtr item;
+    quint64 key;
+    QVariantList values;
+  };
+  const DisplayCacheEntry *DisplayCache(const int row) const;
+
  private Q_SLOTS:
   void TracksAboutToBeDequeued(const QModelIndex&, const int begin, const int end);
   void TracksDequeued();
@@ -364,6 +385,8 @@ class Playlist : public QAbstractListModel {
   void ItemsLoaded();
   void ScheduleSave();
   void Save();
+  void InvalidateDisplayCache(const QModelIndex &top_left, const QModelIndex &bottom_right);
+  void ClearDisplayCache();
 
  private:
   bool is_loading_;
@@ -421,6 +444,10 @@ class Playlist : public QAbstractListModel {
   bool auto_sort_;
   Column sort_column_;
   Qt::SortOrder sort_order_;
+  int sort_id_;
+
+  mutable QCache<const PlaylistItem*, DisplayCacheEntry> display_cache_;
+  mutable quint64 display_cache_serial_;
 };
 
 #endif  // PLAYLIST_H
@@ -27,10 +27,6 @@
 #include <QApplication>
 #include <QObject>
 #include <QWidget>
-#include <QThread>
-#include <QtConcurrentRun>
-#include <QFuture>
-#include <QFutureWatcher>
 #include <QAbstractItemModel>
 #include <QAbstractItemView>
 #include <QCompleter>
@@ -46,15 +42,23 @@
 #include <QUrl>
 #include <QIcon>
 #include <QPixmap>
-#include <QPixmapCache>
 #include <QPainter>
+#include <QPalette>
+#include <QBrush>
+#include <QStaticText>
+#include <QTransform>
+#include <QCache>
+#include <QHash>
 #include <QColor>
 #include <QPen>
 #include <QPoint>
+#include <QPointF>
 #include <QRect>
 #include <QSize>
+#include <QSizeF>
 #include <QLineEdit>
 #include <QScrollBar>
+#include <QStyle>
 #include <QToolTip>
 #include <QTreeView>
 #include <QWhatsThis>
@@ -70,6 +74,7 @@
 #include "collection/collectionbackend.h"
 #include "playlist/playlist.h"
 #include "playlistdelegates.h"
+#include "tagcompletionindex.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -81,6 +86,7 @@ constexpr QRgb kQueueBoxGradientColor1 = qRgb(102, 150, 227);
 constexpr QRgb kQueueBoxGradientColor2 = qRgb(77, 121, 200);
 constexpr int kQueueOpacitySteps = 10;
 constexpr float kQueueOpacityLowerBound = 0.4F;
+constexpr int kTextLayoutCacheSize = 8000;
 }  // namespace
 
 const int PlaylistDelegateBase::kMinHeight = 19;
@@ -92,6 +98,11 @@ QueuedItemDelegate::QueuedItemDelegate(QObject *parent, const int indicator_colu
 void QueuedItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   QStyledItemDelegate::paint(painter, option, idx);
+  DrawQueueIndicator(painter, option, idx);
+
+}
+
+void QueuedItemDelegate::DrawQueueIndicator(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   if (idx.column() == indicator_column_) {
     bool ok = false;
@@ -166,7 +177,7 @@ int QueuedItemDelegate::queue_indicator_size(const QModelIndex &idx) const {
 
 
 PlaylistDelegateBase::PlaylistDelegateBase(QObject *parent, const QString &suffix)
-    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix)
+    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix), row_texts_(kTextLayoutCacheSize)
 {
 }
 
@@ -214,7 +225,9 @@ QSize PlaylistDelegateBase::sizeHint(const QStyleOptionViewItem &option, const Q
 
 void PlaylistDelegateBase::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
-  QueuedItemDelegate::paint(painter, Adjusted(option, idx), idx);
+  const QStyleOptionViewItem adjusted_option = Adjusted(option, idx);
+  DrawItem(painter, adjusted_option, idx);
+  DrawQueueIndicator(painter, adjusted_option, idx);
 
   // Stop after indicator
   if (idx.column() == static_cast<int>(Playlist::Column::Title)) {
@@ -228,6 +241,133 @@ void PlaylistDelegateBase::paint(QPainter *painter, const QStyleOptionViewItem &
 
 }
 
+void PlaylistDelegateBase::DrawItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
+
+  QStyleOptionViewItem opt(option);
+
+  const QWidget *widget = opt.widget;
+  QStyle *style = widget ? widget->style() : QApplication::style();
+
+  bool ok = false;
+  const quint64 row_key = CacheText() ? idx.data(Playlist::Role_DisplayCacheKey).toULongLong(&ok) : 0;
+  if (!ok) {
+    initStyleOption(&opt, idx);
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+    return;
+  }
+
+  // The row key changes every time the row is changed, so entries of old rows just age out of the cache.
+  RowText *row_text = row_texts_.object(row_key);
+  if (!row_text) {
+    row_text = new RowText;
+    row_texts_.insert(row_key, row_text);
+  }
+
+  RowText::iterator column_text = row_text->find(idx.column());
+  if (column_text == row_text->end()) {
+    // Format the value through displayText() once, later paints of the row reuse the text.
+    initStyleOption(&opt, idx);
+    ColumnText new_column_text;
+    new_column_text.text = opt.text;
+    column_text = row_text->insert(idx.column(), new_column_text);
+  }
+  else {
+    InitStyleOption(&opt, idx, column_text->text);
+  }
+
+  if (opt.text.isEmpty() || opt.text.contains(u'\n')) {
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+    return;
+  }
+
+  // Let the style draw the background, selection and focus, and draw the text ourselves.
+  const int text_margin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+  const QRect text_rect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, widget).adjusted(text_margin, 0, -text_margin, 0);
+  opt.text.clear();
+  style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+  if (text_rect.width() <= 0) return;
+
+  const QStaticText &static_text = ElidedTextLayout(&*column_text, opt.font, text_rect.width(), opt.textElideMode);
+  const QSizeF text_size = static_text.size();
+  const Qt::Alignment alignment = QStyle::visualAlignment(opt.direction, opt.displayAlignment);
+
+  qreal x = text_rect.left();
+  if (alignment & Qt::AlignRight) {
+    x = text_rect.left() + text_rect.width() - text_size.width();
+  }
+  else if (alignment & Qt::AlignHCenter) {
+    x = text_rect.left() + (text_rect.width() - text_size.width()) / 2.0;
+  }
+
+  qreal y = text_rect.top() + (text_rect.height() - text_size.height()) / 2.0;
+  if (alignment & Qt::AlignTop) {
+    y = text_rect.top();
+  }
+  else if (alignment & Qt::AlignBottom) {
+    y = text_rect.top() + text_rect.height() - text_size.height();
+  }
+
+  QPalette::ColorGroup color_group = QPalette::Disabled;
+  if (opt.state & QStyle::State_Enabled) {
+    color_group = opt.state & QStyle::State_Active ? QPalette::Normal : QPalette::Inactive;
+  }
+
+  painter->save();
+  painter->setFont(opt.font);
+  painter->setPen(opt.palette.color(color_group, opt.state & QStyle::State_Selected ? QPalette::HighlightedText : QPalette::Text));
+  painter->drawStaticText(QPointF(x, y), static_text);
+  painter->restore();
+
+}
+
+void PlaylistDelegateBase::InitStyleOption(QStyleOptionViewItem *option, const QModelIndex &idx, const QString &text) const {
+
+  // Same as QStyledItemDelegate::initStyleOption(), but with the text already formatted for the row instead of calling displayText().
+  const QVariant font = idx.data(Qt::FontRole);
+  if (font.isValid() && !font.isNull()) {
+    option->font = qvariant_cast<QFont>(font).resolve(option->font);
+    option->fontMetrics = QFontMetrics(option->font);
+  }
+
+  const QVariant alignment = idx.data(Qt::TextAlignmentRole);
+  if (alignment.isValid() && !alignment.isNull()) {
+    option->displayAlignment = alignment.value<Qt::Alignment>();
+  }
+
+  const QVariant foreground = idx.data(Qt::ForegroundRole);
+  if (foreground.canConvert<QBrush>()) {
+    option->palette.setBrush(QPalette::Text, qvariant_cast<QBrush>(foreground));
+  }
+
+  option->index = idx;
+
+  if (!text.isNull()) {
+    option->features |= QStyleOptionViewItem::HasDisplay;
+    option->text = text;
+  }
+
+  option->backgroundBrush = qvariant_cast<QBrush>(idx.data(Qt::BackgroundRole));
+
+}
+
+const QStaticText &PlaylistDelegateBase::ElidedTextLayout(ColumnText *column_text, const QFont &font, const int width, const Qt::TextElideMode elide_mode) {
+
+  if (column_text->width == width && column_text->font == font) {
+    return column_text->static_text;
+  }
+
+  column_text->font = font;
+  column_text->width = width;
+  column_text->static_text.setTextFormat(Qt::PlainText);
+  column_text->static_text.setPerformanceHint(QStaticText::AggressiveCaching);
+  column_text->static_text.setText(QFontMetrics(font).elidedText(column_text->text, elide_mode, width));
+  column_text->static_text.prepare(QTransform(), font);
+
+  return column_text->static_text;
+
+}
+
 QStyleOptionViewItem PlaylistDelegateBase::Adjusted(const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   if (!view_) return option;
@@ -371,63 +511,16 @@ QWidget *TextItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewI
   return new QLineEdit(parent);
 }
 
-TagCompletionModel::TagCompletionModel(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QObject *parent) : QStringListModel(parent) {
+TagCompleter::TagCompleter(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QLineEdit *editor) : QCompleter(editor) {
 
-  QString col = database_column(column);
-  if (!col.isEmpty()) {
-    setStringList(backend->GetAll(col));
+  // The model is shared by all completers for the column and kept sorted, so prefix lookups can use binary search.
+  TagCompletionModel *model = TagCompletionIndex::Instance(backend)->model(column);
+  if (model) {
+    setModel(model);
   }
-
-  if (QThread::currentThread() != backend->thread() && QThread::currentThread() != qApp->thread()) {
-    backend->Close();
-  }
-
-}
-
-QString TagCompletionModel::database_column(const Playlist::Column column) {
-
-  switch (column) {
-    case Playlist::Column::Artist:       return u"artist"_s;
-    case Playlist::Column::Album:        return u"album"_s;
-    case Playlist::Column::AlbumArtist:  return u"albumartist"_s;
-    case Playlist::Column::Composer:     return u"composer"_s;
-    case Playlist::Column::Performer:    return u"performer"_s;
-    case Playlist::Column::Grouping:     return u"grouping"_s;
-    case Playlist::Column::Genre:        return u"genre"_s;
-    default:
-      qLog(Warning) << "Unknown column" << static_cast<int>(column);
-      return QString();
-  }
-
-}
-
-static TagCompletionModel *InitCompletionModel(SharedPtr<CollectionBackend> backend, Playlist::Column column) {
-
-  return new TagCompletionModel(backend, column);
-
-}
-
-TagCompleter::TagCompleter(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QLineEdit *editor) : QCompleter(editor), editor_(editor) {
-
-  QFuture<TagCompletionModel*> future = QtConcurrent::run(&InitCompletionModel, backend, column);
-  QFutureWatcher<TagCompletionModel*> *watcher = new QFutureWatcher<TagCompletionModel*>();
-  QObject::connect(watcher, &QFutureWatcher<TagCompletionModel*>::finished, this, &TagCompleter::ModelReady);
-  watcher->setFuture(future);
-
-}
-
-TagCompleter::~TagCompleter() {
-  delete model();
-}
-
-void TagCompleter::ModelReady() {
-
-  QFutureWatcher<TagCompletionModel*> *watcher = static_cast<QFutureWatcher<TagCompletionModel*>*>(sender());
-  TagCompletionModel *model = watcher->result();
-  watcher->deleteLater();
-  setModel(model);
   setCaseSensitivity(Qt::CaseInsensitive);
-  editor_->setCompleter(this);
+  setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+  editor->setCompleter(this);
 
 }
 
@@ -477,15 +570,15 @@ QString SongSourceDelegate::displayText(const QVariant &value, const QLocale &lo
 
 QPixmap SongSourceDelegate::LookupPixmap(const Song::Source source, const QSize size, const qreal device_pixel_ratio) const {
 
-  QPixmap pixmap;
-  const QString pixmap_cache_key = QStringLiteral("%1-%2x%3-%4").arg(Song::TextForSource(source)).arg(size.width()).arg(size.height()).arg(device_pixel_ratio);
-  if (QPixmapCache::find(pixmap_cache_key, &pixmap)) {
-    return pixmap;
+  const quint64 pixmap_cache_key = (static_cast<quint64>(source) << 48) | (static_cast<quint64>(size.width() & 0xFFFF) << 32) | (static_cast<quint64>(size.height() & 0xFFFF) << 16) | static_cast<quint64>(qRound(device_pixel_ratio * 100.0) & 0xFFFF);
+  QHash<quint64, QPixmap>::const_iterator it = pixmaps_.constFind(pixmap_cache_key);
+  if (it != pixmaps_.constEnd()) {
+    return it.value();
   }
 
   QIcon icon(Song::IconForSource(source));
-  pixmap = icon.pixmap(size, device_pixel_ratio);
-  QPixmapCache::insert(pixmap_cache_key, pixmap);
+  const QPixmap pixmap = icon.pixmap(size, device_pixel_ratio);
+  pixmaps_.insert(pixmap_cache_key, pixmap);
 
   return pixmap;
 
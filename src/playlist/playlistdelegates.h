@@ -24,6 +24,7 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QObject>
 #include <QWidget>
 #include <QAbstractItemView>
@@ -34,6 +35,8 @@
 #include <QLocale>
 #include <QVariant>
 #include <QUrl>
+#include <QHash>
+#include <QCache>
 #include <QPixmap>
 #include <QPainter>
 #include <QRect>
@@ -42,7 +45,7 @@
 #include <QSize>
 #include <QFont>
 #include <QString>
-#include <QStringListModel>
+#include <QStaticText>
 #include <QStyleOption>
 #include <QHelpEvent>
 #include <QLineEdit>
@@ -65,6 +68,9 @@ class QueuedItemDelegate : public QStyledItemDelegate {
 
   int queue_indicator_size(const QModelIndex &idx) const;
 
+ protected:
+  void DrawQueueIndicator(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const;
+
  private:
   int indicator_column_;
 };
@@ -86,9 +92,33 @@ class PlaylistDelegateBase : public QueuedItemDelegate {
  public Q_SLOTS:
   bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &idx) override;
 
+ protected:
+  // Draws the item like QStyledItemDelegate, but with the text formatted and laid out once per row change instead of on every paint.
+  void DrawItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const;
+  // Delegates showing text that changes without the row changing, like the time since an event, are formatted on every paint.
+  virtual bool CacheText() const { return true; }
+
+ private:
+  // Formatted text of a column and its elided layout, kept until the row is changed.
+  class ColumnText {
+   public:
+    ColumnText() : width(-1) {}
+    QString text;
+    QFont font;
+    int width;
+    QStaticText static_text;
+  };
+  using RowText = QHash<int, ColumnText>;
+
+  void InitStyleOption(QStyleOptionViewItem *option, const QModelIndex &idx, const QString &text) const;
+  static const QStaticText &ElidedTextLayout(ColumnText *column_text, const QFont &font, const int width, const Qt::TextElideMode elide_mode);
+
  protected:
   QTreeView *view_;
   QString suffix_;
+
+ private:
+  mutable QCache<quint64, RowText> row_texts_;
 };
 
 class LengthItemDelegate : public PlaylistDelegateBase {
@@ -121,6 +151,9 @@ class LastPlayedItemDelegate : public PlaylistDelegateBase {
  public:
   explicit LastPlayedItemDelegate(QObject *parent) : PlaylistDelegateBase(parent) {}
   QString displayText(const QVariant &value, const QLocale &locale) const override;
+
+ protected:
+  bool CacheText() const override { return false; }
 };
 
 class FileTypeItemDelegate : public PlaylistDelegateBase {
@@ -139,28 +172,11 @@ class TextItemDelegate : public PlaylistDelegateBase {
   QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &idx) const override;
 };
 
-class TagCompletionModel : public QStringListModel {
-  Q_OBJECT
-
- public:
-  explicit TagCompletionModel(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QObject *parent = nullptr);
-
- private:
-  static QString database_column(const Playlist::Column column);
-};
-
 class TagCompleter : public QCompleter {
   Q_OBJECT
 
  public:
   explicit TagCompleter(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QLineEdit *editor);
-  ~TagCompleter() override;
-
- private Q_SLOTS:
-  void ModelReady();
-
- private:
-  QLineEdit *editor_;
 };
 
 class TagCompletionItemDelegate : public PlaylistDelegateBase {
@@ -194,6 +210,9 @@ class SongSourceDelegate : public PlaylistDelegateBase {
 
  private:
   QPixmap LookupPixmap(const Song::Source source, const QSize size, const qreal device_pixel_ratio) const;
+
+ private:
+  mutable QHash<quint64, QPixmap> pixmaps_;
 };
 
 class RatingItemDelegate : public PlaylistDelegateBase {
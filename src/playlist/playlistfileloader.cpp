@@ -0,0 +1,95 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QObject>
+#include <QMetaObject>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QString>
+
+#include "core/song.h"
+#include "playlistparsers/playlistparser.h"
+#include "playlistfileloader.h"
+
+PlaylistFileLoader::PlaylistFileLoader(PlaylistParser *parser, QObject *parent)
+    : QObject(parent),
+      parser_(parser) {}
+
+PlaylistFileLoader::~PlaylistFileLoader() {
+
+  CancelAll();
+
+}
+
+void PlaylistFileLoader::Load(const int id, const QString &filename) {
+
+  Cancel(id);
+
+  QFuture<void> future = QtConcurrent::run([this, parser = parser_, id, filename](QPromise<void> &promise) {
+    parser->LoadFromFile(filename, [this, id, &promise](const SongList &songs) {
+      if (promise.isCanceled()) return false;
+      QMetaObject::invokeMethod(this, [this, id, songs]() {
+        // Chunks already on their way when the load was cancelled are dropped.
+        if (loads_.contains(id)) Q_EMIT ChunkLoaded(id, songs);
+      }, Qt::QueuedConnection);
+      return true;
+    });
+  });
+  QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
+  QObject::connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, id]() {
+    if (loads_.contains(id) && loads_.value(id).isFinished()) {
+      loads_.remove(id);
+    }
+    cancelled_loads_.removeIf([](const QFuture<void> &cancelled_future) { return cancelled_future.isFinished(); });
+    watcher->deleteLater();
+    Q_EMIT LoadFinished(id);
+  });
+  watcher->setFuture(future);
+  loads_.insert(id, future);
+
+}
+
+void PlaylistFileLoader::Cancel(const int id) {
+
+  if (!loads_.contains(id)) return;
+
+  // The worker only stops at the next chunk, keep the future so it can still be waited for.
+  QFuture<void> future = loads_.take(id);
+  future.cancel();
+  cancelled_loads_ << future;
+
+}
+
+void PlaylistFileLoader::CancelAll() {
+
+  const QList<int> ids = loads_.keys();
+  for (const int id : ids) {
+    Cancel(id);
+  }
+
+  for (QFuture<void> &future : cancelled_loads_) {
+    future.waitForFinished();
+  }
+  cancelled_loads_.clear();
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYLISTFILELOADER_H
+#define PLAYLISTFILELOADER_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QFuture>
+#include <QString>
+
+#include "core/song.h"
+
+class PlaylistParser;
+
+// Loads playlist files on worker threads, the songs are passed on in chunks while the file is parsed.
+// Cancelled loads are waited for when the loader is destroyed, so the parser is never used after it is gone.
+class PlaylistFileLoader : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit PlaylistFileLoader(PlaylistParser *parser, QObject *parent = nullptr);
+  ~PlaylistFileLoader() override;
+
+  void Load(const int id, const QString &filename);
+
+  // ChunkLoaded() is not emitted for the ID anymore, LoadFinished() is still emitted when the worker stops.
+  void Cancel(const int id);
+  // Cancels all loads and waits for the workers to stop.
+  void CancelAll();
+
+  bool IsLoading(const int id) const { return loads_.contains(id); }
+  bool IsRunning() const { return !loads_.isEmpty() || !cancelled_loads_.isEmpty(); }
+
+ Q_SIGNALS:
+  void ChunkLoaded(const int id, const SongList &songs);
+  void LoadFinished(const int id);
+
+ private:
+  PlaylistParser *parser_;
+  // key = id
+  QMap<int, QFuture<void>> loads_;
+  QList<QFuture<void>> cancelled_loads_;
+};
+
+#endif  // PLAYLISTFILELOADER_H
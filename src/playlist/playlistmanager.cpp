@@ -33,6 +33,7 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QList>
+#include <QMap>
 #include <QSet>
 #include <QString>
 #include <QRegularExpression>
@@ -44,6 +45,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/settings.h"
+#include "core/taskmanager.h"
 #include "constants/filenameconstants.h"
 #include "utilities/timeutils.h"
 #include "collection/collectionbackend.h"
@@ -52,6 +54,7 @@
 #include "playlist.h"
 #include "playlistbackend.h"
 #include "playlistcontainer.h"
+#include "playlistfileloader.h"
 #include "playlistmanager.h"
 #include "playlistitem.h"
 #include "playlistview.h"
@@ -79,6 +82,7 @@ PlaylistManager::PlaylistManager(const SharedPtr<TaskManager> task_manager,
       current_albumcover_loader_(current_albumcover_loader),
       sequence_(nullptr),
       parser_(nullptr),
+      file_loader_(nullptr),
       playlist_container_(nullptr),
       current_(-1),
       active_(-1),
@@ -90,6 +94,9 @@ PlaylistManager::PlaylistManager(const SharedPtr<TaskManager> task_manager,
 
 PlaylistManager::~PlaylistManager() {
 
+  // The parser is destroyed with this object, the workers using it have to stop first.
+  if (file_loader_) file_loader_->CancelAll();
+
   const QList<Data> datas = playlists_.values();
   for (const Data &data : datas) delete data.p;
 
@@ -101,12 +108,15 @@ void PlaylistManager::Init(PlaylistSequence *sequence, PlaylistContainer *playli
   playlist_container_ = playlist_container;
 
   parser_ = new PlaylistParser(tagreader_client_, collection_backend_, this);
+  file_loader_ = new PlaylistFileLoader(parser_, this);
 
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsChanged, this, &PlaylistManager::UpdateCollectionSongs);
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsStatisticsChanged, this, &PlaylistManager::UpdateCollectionSongs);
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsRatingChanged, this, &PlaylistManager::UpdateCollectionSongs);
 
   QObject::connect(parser_, &PlaylistParser::Error, this, &PlaylistManager::Error);
+  QObject::connect(file_loader_, &PlaylistFileLoader::ChunkLoaded, this, &PlaylistManager::PlaylistChunkLoaded);
+  QObject::connect(file_loader_, &PlaylistFileLoader::LoadFinished, this, &PlaylistManager::PlaylistFileLoadFinished);
 
   const PlaylistBackend::PlaylistList playlists = playlist_backend_->GetAllOpenPlaylists();
   for (const PlaylistBackend::Playlist &p : playlists) {
@@ -217,7 +227,30 @@ void PlaylistManager::Load(const QString &filename) {
 
   Playlist *playlist = AddPlaylist(id, fileinfo.completeBaseName(), QString(), QString(), false);
 
-  playlist->InsertUrls(QList<QUrl>() << QUrl::fromLocalFile(filename));
+  if (!parser_->ParserForExtension(PlaylistParser::Type::Load, fileinfo.suffix())) {
+    playlist->InsertUrls(QList<QUrl>() << QUrl::fromLocalFile(filename));
+    return;
+  }
+
+  // Insert the songs in chunks while the file is parsed, closing the playlist cancels loading.
+  playlist_load_tasks_.insert(id, task_manager_->StartTask(tr("Loading playlist %1").arg(fileinfo.fileName())));
+  file_loader_->Load(id, filename);
+
+}
+
+void PlaylistManager::PlaylistChunkLoaded(const int id, const SongList &songs) {
+
+  if (!playlists_.contains(id)) return;
+
+  playlists_[id].p->InsertSongsOrCollectionItems(songs);
+
+}
+
+void PlaylistManager::PlaylistFileLoadFinished(const int id) {
+
+  if (file_loader_->IsLoading(id) || !playlist_load_tasks_.contains(id)) return;
+
+  task_manager_->SetTaskFinished(playlist_load_tasks_.take(id));
 
 }
 
@@ -333,6 +366,8 @@ bool PlaylistManager::Close(const int id) {
   if (id == active_) SetActivePlaylist(next_id);
   if (id == current_) SetCurrentPlaylist(next_id);
 
+  file_loader_->Cancel(id);
+
   Data data = playlists_.take(id);
   Q_EMIT PlaylistClosed(id);
 
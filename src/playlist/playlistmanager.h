@@ -47,6 +47,7 @@ class CurrentAlbumCoverLoader;
 class PlaylistBackend;
 class PlaylistContainer;
 class PlaylistParser;
+class PlaylistFileLoader;
 class PlaylistSequence;
 
 class PlaylistManager : public PlaylistManagerInterface {
@@ -152,6 +153,8 @@ class PlaylistManager : public PlaylistManagerInterface {
   void UpdateCollectionSongs(const SongList &songs);
   void ItemsLoadedForSavePlaylist(const SongList &songs, const QString &filename, const PlaylistSettings::PathType path_type);
   void PlaylistLoaded();
+  void PlaylistChunkLoaded(const int id, const SongList &songs);
+  void PlaylistFileLoadFinished(const int id);
 
  private:
   Playlist *AddPlaylist(const int id, const QString &name, const QString &special_type, const QString &ui_path, const bool favorite);
@@ -181,6 +184,10 @@ class PlaylistManager : public PlaylistManagerInterface {
   int current_;
   int active_;
   int playlists_loading_;
+
+  PlaylistFileLoader *file_loader_;
+  // Tasks of the playlist files being loaded in chunks, key = id
+  QMap<int, int> playlist_load_tasks_;
 };
 
 #endif  // PLAYLISTMANAGER_H
@@ -145,6 +145,8 @@ PlaylistView::PlaylistView(QWidget *parent)
   setStyle(style_);
   setMouseTracking(true);
   setAlternatingRowColors(true);
+  // All rows have the same height, so only the visible rows need to be laid out.
+  setUniformRowHeights(true);
   setAttribute(Qt::WA_MacShowFocusRect, false);
 #ifdef Q_OS_MACOS
   setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
@@ -36,6 +36,10 @@
 #include "playlist.h"
 #include "songloaderinserter.h"
 
+namespace {
+constexpr qint64 kMetadataFirstBatchSize = 100;
+}
+
 SongLoaderInserter::SongLoaderInserter(const SharedPtr<TaskManager> task_manager,
                                        const SharedPtr<TagReaderClient> tagreader_client,
                                        const SharedPtr<UrlHandlers> url_handlers,
@@ -177,7 +181,6 @@ void SongLoaderInserter::AsyncLoad() {
   int async_progress = 0;
   int async_load_id = task_manager_->StartTask(tr("Loading tracks"));
   task_manager_->SetTaskProgress(async_load_id, async_progress, pending_.count());
-  bool first_loaded = false;
   for (int i = 0; i < pending_.count(); ++i) {
     SongLoader *loader = pending_.value(i);
     SongLoader::Result res = loader->LoadFilenamesBlocking();
@@ -191,38 +194,35 @@ void SongLoaderInserter::AsyncLoad() {
       continue;
     }
 
-    if (!first_loaded) {
-      // Load everything from the first song.
-      // It'll start playing as soon as we emit PreloadFinished, so it needs to have the duration set to show properly in the UI.
-      loader->LoadMetadataBlocking();
-      first_loaded = true;
-    }
-
     songs_ << loader->songs();
 
   }
+
+  if (!songs_.isEmpty()) {
+    // Load everything from the first song.
+    // It'll start playing as soon as we emit PreloadFinished, so it needs to have the duration set to show properly in the UI.
+    SongList first_songs = songs_.mid(0, 1);
+    SongLoader::LoadMetadataBlocking(collection_backend_, tagreader_client_, first_songs);
+    songs_[0] = first_songs.first();
+  }
+
   task_manager_->SetTaskFinished(async_load_id);
   Q_EMIT PreloadFinished();
 
   // Songs are inserted in playlist, now load them completely.
-  async_progress = 0;
+  // This is done in order and in batches, so the playlist items are replaced progressively by the new ones, fully loaded.
+  // Each batch makes the playlist walk its items, so the batches double in size to keep the number of walks logarithmic.
   async_load_id = task_manager_->StartTask(tr("Loading tracks info"));
-  task_manager_->SetTaskProgress(async_load_id, async_progress, songs_.count());
-  SongList songs;
-  for (int i = 0; i < pending_.count(); ++i) {
-    SongLoader *loader = pending_.value(i);
-    if (i != 0) {
-      // We already did this earlier for the first song.
-      loader->LoadMetadataBlocking();
-    }
-    songs << loader->songs();
-    task_manager_->SetTaskProgress(async_load_id, songs.count());
+  task_manager_->SetTaskProgress(async_load_id, 0, songs_.count());
+  qint64 batch_size = kMetadataFirstBatchSize;
+  for (qint64 i = 1; i < songs_.count(); i += batch_size, batch_size *= 2) {
+    SongList songs = songs_.mid(i, batch_size);
+    SongLoader::LoadMetadataBlocking(collection_backend_, tagreader_client_, songs);
+    Q_EMIT EffectiveLoadFinished(songs);
+    task_manager_->SetTaskProgress(async_load_id, static_cast<quint64>(i + songs.count()));
   }
   task_manager_->SetTaskFinished(async_load_id);
 
-  // Replace the partially-loaded items by the new ones, fully loaded.
-  Q_EMIT EffectiveLoadFinished(songs);
-
   deleteLater();
 
 }
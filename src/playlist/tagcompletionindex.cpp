@@ -0,0 +1,376 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <QApplication>
+#include <QObject>
+#include <QThread>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringListModel>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/song.h"
+#include "collection/collectionbackend.h"
+#include "playlist.h"
+#include "tagcompletionindex.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr Playlist::Column kCompletionColumns[] = {
+  Playlist::Column::Artist,
+  Playlist::Column::Album,
+  Playlist::Column::AlbumArtist,
+  Playlist::Column::Composer,
+  Playlist::Column::Performer,
+  Playlist::Column::Grouping,
+  Playlist::Column::Genre
+};
+}  // namespace
+
+TagCompletionModel::TagCompletionModel(QObject *parent) : QStringListModel(parent) {}
+
+bool TagCompletionModel::LessThan(const QString &a, const QString &b) {
+
+  return a.compare(b, Qt::CaseInsensitive) < 0;
+
+}
+
+void TagCompletionModel::SetValues(QStringList values) {
+
+  std::sort(values.begin(), values.end(), &TagCompletionModel::LessThan);
+  setStringList(values);
+
+}
+
+void TagCompletionModel::AddValue(const QString &value) {
+
+  int row = 0;
+  {
+    const QStringList values = stringList();
+    row = static_cast<int>(std::lower_bound(values.begin(), values.end(), value, &TagCompletionModel::LessThan) - values.begin());
+  }
+
+  insertRows(row, 1);
+  setData(index(row), value);
+
+}
+
+void TagCompletionModel::RemoveValue(const QString &value) {
+
+  int row = -1;
+  {
+    const QStringList values = stringList();
+    // Values differing only in case compare equal, so look for the exact value among them.
+    for (QStringList::const_iterator it = std::lower_bound(values.begin(), values.end(), value, &TagCompletionModel::LessThan); it != values.end() && !LessThan(value, *it); ++it) {
+      if (*it == value) {
+        row = static_cast<int>(it - values.begin());
+        break;
+      }
+    }
+  }
+
+  if (row != -1) {
+    removeRows(row, 1);
+  }
+
+}
+
+TagCompletionIndex::TagCompletionIndex(SharedPtr<CollectionBackend> backend, QObject *parent)
+    : QObject(parent),
+      backend_(backend),
+      loading_(false),
+      loaded_(false) {
+
+  setObjectName(QLatin1String(metaObject()->className()));
+
+  for (const Playlist::Column column : kCompletionColumns) {
+    ColumnIndex column_index;
+    column_index.column = column;
+    column_index.model = new TagCompletionModel(this);
+    columns_ << column_index;
+  }
+
+  QObject::connect(&*backend, &CollectionBackend::SongsAdded, this, &TagCompletionIndex::SongsAddedOrChanged);
+  QObject::connect(&*backend, &CollectionBackend::SongsChanged, this, &TagCompletionIndex::SongsAddedOrChanged);
+  QObject::connect(&*backend, &CollectionBackend::SongsDeleted, this, &TagCompletionIndex::SongsDeleted);
+  QObject::connect(&*backend, &CollectionBackend::DatabaseReset, this, &TagCompletionIndex::Load);
+
+  Load();
+
+}
+
+TagCompletionIndex *TagCompletionIndex::Instance(SharedPtr<CollectionBackend> backend) {
+
+  Q_ASSERT(QThread::currentThread() == qApp->thread());
+
+  static QHash<CollectionBackend*, TagCompletionIndex*> instances;
+
+  CollectionBackend *backend_ptr = &*backend;
+  if (!instances.contains(backend_ptr)) {
+    TagCompletionIndex *instance = new TagCompletionIndex(backend);
+    instances.insert(backend_ptr, instance);
+    QObject::connect(backend_ptr, &QObject::destroyed, instance, [backend_ptr, instance]() {
+      instances.remove(backend_ptr);
+      instance->deleteLater();
+    });
+  }
+
+  return instances.value(backend_ptr);
+
+}
+
+QString TagCompletionIndex::database_column(const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Artist:       return u"artist"_s;
+    case Playlist::Column::Album:        return u"album"_s;
+    case Playlist::Column::AlbumArtist:  return u"albumartist"_s;
+    case Playlist::Column::Composer:     return u"composer"_s;
+    case Playlist::Column::Performer:    return u"performer"_s;
+    case Playlist::Column::Grouping:     return u"grouping"_s;
+    case Playlist::Column::Genre:        return u"genre"_s;
+    default:
+      qLog(Warning) << "Unknown column" << static_cast<int>(column);
+      return QString();
+  }
+
+}
+
+QString TagCompletionIndex::SongValue(const Song &song, const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Artist:       return song.artist();
+    case Playlist::Column::Album:        return song.album();
+    case Playlist::Column::AlbumArtist:  return song.albumartist();
+    case Playlist::Column::Composer:     return song.composer();
+    case Playlist::Column::Performer:    return song.performer();
+    case Playlist::Column::Grouping:     return song.grouping();
+    case Playlist::Column::Genre:        return song.genre();
+    default:
+      return QString();
+  }
+
+}
+
+TagCompletionModel *TagCompletionIndex::model(const Playlist::Column column) const {
+
+  for (const ColumnIndex &column_index : columns_) {
+    if (column_index.column == column) return column_index.model;
+  }
+
+  qLog(Warning) << "Unknown column" << static_cast<int>(column);
+
+  return nullptr;
+
+}
+
+QHash<int, QStringList> TagCompletionIndex::LoadSongValues(SharedPtr<CollectionBackend> backend, const QStringList &columns) {
+
+  const QHash<int, QStringList> song_values = backend->GetAllColumnValues(columns);
+
+  if (QThread::currentThread() != backend->thread() && QThread::currentThread() != qApp->thread()) {
+    backend->Close();
+  }
+
+  return song_values;
+
+}
+
+void TagCompletionIndex::Load() {
+
+  SharedPtr<CollectionBackend> backend = backend_.lock();
+  if (!backend || loading_) return;
+
+  loading_ = true;
+
+  QStringList columns;
+  columns.reserve(columns_.count());
+  for (const ColumnIndex &column_index : std::as_const(columns_)) {
+    columns << database_column(column_index.column);
+  }
+
+  QFuture<QHash<int, QStringList>> future = QtConcurrent::run(&TagCompletionIndex::LoadSongValues, backend, columns);
+  QFutureWatcher<QHash<int, QStringList>> *watcher = new QFutureWatcher<QHash<int, QStringList>>();
+  QObject::connect(watcher, &QFutureWatcher<QHash<int, QStringList>>::finished, this, &TagCompletionIndex::LoadFinished);
+  watcher->setFuture(future);
+
+}
+
+void TagCompletionIndex::LoadFinished() {
+
+  QFutureWatcher<QHash<int, QStringList>> *watcher = static_cast<QFutureWatcher<QHash<int, QStringList>>*>(sender());
+  const QHash<int, QStringList> song_values = watcher->result();
+  watcher->deleteLater();
+
+  song_values_.clear();
+  song_values_.reserve(song_values.count());
+  for (ColumnIndex &column_index : columns_) {
+    column_index.counts.clear();
+  }
+
+  for (QHash<int, QStringList>::const_iterator it = song_values.constBegin(); it != song_values.constEnd(); ++it) {
+    QStringList values;
+    values.reserve(columns_.count());
+    for (int i = 0; i < columns_.count(); ++i) {
+      const QString value = it.value().value(i);
+      if (value.isEmpty()) {
+        values << QString();
+        continue;
+      }
+      // Keep one shared copy of each value.
+      QHash<QString, int>::iterator count_it = columns_[i].counts.find(value);
+      if (count_it == columns_[i].counts.end()) {
+        count_it = columns_[i].counts.insert(value, 0);
+      }
+      ++count_it.value();
+      values << count_it.key();
+    }
+    song_values_.insert(it.key(), values);
+  }
+
+  for (ColumnIndex &column_index : columns_) {
+    column_index.model->SetValues(column_index.counts.keys());
+  }
+
+  loading_ = false;
+  loaded_ = true;
+
+  const SongList pending_changed_songs = pending_changed_songs_;
+  const SongList pending_deleted_songs = pending_deleted_songs_;
+  pending_changed_songs_.clear();
+  pending_deleted_songs_.clear();
+  SongsAddedOrChanged(pending_changed_songs);
+  SongsDeleted(pending_deleted_songs);
+
+  qLog(Debug) << "Loaded tag completions for" << song_values_.count() << "songs";
+
+  Q_EMIT Loaded();
+
+}
+
+QString TagCompletionIndex::AddValue(ColumnIndex &column_index, const QString &value) {
+
+  QHash<QString, int>::iterator it = column_index.counts.find(value);
+  if (it == column_index.counts.end()) {
+    it = column_index.counts.insert(value, 0);
+    column_index.model->AddValue(value);
+  }
+  ++it.value();
+
+  return it.key();
+
+}
+
+void TagCompletionIndex::RemoveValue(ColumnIndex &column_index, const QString &value) {
+
+  QHash<QString, int>::iterator it = column_index.counts.find(value);
+  if (it == column_index.counts.end()) return;
+
+  if (--it.value() <= 0) {
+    column_index.counts.erase(it);
+    column_index.model->RemoveValue(value);
+  }
+
+}
+
+void TagCompletionIndex::SetSongValues(const int song_id, const QStringList &values) {
+
+  const QStringList old_values = song_values_.value(song_id);
+  if (old_values == values) return;
+
+  QStringList new_values;
+  new_values.reserve(columns_.count());
+  for (int i = 0; i < columns_.count(); ++i) {
+    const QString old_value = old_values.value(i);
+    const QString value = values.value(i);
+    if (value == old_value) {
+      new_values << old_value;
+      continue;
+    }
+    if (!old_value.isEmpty()) {
+      RemoveValue(columns_[i], old_value);
+    }
+    new_values << (value.isEmpty() ? QString() : AddValue(columns_[i], value));
+  }
+
+  song_values_.insert(song_id, new_values);
+
+}
+
+void TagCompletionIndex::RemoveSong(const int song_id) {
+
+  if (!song_values_.contains(song_id)) return;
+
+  const QStringList old_values = song_values_.take(song_id);
+  for (int i = 0; i < columns_.count() && i < old_values.count(); ++i) {
+    if (!old_values[i].isEmpty()) {
+      RemoveValue(columns_[i], old_values[i]);
+    }
+  }
+
+}
+
+void TagCompletionIndex::SongsAddedOrChanged(const SongList &songs) {
+
+  if (loading_) {
+    pending_changed_songs_ << songs;
+    return;
+  }
+
+  for (const Song &song : songs) {
+    if (song.id() == -1) continue;
+    if (song.unavailable()) {
+      RemoveSong(song.id());
+      continue;
+    }
+    QStringList values;
+    values.reserve(columns_.count());
+    for (const ColumnIndex &column_index : std::as_const(columns_)) {
+      values << SongValue(song, column_index.column);
+    }
+    SetSongValues(song.id(), values);
+  }
+
+}
+
+void TagCompletionIndex::SongsDeleted(const SongList &songs) {
+
+  if (loading_) {
+    pending_deleted_songs_ << songs;
+    return;
+  }
+
+  for (const Song &song : songs) {
+    RemoveSong(song.id());
+  }
+
+}
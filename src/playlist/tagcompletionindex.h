@@ -0,0 +1,108 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGCOMPLETIONINDEX_H
+#define TAGCOMPLETIONINDEX_H
+
+#include "config.h"
+
+#include <memory>
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringListModel>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "playlist.h"
+
+class CollectionBackend;
+
+// A string list model kept sorted case insensitively, so completers can use binary search for prefixes.
+class TagCompletionModel : public QStringListModel {
+  Q_OBJECT
+
+ public:
+  explicit TagCompletionModel(QObject *parent = nullptr);
+
+  void SetValues(QStringList values);
+  void AddValue(const QString &value);
+  void RemoveValue(const QString &value);
+
+  static bool LessThan(const QString &a, const QString &b);
+};
+
+// Distinct tag values of the collection per column, shared by all tag completers using the same collection backend.
+// Loaded once and kept up to date from the backend signals.
+class TagCompletionIndex : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit TagCompletionIndex(SharedPtr<CollectionBackend> backend, QObject *parent = nullptr);
+
+  static TagCompletionIndex *Instance(SharedPtr<CollectionBackend> backend);
+
+  // Returns the completion model for the column, or nullptr if the column has no completions.
+  TagCompletionModel *model(const Playlist::Column column) const;
+
+  bool is_loaded() const { return loaded_; }
+
+  static QString database_column(const Playlist::Column column);
+
+ private:
+  class ColumnIndex {
+   public:
+    ColumnIndex() : column(Playlist::Column::Title), model(nullptr) {}
+    Playlist::Column column;
+    TagCompletionModel *model;
+    QHash<QString, int> counts;
+  };
+
+  static QString SongValue(const Song &song, const Playlist::Column column);
+  static QHash<int, QStringList> LoadSongValues(SharedPtr<CollectionBackend> backend, const QStringList &columns);
+
+  void Load();
+  QString AddValue(ColumnIndex &column_index, const QString &value);
+  void RemoveValue(ColumnIndex &column_index, const QString &value);
+  void SetSongValues(const int song_id, const QStringList &values);
+  void RemoveSong(const int song_id);
+
+ Q_SIGNALS:
+  void Loaded();
+
+ private Q_SLOTS:
+  void LoadFinished();
+  void SongsAddedOrChanged(const SongList &songs);
+  void SongsDeleted(const SongList &songs);
+
+ private:
+  std::weak_ptr<CollectionBackend> backend_;
+  QList<ColumnIndex> columns_;
+  QHash<int, QStringList> song_values_;
+  bool loading_;
+  bool loaded_;
+  // Changes received while loading, applied on top of the loaded values.
+  SongList pending_changed_songs_;
+  SongList pending_deleted_songs_;
+};
+
+#endif  // TAGCOMPLETIONINDEX_H
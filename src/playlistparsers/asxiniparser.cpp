@@ -46,7 +46,7 @@ SongList AsxIniParser::Load(QIODevice *device, const QString &playlist_path, con
 
   Q_UNUSED(playlist_path);
 
-  SongList ret;
+  SongEntryList entries;
 
   while (!device->atEnd()) {
     QString line = QString::fromUtf8(device->readLine()).trimmed();
@@ -55,10 +55,15 @@ SongList AsxIniParser::Load(QIODevice *device, const QString &playlist_path, con
     QString value = line.mid(equals + 1);
 
     if (key.startsWith("ref"_L1)) {
-      Song song = LoadSong(value, 0, 0, dir, collection_lookup);
-      if (song.is_valid()) {
-        ret << song;
-      }
+      entries << SongEntry(value);
+    }
+  }
+
+  SongList ret;
+  const SongList songs = LoadSongs(entries, dir, collection_lookup);
+  for (const Song &song : songs) {
+    if (song.is_valid()) {
+      ret << song;
     }
   }
 
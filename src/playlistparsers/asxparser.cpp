@@ -72,21 +72,39 @@ SongList ASXParser::Load(QIODevice *device, const QString &playlist_path, const
     return SongList();
   }
 
-  SongList ret;
+  SongEntryList entries;
+  SongList playlist_songs;
   while (!reader.atEnd() && Utilities::ParseUntilElementCI(&reader, u"entry"_s)) {
-    Song song = ParseTrack(&reader, dir, collection_lookup);
+    SongEntry entry;
+    playlist_songs << ParseTrack(&reader, &entry);
+    entries << entry;
+  }
+
+  buffer.close();
+
+  SongList ret;
+  const SongList loaded_songs = LoadSongs(entries, dir, collection_lookup);
+  for (qint64 i = 0; i < loaded_songs.count(); ++i) {
+    Song song = loaded_songs[i];
+    const Song &playlist_song = playlist_songs[i];
+
+    // Override metadata with what was in the playlist
+    if (song.source() != Song::Source::Collection) {
+      if (!playlist_song.title().isEmpty()) song.set_title(playlist_song.title());
+      if (!playlist_song.artist().isEmpty()) song.set_artist(playlist_song.artist());
+      if (!playlist_song.album().isEmpty()) song.set_album(playlist_song.album());
+    }
+
     if (song.is_valid()) {
       ret << song;
     }
   }
 
-  buffer.close();
-
   return ret;
 
 }
 
-Song ASXParser::ParseTrack(QXmlStreamReader *reader, const QDir &dir, const bool collection_lookup) const {
+Song ASXParser::ParseTrack(QXmlStreamReader *reader, SongEntry *entry) {
 
   QString title, artist, album, ref;
 
@@ -120,14 +138,12 @@ Song ASXParser::ParseTrack(QXmlStreamReader *reader, const QDir &dir, const bool
   }
 
 return_song:
-  Song song = LoadSong(ref, 0, 0, dir, collection_lookup);
+  entry->filename_or_url = ref;
 
-  // Override metadata with what was in the playlist
-  if (song.source() != Song::Source::Collection) {
-    if (!title.isEmpty()) song.set_title(title);
-    if (!artist.isEmpty()) song.set_artist(artist);
-    if (!album.isEmpty()) song.set_album(album);
-  }
+  Song song;
+  song.set_title(title);
+  song.set_artist(artist);
+  song.set_album(album);
 
   return song;
 
@@ -57,7 +57,8 @@ class ASXParser : public XMLParser {
   void Save(const SongList &songs, QIODevice *device, const QDir &dir = QDir(), const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const override;
 
  private:
-  Song ParseTrack(QXmlStreamReader *reader, const QDir &dir, const bool collection_lookup) const;
+  // Returns the metadata in the playlist for the entry, and sets the entry to load.
+  static Song ParseTrack(QXmlStreamReader *reader, SongEntry *entry);
 };
 
 #endif
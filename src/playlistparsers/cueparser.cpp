@@ -19,6 +19,8 @@
  *
  */
 
+#include <utility>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QIODevice>
@@ -253,11 +255,18 @@ SongList CueParser::Load(QIODevice *device, const QString &playlist_path, const
 
   QDateTime cue_mtime = QFileInfo(playlist_path).lastModified();
 
+  SongEntryList song_entries;
+  song_entries.reserve(entries.count());
+  for (const CueEntry &entry : std::as_const(entries)) {
+    song_entries << SongEntry(entry.file, IndexToMarker(entry.index));
+  }
+  const SongList songs = LoadSongs(song_entries, dir, collection_lookup);
+
   // Finalize parsing songs
   for (int i = 0; i < entries.length(); i++) {
     CueEntry entry = entries.at(i);
 
-    Song song = LoadSong(entry.file, IndexToMarker(entry.index), 0, dir, collection_lookup);
+    Song song = songs.at(i);
 
     // Cue song has mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
     if (cue_mtime.isValid()) {
@@ -21,8 +21,8 @@
 #include <QObject>
 #include <QIODevice>
 #include <QDir>
-#include <QBuffer>
 #include <QByteArray>
+#include <QList>
 #include <QString>
 #include <QStringList>
 #include <QSettings>
@@ -44,59 +44,88 @@ M3UParser::M3UParser(const SharedPtr<TagReaderClient> tagreader_client, const Sh
 
 SongList M3UParser::Load(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup) const {
 
+  SongList ret;
+  LoadChunks(device, playlist_path, dir, collection_lookup, [&ret](const SongList &songs) {
+    ret << songs;
+    return true;
+  });
+
+  return ret;
+
+}
+
+bool M3UParser::LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const {
+
   Q_UNUSED(playlist_path);
 
   M3UType type = M3UType::STANDARD;
   Metadata current_metadata;
-
-  QString data = QString::fromUtf8(device->readAll());
-  data.replace(u'\r', u'\n');
-  data.replace("\n\n"_L1, "\n"_L1);
-  QByteArray bytes = data.toUtf8();
-  QBuffer buffer(&bytes);
-  if (!buffer.open(QIODevice::ReadOnly)) return SongList();
-
-  QString line = QString::fromUtf8(buffer.readLine()).trimmed();
-  if (line.startsWith("#EXTM3U"_L1)) {
-    // This is in extended M3U format.
-    type = M3UType::EXTENDED;
-    line = QString::fromUtf8(buffer.readLine()).trimmed();
-  }
-
-  SongList ret;
-  Q_FOREVER {
-    if (line.startsWith(u'#')) {
-      // Extended info or comment.
-      if (type == M3UType::EXTENDED && line.startsWith("#EXT"_L1)) {
-        if (!ParseMetadata(line, &current_metadata)) {
-          qLog(Warning) << "Failed to parse metadata: " << line;
+  bool first_line = true;
+
+  SongEntryList entries;
+  QList<Metadata> entries_metadata;
+  while (!device->atEnd()) {
+    // Lines can also be separated by carriage returns only.
+    const QStringList lines = QString::fromUtf8(device->readLine()).split(u'\r');
+    for (const QString &raw_line : lines) {
+      const QString line = raw_line.trimmed();
+      if (line.isEmpty()) continue;
+      if (first_line) {
+        first_line = false;
+        if (line.startsWith("#EXTM3U"_L1)) {
+          // This is in extended M3U format.
+          type = M3UType::EXTENDED;
+          continue;
         }
       }
-    }
-    else if (!line.isEmpty()) {
-      Song song = LoadSong(line, 0, 0, dir, collection_lookup);
-      if (!current_metadata.title.isEmpty()) {
-        song.set_title(current_metadata.title);
-      }
-      if (!current_metadata.artist.isEmpty()) {
-        song.set_artist(current_metadata.artist);
+      if (line.startsWith(u'#')) {
+        // Extended info or comment.
+        if (type == M3UType::EXTENDED && line.startsWith("#EXT"_L1)) {
+          if (!ParseMetadata(line, &current_metadata)) {
+            qLog(Warning) << "Failed to parse metadata: " << line;
+          }
+        }
+        continue;
       }
-      if (current_metadata.length > 0) {
-        song.set_length_nanosec(current_metadata.length);
+      entries << SongEntry(line);
+      entries_metadata << current_metadata;
+      current_metadata = Metadata();
+      if (entries.count() >= kLoadChunkSize) {
+        if (!callback(LoadChunk(entries, entries_metadata, dir, collection_lookup))) {
+          return false;
+        }
+        entries.clear();
+        entries_metadata.clear();
       }
-      ret << song;
+    }
+  }
 
-      current_metadata = Metadata();
+  if (!entries.isEmpty()) {
+    return callback(LoadChunk(entries, entries_metadata, dir, collection_lookup));
+  }
+
+  return true;
+
+}
+
+SongList M3UParser::LoadChunk(const SongEntryList &entries, const QList<Metadata> &entries_metadata, const QDir &dir, const bool collection_lookup) const {
+
+  SongList songs = LoadSongs(entries, dir, collection_lookup);
+  for (qint64 i = 0; i < songs.count(); ++i) {
+    const Metadata &metadata = entries_metadata[i];
+    Song &song = songs[i];
+    if (!metadata.title.isEmpty()) {
+      song.set_title(metadata.title);
     }
-    if (buffer.atEnd()) {
-      break;
+    if (!metadata.artist.isEmpty()) {
+      song.set_artist(metadata.artist);
+    }
+    if (metadata.length > 0) {
+      song.set_length_nanosec(metadata.length);
     }
-    line = QString::fromUtf8(buffer.readLine()).trimmed();
   }
 
-  buffer.close();
-
-  return ret;
+  return songs;
 
 }
 
@@ -26,6 +26,7 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QByteArray>
+#include <QList>
 #include <QString>
 #include <QStringList>
 #include <QDir>
@@ -54,6 +55,7 @@ class M3UParser : public ParserBase {
   bool TryMagic(const QByteArray &data) const override;
 
   SongList Load(QIODevice *device, const QString &playlist_path = QLatin1String(""), const QDir &dir = QDir(), const bool collection_lookup = true) const override;
+  bool LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const override;
   void Save(const SongList &songs, QIODevice *device, const QDir &dir = QDir(), const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const override;
 
  private:
@@ -71,6 +73,7 @@ class M3UParser : public ParserBase {
   };
 
   static bool ParseMetadata(const QString &line, Metadata *metadata);
+  SongList LoadChunk(const SongEntryList &entries, const QList<Metadata> &entries_metadata, const QDir &dir, const bool collection_lookup) const;
 
 };
 
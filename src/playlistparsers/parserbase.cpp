@@ -19,11 +19,21 @@
  *
  */
 
+#include <algorithm>
+#include <utility>
+
 #include <QtGlobal>
+#include <QtConcurrentMap>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QBuffer>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QString>
+#include <QStringList>
 #include <QRegularExpression>
 #include <QUrl>
 
@@ -36,13 +46,15 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+const int ParserBase::kLoadChunkSize = 1000;
+
 ParserBase::ParserBase(const SharedPtr<TagReaderClient> tagreader_client, const SharedPtr<CollectionBackendInterface> collection_backend, QObject *parent)
     : QObject(parent), tagreader_client_(tagreader_client), collection_backend_(collection_backend) {}
 
-void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning, const int track, const QDir &dir, Song *song, const bool collection_lookup) const {
+QString ParserBase::ResolveFilename(const QString &filename_or_url, const QDir &dir, Song *song) const {
 
   if (filename_or_url.isEmpty()) {
-    return;
+    return QString();
   }
 
   QString filename = filename_or_url;
@@ -58,12 +70,12 @@ void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning
       song->set_url(QUrl::fromUserInput(filename_or_url));
       song->set_filetype(Song::FileType::Stream);
       song->set_valid(true);
-      return;
+      return QString();
     }
     else {
       qLog(Error) << "Don't know how to handle" << url;
       Q_EMIT Error(tr("Don't know how to handle %1").arg(filename_or_url));
-      return;
+      return QString();
     }
   }
 
@@ -74,52 +86,127 @@ void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning
     filename = dir.absoluteFilePath(filename);
   }
 
-  const QUrl url = QUrl::fromLocalFile(filename);
+  return filename;
 
-  // Search the collection
-  if (collection_backend_ && collection_lookup) {
-    Song collection_song;
-    if (track > 0) {
-      collection_song = collection_backend_->GetSongByUrlAndTrack(url, track);
+}
+
+QList<qint64> ParserBase::FindInCollection(const SongEntryList &entries, const QList<qint64> &indexes, const QList<QUrl> &urls, SongList &songs) const {
+
+  const QHash<QUrl, SongList> collection_songs = collection_backend_->GetSongsByUrls(urls);
+
+  QList<qint64> not_found;
+  for (qint64 i = 0; i < indexes.count(); ++i) {
+    const SongEntry &entry = entries[indexes[i]];
+    const SongList sections = collection_songs.value(urls[i]);
+    const SongList::const_iterator it_track = std::find_if(sections.begin(), sections.end(), [&entry](const Song &section) { return entry.track > 0 && section.track() == entry.track; });
+    const SongList::const_iterator it_beginning = std::find_if(sections.begin(), sections.end(), [&entry](const Song &section) { return section.beginning_nanosec() == entry.beginning; });
+    if (it_track != sections.end()) {
+      songs[indexes[i]] = *it_track;
+    }
+    else if (it_beginning != sections.end()) {
+      songs[indexes[i]] = *it_beginning;
+    }
+    else {
+      not_found << indexes[i];
+    }
+  }
+
+  return not_found;
+
+}
+
+SongList ParserBase::LoadSongs(const SongEntryList &entries, const QDir &dir, const bool collection_lookup) const {
+
+  SongList songs;
+  QStringList filenames;
+  songs.reserve(entries.count());
+  filenames.reserve(entries.count());
+  QList<qint64> pending;
+  for (const SongEntry &entry : entries) {
+    Song song(Song::Source::LocalFile);
+    const QString filename = ResolveFilename(entry.filename_or_url, dir, &song);
+    if (!filename.isEmpty()) {
+      song.set_url(QUrl::fromLocalFile(filename));
+      pending << songs.count();
     }
-    if (!collection_song.is_valid()) {
-      collection_song = collection_backend_->GetSongByUrl(url, beginning);
+    songs << song;
+    filenames << filename;
+  }
+
+  // Search the collection
+  if (collection_backend_ && collection_lookup && !pending.isEmpty()) {
+    QList<QUrl> urls;
+    urls.reserve(pending.count());
+    for (const qint64 i : std::as_const(pending)) {
+      urls << QUrl::fromLocalFile(filenames[i]);
     }
+    pending = FindInCollection(entries, pending, urls, songs);
+
     // Try canonical path
-    if (!collection_song.is_valid()) {
-      const QString canonical_filepath = QFileInfo(filename).canonicalFilePath();
-      if (canonical_filepath != filename) {
-        const QUrl canonical_filepath_url = QUrl::fromLocalFile(canonical_filepath);
-        if (track > 0) {
-          collection_song = collection_backend_->GetSongByUrlAndTrack(canonical_filepath_url, track);
-        }
-        if (!collection_song.is_valid()) {
-          collection_song = collection_backend_->GetSongByUrl(canonical_filepath_url, beginning);
-        }
+    QList<qint64> canonical_indexes;
+    QList<QUrl> canonical_urls;
+    for (const qint64 i : std::as_const(pending)) {
+      const QString canonical_filepath = QFileInfo(filenames[i]).canonicalFilePath();
+      if (!canonical_filepath.isEmpty() && canonical_filepath != filenames[i]) {
+        canonical_indexes << i;
+        canonical_urls << QUrl::fromLocalFile(canonical_filepath);
       }
     }
-    // If it was found in the collection then use it, otherwise load metadata from disk.
-    if (collection_song.is_valid()) {
-      *song = collection_song;
-      return;
+    if (!canonical_indexes.isEmpty()) {
+      const QList<qint64> canonical_not_found = FindInCollection(entries, canonical_indexes, canonical_urls, songs);
+      QSet<qint64> found(canonical_indexes.begin(), canonical_indexes.end());
+      for (const qint64 i : canonical_not_found) {
+        found.remove(i);
+      }
+      pending.removeIf([&found](const qint64 i) { return found.contains(i); });
     }
   }
 
-  if (tagreader_client_) {
-    const TagReaderResult result = tagreader_client_->ReadFileBlocking(filename, song);
-    if (!result.success()) {
-      qLog(Error) << "Could not read file" << filename << result.error_string();
-    }
+  // If it was not found in the collection then load metadata from disk.
+  if (tagreader_client_ && !pending.isEmpty()) {
+    Song *songs_data = songs.data();
+    QtConcurrent::blockingMap(pending, [this, songs_data, &filenames](const qint64 i) {
+      const TagReaderResult result = tagreader_client_->ReadFileBlocking(filenames[i], &songs_data[i]);
+      if (!result.success()) {
+        qLog(Error) << "Could not read file" << filenames[i] << result.error_string();
+      }
+    });
   }
 
+  return songs;
+
 }
 
-Song ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning, const int track, const QDir &dir, const bool collection_lookup) const {
+bool ParserBase::LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const {
+
+  const SongList songs = Load(device, playlist_path, dir, collection_lookup);
+  return songs.isEmpty() || callback(songs);
+
+}
+
+bool ParserBase::LoadFile(QFile *file, const bool collection_lookup, const ChunkCallback &callback) const {
+
+  const QString filename = file->fileName();
+  const QDir dir = QFileInfo(filename).absolutePath();
+
+  uchar *data = file->size() > 0 ? file->map(0, file->size()) : nullptr;
+  if (!data) {
+    return LoadChunks(file, filename, dir, collection_lookup, callback);
+  }
+
+  // Parse the mapped file through a buffer, only the pages being parsed have to be read into memory.
+  QByteArray mapped_data = QByteArray::fromRawData(reinterpret_cast<const char*>(data), file->size());
+  QBuffer buffer(&mapped_data);
+  if (!buffer.open(QIODevice::ReadOnly)) {
+    file->unmap(data);
+    return LoadChunks(file, filename, dir, collection_lookup, callback);
+  }
 
-  Song song(Song::Source::LocalFile);
-  LoadSong(filename_or_url, beginning, track, dir, &song, collection_lookup);
+  const bool finished = LoadChunks(&buffer, filename, dir, collection_lookup, callback);
+  buffer.close();
+  file->unmap(data);
 
-  return song;
+  return finished;
 
 }
 
@@ -24,8 +24,11 @@
 
 #include "config.h"
 
+#include <functional>
+
 #include <QtGlobal>
 #include <QObject>
+#include <QList>
 #include <QDir>
 #include <QByteArray>
 #include <QString>
@@ -37,6 +40,7 @@
 #include "constants/playlistsettings.h"
 
 class QIODevice;
+class QFile;
 class CollectionBackendInterface;
 class TagReaderClient;
 
@@ -62,21 +66,48 @@ class ParserBase : public QObject {
   virtual SongList Load(QIODevice *device, const QString &playlist_path = QLatin1String(""), const QDir &dir = QDir(), const bool collection_lookup = true) const = 0;
   virtual void Save(const SongList &songs, QIODevice *device, const QDir &dir = QDir(), const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const = 0;
 
+  // Receives the songs of a playlist in chunks, in order. Returning false stops loading.
+  using ChunkCallback = std::function<bool(const SongList &songs)>;
+
+  // Loads the playlist like Load(), but passes the songs to the callback in chunks while the entries are parsed, so huge playlists never have to be complete in memory.
+  // Returns false if loading was stopped by the callback. The default implementation passes all songs returned by Load() as one chunk.
+  virtual bool LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const;
+
+  // Loads the playlist from an opened local file with LoadChunks(). The file is mapped into memory instead of being read, when possible.
+  bool LoadFile(QFile *file, const bool collection_lookup, const ChunkCallback &callback) const;
+
  Q_SIGNALS:
   void Error(const QString &error) const;
 
  protected:
-  // Loads a song.  If filename_or_url is a URL (with a scheme other than "file") then it is set on the song and the song marked as a stream.
-  // Also sets the song's metadata by searching in the Collection, or loading from the file as a fallback.
+  static const int kLoadChunkSize;
+
+  // A playlist entry, loaded by LoadSongs().
+  struct SongEntry {
+    explicit SongEntry(const QString &_filename_or_url = QString(), const qint64 _beginning = 0, const int _track = 0) : filename_or_url(_filename_or_url), beginning(_beginning), track(_track) {}
+    QString filename_or_url;
+    qint64 beginning;
+    int track;
+  };
+  using SongEntryList = QList<SongEntry>;
+
+  // Loads the songs of all the entries in a playlist, the returned list has one song for each entry, in the same order.
+  // If filename_or_url is a URL (with a scheme other than "file") then it is set on the song and the song marked as a stream.
+  // Also sets the songs' metadata by searching in the Collection, or loading from the files as a fallback.
+  // The collection is searched for all entries at once, and only the files not found in the collection are read, in parallel.
   // This function should always be used when loading a playlist.
-  Song LoadSong(const QString &filename_or_url, const qint64 beginning, const int track, const QDir &dir, const bool collection_lookup) const;
-  void LoadSong(const QString &filename_or_url, const qint64 beginning, const int track, const QDir &dir, Song *song, const bool collection_lookup) const;
+  SongList LoadSongs(const SongEntryList &entries, const QDir &dir, const bool collection_lookup) const;
 
   // If the URL is a file:// URL then returns its path, absolute or relative to the directory depending on the path_type option.
   // Otherwise, returns the URL as is. This function should always be used when saving a playlist.
   static QString URLOrFilename(const QUrl &url, const QDir &dir, const PlaylistSettings::PathType path_type);
 
  private:
+  // Returns the absolute filename of a local file entry. Streams are set up directly on the song, and an empty filename is returned for them.
+  QString ResolveFilename(const QString &filename_or_url, const QDir &dir, Song *song) const;
+  // Searches the collection for the entries at the given indexes, and returns the indexes that were not found.
+  QList<qint64> FindInCollection(const SongEntryList &entries, const QList<qint64> &indexes, const QList<QUrl> &urls, SongList &songs) const;
+
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<CollectionBackendInterface> collection_backend_;
 };
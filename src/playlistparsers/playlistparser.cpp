@@ -178,6 +178,18 @@ ParserBase *PlaylistParser::ParserForMagic(const QByteArray &data, const QString
 
 SongList PlaylistParser::LoadFromFile(const QString &filename) const {
 
+  SongList ret;
+  LoadFromFile(filename, [&ret](const SongList &songs) {
+    ret << songs;
+    return true;
+  });
+
+  return ret;
+
+}
+
+bool PlaylistParser::LoadFromFile(const QString &filename, const ParserBase::ChunkCallback &callback) const {
+
   QFileInfo fileinfo(filename);
 
   // Find a parser that supports this file extension
@@ -185,20 +197,20 @@ SongList PlaylistParser::LoadFromFile(const QString &filename) const {
   if (!parser) {
     qLog(Error) << "Unknown filetype:" << filename;
     Q_EMIT Error(tr("Unknown filetype: %1").arg(filename));
-    return SongList();
+    return false;
   }
 
   // Open the file
   QFile file(filename);
   if (!file.open(QIODevice::ReadOnly)) {
     Q_EMIT Error(tr("Could not open file %1").arg(filename));
-    return SongList();
+    return false;
   }
 
-  const SongList songs = parser->Load(&file, filename, fileinfo.absolutePath(), true);
+  const bool finished = parser->LoadFile(&file, true, callback);
   file.close();
 
-  return songs;
+  return finished;
 
 }
 
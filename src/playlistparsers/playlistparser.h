@@ -33,11 +33,11 @@
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "constants/playlistsettings.h"
+#include "parserbase.h"
 
 class QIODevice;
 class TagReaderClient;
 class CollectionBackendInterface;
-class ParserBase;
 
 class PlaylistParser : public QObject {
   Q_OBJECT
@@ -65,6 +65,8 @@ class PlaylistParser : public QObject {
   ParserBase *ParserForMimeType(const Type type, const QString &mime) const;
 
   SongList LoadFromFile(const QString &filename) const;
+  // Loads the songs in chunks passed to the callback while the file is parsed, returns false if there was an error or loading was stopped by the callback.
+  bool LoadFromFile(const QString &filename, const ParserBase::ChunkCallback &callback) const;
   SongList LoadFromDevice(QIODevice *device, const QString &path_hint = QString(), const QDir &dir_hint = QDir()) const;
   void Save(const SongList &songs, const QString &filename, const PlaylistSettings::PathType) const;
 
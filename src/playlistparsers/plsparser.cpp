@@ -46,6 +46,7 @@ SongList PLSParser::Load(QIODevice *device, const QString &playlist_path, const
   Q_UNUSED(playlist_path);
 
   QMap<int, Song> songs;
+  QMap<int, QString> files;
   static const QRegularExpression n_re(u"\\d+$"_s);
 
   while (!device->atEnd()) {
@@ -58,15 +59,7 @@ SongList PLSParser::Load(QIODevice *device, const QString &playlist_path, const
     int n = re_match.captured(0).toInt();
 
     if (key.startsWith("file"_L1)) {
-      Song song = LoadSong(value, 0, 0, dir, collection_lookup);
-
-      // Use the title and length we've already loaded if any
-      if (!songs[n].title().isEmpty()) song.set_title(songs[n].title());
-      if (songs[n].length_nanosec() != -1) {
-        song.set_length_nanosec(songs[n].length_nanosec());
-      }
-
-      songs[n] = song;
+      files[n] = value;
     }
     else if (key.startsWith("title"_L1)) {
       songs[n].set_title(value);
@@ -79,6 +72,27 @@ SongList PLSParser::Load(QIODevice *device, const QString &playlist_path, const
     }
   }
 
+  SongEntryList entries;
+  entries.reserve(files.count());
+  for (QMap<int, QString>::const_iterator it = files.constBegin(); it != files.constEnd(); ++it) {
+    entries << SongEntry(it.value());
+  }
+  const SongList loaded_songs = LoadSongs(entries, dir, collection_lookup);
+
+  qint64 i = 0;
+  for (QMap<int, QString>::const_iterator it = files.constBegin(); it != files.constEnd(); ++it) {
+    Song song = loaded_songs[i++];
+
+    // Use the title and length from the playlist if any
+    const Song playlist_song = songs.value(it.key());
+    if (!playlist_song.title().isEmpty()) song.set_title(playlist_song.title());
+    if (playlist_song.length_nanosec() != -1) {
+      song.set_length_nanosec(playlist_song.length_nanosec());
+    }
+
+    songs[it.key()] = song;
+  }
+
   return songs.values();
 
 }
@@ -57,14 +57,23 @@ SongList WplParser::Load(QIODevice *device, const QString &playlist_path, const
     return ret;
   }
 
+  SongEntryList entries;
   while (!reader.atEnd() && Utilities::ParseUntilElement(&reader, u"seq"_s)) {
-    ParseSeq(dir, &reader, &ret, collection_lookup);
+    ParseSeq(&reader, &entries);
   }
+
+  const SongList songs = LoadSongs(entries, dir, collection_lookup);
+  for (const Song &song : songs) {
+    if (song.is_valid()) {
+      ret << song;
+    }
+  }
+
   return ret;
 
 }
 
-void WplParser::ParseSeq(const QDir &dir, QXmlStreamReader *reader, SongList *songs, const bool collection_lookup) const {
+void WplParser::ParseSeq(QXmlStreamReader *reader, SongEntryList *entries) {
 
   while (!reader->atEnd()) {
     QXmlStreamReader::TokenType type = reader->readNext();
@@ -74,10 +83,7 @@ void WplParser::ParseSeq(const QDir &dir, QXmlStreamReader *reader, SongList *so
         if (name == "media"_L1) {
           QString src = reader->attributes().value("src"_L1).toString();
           if (!src.isEmpty()) {
-            Song song = LoadSong(src, 0, 0, dir, collection_lookup);
-            if (song.is_valid()) {
-              songs->append(song);
-            }
+            entries->append(SongEntry(src));
           }
         }
         else {
@@ -59,7 +59,7 @@ class WplParser : public XMLParser {
   void Save(const SongList &songs, QIODevice *device, const QDir &dir, const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const override;
 
  private:
-  void ParseSeq(const QDir &dir, QXmlStreamReader *reader, SongList *songs, const bool collection_lookup) const;
+  static void ParseSeq(QXmlStreamReader *reader, SongEntryList *entries);
   static void WriteMeta(const QString &name, const QString &content, QXmlStreamWriter *writer);
 };
 
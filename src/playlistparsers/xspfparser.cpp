@@ -46,17 +46,66 @@ XSPFParser::XSPFParser(const SharedPtr<TagReaderClient> tagreader_client, const
 
 SongList XSPFParser::Load(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup) const {
 
-  Q_UNUSED(playlist_path);
+  SongList ret;
+  LoadChunks(device, playlist_path, dir, collection_lookup, [&ret](const SongList &songs) {
+    ret << songs;
+    return true;
+  });
 
-  SongList songs;
+  return ret;
+
+}
+
+bool XSPFParser::LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const {
+
+  Q_UNUSED(playlist_path);
 
   QXmlStreamReader reader(device);
   if (!Utilities::ParseUntilElement(&reader, u"playlist"_s) || !Utilities::ParseUntilElement(&reader, u"trackList"_s)) {
-    return songs;
+    return true;
   }
 
+  SongEntryList entries;
+  SongList playlist_songs;
   while (!reader.atEnd() && Utilities::ParseUntilElement(&reader, u"track"_s)) {
-    const Song song = ParseTrack(&reader, dir, collection_lookup);
+    SongEntry entry;
+    playlist_songs << ParseTrack(&reader, &entry);
+    entries << entry;
+    if (entries.count() >= kLoadChunkSize) {
+      if (!callback(LoadChunk(entries, playlist_songs, dir, collection_lookup))) {
+        return false;
+      }
+      entries.clear();
+      playlist_songs.clear();
+    }
+  }
+
+  if (!entries.isEmpty()) {
+    return callback(LoadChunk(entries, playlist_songs, dir, collection_lookup));
+  }
+
+  return true;
+
+}
+
+SongList XSPFParser::LoadChunk(const SongEntryList &entries, const SongList &playlist_songs, const QDir &dir, const bool collection_lookup) const {
+
+  SongList songs;
+  const SongList loaded_songs = LoadSongs(entries, dir, collection_lookup);
+  for (qint64 i = 0; i < loaded_songs.count(); ++i) {
+    Song song = loaded_songs[i];
+    const Song &playlist_song = playlist_songs[i];
+
+    // Override metadata with what was in the playlist
+    if (song.source() != Song::Source::Collection) {
+      if (!playlist_song.title().isEmpty()) song.set_title(playlist_song.title());
+      if (!playlist_song.artist().isEmpty()) song.set_artist(playlist_song.artist());
+      if (!playlist_song.album().isEmpty()) song.set_album(playlist_song.album());
+      if (!playlist_song.art_manual().isEmpty()) song.set_art_manual(playlist_song.art_manual());
+      if (playlist_song.length_nanosec() > 0) song.set_length_nanosec(playlist_song.length_nanosec());
+      if (playlist_song.track() > 0) song.set_track(playlist_song.track());
+    }
+
     if (song.is_valid()) {
       songs << song;
     }
@@ -66,7 +115,7 @@ SongList XSPFParser::Load(QIODevice *device, const QString &playlist_path, const
 
 }
 
-Song XSPFParser::ParseTrack(QXmlStreamReader *reader, const QDir &dir, const bool collection_lookup) const {
+Song XSPFParser::ParseTrack(QXmlStreamReader *reader, SongEntry *entry) {
 
   QString title, artist, album, location, art;
   qint64 nanosec = -1;
@@ -124,17 +173,16 @@ Song XSPFParser::ParseTrack(QXmlStreamReader *reader, const QDir &dir, const boo
   }
 
 return_song:
-  Song song = LoadSong(location, 0, track_num, dir, collection_lookup);
-
-  // Override metadata with what was in the playlist
-  if (song.source() != Song::Source::Collection) {
-    if (!title.isEmpty()) song.set_title(title);
-    if (!artist.isEmpty()) song.set_artist(artist);
-    if (!album.isEmpty()) song.set_album(album);
-    if (!art.isEmpty()) song.set_art_manual(QUrl(art));
-    if (nanosec > 0) song.set_length_nanosec(nanosec);
-    if (track_num > 0) song.set_track(track_num);
-  }
+  entry->filename_or_url = location;
+  entry->track = track_num;
+
+  Song song;
+  song.set_title(title);
+  song.set_artist(artist);
+  song.set_album(album);
+  if (!art.isEmpty()) song.set_art_manual(QUrl(art));
+  song.set_length_nanosec(nanosec);
+  song.set_track(track_num);
 
   return song;
 
@@ -53,10 +53,13 @@ class XSPFParser : public XMLParser {
   bool TryMagic(const QByteArray &data) const override;
 
   SongList Load(QIODevice *device, const QString &playlist_path = QLatin1String(""), const QDir &dir = QDir(), const bool collection_lookup = true) const override;
+  bool LoadChunks(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup, const ChunkCallback &callback) const override;
   void Save(const SongList &songs, QIODevice *device, const QDir &dir = QDir(), const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const override;
 
  private:
-  Song ParseTrack(QXmlStreamReader *reader, const QDir &dir, const bool collection_lookup) const;
+  // Returns the metadata in the playlist for the track, and sets the entry to load.
+  static Song ParseTrack(QXmlStreamReader *reader, SongEntry *entry);
+  SongList LoadChunk(const SongEntryList &entries, const SongList &playlist_songs, const QDir &dir, const bool collection_lookup) const;
 };
 
 #endif
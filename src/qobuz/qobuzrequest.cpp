@@ -27,6 +27,7 @@
 #include <QByteArrayList>
 #include <QString>
 #include <QUrl>
+#include <QFileInfo>
 #include <QImage>
 #include <QImageReader>
 #include <QNetworkRequest>
@@ -34,7 +35,6 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -43,6 +43,7 @@
 #include "constants/timeconstants.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
+#include "streaming/streamingrequestscheduler.h"
 #include "qobuzservice.h"
 #include "qobuzurlhandler.h"
 #include "qobuzbaserequest.h"
@@ -51,13 +52,10 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
-constexpr int kMaxConcurrentAlbumCoverRequests = 1;
-constexpr int kFlushRequestsDelay = 200;
+constexpr int kConcurrentRequests = 3;
+constexpr int kConcurrentAlbumCoverRequests = 1;
+constexpr int kMaxConcurrentRequests = 8;
+constexpr int kMaxConcurrentAlbumCoverRequests = 4;
 }  // namespace
 
 QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
@@ -65,7 +63,7 @@ QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler,
       service_(service),
       url_handler_(url_handler),
       network_(network),
-      timer_flush_requests_(new QTimer(this)),
+      scheduler_(service->request_scheduler()),
       query_type_(query_type),
       query_id_(-1),
       finished_(false),
@@ -97,29 +95,21 @@ QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler,
       album_covers_requests_total_(0),
       album_covers_requests_active_(0),
       album_covers_requests_received_(0),
+      songs_synced_(0),
       no_results_(false) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &QobuzRequest::FlushRequests);
+  scheduler_->AddEndpoint(u"artists"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"songs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"artistalbums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumsongs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumcovers"_s, kConcurrentAlbumCoverRequests, kMaxConcurrentAlbumCoverRequests);
 
 }
 
 QobuzRequest::~QobuzRequest() {
 
-  while (!replies_.isEmpty()) {
-    QNetworkReply *reply = replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
-
-  while (!album_cover_replies_.isEmpty()) {
-    QNetworkReply *reply = album_cover_replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
+  scheduler_->Abort(this);
 
 }
 
@@ -151,50 +141,6 @@ void QobuzRequest::Process() {
 
 }
 
-void QobuzRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
-void QobuzRequest::FlushRequests() {
-
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
-
-}
-
 void QobuzRequest::Search(const int query_id, const QString &search_text) {
   query_id_ = query_id;
   search_text_ = search_text;
@@ -213,43 +159,30 @@ void QobuzRequest::AddArtistsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  artists_requests_queue_.enqueue(request);
-
   ++artists_requests_total_;
+  ++artists_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artists"_s, this, [this, request]() { return SendArtistsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void QobuzRequest::FlushArtistsRequests() {
-
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
-
-    Request request = artists_requests_queue_.dequeue();
+QNetworkReply *QobuzRequest::SendArtistsRequest(const Request &request) {
 
-    ParamList params;
-    if (query_type_ == Type::FavouriteArtists) {
-      params << Param(u"type"_s, u"artists"_s);
-      params << Param(u"user_auth_token"_s, user_auth_token());
-    }
-    else if (query_type_ == Type::SearchArtists) params << Param(u"query"_s, search_text_);
-    if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteArtists) {
-      reply = CreateRequest(u"favorite/getUserFavorites"_s, params);
-    }
-    else if (query_type_ == Type::SearchArtists) {
-      reply = CreateRequest(u"artist/search"_s, params);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
-
-    ++artists_requests_active_;
+  ParamList params;
+  if (query_type_ == Type::FavouriteArtists) {
+    params << Param(u"type"_s, u"artists"_s);
+    params << Param(u"user_auth_token"_s, user_auth_token());
+  }
+  else if (query_type_ == Type::SearchArtists) params << Param(u"query"_s, search_text_);
+  if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
+  if (query_type_ == Type::SearchArtists) {
+    return CreateRequest(u"artist/search"_s, params);
   }
 
+  return CreateRequest(u"favorite/getUserFavorites"_s, params);
+
 }
 
 void QobuzRequest::GetAlbums() {
@@ -265,43 +198,30 @@ void QobuzRequest::AddAlbumsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  albums_requests_queue_.enqueue(request);
-
   ++albums_requests_total_;
+  ++albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albums"_s, this, [this, request]() { return SendAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void QobuzRequest::FlushAlbumsRequests() {
-
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
-
-    Request request = albums_requests_queue_.dequeue();
-
-    ParamList params;
-    if (query_type_ == Type::FavouriteAlbums) {
-      params << Param(u"type"_s, u"albums"_s);
-      params << Param(u"user_auth_token"_s, user_auth_token());
-    }
-    else if (query_type_ == Type::SearchAlbums) params << Param(u"query"_s, search_text_);
-    if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteAlbums) {
-      reply = CreateRequest(u"favorite/getUserFavorites"_s, params);
-    }
-    else if (query_type_ == Type::SearchAlbums) {
-      reply = CreateRequest(u"album/search"_s, params);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
+QNetworkReply *QobuzRequest::SendAlbumsRequest(const Request &request) {
 
-    ++albums_requests_active_;
+  ParamList params;
+  if (query_type_ == Type::FavouriteAlbums) {
+    params << Param(u"type"_s, u"albums"_s);
+    params << Param(u"user_auth_token"_s, user_auth_token());
+  }
+  else if (query_type_ == Type::SearchAlbums) params << Param(u"query"_s, search_text_);
+  if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
+  if (query_type_ == Type::SearchAlbums) {
+    return CreateRequest(u"album/search"_s, params);
   }
 
+  return CreateRequest(u"favorite/getUserFavorites"_s, params);
+
 }
 
 void QobuzRequest::GetSongs() {
@@ -317,43 +237,30 @@ void QobuzRequest::AddSongsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  songs_requests_queue_.enqueue(request);
-
   ++songs_requests_total_;
+  ++songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"songs"_s, this, [this, request]() { return SendSongsRequest(request); }, [this, request](QNetworkReply *reply) { SongsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void QobuzRequest::FlushSongsRequests() {
-
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
-
-    Request request = songs_requests_queue_.dequeue();
+QNetworkReply *QobuzRequest::SendSongsRequest(const Request &request) {
 
-    ParamList params;
-    if (query_type_ == Type::FavouriteSongs) {
-      params << Param(u"type"_s, u"tracks"_s);
-      params << Param(u"user_auth_token"_s, user_auth_token());
-    }
-    else if (query_type_ == Type::SearchSongs) params << Param(u"query"_s, search_text_);
-    if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteSongs) {
-      reply = CreateRequest(u"favorite/getUserFavorites"_s, params);
-    }
-    else if (query_type_ == Type::SearchSongs) {
-      reply = CreateRequest(u"track/search"_s, params);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
-
-    ++songs_requests_active_;
+  ParamList params;
+  if (query_type_ == Type::FavouriteSongs) {
+    params << Param(u"type"_s, u"tracks"_s);
+    params << Param(u"user_auth_token"_s, user_auth_token());
+  }
+  else if (query_type_ == Type::SearchSongs) params << Param(u"query"_s, search_text_);
+  if (request.limit > 0) params << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
+  if (query_type_ == Type::SearchSongs) {
+    return CreateRequest(u"track/search"_s, params);
   }
 
+  return CreateRequest(u"favorite/getUserFavorites"_s, params);
+
 }
 
 void QobuzRequest::ArtistsSearch() {
@@ -400,8 +307,6 @@ void QobuzRequest::AddSongsSearchRequest(const int offset) {
 
 void QobuzRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -541,7 +446,7 @@ void QobuzRequest::ArtistsFinishCheck(const int limit, const int offset, const i
     }
   }
 
-  if (artists_requests_queue_.isEmpty() && artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
+  if (artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
 
     // Get artist albums
     const QList<ArtistAlbumsRequest> requests = artist_albums_requests_pending_.values();
@@ -575,31 +480,21 @@ void QobuzRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
   ArtistAlbumsRequest request;
   request.artist = artist;
   request.offset = offset;
-  artist_albums_requests_queue_.enqueue(request);
-
   ++artist_albums_requests_total_;
+  ++artist_albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artistalbums"_s, this, [this, request]() { return SendArtistAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
 
 }
 
-void QobuzRequest::FlushArtistAlbumsRequests() {
+QNetworkReply *QobuzRequest::SendArtistAlbumsRequest(const ArtistAlbumsRequest &request) {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  ParamList params = ParamList() << Param(u"artist_id"_s, request.artist.artist_id)
+                                 << Param(u"extra"_s, u"albums"_s);
 
-    const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
-    ParamList params = ParamList() << Param(u"artist_id"_s, request.artist.artist_id)
-                                   << Param(u"extra"_s, u"albums"_s);
-
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(u"artist/get"_s, params);
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
-    replies_ << reply;
-
-    ++artist_albums_requests_active_;
-
-  }
+  return CreateRequest(u"artist/get"_s, params);
 
 }
 
@@ -614,8 +509,6 @@ void QobuzRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artist
 
 void QobuzRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_requested, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -791,11 +684,8 @@ void QobuzRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
   }
 
   if (
-      artists_requests_queue_.isEmpty() &&
       artists_requests_active_ <= 0 &&
-      albums_requests_queue_.isEmpty() &&
       albums_requests_active_ <= 0 &&
-      artist_albums_requests_queue_.isEmpty() &&
       artist_albums_requests_active_ <= 0
       ) { // Artist albums query is finished, get all songs for all albums.
 
@@ -833,28 +723,19 @@ void QobuzRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
   request.artist = artist;
   request.album = album;
   request.offset = offset;
-  album_songs_requests_queue_.enqueue(request);
-
   ++album_songs_requests_total_;
+  ++album_songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albumsongs"_s, this, [this, request]() { return SendAlbumSongsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
 
 }
 
-void QobuzRequest::FlushAlbumSongsRequests() {
-
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+QNetworkReply *QobuzRequest::SendAlbumSongsRequest(const AlbumSongsRequest &request) {
 
-    AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
-    ParamList params = ParamList() << Param(u"album_id"_s, request.album.album_id);
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(u"album/get"_s, params);
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
+  ParamList params = ParamList() << Param(u"album_id"_s, request.album.album_id);
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
-    ++album_songs_requests_active_;
-
-  }
+  return CreateRequest(u"album/get"_s, params);
 
 }
 
@@ -871,8 +752,6 @@ void QobuzRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist &a
 
 void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requested, const Album &album_requested, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -1014,11 +893,11 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
   }
+  InsertSongs(songs);
 
   if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
@@ -1224,18 +1103,55 @@ void QobuzRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Arti
 
 }
 
+void QobuzRequest::InsertSongs(const SongList &songs) {
+
+  if (!IsQuery()) {
+    SongMap page_songs;
+    for (const Song &song : songs) {
+      if (!songs_.contains(song.song_id())) {
+        page_songs.insert(song.song_id(), song);
+      }
+      songs_.insert(song.song_id(), song);
+    }
+    // Search results are shown page by page, the complete result is still sent with Results() when the search is finished.
+    if (IsSearch() && !page_songs.isEmpty()) {
+      Q_EMIT PartialResults(query_id_, page_songs);
+    }
+    return;
+  }
+
+  SongMap synced_songs;
+  for (Song song : songs) {
+    if (service_->download_album_covers() && song.art_automatic().isValid() && !SetCachedAlbumCover(song)) {
+      songs_.insert(song.song_id(), song);
+    }
+    synced_songs.insert(song.song_id(), song);
+  }
+
+  if (synced_songs.isEmpty()) return;
+
+  songs_synced_ += static_cast<int>(synced_songs.count());
+  Q_EMIT SongsSynced(query_id_, synced_songs);
+
+}
+
+bool QobuzRequest::SetCachedAlbumCover(Song &song) const {
+
+  const QString filename = CoverUtils::CoverFilePath(CoverOptions(), song.source(), song.effective_albumartist(), song.effective_album(), song.album_id(), QString(), song.art_automatic());
+  if (filename.isEmpty() || !QFileInfo::exists(filename)) return false;
+
+  song.set_art_automatic(QUrl::fromLocalFile(filename));
+
+  return true;
+
+}
+
 void QobuzRequest::GetAlbumCoversCheck() {
 
   if (
       !finished_ &&
       service_->download_album_covers() &&
       IsQuery() &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1262,8 +1178,6 @@ void QobuzRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
-
 }
 
 void QobuzRequest::AddAlbumCoverRequest(const Song &song) {
@@ -1283,40 +1197,25 @@ void QobuzRequest::AddAlbumCoverRequest(const Song &song) {
 
   album_covers_requests_sent_.insert(cover_url, song.song_id());
   ++album_covers_requests_total_;
+  ++album_covers_requests_active_;
 
-  album_cover_requests_queue_.enqueue(request);
+  scheduler_->Queue(u"albumcovers"_s, this, [this, request]() { return SendAlbumCoverRequest(request); }, [this, request](QNetworkReply *reply) { AlbumCoverReceived(reply, request.url, request.filename); });
 
 }
 
-void QobuzRequest::FlushAlbumCoverRequests() {
-
-  while (!album_cover_requests_queue_.isEmpty() && album_covers_requests_active_ < kMaxConcurrentAlbumCoverRequests) {
-
-    AlbumCoverRequest request = album_cover_requests_queue_.dequeue();
+QNetworkReply *QobuzRequest::SendAlbumCoverRequest(const AlbumCoverRequest &request) {
 
-    QNetworkRequest req(request.url);
-    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *reply = network_->get(req);
-    album_cover_replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumCoverReceived(reply, request.url, request.filename); });
+  QNetworkRequest req(request.url);
+  req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
 
-    ++album_covers_requests_active_;
-
-  }
+  return network_->get(req);
 
 }
 
 void QobuzRequest::AlbumCoverReceived(QNetworkReply *reply, const QUrl &cover_url, const QString &filename) {
 
-  if (album_cover_replies_.contains(reply)) {
-    album_cover_replies_.removeAll(reply);
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    reply->deleteLater();
-  }
-  else {
-    AlbumCoverFinishCheck();
-    return;
-  }
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
 
   --album_covers_requests_active_;
   ++album_covers_requests_received_;
@@ -1403,12 +1302,6 @@ void QobuzRequest::FinishCheck() {
 
   if (
       !finished_ &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1419,11 +1312,15 @@ void QobuzRequest::FinishCheck() {
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0
   ) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
-    if (no_results_ && songs_.isEmpty()) {
+    if (IsQuery()) {
+      if (!songs_.isEmpty()) Q_EMIT SongsSynced(query_id_, songs_);
+      if (!no_results_ && songs_synced_ == 0 && errors_.isEmpty())
+        Q_EMIT Results(query_id_, SongMap(), tr("Unknown error"));
+      else
+        Q_EMIT Results(query_id_, SongMap(), ErrorsToHTML(errors_));
+    }
+    else if (no_results_ && songs_.isEmpty()) {
       if (IsSearch())
         Q_EMIT Results(query_id_, SongMap(), tr("No match."));
       else
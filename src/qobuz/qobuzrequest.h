@@ -30,7 +30,6 @@
 #include <QHash>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -42,7 +41,7 @@
 #include "qobuzbaserequest.h"
 
 class QNetworkReply;
-class QTimer;
+class StreamingRequestScheduler;
 class NetworkAccessManager;
 class QobuzService;
 class QobuzUrlHandler;
@@ -101,6 +100,8 @@ class QobuzRequest : public QobuzBaseRequest {
   void LoginSuccess();
   void LoginFailure(const QString &failure_reason);
   void Results(const int id, const SongMap &songs, const QString &error);
+  void SongsSynced(const int id, const SongMap &songs);
+  void PartialResults(const int id, const SongMap &songs);
   void UpdateStatus(const int id, const QString &text);
   void UpdateProgress(const int id, const int max);
   void StreamURLFinished(const QUrl &media_url, const QUrl &url, const Song::FileType filetype, const QString &error = QString());
@@ -123,9 +124,6 @@ class QobuzRequest : public QobuzBaseRequest {
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (query_type_ == Type::SearchArtists || query_type_ == Type::SearchAlbums || query_type_ == Type::SearchSongs); }
 
-  void StartRequests();
-  void FlushRequests();
-
   void GetArtists();
   void GetAlbums();
   void GetSongs();
@@ -136,32 +134,34 @@ class QobuzRequest : public QobuzBaseRequest {
 
   void AddArtistsRequest(const int offset = 0, const int limit = 0);
   void AddArtistsSearchRequest(const int offset = 0);
-  void FlushArtistsRequests();
+  QNetworkReply *SendArtistsRequest(const Request &request);
   void AddAlbumsRequest(const int offset = 0, const int limit = 0);
   void AddAlbumsSearchRequest(const int offset = 0);
-  void FlushAlbumsRequests();
+  QNetworkReply *SendAlbumsRequest(const Request &request);
   void AddSongsRequest(const int offset = 0, const int limit = 0);
   void AddSongsSearchRequest(const int offset = 0);
-  void FlushSongsRequests();
+  QNetworkReply *SendSongsRequest(const Request &request);
 
   void ArtistsFinishCheck(const int limit = 0, const int offset = 0, const int artists_received = 0);
   void AlbumsFinishCheck(const Artist &artist, const int limit = 0, const int offset = 0, const int albums_total = 0, const int albums_received = 0);
   void SongsFinishCheck(const Artist &artist, const Album &album, const int limit = 0, const int offset = 0, const int songs_total = 0, const int songs_received = 0);
 
   void AddArtistAlbumsRequest(const Artist &artist, const int offset = 0);
-  void FlushArtistAlbumsRequests();
+  QNetworkReply *SendArtistAlbumsRequest(const ArtistAlbumsRequest &request);
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
-  void FlushAlbumSongsRequests();
+  QNetworkReply *SendAlbumSongsRequest(const AlbumSongsRequest &request);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+  void InsertSongs(const SongList &songs);
+  bool SetCachedAlbumCover(Song &song) const;
 
   QString AlbumCoverFileName(const Song &song);
 
   void GetAlbumCoversCheck();
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
-  void FlushAlbumCoverRequests();
+  QNetworkReply *SendAlbumCoverRequest(const AlbumCoverRequest &request);
   void AlbumCoverFinishCheck();
 
   int GetProgress(const int count, const int total);
@@ -173,7 +173,7 @@ class QobuzRequest : public QobuzBaseRequest {
   QobuzService *service_;
   QobuzUrlHandler *url_handler_;
   const SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_flush_requests_;
+  StreamingRequestScheduler *scheduler_;
 
   const Type query_type_;
   int query_id_;
@@ -181,14 +181,6 @@ class QobuzRequest : public QobuzBaseRequest {
 
   bool finished_;
 
-  QQueue<Request> artists_requests_queue_;
-  QQueue<Request> albums_requests_queue_;
-  QQueue<Request> songs_requests_queue_;
-
-  QQueue<ArtistAlbumsRequest> artist_albums_requests_queue_;
-  QQueue<AlbumSongsRequest> album_songs_requests_queue_;
-  QQueue<AlbumCoverRequest> album_cover_requests_queue_;
-
   QHash<QString, ArtistAlbumsRequest> artist_albums_requests_pending_;
   QHash<QString, AlbumSongsRequest> album_songs_requests_pending_;
   QMultiMap<QUrl, QString> album_covers_requests_sent_;
@@ -228,10 +220,9 @@ class QobuzRequest : public QobuzBaseRequest {
   int album_covers_requests_received_;
 
   SongMap songs_;
+  int songs_synced_;
   QStringList errors_;
   bool no_results_;
-  QList<QNetworkReply*> replies_;
-  QList<QNetworkReply*> album_cover_replies_;
 };
 
 #endif  // QOBUZREQUEST_H
@@ -520,9 +520,11 @@ void QobuzService::GetArtists() {
   ResetArtistsRequest();
   artists_request_.reset(new QobuzRequest(this, url_handler_, network_, QobuzBaseRequest::Type::FavouriteArtists), [](QobuzRequest *request) { request->deleteLater(); });
   QObject::connect(&*artists_request_, &QobuzRequest::Results, this, &QobuzService::ArtistsResultsReceived);
+  QObject::connect(&*artists_request_, &QobuzRequest::SongsSynced, this, &QobuzService::ArtistsSyncedReceived);
   QObject::connect(&*artists_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::ArtistsUpdateStatusReceived);
   QObject::connect(&*artists_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::ArtistsUpdateProgressReceived);
 
+  artists_collection_backend_->BeginSyncAsync();
   artists_request_->Process();
 
 }
@@ -530,11 +532,21 @@ void QobuzService::GetArtists() {
 void QobuzService::ArtistsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT ArtistsResults(songs, error);
+  Q_UNUSED(songs);
+
+  artists_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT ArtistsSyncFinished(error);
   ResetArtistsRequest();
 
 }
 
+void QobuzService::ArtistsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  artists_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void QobuzService::ArtistsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT ArtistsUpdateStatus(text);
@@ -570,9 +582,11 @@ void QobuzService::GetAlbums() {
   ResetAlbumsRequest();
   albums_request_.reset(new QobuzRequest(this, url_handler_, network_, QobuzBaseRequest::Type::FavouriteAlbums), [](QobuzRequest *request) { request->deleteLater(); });
   QObject::connect(&*albums_request_, &QobuzRequest::Results, this, &QobuzService::AlbumsResultsReceived);
+  QObject::connect(&*albums_request_, &QobuzRequest::SongsSynced, this, &QobuzService::AlbumsSyncedReceived);
   QObject::connect(&*albums_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::AlbumsUpdateStatusReceived);
   QObject::connect(&*albums_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::AlbumsUpdateProgressReceived);
 
+  albums_collection_backend_->BeginSyncAsync();
   albums_request_->Process();
 
 }
@@ -580,11 +594,21 @@ void QobuzService::GetAlbums() {
 void QobuzService::AlbumsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT AlbumsResults(songs, error);
+  Q_UNUSED(songs);
+
+  albums_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT AlbumsSyncFinished(error);
   ResetAlbumsRequest();
 
 }
 
+void QobuzService::AlbumsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  albums_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void QobuzService::AlbumsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT AlbumsUpdateStatus(text);
@@ -620,9 +644,11 @@ void QobuzService::GetSongs() {
   ResetSongsRequest();
   songs_request_.reset(new QobuzRequest(this, url_handler_, network_, QobuzBaseRequest::Type::FavouriteSongs), [](QobuzRequest *request) { request->deleteLater(); });
   QObject::connect(&*songs_request_, &QobuzRequest::Results, this, &QobuzService::SongsResultsReceived);
+  QObject::connect(&*songs_request_, &QobuzRequest::SongsSynced, this, &QobuzService::SongsSyncedReceived);
   QObject::connect(&*songs_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::SongsUpdateStatusReceived);
   QObject::connect(&*songs_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::SongsUpdateProgressReceived);
 
+  songs_collection_backend_->BeginSyncAsync();
   songs_request_->Process();
 
 }
@@ -630,11 +656,21 @@ void QobuzService::GetSongs() {
 void QobuzService::SongsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT SongsResults(songs, error);
+  Q_UNUSED(songs);
+
+  songs_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT SongsSyncFinished(error);
   ResetSongsRequest();
 
 }
 
+void QobuzService::SongsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  songs_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void QobuzService::SongsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT SongsUpdateStatus(text);
@@ -679,6 +715,16 @@ void QobuzService::StartSearch() {
 }
 
 void QobuzService::CancelSearch() {
+
+  timer_search_delay_->stop();
+
+  // Abort the replies of a superseded search right away instead of letting it finish in the background.
+  if (search_request_) {
+    QObject::disconnect(&*search_request_, nullptr, this, nullptr);
+    QObject::disconnect(this, nullptr, &*search_request_, nullptr);
+    search_request_.reset();
+  }
+
 }
 
 void QobuzService::SendSearch() {
@@ -700,6 +746,7 @@ void QobuzService::SendSearch() {
   search_request_.reset(new QobuzRequest(this, url_handler_, network_, query_type), [](QobuzRequest *request) { request->deleteLater(); } );
 
   QObject::connect(&*search_request_, &QobuzRequest::Results, this, &QobuzService::SearchResultsReceived);
+  QObject::connect(&*search_request_, &QobuzRequest::PartialResults, this, &QobuzService::SearchPartialResults);
   QObject::connect(&*search_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::SearchUpdateStatus);
   QObject::connect(&*search_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::SearchUpdateProgress);
 
@@ -137,6 +137,9 @@ class QobuzService : public StreamingService {
   void ArtistsResultsReceived(const int id, const SongMap &songs, const QString &error);
   void AlbumsResultsReceived(const int id, const SongMap &songs, const QString &error);
   void SongsResultsReceived(const int id, const SongMap &songs, const QString &error);
+  void ArtistsSyncedReceived(const int id, const SongMap &songs);
+  void AlbumsSyncedReceived(const int id, const SongMap &songs);
+  void SongsSyncedReceived(const int id, const SongMap &songs);
   void SearchResultsReceived(const int id, const SongMap &songs, const QString &error);
   void ArtistsUpdateStatusReceived(const int id, const QString &text);
   void AlbumsUpdateStatusReceived(const int id, const QString &text);
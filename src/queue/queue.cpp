@@ -46,7 +46,13 @@ namespace {
 constexpr char kRowsMimetype[] = "application/x-strawberry-queue-rows";
 }
 
-Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), playlist_(playlist), total_length_ns_(0) {
+Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), source_row_positions_dirty_(false), playlist_(playlist), total_length_ns_(0) {
+
+  // Connected before anyone else, so positions are invalidated before the playlist reacts to the queue changing.
+  QObject::connect(this, &Queue::rowsInserted, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(this, &Queue::rowsRemoved, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(this, &Queue::layoutChanged, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(this, &Queue::modelReset, this, &Queue::InvalidateSourceRowPositions);
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
   QObject::connect(this, &Queue::TotalLengthChanged, this, &Queue::UpdateSummaryText);
@@ -59,22 +65,55 @@ QModelIndex Queue::mapFromSource(const QModelIndex &source_index) const {
 
   if (!source_index.isValid()) return QModelIndex();
 
-  const int source_row = source_index.row();
-  for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) {
-      return index(i, source_index.column());
-    }
-  }
-  return QModelIndex();
+  const int position = SourceRowPosition(source_index.row());
+  if (position == -1) return QModelIndex();
+
+  return index(position, source_index.column());
 
 }
 
 bool Queue::ContainsSourceRow(const int source_row) const {
 
+  return SourceRowPosition(source_row) != -1;
+
+}
+
+int Queue::SourceRowPosition(const int source_row) const {
+
+  if (source_row_positions_dirty_) {
+    UpdateSourceRowPositions();
+  }
+
+  int position = source_row_positions_.value(source_row, -1);
+
+  // Persistent indexes can move without us being notified in time, so verify the hit before trusting it.
+  if (position != -1 && (position >= source_indexes_.count() || source_indexes_[position].row() != source_row)) {
+    UpdateSourceRowPositions();
+    position = source_row_positions_.value(source_row, -1);
+  }
+
+  return position;
+
+}
+
+void Queue::UpdateSourceRowPositions() const {
+
+  source_row_positions_.clear();
+  source_row_positions_.reserve(source_indexes_.count());
   for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) return true;
+    const int source_row = source_indexes_[i].row();
+    if (source_row != -1 && !source_row_positions_.contains(source_row)) {
+      source_row_positions_.insert(source_row, i);
+    }
   }
-  return false;
+
+  source_row_positions_dirty_ = false;
+
+}
+
+void Queue::InvalidateSourceRowPositions() {
+
+  source_row_positions_dirty_ = true;
 
 }
 
@@ -92,13 +131,21 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
     QObject::disconnect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::InvalidateSourceRowPositions);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::InvalidateSourceRowPositions);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::InvalidateSourceRowPositions);
   }
 
   QAbstractProxyModel::setSourceModel(source_model);
 
+  InvalidateSourceRowPositions();
+
   QObject::connect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::InvalidateSourceRowPositions);
 
 }
 
@@ -116,6 +163,8 @@ void Queue::SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bo
 
 void Queue::SourceLayoutChanged() {
 
+  InvalidateSourceRowPositions();
+
   QObject::disconnect(signal_item_count_changed_);
 
   for (int i = 0; i < source_indexes_.count(); ++i) {
@@ -189,9 +238,17 @@ void Queue::ToggleTracks(const QModelIndexList &source_indexes) {
     else {
       // Enqueue the track
       const int row = static_cast<int>(source_indexes_.count());
+      const bool source_row_positions_valid = !source_row_positions_dirty_;
       beginInsertRows(QModelIndex(), row, row);
       source_indexes_ << QPersistentModelIndex(source_index);
       endInsertRows();
+      // Appending does not move any existing positions, so update the map instead of rebuilding it.
+      if (source_row_positions_valid) {
+        if (!source_row_positions_.contains(source_index.row())) {
+          source_row_positions_.insert(source_index.row(), row);
+        }
+        source_row_positions_dirty_ = false;
+      }
     }
   }
 
@@ -223,7 +280,11 @@ void Queue::InsertFirst(const QModelIndexList &source_indexes) {
 }
 
 int Queue::PositionOf(const QModelIndex &source_index) const {
-  return mapFromSource(source_index).row();
+
+  if (!source_index.isValid()) return -1;
+
+  return SourceRowPosition(source_index.row());
+
 }
 
 bool Queue::is_empty() const { return source_indexes_.isEmpty(); }
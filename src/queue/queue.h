@@ -28,6 +28,7 @@
 #include <QAbstractItemModel>
 #include <QAbstractProxyModel>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -89,9 +90,17 @@ class Queue : public QAbstractProxyModel {
   void SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
   void SourceLayoutChanged();
   void UpdateTotalLength();
+  void InvalidateSourceRowPositions();
+
+ private:
+  int SourceRowPosition(const int source_row) const;
+  void UpdateSourceRowPositions() const;
 
  private:
   QList<QPersistentModelIndex> source_indexes_;
+  // Maps source rows to queue positions, rebuilt lazily when the queue or the source rows change.
+  mutable QHash<int, int> source_row_positions_;
+  mutable bool source_row_positions_dirty_;
   const Playlist *playlist_;
   quint64 total_length_ns_;
   QMetaObject::Connection signal_item_count_changed_;
@@ -0,0 +1,386 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <memory>
+#include <utility>
+#include <initializer_list>
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+
+#include <QObject>
+#include <QMetaObject>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QUrl>
+#include <QTemporaryDir>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/song.h"
+#include "tagreader/tagreaderclient.h"
+#include "transcoder/transcoder.h"
+#include "ripper.h"
+
+using std::make_unique;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+// How often the read loop checks for cancellation while waiting for the track to finish.
+constexpr GstClockTime kBusPollInterval = 100 * GST_MSECOND;
+}  // namespace
+
+Ripper::Ripper(const SharedPtr<TagReaderClient> tagreader_client, QObject *parent)
+    : QObject(parent),
+      tagreader_client_(tagreader_client),
+      transcoder_(new Transcoder(this)),
+      running_(false),
+      reading_(false),
+      writing_tags_(false),
+      cancel_requested_(false) {
+
+  QObject::connect(transcoder_, &Transcoder::JobComplete, this, &Ripper::TrackEncoded);
+  QObject::connect(transcoder_, &Transcoder::LogLine, this, &Ripper::LogLine);
+
+}
+
+Ripper::~Ripper() {
+
+  cancel_requested_ = true;
+  read_future_.waitForFinished();
+  tags_future_.waitForFinished();
+
+}
+
+void Ripper::set_max_encoders(const int count) {
+
+  transcoder_->set_max_threads(count);
+
+}
+
+void Ripper::AddTrack(const Song &song, const QString &output_filename, const TranscoderPreset &preset) {
+
+  if (running_) return;
+
+  Track track;
+  track.song = song;
+  track.output_filename = output_filename;
+  track.preset = preset;
+  tracks_ << track;
+
+}
+
+void Ripper::ClearTracks() {
+
+  if (running_) return;
+
+  tracks_.clear();
+
+}
+
+void Ripper::SetTracksMetadata(const SongList &songs) {
+
+  for (const Song &song : songs) {
+    for (Track &track : tracks_) {
+      if (track.song.track() == song.track()) {
+        track.song = song;
+      }
+    }
+  }
+
+}
+
+void Ripper::Start() {
+
+  if (running_ || tracks_.isEmpty()) return;
+
+  temporary_dir_ = make_unique<QTemporaryDir>();
+  if (!temporary_dir_->isValid()) {
+    Q_EMIT LogLine(tr("Could not create a temporary directory for ripping."));
+    temporary_dir_.reset();
+    Q_EMIT Finished(SongList());
+    return;
+  }
+
+  for (int i = 0; i < tracks_.count(); ++i) {
+    Track &track = tracks_[i];
+    track.temporary_filename = temporary_dir_->filePath(u"track%1.wav"_s.arg(i));
+    track.read = false;
+    track.finished = false;
+    track.success = false;
+  }
+
+  running_ = true;
+  reading_ = true;
+  writing_tags_ = false;
+  cancel_requested_ = false;
+
+  Q_EMIT LogLine(tr("Ripping %1 tracks").arg(tracks_.count()));
+  UpdateProgress();
+
+  read_future_ = QtConcurrent::run(&Ripper::ReadTracks, this, tracks_);
+  QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
+  QObject::connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher]() {
+    watcher->deleteLater();
+    ReadFinished();
+  });
+  watcher->setFuture(read_future_);
+
+}
+
+void Ripper::Cancel() {
+
+  if (!running_) return;
+
+  cancel_requested_ = true;
+  transcoder_->Cancel();
+  read_future_.waitForFinished();
+  // Writing the tags can't be interrupted, but Finished is not emitted for it anymore.
+  tags_future_.waitForFinished();
+
+  for (const Track &track : std::as_const(tracks_)) {
+    if (!track.finished && QFile::exists(track.output_filename)) {
+      QFile::remove(track.output_filename);
+    }
+  }
+
+  running_ = false;
+  reading_ = false;
+  writing_tags_ = false;
+  temporary_dir_.reset();
+
+  Q_EMIT Cancelled();
+
+}
+
+GstElement *Ripper::CreateSource(const int track_number) const {
+
+  if (source_factory_) {
+    return source_factory_(track_number);
+  }
+
+  GError *error = nullptr;
+  GstElement *source = gst_element_make_from_uri(GST_URI_SRC, "cdda://", nullptr, &error);
+  if (error) {
+    qLog(Error) << "Could not create CDDA source:" << error->message;
+    g_error_free(error);
+  }
+  if (!source) return nullptr;
+
+  if (!device_.isEmpty()) {
+    g_object_set(source, "device", device_.toLocal8Bit().constData(), nullptr);
+  }
+  g_object_set(source, "track", static_cast<guint>(track_number), nullptr);
+
+  return source;
+
+}
+
+void Ripper::ReadTracks(const QList<Track> &tracks) {
+
+  // Reading is seek-bound, so the tracks are read one after the other while the transcoder encodes the ones already read.
+  for (int i = 0; i < tracks.count(); ++i) {
+    if (cancel_requested_.value()) return;
+    const bool success = ReadTrack(tracks[i]);
+    QMetaObject::invokeMethod(this, [this, i, success]() { TrackRead(i, success); }, Qt::QueuedConnection);
+  }
+
+}
+
+bool Ripper::ReadTrack(const Track &track) {
+
+  GstElement *pipeline = gst_pipeline_new("ripper");
+  GstElement *source = CreateSource(track.song.track());
+  GstElement *convert = gst_element_factory_make("audioconvert", nullptr);
+  GstElement *encoder = gst_element_factory_make("wavenc", nullptr);
+  GstElement *sink = gst_element_factory_make("filesink", nullptr);
+
+  const bool elements_created = source && convert && encoder && sink;
+  for (GstElement *element : {source, convert, encoder, sink}) {
+    if (element) gst_bin_add(GST_BIN(pipeline), element);
+  }
+
+  if (!elements_created || !gst_element_link_many(source, convert, encoder, sink, nullptr)) {
+    qLog(Error) << "Could not create the pipeline for ripping track" << track.song.track();
+    gst_object_unref(pipeline);
+    return false;
+  }
+
+  g_object_set(sink, "location", track.temporary_filename.toUtf8().constData(), nullptr);
+
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+  GstBus *bus = gst_element_get_bus(pipeline);
+  bool success = false;
+  while (!cancel_requested_.value()) {
+    GstMessage *msg = gst_bus_timed_pop_filtered(bus, kBusPollInterval, static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    if (!msg) continue;
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS) {
+      success = true;
+    }
+    else {
+      GError *error = nullptr;
+      gchar *debugs = nullptr;
+      gst_message_parse_error(msg, &error, &debugs);
+      qLog(Error) << "Error ripping track" << track.song.track() << ":" << (error ? error->message : "") << debugs;
+      if (error) g_error_free(error);
+      g_free(debugs);
+    }
+    gst_message_unref(msg);
+    break;
+  }
+  gst_object_unref(bus);
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+
+  return success;
+
+}
+
+void Ripper::TrackRead(const int index, const bool success) {
+
+  if (!running_ || index >= tracks_.count()) return;
+
+  Track &track = tracks_[index];
+  track.read = true;
+
+  if (success) {
+    // The transcoder writes straight to the output, so files ripped into a collection directory are picked up by the collection watcher.
+    QDir().mkpath(QFileInfo(track.output_filename).absolutePath());
+    transcoder_->AddJob(track.temporary_filename, track.preset, track.output_filename);
+    transcoder_->Start();
+  }
+  else {
+    Q_EMIT LogLine(tr("Could not read track %1").arg(track.song.track()));
+    track.finished = true;
+  }
+
+  UpdateProgress();
+  MaybeWriteTags();
+
+}
+
+void Ripper::ReadFinished() {
+
+  if (!running_) return;
+
+  reading_ = false;
+  MaybeWriteTags();
+
+}
+
+void Ripper::TrackEncoded(const QString &input, const QString &output, const bool success) {
+
+  if (!running_) return;
+
+  for (Track &track : tracks_) {
+    if (track.temporary_filename != input) continue;
+    track.finished = true;
+    track.success = success;
+    if (!success) {
+      Q_EMIT LogLine(tr("Could not encode track %1 to %2").arg(track.song.track()).arg(output));
+    }
+    QFile::remove(input);
+    break;
+  }
+
+  UpdateProgress();
+  MaybeWriteTags();
+
+}
+
+void Ripper::UpdateProgress() {
+
+  if (tracks_.isEmpty()) return;
+
+  qint64 steps = 0;
+  for (const Track &track : std::as_const(tracks_)) {
+    if (track.read) ++steps;
+    if (track.finished) ++steps;
+  }
+
+  Q_EMIT Progress(static_cast<int>(steps * 100 / (tracks_.count() * 2)));
+
+}
+
+void Ripper::MaybeWriteTags() {
+
+  if (!running_ || reading_ || writing_tags_) return;
+
+  for (const Track &track : std::as_const(tracks_)) {
+    if (!track.finished) return;
+  }
+
+  writing_tags_ = true;
+
+  tags_future_ = QtConcurrent::run(&Ripper::WriteTags, tagreader_client_, tracks_);
+  QFutureWatcher<SongList> *watcher = new QFutureWatcher<SongList>();
+  QObject::connect(watcher, &QFutureWatcher<SongList>::finished, this, [this, watcher]() {
+    const SongList songs = watcher->result();
+    watcher->deleteLater();
+    // Cancelled while the tags were written.
+    if (!running_ || !writing_tags_) return;
+    running_ = false;
+    writing_tags_ = false;
+    temporary_dir_.reset();
+    Q_EMIT LogLine(tr("Ripped %1 of %2 tracks").arg(songs.count()).arg(tracks_.count()));
+    Q_EMIT Finished(songs);
+  });
+  watcher->setFuture(tags_future_);
+
+}
+
+SongList Ripper::WriteTags(const SharedPtr<TagReaderClient> tagreader_client, const QList<Track> &tracks) {
+
+  SongList songs;
+  for (const Track &track : tracks) {
+    if (!track.success) continue;
+
+    const QFileInfo fileinfo(track.output_filename);
+    Song song = track.song;
+    song.set_source(Song::Source::LocalFile);
+    song.set_url(QUrl::fromLocalFile(fileinfo.absoluteFilePath()));
+    song.set_basefilename(fileinfo.fileName());
+    song.set_filetype(track.preset.filetype_);
+
+    const TagReaderResult result = tagreader_client->WriteFileBlocking(track.output_filename, song);
+    if (!result.success()) {
+      qLog(Error) << "Could not write tags to" << track.output_filename << result.error_string();
+    }
+
+    const QFileInfo tagged_fileinfo(track.output_filename);
+    song.set_filesize(tagged_fileinfo.size());
+    song.set_mtime(tagged_fileinfo.lastModified().toSecsSinceEpoch());
+    songs << song;
+  }
+
+  return songs;
+
+}
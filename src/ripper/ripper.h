@@ -0,0 +1,121 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RIPPER_H
+#define RIPPER_H
+
+#include "config.h"
+
+#include <functional>
+
+#include <gst/gst.h>
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QFuture>
+#include <QTemporaryDir>
+
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "includes/mutex_protected.h"
+#include "core/song.h"
+#include "transcoder/transcoder.h"
+
+class TagReaderClient;
+
+// Rips the tracks of an audio CD into files.
+// The disc is read one track at a time to temporary WAV files, the transcoder encodes each track while the next one is read.
+// Tags are written when all tracks are encoded, so metadata from a MusicBrainz lookup that finishes during ripping is used.
+class Ripper : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit Ripper(const SharedPtr<TagReaderClient> tagreader_client, QObject *parent = nullptr);
+  ~Ripper() override;
+
+  // Creates the element reading a track, the default reads from the CD drive.
+  using SourceFactory = std::function<GstElement*(const int track_number)>;
+
+  void set_device(const QString &device) { device_ = device; }
+  void set_source_factory(const SourceFactory &source_factory) { source_factory_ = source_factory; }
+
+  // Number of tracks encoded at the same time.
+  void set_max_encoders(const int count);
+
+  // The song holds the track number and the tags to write, the output file can be in a collection directory.
+  void AddTrack(const Song &song, const QString &output_filename, const TranscoderPreset &preset);
+  void ClearTracks();
+  qint64 TracksCount() const { return tracks_.count(); }
+
+  bool running() const { return running_; }
+
+ public Q_SLOTS:
+  void Start();
+  void Cancel();
+
+  // Updates the tags of the tracks with the same track number.
+  void SetTracksMetadata(const SongList &songs);
+
+ Q_SIGNALS:
+  void Progress(const int percent);
+  void LogLine(const QString &message);
+  void Finished(const SongList &songs);
+  void Cancelled();
+
+ private:
+  struct Track {
+    Track() : read(false), finished(false), success(false) {}
+    Song song;
+    QString output_filename;
+    QString temporary_filename;
+    TranscoderPreset preset;
+    bool read;
+    // Encoded, or failed to read or encode.
+    bool finished;
+    bool success;
+  };
+
+  GstElement *CreateSource(const int track_number) const;
+  void ReadTracks(const QList<Track> &tracks);
+  bool ReadTrack(const Track &track);
+  static SongList WriteTags(const SharedPtr<TagReaderClient> tagreader_client, const QList<Track> &tracks);
+
+  void TrackRead(const int index, const bool success);
+  void ReadFinished();
+  void TrackEncoded(const QString &input, const QString &output, const bool success);
+  void UpdateProgress();
+  void MaybeWriteTags();
+
+ private:
+  const SharedPtr<TagReaderClient> tagreader_client_;
+  Transcoder *transcoder_;
+  QString device_;
+  SourceFactory source_factory_;
+  QList<Track> tracks_;
+  ScopedPtr<QTemporaryDir> temporary_dir_;
+  QFuture<void> read_future_;
+  QFuture<SongList> tags_future_;
+  bool running_;
+  bool reading_;
+  bool writing_tags_;
+  mutex_protected<bool> cancel_requested_;
+};
+
+#endif  // RIPPER_H
@@ -51,7 +51,11 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kRequestsDelay = 2000;
+// Pages are requested concurrently, but started at most 4 per second to stay within the API limits.
+constexpr int kRequestsDelay = 250;
+constexpr int kMaxConcurrentRequests = 4;
+constexpr int kRecentTracksPerPage = 200;
+constexpr int kTopTracksPerPage = 500;
 }
 
 LastFMImport::LastFMImport(const SharedPtr<NetworkAccessManager> network, QObject *parent)
@@ -93,6 +97,8 @@ void LastFMImport::AbortAll() {
 
   recent_tracks_requests_.clear();
   top_tracks_requests_.clear();
+  lastplayed_tracks_.clear();
+  playcount_tracks_.clear();
   timer_flush_requests_->stop();
 
 }
@@ -230,6 +236,8 @@ void LastFMImport::ImportData(const bool lastplayed, const bool playcount) {
 
 void LastFMImport::FlushRequests() {
 
+  if (replies_.count() >= kMaxConcurrentRequests) return;
+
   if (!recent_tracks_requests_.isEmpty()) {
     SendGetRecentTracksRequest(recent_tracks_requests_.dequeue());
     return;
@@ -264,7 +272,7 @@ void LastFMImport::SendGetRecentTracksRequest(GetRecentTracksRequest request) {
   }
   else {
     params << Param(u"page"_s, QString::number(request.page));
-    params << Param(u"limit"_s, u"500"_s);
+    params << Param(u"limit"_s, QString::number(kRecentTracksPerPage));
   }
 
   QNetworkReply *reply = CreateRequest(params);
@@ -344,12 +352,14 @@ void LastFMImport::GetRecentTracksRequestFinished(QNetworkReply *reply, const in
   }
 
   int total = obj_attr["total"_L1].toString().toInt();
-  int pages = obj_attr["totalPages"_L1].toString().toInt();
 
   if (page == 0) {
     lastplayed_total_ = total;
     UpdateTotalCheck();
-    AddGetRecentTracksRequest(1);
+    const int pages = (total + kRecentTracksPerPage - 1) / kRecentTracksPerPage;
+    for (int i = 1; i <= pages; ++i) {
+      AddGetRecentTracksRequest(i);
+    }
   }
   else {
 
@@ -388,18 +398,19 @@ void LastFMImport::GetRecentTracksRequestFinished(QNetworkReply *reply, const in
       QString title = obj_track["name"_L1].toString();
       QDateTime datetime = QDateTime::fromString(date, u"dd MMM yyyy, hh:mm"_s);
       if (datetime.isValid()) {
-        Q_EMIT UpdateLastPlayed(artist, album, title, datetime.toSecsSinceEpoch());
+        const QString key = artist.toLower() + u'\n' + album.toLower() + u'\n' + title.toLower();
+        CollectionLastPlayed &lastplayed = lastplayed_tracks_[key];
+        if (datetime.toSecsSinceEpoch() > lastplayed.lastplayed) {
+          lastplayed.artist = artist;
+          lastplayed.album = album;
+          lastplayed.title = title;
+          lastplayed.lastplayed = datetime.toSecsSinceEpoch();
+        }
       }
 
-      UpdateProgressCheck();
-
     }
 
-    if (page == 1) {
-      for (int i = 2; i <= pages; ++i) {
-        AddGetRecentTracksRequest(i);
-      }
-    }
+    UpdateProgressCheck();
 
   }
 
@@ -427,7 +438,7 @@ void LastFMImport::SendGetTopTracksRequest(GetTopTracksRequest request) {
   }
   else {
     params << Param(u"page"_s, QString::number(request.page));
-    params << Param(u"limit"_s, u"500"_s);
+    params << Param(u"limit"_s, QString::number(kTopTracksPerPage));
   }
 
   QNetworkReply *reply = CreateRequest(params);
@@ -506,13 +517,15 @@ void LastFMImport::GetTopTracksRequestFinished(QNetworkReply *reply, const int p
     return;
   }
 
-  int pages = obj_attr["totalPages"_L1].toString().toInt();
   int total = obj_attr["total"_L1].toString().toInt();
 
   if (page == 0) {
     playcount_total_ = total;
     UpdateTotalCheck();
-    AddGetTopTracksRequest(1);
+    const int pages = (total + kTopTracksPerPage - 1) / kTopTracksPerPage;
+    for (int i = 1; i <= pages; ++i) {
+      AddGetTopTracksRequest(i);
+    }
   }
   else {
 
@@ -547,16 +560,14 @@ void LastFMImport::GetTopTracksRequestFinished(QNetworkReply *reply, const int p
 
       if (playcount <= 0) continue;
 
-      Q_EMIT UpdatePlayCount(artist, title, playcount, false);
-      UpdateProgressCheck();
+      CollectionPlayCount &track_playcount = playcount_tracks_[artist.toLower() + u'\n' + title.toLower()];
+      track_playcount.artist = artist;
+      track_playcount.title = title;
+      track_playcount.playcount += playcount;
 
     }
 
-    if (page == 1) {
-      for (int i = 2; i <= pages; ++i) {
-        AddGetTopTracksRequest(i);
-      }
-    }
+    UpdateProgressCheck();
 
   }
 
@@ -576,7 +587,21 @@ void LastFMImport::UpdateProgressCheck() {
 }
 
 void LastFMImport::FinishCheck() {
-  if (replies_.isEmpty() && recent_tracks_requests_.isEmpty() && top_tracks_requests_.isEmpty()) Q_EMIT Finished();
+
+  if (!replies_.isEmpty() || !recent_tracks_requests_.isEmpty() || !top_tracks_requests_.isEmpty()) return;
+
+  // Everything is written to the collection at once, instead of updating the songs for each track.
+  if (!lastplayed_tracks_.isEmpty()) {
+    Q_EMIT UpdateLastPlayed(lastplayed_tracks_.values());
+    lastplayed_tracks_.clear();
+  }
+  if (!playcount_tracks_.isEmpty()) {
+    Q_EMIT UpdatePlayCount(playcount_tracks_.values());
+    playcount_tracks_.clear();
+  }
+
+  Q_EMIT Finished();
+
 }
 
 void LastFMImport::Error(const QString &error, const QVariant &debug) {
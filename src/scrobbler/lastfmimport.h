@@ -29,9 +29,11 @@
 #include <QByteArray>
 #include <QString>
 #include <QQueue>
+#include <QHash>
 #include <QDateTime>
 
 #include "includes/shared_ptr.h"
+#include "collection/collectionplaystatistics.h"
 
 class QTimer;
 class QNetworkReply;
@@ -81,8 +83,8 @@ class LastFMImport : public QObject {
   void FinishCheck();
 
  Q_SIGNALS:
-  void UpdatePlayCount(const QString&, const QString&, const int, const bool = false);
-  void UpdateLastPlayed(const QString&, const QString&, const QString&, const qint64);
+  void UpdatePlayCount(const CollectionPlayCountList &playcount_list, const bool save_tags = false);
+  void UpdateLastPlayed(const CollectionLastPlayedList &lastplayed_list);
   void UpdateTotal(const int, const int);
   void UpdateProgress(const int, const int);
   void Finished();
@@ -106,6 +108,8 @@ class LastFMImport : public QObject {
   int lastplayed_received_;
   QQueue<GetRecentTracksRequest> recent_tracks_requests_;
   QQueue<GetTopTracksRequest> top_tracks_requests_;
+  QHash<QString, CollectionLastPlayed> lastplayed_tracks_;
+  QHash<QString, CollectionPlayCount> playcount_tracks_;
   QList<QNetworkReply*> replies_;
 };
 
@@ -22,6 +22,7 @@
 #include <QObject>
 
 #include "includes/shared_ptr.h"
+#include "core/taskmanager.h"
 #include "core/networkaccessmanager.h"
 
 #include "scrobblersettingsservice.h"
@@ -36,5 +37,5 @@ constexpr char kAuthUrl[] = "https://www.last.fm/api/auth/";
 constexpr char kCacheFile[] = "lastfmscrobbler.cache";
 }  // namespace
 
-LastFMScrobbler::LastFMScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent)
-    : ScrobblingAPI20(QLatin1String(kName), QLatin1String(kSettingsGroup), QLatin1String(kAuthUrl), QLatin1String(kApiUrl), true, QLatin1String(kCacheFile), settings, network, parent) {}
+LastFMScrobbler::LastFMScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent)
+    : ScrobblingAPI20(QLatin1String(kName), QLatin1String(kSettingsGroup), QLatin1String(kAuthUrl), QLatin1String(kApiUrl), true, QLatin1String(kCacheFile), settings, task_manager, network, parent) {}
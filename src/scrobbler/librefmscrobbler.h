@@ -29,13 +29,14 @@
 #include "scrobblingapi20.h"
 
 class ScrobblerSettingsService;
+class TaskManager;
 class NetworkAccessManager;
 
 class LibreFMScrobbler : public ScrobblingAPI20 {
   Q_OBJECT
 
  public:
-  explicit LibreFMScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  explicit LibreFMScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
 
   static const char *kName;
   static const char *kSettingsGroup;
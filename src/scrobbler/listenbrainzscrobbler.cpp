@@ -43,6 +43,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/networkaccessmanager.h"
+#include "core/taskmanager.h"
 #include "core/song.h"
 #include "core/logging.h"
 #include "core/settings.h"
@@ -55,6 +56,7 @@
 #include "scrobblercache.h"
 #include "scrobblercacheitem.h"
 #include "scrobblemetadata.h"
+#include "scrobblersubmitqueue.h"
 #include "listenbrainzscrobbler.h"
 
 using namespace Qt::Literals::StringLiterals;
@@ -71,9 +73,15 @@ constexpr char kClientIDB64[] = "b2VBVU53cVNRZXIwZXIwOUZpcWkwUQ==";
 constexpr char kClientSecretB64[] = "Uk9GZ2hrZVEzRjNvUHlFaHFpeVdQQQ==";
 constexpr char kCacheFile[] = "listenbrainzscrobbler.cache";
 constexpr int kScrobblesPerRequest = 10;
+
+// Requests are also limited by the X-RateLimit headers in the replies.
+constexpr int kMaxSubmitRequests = 3;
+constexpr qint64 kSubmitRequestInterval = 350;
+constexpr qint64 kRateLimitedDelay = 10LL * 1000LL;
+constexpr int kHttpTooManyRequests = 429;
 }  // namespace
 
-ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent)
+ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent)
     : ScrobblerService(QLatin1String(kName), settings, parent),
       network_(network),
       cache_(new ScrobblerCache(QLatin1String(kCacheFile), this)),
@@ -81,10 +89,10 @@ ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsSe
       enabled_(false),
       expires_in_(-1),
       login_time_(0),
-      submitted_(false),
       scrobbled_(false),
       timestamp_(0),
       submit_error_(false),
+      submit_queue_(QLatin1String(kName), task_manager, kMaxSubmitRequests, kSubmitRequestInterval),
       prefer_albumartist_(false) {
 
   refresh_login_timer_.setSingleShot(true);
@@ -529,7 +537,15 @@ void ListenBrainzScrobbler::Scrobble(const Song &song) {
 
 void ListenBrainzScrobbler::StartSubmit(const bool initial) {
 
-  if (!submitted_ && cache_->Count() > 0) {
+  if (submit_queue_.draining() && !submit_error_) {
+    if (!submit_queue_.full() && !timer_submit_.isActive()) {
+      timer_submit_.setInterval(static_cast<int>(submit_queue_.Delay()));
+      timer_submit_.start();
+    }
+    return;
+  }
+
+  if (!submitted() && cache_->Count() > 0) {
     if (initial && settings_->submit_delay() <= 0 && !submit_error_) {
       if (timer_submit_.isActive()) {
         timer_submit_.stop();
@@ -549,27 +565,47 @@ void ListenBrainzScrobbler::Submit() {
 
   qLog(Debug) << "ListenBrainz: Submitting scrobbles.";
 
-  if (!enabled() || !authenticated() || settings_->offline()) return;
+  if (!enabled() || !authenticated() || settings_->offline()) {
+    submit_queue_.Stop();
+    return;
+  }
 
-  QJsonArray array;
-  ScrobblerCacheItemPtrList cache_items_sent;
+  ScrobblerCacheItemPtrList cache_items_unsent;
   const ScrobblerCacheItemPtrList all_cache_items = cache_->List();
   for (ScrobblerCacheItemPtr cache_item : all_cache_items) {
-    if (cache_item->sent) continue;
-    if (cache_item->error && cache_items_sent.count() > 0) break;
+    if (!cache_item->sent) cache_items_unsent << cache_item;
+  }
+
+  submit_queue_.Update(cache_items_unsent.count(), kScrobblesPerRequest);
+
+  while (!cache_items_unsent.isEmpty() && submit_queue_.CanStart()) {
+    // Scrobbles from a batch that was rejected are submitted one by one to find the ones that are invalid.
+    ScrobblerCacheItemPtrList cache_items;
+    while (!cache_items_unsent.isEmpty() && cache_items.count() < kScrobblesPerRequest) {
+      if (cache_items_unsent.first()->error && !cache_items.isEmpty()) break;
+      cache_items << cache_items_unsent.takeFirst();
+      if (cache_items.last()->error) break;
+    }
+    SendScrobbles(cache_items);
+  }
+
+  if (!cache_items_unsent.isEmpty()) {
+    StartSubmit();
+  }
+
+}
+
+void ListenBrainzScrobbler::SendScrobbles(const ScrobblerCacheItemPtrList &cache_items) {
+
+  QJsonArray array;
+  for (ScrobblerCacheItemPtr cache_item : cache_items) {
     cache_item->sent = true;
-    cache_items_sent << cache_item;
     QJsonObject object_listen;
     object_listen.insert("listened_at"_L1, QJsonValue::fromVariant(cache_item->timestamp));
     object_listen.insert("track_metadata"_L1, JsonTrackMetadata(cache_item->metadata));
     array.append(QJsonValue::fromVariant(object_listen));
-    if (cache_items_sent.count() >= kScrobblesPerRequest || cache_item->error) break;
   }
 
-  if (cache_items_sent.count() <= 0) return;
-
-  submitted_ = true;
-
   QJsonObject object;
   object.insert("listen_type"_L1, "import"_L1);
   object.insert("payload"_L1, array);
@@ -577,7 +613,8 @@ void ListenBrainzScrobbler::Submit() {
 
   QUrl url(QStringLiteral("%1/1/submit-listens").arg(QLatin1String(kApiUrl)));
   QNetworkReply *reply = CreateRequest(url, doc);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, cache_items_sent]() { ScrobbleRequestFinished(reply, cache_items_sent); });
+  submit_queue_.RequestStarted();
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, cache_items]() { ScrobbleRequestFinished(reply, cache_items); });
 
 }
 
@@ -588,7 +625,16 @@ void ListenBrainzScrobbler::ScrobbleRequestFinished(QNetworkReply *reply, Scrobb
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
-  submitted_ = false;
+  submit_queue_.RequestFinished();
+
+  const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  const qint64 rate_limit_reset = reply->rawHeader("X-RateLimit-Reset-In").toLongLong() * kMsecPerSec;
+  if (http_status_code == kHttpTooManyRequests) {
+    submit_queue_.Block(rate_limit_reset > 0 ? rate_limit_reset : kRateLimitedDelay);
+  }
+  else if (reply->hasRawHeader("X-RateLimit-Remaining") && reply->rawHeader("X-RateLimit-Remaining").toInt() <= submit_queue_.active()) {
+    submit_queue_.Block(rate_limit_reset);
+  }
 
   QJsonObject json_obj;
   QString error_message;
@@ -602,11 +648,12 @@ void ListenBrainzScrobbler::ScrobbleRequestFinished(QNetworkReply *reply, Scrobb
       qLog(Debug) << "ListenBrainz: Received scrobble reply without status.";
     }
     cache_->Flush(cache_items);
+    submit_queue_.Submitted(cache_items.count());
     submit_error_ = false;
   }
   else {
     submit_error_ = true;
-    if (reply_result == ReplyResult::APIError) {
+    if (reply_result == ReplyResult::APIError && http_status_code != kHttpTooManyRequests) {
       if (cache_items.count() == 1) {
         const ScrobbleMetadata &metadata = cache_items.first()->metadata;
         Error(tr("Unable to scrobble %1 - %2 because of error: %3").arg(metadata.effective_albumartist(), metadata.title, error_message));
@@ -37,10 +37,12 @@
 #include "scrobblerservice.h"
 #include "scrobblercache.h"
 #include "scrobblemetadata.h"
+#include "scrobblersubmitqueue.h"
 
 class QNetworkReply;
 
 class ScrobblerSettingsService;
+class TaskManager;
 class NetworkAccessManager;
 class LocalRedirectServer;
 
@@ -48,7 +50,7 @@ class ListenBrainzScrobbler : public ScrobblerService {
   Q_OBJECT
 
  public:
-  explicit ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  explicit ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
   ~ListenBrainzScrobbler() override;
 
   static const char *kName;
@@ -59,7 +61,7 @@ class ListenBrainzScrobbler : public ScrobblerService {
 
   bool enabled() const override { return enabled_; }
   bool authenticated() const override { return !access_token_.isEmpty() && !user_token_.isEmpty(); }
-  bool submitted() const override { return submitted_; }
+  bool submitted() const override { return submit_queue_.active() > 0; }
   QString user_token() const { return user_token_; }
 
   void Authenticate();
@@ -98,6 +100,7 @@ class ListenBrainzScrobbler : public ScrobblerService {
   void Error(const QString &error, const QVariant &debug = QVariant());
   void RequestAccessToken(const QUrl &redirect_url = QUrl(), const QString &code = QString());
   void StartSubmit(const bool initial = false) override;
+  void SendScrobbles(const ScrobblerCacheItemPtrList &cache_items);
   void CheckScrobblePrevSong();
 
   const SharedPtr<NetworkAccessManager> network_;
@@ -110,13 +113,13 @@ class ListenBrainzScrobbler : public ScrobblerService {
   QString token_type_;
   QString refresh_token_;
   quint64 login_time_;
-  bool submitted_;
   Song song_playing_;
   bool scrobbled_;
   quint64 timestamp_;
   QTimer refresh_login_timer_;
   QTimer timer_submit_;
   bool submit_error_;
+  ScrobblerSubmitQueue submit_queue_;
 
   bool prefer_albumartist_;
 
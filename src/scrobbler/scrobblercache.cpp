@@ -19,17 +19,25 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <utility>
 #include <functional>
 #include <chrono>
 #include <memory>
 
+#ifdef Q_OS_WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
 #include <QObject>
 #include <QStandardPaths>
 #include <QString>
+#include <QByteArray>
 #include <QFile>
+#include <QSaveFile>
 #include <QIODevice>
-#include <QTextStream>
 #include <QTimer>
 #include <QJsonDocument>
 #include <QJsonValue>
@@ -46,11 +54,20 @@ using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
+namespace {
+constexpr char kJournalSuffix[] = ".journal";
+constexpr int kCompactJournalRecords = 1000;
+}  // namespace
+
 ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
     : QObject(parent),
       timer_flush_(new QTimer(this)),
       filename_(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1Char('/') + filename),
-      loaded_(false) {
+      journal_filename_(filename_ + QLatin1String(kJournalSuffix)),
+      journal_(new QFile(journal_filename_, this)),
+      loaded_(false),
+      journal_records_(0),
+      next_id_(1) {
 
   ReadCache();
   loaded_ = true;
@@ -59,27 +76,158 @@ ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
   timer_flush_->setInterval(10min);
   QObject::connect(timer_flush_, &QTimer::timeout, this, &ScrobblerCache::WriteCache);
 
+  // Start with an empty journal if the last session left records in it.
+  if (journal_records_ > 0) {
+    WriteCache();
+  }
+
 }
 
 ScrobblerCache::~ScrobblerCache() {
+
+  if (journal_->isOpen()) {
+    journal_->close();
+  }
+
+  scrobbler_cache_ids_.clear();
   scrobbler_cache_.clear();
+
+}
+
+QJsonObject ScrobblerCache::ItemToJson(const ScrobblerCacheItem &cache_item) {
+
+  QJsonObject object;
+  object.insert("id"_L1, QJsonValue::fromVariant(cache_item.id));
+  object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item.timestamp));
+  object.insert("artist"_L1, QJsonValue::fromVariant(cache_item.metadata.artist));
+  object.insert("album"_L1, QJsonValue::fromVariant(cache_item.metadata.album));
+  object.insert("title"_L1, QJsonValue::fromVariant(cache_item.metadata.title));
+  object.insert("track"_L1, QJsonValue::fromVariant(cache_item.metadata.track));
+  object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item.metadata.albumartist));
+  object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item.metadata.grouping));
+  object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_album_artist_id));
+  object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_artist_id));
+  object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_original_artist_id));
+  object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_album_id));
+  object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_original_album_id));
+  object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_recording_id));
+  object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_track_id));
+  object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_disc_id));
+  object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_release_group_id));
+  object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_work_id));
+  object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item.metadata.length_nanosec));
+
+  return object;
+
+}
+
+ScrobblerCacheItemPtr ScrobblerCache::ItemFromJson(const QJsonObject &json_obj_track) {
+
+  if (
+      !json_obj_track.contains("timestamp"_L1) ||
+      !json_obj_track.contains("artist"_L1) ||
+      !json_obj_track.contains("album"_L1) ||
+      !json_obj_track.contains("title"_L1) ||
+      !json_obj_track.contains("track"_L1) ||
+      !json_obj_track.contains("albumartist"_L1) ||
+      !json_obj_track.contains("length_nanosec"_L1)
+  ) {
+    qLog(Error) << "Scrobbler cache JSON tracks array value is missing data.";
+    qLog(Debug) << json_obj_track;
+    return nullptr;
+  }
+
+  ScrobbleMetadata metadata;
+  quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
+  metadata.artist = json_obj_track["artist"_L1].toString();
+  metadata.album = json_obj_track["album"_L1].toString();
+  metadata.title = json_obj_track["title"_L1].toString();
+  metadata.track = json_obj_track["track"_L1].toInt();
+  metadata.albumartist = json_obj_track["albumartist"_L1].toString();
+  metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
+
+  if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
+    qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
+    return nullptr;
+  }
+
+  if (json_obj_track.contains("grouping"_L1)) {
+    metadata.grouping = json_obj_track["grouping"_L1].toString();
+  }
+
+  if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
+    metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
+    metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
+    metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
+    metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
+    metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
+    metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
+    metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
+    metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
+    metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
+    metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
+  }
+
+  // Caches written before the journal have no IDs, they get new IDs when inserted.
+  const quint64 id = json_obj_track.contains("id"_L1) ? json_obj_track["id"_L1].toVariant().toULongLong() : 0;
+
+  return make_shared<ScrobblerCacheItem>(metadata, timestamp, id);
+
+}
+
+void ScrobblerCache::InsertItem(ScrobblerCacheItemPtr cache_item) {
+
+  if (cache_item->id == 0) {
+    cache_item->id = next_id_;
+  }
+  else if (scrobbler_cache_ids_.contains(cache_item->id)) {
+    return;
+  }
+  next_id_ = std::max(next_id_, cache_item->id + 1);
+
+  scrobbler_cache_ << cache_item;
+  scrobbler_cache_ids_.insert(cache_item->id, cache_item);
+
 }
 
 void ScrobblerCache::ReadCache() {
 
+  ReadSnapshot();
+  ReadJournal();
+
+}
+
+void ScrobblerCache::ReadSnapshot() {
+
   QFile file(filename_);
   bool result = file.open(QIODevice::ReadOnly | QIODevice::Text);
   if (!result) return;
 
-  QTextStream stream(&file);
-  stream.setEncoding(QStringConverter::Encoding::Utf8);
-  QString data = stream.readAll();
+  const QByteArray data = file.readAll();
   file.close();
 
   if (data.isEmpty()) return;
 
   QJsonParseError error;
-  QJsonDocument json_doc = QJsonDocument::fromJson(data.toUtf8(), &error);
+  QJsonDocument json_doc = QJsonDocument::fromJson(data, &error);
   if (error.error != QJsonParseError::NoError) {
     qLog(Error) << "Scrobbler cache is missing JSON data.";
     return;
@@ -117,73 +265,86 @@ void ScrobblerCache::ReadCache() {
       qLog(Debug) << value;
       continue;
     }
-    QJsonObject json_obj_track = value.toObject();
-    if (
-        !json_obj_track.contains("timestamp"_L1) ||
-        !json_obj_track.contains("artist"_L1) ||
-        !json_obj_track.contains("album"_L1) ||
-        !json_obj_track.contains("title"_L1) ||
-        !json_obj_track.contains("track"_L1) ||
-        !json_obj_track.contains("albumartist"_L1) ||
-        !json_obj_track.contains("length_nanosec"_L1)
-    ) {
-      qLog(Error) << "Scrobbler cache JSON tracks array value is missing data.";
-      qLog(Debug) << value;
-      continue;
-    }
-
-    ScrobbleMetadata metadata;
-    quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
-    metadata.artist = json_obj_track["artist"_L1].toString();
-    metadata.album = json_obj_track["album"_L1].toString();
-    metadata.title = json_obj_track["title"_L1].toString();
-    metadata.track = json_obj_track["track"_L1].toInt();
-    metadata.albumartist = json_obj_track["albumartist"_L1].toString();
-    metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
-
-    if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
-      qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
-      continue;
+    ScrobblerCacheItemPtr cache_item = ItemFromJson(value.toObject());
+    if (cache_item) {
+      InsertItem(cache_item);
     }
+  }
 
-    if (json_obj_track.contains("grouping"_L1)) {
-      metadata.grouping = json_obj_track["grouping"_L1].toString();
-    }
+}
 
-    if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
-      metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
-      metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
-      metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
-      metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
-      metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
-      metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
-      metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
-      metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
+void ScrobblerCache::ReadJournal() {
+
+  QFile file(journal_filename_);
+  if (!file.open(QIODevice::ReadOnly)) return;
+
+  bool items_removed = false;
+  while (!file.atEnd()) {
+    const QByteArray line = file.readLine().trimmed();
+    if (line.isEmpty()) continue;
+    ++journal_records_;
+    QJsonParseError error;
+    const QJsonDocument json_doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !json_doc.isObject()) {
+      // The last record is incomplete if writing it was interrupted.
+      qLog(Error) << "Scrobbler cache journal has an invalid record.";
+      continue;
     }
-    if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
-      metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
+    const QJsonObject json_obj = json_doc.object();
+    const QString operation = json_obj["op"_L1].toString();
+    if (operation == "add"_L1) {
+      ScrobblerCacheItemPtr cache_item = ItemFromJson(json_obj);
+      if (cache_item) {
+        InsertItem(cache_item);
+      }
     }
-    if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
-      metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
+    else if (operation == "remove"_L1) {
+      if (scrobbler_cache_ids_.remove(json_obj["id"_L1].toVariant().toULongLong()) > 0) {
+        items_removed = true;
+      }
     }
+  }
+
+  file.close();
+
+  // The list is pruned once after the whole journal is replayed, removing each item from it on its own makes a large journal quadratic.
+  if (items_removed) PruneItems();
+
+}
 
-    ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(metadata, timestamp);
-    scrobbler_cache_ << cache_item;
+bool ScrobblerCache::OpenJournal() {
 
+  if (journal_->isOpen()) return true;
+
+  if (!journal_->open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qLog(Error) << "Unable to open scrobbler cache journal" << journal_filename_ << journal_->errorString();
+    return false;
+  }
+
+  return true;
+
+}
+
+void ScrobblerCache::AppendJournal(const QByteArray &data, const int records) {
+
+  if (!loaded_ || data.isEmpty() || !OpenJournal()) return;
+
+  if (journal_->write(data) != data.size() || !journal_->flush()) {
+    qLog(Error) << "Unable to write scrobbler cache journal" << journal_filename_ << journal_->errorString();
+    return;
+  }
+
+  // Make sure the records survive a crash or power loss before the scrobbles are considered cached.
+#ifdef Q_OS_WIN32
+  _commit(journal_->handle());
+#else
+  fsync(journal_->handle());
+#endif
+
+  journal_records_ += records;
+
+  if (journal_records_ >= kCompactJournalRecords && journal_records_ > scrobbler_cache_.count() && !timer_flush_->isActive()) {
+    timer_flush_->start();
   }
 
 }
@@ -194,72 +355,82 @@ void ScrobblerCache::WriteCache() {
 
   qLog(Debug) << "Writing scrobbler cache file" << filename_;
 
+  if (journal_->isOpen()) {
+    journal_->close();
+  }
+
   if (scrobbler_cache_.isEmpty()) {
     QFile file(filename_);
     if (file.exists()) file.remove();
+    if (journal_->exists()) journal_->remove();
+    journal_records_ = 0;
     return;
   }
 
   QJsonArray array;
   for (ScrobblerCacheItemPtr cache_item : std::as_const(scrobbler_cache_)) {
-    QJsonObject object;
-    object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item->timestamp));
-    object.insert("artist"_L1, QJsonValue::fromVariant(cache_item->metadata.artist));
-    object.insert("album"_L1, QJsonValue::fromVariant(cache_item->metadata.album));
-    object.insert("title"_L1, QJsonValue::fromVariant(cache_item->metadata.title));
-    object.insert("track"_L1, QJsonValue::fromVariant(cache_item->metadata.track));
-    object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item->metadata.albumartist));
-    object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item->metadata.grouping));
-    object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_artist_id));
-    object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_artist_id));
-    object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_artist_id));
-    object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_id));
-    object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_album_id));
-    object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_recording_id));
-    object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_track_id));
-    object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_disc_id));
-    object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_release_group_id));
-    object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_work_id));
-    object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item->metadata.length_nanosec));
-    array.append(QJsonValue::fromVariant(object));
+    array.append(ItemToJson(*cache_item));
   }
 
   QJsonObject object;
   object.insert("tracks"_L1, array);
   QJsonDocument doc(object);
 
-  QFile file(filename_);
-  bool result = file.open(QIODevice::WriteOnly | QIODevice::Text);
+  // The snapshot replaces the old file only when completely written, the journal is removed after that.
+  QSaveFile file(filename_);
+  bool result = file.open(QIODevice::WriteOnly);
   if (!result) {
     qLog(Error) << "Unable to open scrobbler cache file" << filename_;
     return;
   }
-  QTextStream stream(&file);
-  stream.setEncoding(QStringConverter::Encoding::Utf8);
-  stream << doc.toJson();
-  file.close();
+  file.write(doc.toJson());
+  if (!file.commit()) {
+    qLog(Error) << "Unable to write scrobbler cache file" << filename_ << file.errorString();
+    return;
+  }
+
+  if (journal_->exists()) journal_->remove();
+  journal_records_ = 0;
 
 }
 
 ScrobblerCacheItemPtr ScrobblerCache::Add(const Song &song, const quint64 timestamp) {
 
   ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(ScrobbleMetadata(song), timestamp);
+  InsertItem(cache_item);
 
-  scrobbler_cache_ << cache_item;
+  QJsonObject json_obj = ItemToJson(*cache_item);
+  json_obj.insert("op"_L1, "add"_L1);
+  AppendJournal(QJsonDocument(json_obj).toJson(QJsonDocument::Compact) + '\n', 1);
 
-  if (loaded_ && !timer_flush_->isActive()) {
-    timer_flush_->start();
+  return cache_item;
+
+}
+
+void ScrobblerCache::RemoveItems(const ScrobblerCacheItemPtrList &cache_items) {
+
+  bool items_removed = false;
+  for (ScrobblerCacheItemPtr cache_item : cache_items) {
+    if (scrobbler_cache_ids_.remove(cache_item->id) > 0) {
+      items_removed = true;
+    }
   }
 
-  return cache_item;
+  if (items_removed) PruneItems();
+
+}
+
+void ScrobblerCache::PruneItems() {
+
+  // Drops the items that are no longer in the ID index in a single pass.
+  scrobbler_cache_.removeIf([this](const ScrobblerCacheItemPtr &cache_item) { return scrobbler_cache_ids_.value(cache_item->id) != cache_item; });
 
 }
 
 void ScrobblerCache::Remove(ScrobblerCacheItemPtr cache_item) {
 
-  if (scrobbler_cache_.contains(cache_item)) {
-    scrobbler_cache_.removeAll(cache_item);
-  }
+  Flush(ScrobblerCacheItemPtrList() << cache_item);
+
 }
 
 void ScrobblerCache::ClearSent(ScrobblerCacheItemPtrList cache_items) {
@@ -280,14 +451,18 @@ void ScrobblerCache::SetError(ScrobblerCacheItemPtrList cache_items) {
 
 void ScrobblerCache::Flush(ScrobblerCacheItemPtrList cache_items) {
 
-  for (ScrobblerCacheItemPtr cache_item : cache_items) {
-    if (scrobbler_cache_.contains(cache_item)) {
-      scrobbler_cache_.removeAll(cache_item);
-    }
+  QByteArray data;
+  int records = 0;
+  for (ScrobblerCacheItemPtr cache_item : std::as_const(cache_items)) {
+    if (!scrobbler_cache_ids_.contains(cache_item->id)) continue;
+    QJsonObject json_obj;
+    json_obj.insert("op"_L1, "remove"_L1);
+    json_obj.insert("id"_L1, QJsonValue::fromVariant(cache_item->id));
+    data += QJsonDocument(json_obj).toJson(QJsonDocument::Compact) + '\n';
+    ++records;
   }
 
-  if (!timer_flush_->isActive()) {
-    timer_flush_->start();
-  }
+  RemoveItems(cache_items);
+  AppendJournal(data, records);
 
 }
@@ -27,13 +27,20 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QList>
+#include <QHash>
 #include <QString>
+#include <QByteArray>
+#include <QJsonObject>
 
 #include "scrobblercacheitem.h"
 
 class QTimer;
+class QFile;
 class Song;
 
+// Scrobbles waiting to be submitted.
+// The cache is stored as a JSON snapshot and a journal of added and removed scrobbles, so each change only appends to the journal.
+// The journal is merged into the snapshot when it grows larger than the cache.
 class ScrobblerCache : public QObject {
   Q_OBJECT
 
@@ -54,11 +61,27 @@ class ScrobblerCache : public QObject {
  public Q_SLOTS:
   void WriteCache();
 
+ private:
+  static QJsonObject ItemToJson(const ScrobblerCacheItem &cache_item);
+  static ScrobblerCacheItemPtr ItemFromJson(const QJsonObject &json_obj);
+  void ReadSnapshot();
+  void ReadJournal();
+  void InsertItem(ScrobblerCacheItemPtr cache_item);
+  void RemoveItems(const ScrobblerCacheItemPtrList &cache_items);
+  void PruneItems();
+  bool OpenJournal();
+  void AppendJournal(const QByteArray &data, const int records);
+
  private:
   QTimer *timer_flush_;
   QString filename_;
+  QString journal_filename_;
+  QFile *journal_;
   bool loaded_;
+  int journal_records_;
+  quint64 next_id_;
   QList<ScrobblerCacheItemPtr> scrobbler_cache_;
+  QHash<quint64, ScrobblerCacheItemPtr> scrobbler_cache_ids_;
 };
 
 #endif  // SCROBBLERCACHE_H
@@ -24,8 +24,9 @@
 #include "scrobblercacheitem.h"
 #include "scrobblemetadata.h"
 
-ScrobblerCacheItem::ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp)
-    : metadata(_metadata),
+ScrobblerCacheItem::ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp, const quint64 _id)
+    : id(_id),
+      metadata(_metadata),
       timestamp(_timestamp),
       sent(false),
       error(false) {}
@@ -31,8 +31,9 @@
 class ScrobblerCacheItem {
 
  public:
-  explicit ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp);
+  explicit ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp, const quint64 _id = 0);
 
+  quint64 id;
   ScrobbleMetadata metadata;
   quint64 timestamp;
   bool sent;
@@ -0,0 +1,162 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/taskmanager.h"
+#include "scrobblersubmitqueue.h"
+
+ScrobblerSubmitQueue::ScrobblerSubmitQueue(const QString &name, const SharedPtr<TaskManager> task_manager, const int max_requests, const qint64 request_interval)
+    : name_(name),
+      task_manager_(task_manager),
+      max_requests_(std::max(1, max_requests)),
+      request_interval_(request_interval),
+      active_(0),
+      last_request_(-1),
+      blocked_until_(0),
+      draining_(false),
+      task_id_(-1),
+      drain_started_(0),
+      drain_total_(0),
+      drain_submitted_(0) {
+
+  clock_.start();
+
+}
+
+ScrobblerSubmitQueue::~ScrobblerSubmitQueue() {
+
+  Stop();
+
+}
+
+void ScrobblerSubmitQueue::Update(const qint64 backlog, const int batch_size) {
+
+  if (!draining_) {
+    if (backlog <= static_cast<qint64>(batch_size) * kDrainBatches) return;
+    qLog(Debug) << name_ << "Draining backlog of" << backlog << "scrobbles with up to" << max_requests_ << "requests";
+    draining_ = true;
+    drain_started_ = clock_.elapsed();
+    drain_total_ = backlog;
+    drain_submitted_ = 0;
+    if (task_manager_) {
+      task_id_ = task_manager_->StartTask(QObject::tr("Submitting scrobbles to %1").arg(name_));
+    }
+    UpdateTask();
+    return;
+  }
+
+  if (backlog <= 0 && active_ == 0) {
+    Stop();
+    return;
+  }
+
+  // Scrobbles added or re-queued while draining.
+  drain_total_ = std::max(drain_total_, drain_submitted_ + backlog);
+  UpdateTask();
+
+}
+
+bool ScrobblerSubmitQueue::CanStart() const {
+
+  return !full() && Delay() <= 0;
+
+}
+
+qint64 ScrobblerSubmitQueue::Delay() const {
+
+  const qint64 now = clock_.elapsed();
+
+  qint64 delay = blocked_until_ - now;
+  if (draining_ && last_request_ >= 0) {
+    delay = std::max(delay, last_request_ + request_interval_ - now);
+  }
+
+  return std::max(0LL, delay);
+
+}
+
+void ScrobblerSubmitQueue::RequestStarted() {
+
+  ++active_;
+  last_request_ = clock_.elapsed();
+
+}
+
+void ScrobblerSubmitQueue::RequestFinished() {
+
+  if (active_ > 0) --active_;
+
+}
+
+void ScrobblerSubmitQueue::Submitted(const qint64 count) {
+
+  if (!draining_) return;
+
+  drain_submitted_ += count;
+  UpdateTask();
+
+}
+
+void ScrobblerSubmitQueue::Block(const qint64 msec) {
+
+  blocked_until_ = std::max(blocked_until_, clock_.elapsed() + msec);
+
+}
+
+void ScrobblerSubmitQueue::Stop() {
+
+  if (!draining_) return;
+
+  qLog(Debug) << name_ << "Submitted" << drain_submitted_ << "scrobbles in" << (clock_.elapsed() - drain_started_) / 1000 << "seconds," << qRound(throughput()) << "per minute";
+
+  draining_ = false;
+  if (task_id_ != -1) {
+    task_manager_->SetTaskFinished(task_id_);
+    task_id_ = -1;
+  }
+
+}
+
+double ScrobblerSubmitQueue::throughput() const {
+
+  const qint64 elapsed = clock_.elapsed() - drain_started_;
+  if (elapsed <= 0) return 0.0;
+
+  return static_cast<double>(drain_submitted_) * 60000.0 / static_cast<double>(elapsed);
+
+}
+
+void ScrobblerSubmitQueue::UpdateTask() {
+
+  if (task_id_ == -1) return;
+
+  task_manager_->SetTaskName(task_id_, QObject::tr("Submitting scrobbles to %1 (%2 per minute)").arg(name_).arg(qRound(throughput())));
+  task_manager_->SetTaskProgress(task_id_, static_cast<quint64>(drain_submitted_), static_cast<quint64>(drain_total_));
+
+}
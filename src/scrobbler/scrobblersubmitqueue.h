@@ -0,0 +1,90 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCROBBLERSUBMITQUEUE_H
+#define SCROBBLERSUBMITQUEUE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+
+class TaskManager;
+
+// Limits the scrobble requests a service has in flight.
+// Normally one batch is submitted at a time. When the cache holds a backlog of several batches, for example after being offline,
+// the queue drains it with up to max_requests batches in flight, started at least request_interval milliseconds apart.
+class ScrobblerSubmitQueue {
+ public:
+  explicit ScrobblerSubmitQueue(const QString &name, const SharedPtr<TaskManager> task_manager, const int max_requests, const qint64 request_interval);
+  ~ScrobblerSubmitQueue();
+
+  // Number of batches waiting in the cache before the backlog is drained in parallel.
+  static constexpr int kDrainBatches = 3;
+
+  bool draining() const { return draining_; }
+  int active() const { return active_; }
+  int max_requests() const { return draining_ ? max_requests_ : 1; }
+  bool full() const { return active_ >= max_requests(); }
+
+  // Called with the number of unsent scrobbles before submitting, starts or finishes draining the backlog.
+  void Update(const qint64 backlog, const int batch_size);
+
+  bool CanStart() const;
+  // Milliseconds until the next request can be started.
+  qint64 Delay() const;
+
+  void RequestStarted();
+  void RequestFinished();
+  void Submitted(const qint64 count);
+
+  // Don't start new requests for a while, when the service is rate limiting us.
+  void Block(const qint64 msec);
+
+  void Stop();
+
+  // Scrobbles per minute while draining the backlog.
+  double throughput() const;
+
+ private:
+  void UpdateTask();
+
+  const QString name_;
+  const SharedPtr<TaskManager> task_manager_;
+  const int max_requests_;
+  const qint64 request_interval_;
+
+  QElapsedTimer clock_;
+  int active_;
+  qint64 last_request_;
+  qint64 blocked_until_;
+
+  bool draining_;
+  int task_id_;
+  qint64 drain_started_;
+  qint64 drain_total_;
+  qint64 drain_submitted_;
+
+  Q_DISABLE_COPY(ScrobblerSubmitQueue)
+};
+
+#endif  // SCROBBLERSUBMITQUEUE_H
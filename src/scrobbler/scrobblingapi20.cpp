@@ -47,6 +47,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/networkaccessmanager.h"
+#include "core/taskmanager.h"
 #include "core/song.h"
 #include "core/logging.h"
 #include "core/settings.h"
@@ -60,6 +61,7 @@
 #include "scrobblercache.h"
 #include "scrobblercacheitem.h"
 #include "scrobblemetadata.h"
+#include "scrobblersubmitqueue.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -68,9 +70,18 @@ const char *ScrobblingAPI20::kApiKey = "211990b4c96782c05d1536e7219eb56e";
 namespace {
 constexpr char kSecret[] = "80fd738f49596e9709b1bf9319c444a8";
 constexpr int kScrobblesPerRequest = 50;
+
+// Last.fm allows about 5 requests per second, keep below that when draining the backlog.
+constexpr int kMaxSubmitRequests = 4;
+constexpr qint64 kSubmitRequestInterval = 250;
+constexpr qint64 kRateLimitedDelay = 60LL * 1000LL;
+constexpr qint64 kDailyLimitDelay = 60LL * 60LL * 1000LL;
+
+// Code of the ignoredMessage for scrobbles exceeding the daily scrobble limit, these can be submitted later.
+constexpr int kIgnoredDailyLimitExceeded = 5;
 }
 
-ScrobblingAPI20::ScrobblingAPI20(const QString &name, const QString &settings_group, const QString &auth_url, const QString &api_url, const bool batch, const QString &cache_file, const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent)
+ScrobblingAPI20::ScrobblingAPI20(const QString &name, const QString &settings_group, const QString &auth_url, const QString &api_url, const bool batch, const QString &cache_file, const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent)
     : ScrobblerService(name, settings, parent),
       name_(name),
       settings_group_(settings_group),
@@ -83,10 +94,10 @@ ScrobblingAPI20::ScrobblingAPI20(const QString &name, const QString &settings_gr
       enabled_(false),
       prefer_albumartist_(false),
       subscriber_(false),
-      submitted_(false),
       scrobbled_(false),
       timestamp_(0),
-      submit_error_(false) {
+      submit_error_(false),
+      submit_queue_(name, task_manager, kMaxSubmitRequests, kSubmitRequestInterval) {
 
   timer_submit_.setSingleShot(true);
   QObject::connect(&timer_submit_, &QTimer::timeout, this, &ScrobblingAPI20::Submit);
@@ -472,7 +483,15 @@ void ScrobblingAPI20::Scrobble(const Song &song) {
 
 void ScrobblingAPI20::StartSubmit(const bool initial) {
 
-  if (!submitted_ && cache_->Count() > 0) {
+  if (submit_queue_.draining() && !submit_error_) {
+    if (!submit_queue_.full() && !timer_submit_.isActive()) {
+      timer_submit_.setInterval(static_cast<int>(submit_queue_.Delay()));
+      timer_submit_.start();
+    }
+    return;
+  }
+
+  if (!submitted() && cache_->Count() > 0) {
     if (initial && (!batch_ || settings_->submit_delay() <= 0) && !submit_error_) {
       if (timer_submit_.isActive()) {
         timer_submit_.stop();
@@ -490,23 +509,49 @@ void ScrobblingAPI20::StartSubmit(const bool initial) {
 
 void ScrobblingAPI20::Submit() {
 
-  if (!enabled() || !authenticated() || settings_->offline()) return;
+  if (!enabled() || !authenticated() || settings_->offline()) {
+    submit_queue_.Stop();
+    return;
+  }
+
+  const int batch_size = batch_ ? kScrobblesPerRequest : 1;
+
+  ScrobblerCacheItemPtrList cache_items_unsent;
+  const ScrobblerCacheItemPtrList all_cache_items = cache_->List();
+  for (ScrobblerCacheItemPtr cache_item : all_cache_items) {
+    if (!cache_item->sent) cache_items_unsent << cache_item;
+  }
+
+  submit_queue_.Update(cache_items_unsent.count(), batch_size);
+
+  if (cache_items_unsent.isEmpty()) return;
 
   qLog(Debug) << name_ << "Submitting scrobbles.";
 
+  while (!cache_items_unsent.isEmpty() && submit_queue_.CanStart()) {
+    const ScrobblerCacheItemPtrList cache_items = cache_items_unsent.mid(0, batch_size);
+    cache_items_unsent.remove(0, cache_items.count());
+    if (batch_) {
+      SendScrobbles(cache_items);
+    }
+    else {
+      SendSingleScrobble(cache_items.first());
+    }
+  }
+
+  if (!cache_items_unsent.isEmpty()) {
+    StartSubmit();
+  }
+
+}
+
+void ScrobblingAPI20::SendScrobbles(const ScrobblerCacheItemPtrList &cache_items) {
+
   ParamList params = ParamList() << Param(u"method"_s, u"track.scrobble"_s);
 
   int i = 0;
-  const ScrobblerCacheItemPtrList all_cache_items = cache_->List();
-  ScrobblerCacheItemPtrList cache_items_sent;
-  for (ScrobblerCacheItemPtr cache_item : all_cache_items) {
-    if (cache_item->sent) continue;
+  for (ScrobblerCacheItemPtr cache_item : cache_items) {
     cache_item->sent = true;
-    if (!batch_) {
-      SendSingleScrobble(cache_item);
-      continue;
-    }
-    cache_items_sent << cache_item;
     params << Param(u"%1[%2]"_s.arg(u"artist"_s).arg(i), prefer_albumartist_ ? cache_item->metadata.effective_albumartist() : cache_item->metadata.artist);
     params << Param(u"%1[%2]"_s.arg(u"track"_s).arg(i), StripTitle(cache_item->metadata.title));
     params << Param(u"%1[%2]"_s.arg(u"timestamp"_s).arg(i), QString::number(cache_item->timestamp));
@@ -521,15 +566,11 @@ void ScrobblingAPI20::Submit() {
       params << Param(u"%1[%2]"_s.arg("trackNumber"_L1).arg(i), QString::number(cache_item->metadata.track));
     }
     ++i;
-    if (cache_items_sent.count() >= kScrobblesPerRequest) break;
   }
 
-  if (!batch_ || cache_items_sent.count() <= 0) return;
-
-  submitted_ = true;
-
   QNetworkReply *reply = CreateRequest(params);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, cache_items_sent]() { ScrobbleRequestFinished(reply, cache_items_sent); });
+  submit_queue_.RequestStarted();
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, cache_items]() { ScrobbleRequestFinished(reply, cache_items); });
 
 }
 
@@ -540,61 +581,77 @@ void ScrobblingAPI20::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
-  submitted_ = false;
+  submit_queue_.RequestFinished();
 
   QJsonObject json_obj;
   QString error_message;
   if (GetJsonObject(reply, json_obj, error_message) != ReplyResult::Success) {
     Error(error_message);
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 429 || static_cast<ScrobbleErrorCode>(json_obj.value("error"_L1).toInt()) == ScrobbleErrorCode::RateLimitExceeded) {
+      submit_queue_.Block(kRateLimitedDelay);
+    }
     cache_->ClearSent(cache_items);
     submit_error_ = true;
     StartSubmit();
     return;
   }
 
-  cache_->Flush(cache_items);
   submit_error_ = false;
 
+  // Only scrobbles that were ignored because of a temporary limit are submitted again, the rest are removed from the cache.
+  const ScrobblerCacheItemPtrList cache_items_retry = ParseScrobbleReply(json_obj, cache_items);
+  ScrobblerCacheItemPtrList cache_items_done;
+  for (ScrobblerCacheItemPtr cache_item : std::as_const(cache_items)) {
+    if (!cache_items_retry.contains(cache_item)) cache_items_done << cache_item;
+  }
+  cache_->Flush(cache_items_done);
+  if (!cache_items_retry.isEmpty()) {
+    cache_->ClearSent(cache_items_retry);
+    submit_queue_.Block(kDailyLimitDelay);
+  }
+  submit_queue_.Submitted(cache_items_done.count());
+
+  StartSubmit();
+
+}
+
+ScrobblerCacheItemPtrList ScrobblingAPI20::ParseScrobbleReply(const QJsonObject &json_reply, const ScrobblerCacheItemPtrList &cache_items) {
+
+  QJsonObject json_obj = json_reply;
+
   if (!json_obj.contains("scrobbles"_L1)) {
     Error(u"Json reply from server is missing scrobbles."_s, json_obj);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
 
   QJsonValue value_scrobbles = json_obj["scrobbles"_L1];
   if (!value_scrobbles.isObject()) {
     Error(u"Json scrobbles is not an object."_s, json_obj);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
   json_obj = value_scrobbles.toObject();
   if (json_obj.isEmpty()) {
     Error(u"Json scrobbles object is empty."_s, value_scrobbles);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
   if (!json_obj.contains("@attr"_L1) || !json_obj.contains("scrobble"_L1)) {
     Error(u"Json scrobbles object is missing values."_s, json_obj);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
 
   QJsonValue value_attr = json_obj["@attr"_L1];
   if (!value_attr.isObject()) {
     Error(u"Json scrobbles attr is not an object."_s, value_attr);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
   QJsonObject obj_attr = value_attr.toObject();
   if (obj_attr.isEmpty()) {
     Error(u"Json scrobbles attr is empty."_s, value_attr);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
   if (!obj_attr.contains("accepted"_L1) || !obj_attr.contains("ignored"_L1)) {
     Error(u"Json scrobbles attr is missing values."_s, obj_attr);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
   int accepted = obj_attr["accepted"_L1].toInt();
   int ignored = obj_attr["ignored"_L1].toInt();
@@ -608,8 +665,7 @@ void ScrobblingAPI20::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
     QJsonObject obj_scrobble = value_scrobble.toObject();
     if (obj_scrobble.isEmpty()) {
       Error(u"Json scrobbles scrobble object is empty."_s, obj_scrobble);
-      StartSubmit();
-      return;
+      return ScrobblerCacheItemPtrList();
     }
     array_scrobble.append(obj_scrobble);
   }
@@ -617,17 +673,18 @@ void ScrobblingAPI20::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
     array_scrobble = value_scrobble.toArray();
     if (array_scrobble.isEmpty()) {
       Error(u"Json scrobbles scrobble array is empty."_s, value_scrobble);
-      StartSubmit();
-      return;
+      return ScrobblerCacheItemPtrList();
     }
   }
   else {
     Error(u"Json scrobbles scrobble is not an object or array."_s, value_scrobble);
-    StartSubmit();
-    return;
+    return ScrobblerCacheItemPtrList();
   }
 
-  for (const QJsonValue &value : std::as_const(array_scrobble)) {
+  ScrobblerCacheItemPtrList cache_items_retry;
+  for (qint64 i = 0; i < array_scrobble.count(); ++i) {
+
+    const QJsonValue value = array_scrobble.at(i);
 
     if (!value.isObject()) {
       Error(u"Json scrobbles scrobble array value is not an object."_s);
@@ -681,6 +738,12 @@ void ScrobblingAPI20::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
     QString ignoredmessage_text = obj_ignoredmessage["#text"_L1].toString();
 
     if (ignoredmessage) {
+      // The scrobbles are returned in the order they were submitted.
+      if (obj_ignoredmessage["code"_L1].toVariant().toInt() == kIgnoredDailyLimitExceeded && array_scrobble.count() == cache_items.count()) {
+        qLog(Debug) << name_ << "Scrobble for" << song << "exceeded the daily limit, submitting it later.";
+        cache_items_retry << cache_items.at(i);
+        continue;
+      }
       Error(u"Scrobble for \"%1\" ignored: %2"_s.arg(song, ignoredmessage_text));
     }
     else {
@@ -689,7 +752,7 @@ void ScrobblingAPI20::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
 
  }
 
-  StartSubmit();
+  return cache_items_retry;
 
 }
 
@@ -712,7 +775,10 @@ void ScrobblingAPI20::SendSingleScrobble(ScrobblerCacheItemPtr item) {
     params << Param(u"trackNumber"_s, QString::number(item->metadata.track));
   }
 
+  item->sent = true;
+
   QNetworkReply *reply = CreateRequest(params);
+  submit_queue_.RequestStarted();
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, item]() { SingleScrobbleRequestFinished(reply, item); });
 
 }
@@ -724,21 +790,33 @@ void ScrobblingAPI20::SingleScrobbleRequestFinished(QNetworkReply *reply, Scrobb
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
+  submit_queue_.RequestFinished();
+
   QJsonObject json_obj;
   QString error_message;
   if (GetJsonObject(reply, json_obj, error_message) != ReplyResult::Success) {
     Error(error_message);
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 429 || static_cast<ScrobbleErrorCode>(json_obj.value("error"_L1).toInt()) == ScrobbleErrorCode::RateLimitExceeded) {
+      submit_queue_.Block(kRateLimitedDelay);
+    }
     cache_item->sent = false;
+    submit_error_ = true;
+    StartSubmit();
     return;
   }
 
   if (!json_obj.contains("scrobbles"_L1)) {
     Error(u"Json reply from server is missing scrobbles."_s, json_obj);
     cache_item->sent = false;
+    submit_error_ = true;
+    StartSubmit();
     return;
   }
 
   cache_->Remove(cache_item);
+  submit_queue_.Submitted(1);
+  submit_error_ = false;
+  StartSubmit();
 
   QJsonValue value_scrobbles = json_obj["scrobbles"_L1];
   if (!value_scrobbles.isObject()) {
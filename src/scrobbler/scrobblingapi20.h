@@ -35,10 +35,12 @@
 #include "scrobblerservice.h"
 #include "scrobblercache.h"
 #include "scrobblercacheitem.h"
+#include "scrobblersubmitqueue.h"
 
 class QNetworkReply;
 
 class ScrobblerSettingsService;
+class TaskManager;
 class NetworkAccessManager;
 class LocalRedirectServer;
 
@@ -46,7 +48,7 @@ class ScrobblingAPI20 : public ScrobblerService {
   Q_OBJECT
 
  public:
-  explicit ScrobblingAPI20(const QString &name, const QString &settings_group, const QString &auth_url, const QString &api_url, const bool batch, const QString &cache_file, const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  explicit ScrobblingAPI20(const QString &name, const QString &settings_group, const QString &auth_url, const QString &api_url, const bool batch, const QString &cache_file, const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
   ~ScrobblingAPI20() override;
 
   static const char *kApiKey;
@@ -57,7 +59,7 @@ class ScrobblingAPI20 : public ScrobblerService {
   bool enabled() const override { return enabled_; }
   bool authenticated() const override { return !username_.isEmpty() && !session_key_.isEmpty(); }
   bool subscriber() const { return subscriber_; }
-  bool submitted() const override { return submitted_; }
+  bool submitted() const override { return submit_queue_.active() > 0; }
   QString username() const { return username_; }
 
   void Authenticate();
@@ -125,7 +127,9 @@ class ScrobblingAPI20 : public ScrobblerService {
 
   void RequestSession(const QString &token);
   void AuthError(const QString &error);
+  void SendScrobbles(const ScrobblerCacheItemPtrList &cache_items);
   void SendSingleScrobble(ScrobblerCacheItemPtr item);
+  ScrobblerCacheItemPtrList ParseScrobbleReply(const QJsonObject &json_reply, const ScrobblerCacheItemPtrList &cache_items);
   void Error(const QString &error, const QVariant &debug = QVariant());
   static QString ErrorString(const ScrobbleErrorCode error);
   void StartSubmit(const bool initial = false) override;
@@ -149,13 +153,13 @@ class ScrobblingAPI20 : public ScrobblerService {
   QString username_;
   QString session_key_;
 
-  bool submitted_;
   Song song_playing_;
   bool scrobbled_;
   quint64 timestamp_;
   bool submit_error_;
 
   QTimer timer_submit_;
+  ScrobblerSubmitQueue submit_queue_;
 
   QList<QNetworkReply*> replies_;
 };
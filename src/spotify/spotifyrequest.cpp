@@ -25,6 +25,7 @@
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
+#include <QFileInfo>
 #include <QImage>
 #include <QImageReader>
 #include <QNetworkRequest>
@@ -32,7 +33,6 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 
 #include "core/logging.h"
 #include "core/networkaccessmanager.h"
@@ -40,6 +40,7 @@
 #include "constants/timeconstants.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
+#include "streaming/streamingrequestscheduler.h"
 #include "spotifyservice.h"
 #include "spotifybaserequest.h"
 #include "spotifyrequest.h"
@@ -47,20 +48,17 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-const int kMaxConcurrentArtistsRequests = 1;
-const int kMaxConcurrentAlbumsRequests = 1;
-const int kMaxConcurrentSongsRequests = 1;
-const int kMaxConcurrentArtistAlbumsRequests = 1;
-const int kMaxConcurrentAlbumSongsRequests = 1;
+const int kConcurrentRequests = 1;
+const int kConcurrentAlbumCoverRequests = 10;
+const int kMaxConcurrentRequests = 4;
 const int kMaxConcurrentAlbumCoverRequests = 10;
-const int kFlushRequestsDelay = 200;
 }
 
 SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkAccessManager> network, const Type type, QObject *parent)
     : SpotifyBaseRequest(service, network, parent),
       service_(service),
       network_(network),
-      timer_flush_requests_(new QTimer(this)),
+      scheduler_(service->request_scheduler()),
       type_(type),
       fetchalbums_(service->fetchalbums()),
       query_id_(-1),
@@ -93,33 +91,21 @@ SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkA
       album_covers_requests_total_(0),
       album_covers_requests_active_(0),
       album_covers_requests_received_(0),
+      songs_synced_(0),
       no_results_(false) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &SpotifyRequest::FlushRequests);
+  scheduler_->AddEndpoint(u"artists"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"songs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"artistalbums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumsongs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumcovers"_s, kConcurrentAlbumCoverRequests, kMaxConcurrentAlbumCoverRequests);
 
 }
 
 SpotifyRequest::~SpotifyRequest() {
 
-  if (timer_flush_requests_->isActive()) {
-    timer_flush_requests_->stop();
-  }
-
-  while (!replies_.isEmpty()) {
-    QNetworkReply *reply = replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
-
-  while (!album_cover_replies_.isEmpty()) {
-    QNetworkReply *reply = album_cover_replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
+  scheduler_->Abort(this);
 
 }
 
@@ -156,50 +142,6 @@ void SpotifyRequest::Process() {
 
 }
 
-void SpotifyRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
-void SpotifyRequest::FlushRequests() {
-
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
-
-}
-
 void SpotifyRequest::Search(const int query_id, const QString &search_text) {
 
   query_id_ = query_id;
@@ -220,45 +162,32 @@ void SpotifyRequest::AddArtistsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  artists_requests_queue_.enqueue(request);
-
   ++artists_requests_total_;
+  ++artists_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artists"_s, this, [this, request]() { return SendArtistsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void SpotifyRequest::FlushArtistsRequests() {
+QNetworkReply *SpotifyRequest::SendArtistsRequest(const Request &request) {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
-
-    Request request = artists_requests_queue_.dequeue();
-
-    ParamList parameters = ParamList() << Param(u"type"_s, u"artist"_s);
-    if (type_ == Type::SearchArtists) {
-      parameters << Param(u"q"_s, search_text_);
-    }
-    if (request.limit > 0) {
-      parameters << Param(u"limit"_s, QString::number(request.limit));
-    }
-    if (request.offset > 0) {
-      parameters << Param(u"offset"_s, QString::number(request.offset));
-    }
-    QNetworkReply *reply = nullptr;
-    if (type_ == Type::FavouriteArtists) {
-      reply = CreateRequest(u"me/following"_s, parameters);
-    }
-    if (type_ == Type::SearchArtists) {
-      reply = CreateRequest(u"search"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
-
-    ++artists_requests_active_;
+  ParamList parameters = ParamList() << Param(u"type"_s, u"artist"_s);
+  if (type_ == Type::SearchArtists) {
+    parameters << Param(u"q"_s, search_text_);
+  }
+  if (request.limit > 0) {
+    parameters << Param(u"limit"_s, QString::number(request.limit));
+  }
+  if (request.offset > 0) {
+    parameters << Param(u"offset"_s, QString::number(request.offset));
+  }
 
+  if (type_ == Type::SearchArtists) {
+    return CreateRequest(u"search"_s, parameters);
   }
 
+  return CreateRequest(u"me/following"_s, parameters);
+
 }
 
 void SpotifyRequest::GetAlbums() {
@@ -274,45 +203,32 @@ void SpotifyRequest::AddAlbumsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  albums_requests_queue_.enqueue(request);
-
   ++albums_requests_total_;
+  ++albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albums"_s, this, [this, request]() { return SendAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void SpotifyRequest::FlushAlbumsRequests() {
-
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
-
-    Request request = albums_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (type_ == Type::SearchAlbums) {
-      parameters << Param(u"type"_s, u"album"_s);
-      parameters << Param(u"q"_s, search_text_);
-    }
-    else {
-      parameters << Param(u"include_groups"_s, u"album,single"_s);
-    }
-    if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (type_ == Type::FavouriteAlbums) {
-      reply = CreateRequest(u"me/albums"_s, parameters);
-    }
-    if (type_ == Type::SearchAlbums) {
-      reply = CreateRequest(u"search"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
+QNetworkReply *SpotifyRequest::SendAlbumsRequest(const Request &request) {
 
-    ++albums_requests_active_;
+  ParamList parameters;
+  if (type_ == Type::SearchAlbums) {
+    parameters << Param(u"type"_s, u"album"_s);
+    parameters << Param(u"q"_s, search_text_);
+  }
+  else {
+    parameters << Param(u"include_groups"_s, u"album,single"_s);
+  }
+  if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
 
+  if (type_ == Type::SearchAlbums) {
+    return CreateRequest(u"search"_s, parameters);
   }
 
+  return CreateRequest(u"me/albums"_s, parameters);
+
 }
 
 void SpotifyRequest::GetSongs() {
@@ -328,46 +244,33 @@ void SpotifyRequest::AddSongsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  songs_requests_queue_.enqueue(request);
-
   ++songs_requests_total_;
+  ++songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"songs"_s, this, [this, request]() { return SendSongsRequest(request); }, [this, request](QNetworkReply *reply) { SongsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void SpotifyRequest::FlushSongsRequests() {
-
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+QNetworkReply *SpotifyRequest::SendSongsRequest(const Request &request) {
 
-    Request request = songs_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (type_ == Type::SearchSongs) {
-      parameters << Param(u"type"_s, u"track"_s);
-      parameters << Param(u"q"_s, search_text_);
-    }
-    if (request.limit > 0) {
-      parameters << Param(u"limit"_s, QString::number(request.limit));
-    }
-    if (request.offset > 0) {
-      parameters << Param(u"offset"_s, QString::number(request.offset));
-    }
-    QNetworkReply *reply = nullptr;
-    if (type_ == Type::FavouriteSongs) {
-      reply = CreateRequest(u"me/tracks"_s, parameters);
-    }
-    if (type_ == Type::SearchSongs) {
-      reply = CreateRequest(u"search"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
-
-    ++songs_requests_active_;
+  ParamList parameters;
+  if (type_ == Type::SearchSongs) {
+    parameters << Param(u"type"_s, u"track"_s);
+    parameters << Param(u"q"_s, search_text_);
+  }
+  if (request.limit > 0) {
+    parameters << Param(u"limit"_s, QString::number(request.limit));
+  }
+  if (request.offset > 0) {
+    parameters << Param(u"offset"_s, QString::number(request.offset));
+  }
 
+  if (type_ == Type::SearchSongs) {
+    return CreateRequest(u"search"_s, parameters);
   }
 
+  return CreateRequest(u"me/tracks"_s, parameters);
+
 }
 
 void SpotifyRequest::ArtistsSearch() {
@@ -414,8 +317,6 @@ void SpotifyRequest::AddSongsSearchRequest(const int offset) {
 
 void SpotifyRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -546,7 +447,7 @@ void SpotifyRequest::ArtistsFinishCheck(const int limit, const int offset, const
     }
   }
 
-  if (artists_requests_queue_.isEmpty() && artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
+  if (artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
 
     // Get artist albums
     const QList<ArtistAlbumsRequest> requests = artist_albums_requests_pending_.values();
@@ -580,29 +481,19 @@ void SpotifyRequest::AddArtistAlbumsRequest(const Artist &artist, const int offs
   ArtistAlbumsRequest request;
   request.artist = artist;
   request.offset = offset;
-  artist_albums_requests_queue_.enqueue(request);
-
   ++artist_albums_requests_total_;
+  ++artist_albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artistalbums"_s, this, [this, request]() { return SendArtistAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
 
 }
 
-void SpotifyRequest::FlushArtistAlbumsRequests() {
-
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+QNetworkReply *SpotifyRequest::SendArtistAlbumsRequest(const ArtistAlbumsRequest &request) {
 
-    ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
+  ParamList parameters;
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
 
-    ParamList parameters;
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
-    replies_ << reply;
-
-    ++artist_albums_requests_active_;
-
-  }
+  return CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
 
 }
 
@@ -617,8 +508,6 @@ void SpotifyRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artis
 
 void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_artist, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -795,11 +684,11 @@ void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_a
           if (song.is_compilation()) compilation = true;
           songs << song;
         }
-        for (Song song : std::as_const(songs)) {
+        for (Song &song : songs) {
           if (compilation) song.set_compilation_detected(true);
           if (!multidisc) song.set_disc(0);
-          songs_.insert(song.song_id(), song);
         }
+        InsertSongs(songs);
       }
     }
     else if (!album_songs_requests_pending_.contains(album.album_id)) {
@@ -845,11 +734,8 @@ void SpotifyRequest::AlbumsFinishCheck(const Artist &artist, const int limit, co
   }
 
   if (
-      artists_requests_queue_.isEmpty() &&
       artists_requests_active_ <= 0 &&
-      albums_requests_queue_.isEmpty() &&
       albums_requests_active_ <= 0 &&
-      artist_albums_requests_queue_.isEmpty() &&
       artist_albums_requests_active_ <= 0
       ) { // Artist albums query is finished, get all songs for all albums.
 
@@ -893,27 +779,19 @@ void SpotifyRequest::AddAlbumSongsRequest(const Artist &artist, const Album &alb
   request.artist = artist;
   request.album = album;
   request.offset = offset;
-  album_songs_requests_queue_.enqueue(request);
-
   ++album_songs_requests_total_;
+  ++album_songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albumsongs"_s, this, [this, request]() { return SendAlbumSongsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
 
 }
 
-void SpotifyRequest::FlushAlbumSongsRequests() {
+QNetworkReply *SpotifyRequest::SendAlbumSongsRequest(const AlbumSongsRequest &request) {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  ParamList parameters;
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
 
-    AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
-    ++album_songs_requests_active_;
-    ParamList parameters;
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
-
-  }
+  return CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
 
 }
 
@@ -930,8 +808,6 @@ void SpotifyRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist
 
 void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -1020,11 +896,11 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
   }
+  InsertSongs(songs);
 
   if (type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
@@ -1175,18 +1051,55 @@ void SpotifyRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Ar
 
 }
 
+void SpotifyRequest::InsertSongs(const SongList &songs) {
+
+  if (!IsQuery()) {
+    SongMap page_songs;
+    for (const Song &song : songs) {
+      if (!songs_.contains(song.song_id())) {
+        page_songs.insert(song.song_id(), song);
+      }
+      songs_.insert(song.song_id(), song);
+    }
+    // Search results are shown page by page, the complete result is still sent with Results() when the search is finished.
+    if (IsSearch() && !page_songs.isEmpty()) {
+      Q_EMIT PartialResults(query_id_, page_songs);
+    }
+    return;
+  }
+
+  SongMap synced_songs;
+  for (Song song : songs) {
+    if (service_->download_album_covers() && song.art_automatic().isValid() && !SetCachedAlbumCover(song)) {
+      songs_.insert(song.song_id(), song);
+    }
+    synced_songs.insert(song.song_id(), song);
+  }
+
+  if (synced_songs.isEmpty()) return;
+
+  songs_synced_ += static_cast<int>(synced_songs.count());
+  Q_EMIT SongsSynced(query_id_, synced_songs);
+
+}
+
+bool SpotifyRequest::SetCachedAlbumCover(Song &song) const {
+
+  const QString filename = CoverUtils::CoverFilePath(CoverOptions(), song.source(), song.effective_albumartist(), song.effective_album(), song.album_id(), QString(), song.art_automatic());
+  if (filename.isEmpty() || !QFileInfo::exists(filename)) return false;
+
+  song.set_art_automatic(QUrl::fromLocalFile(filename));
+
+  return true;
+
+}
+
 void SpotifyRequest::GetAlbumCoversCheck() {
 
   if (
       !finished_ &&
       service_->download_album_covers() &&
       IsQuery() &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1213,8 +1126,6 @@ void SpotifyRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
-
 }
 
 void SpotifyRequest::AddAlbumCoverRequest(const Song &song) {
@@ -1232,40 +1143,25 @@ void SpotifyRequest::AddAlbumCoverRequest(const Song &song) {
 
   album_covers_requests_sent_.insert(song.album_id(), song.song_id());
   ++album_covers_requests_total_;
+  ++album_covers_requests_active_;
 
-  album_cover_requests_queue_.enqueue(request);
+  scheduler_->Queue(u"albumcovers"_s, this, [this, request]() { return SendAlbumCoverRequest(request); }, [this, request](QNetworkReply *reply) { AlbumCoverReceived(reply, request.album_id, request.url, request.filename); });
 
 }
 
-void SpotifyRequest::FlushAlbumCoverRequests() {
-
-  while (!album_cover_requests_queue_.isEmpty() && album_covers_requests_active_ < kMaxConcurrentAlbumCoverRequests) {
-
-    AlbumCoverRequest request = album_cover_requests_queue_.dequeue();
+QNetworkReply *SpotifyRequest::SendAlbumCoverRequest(const AlbumCoverRequest &request) {
 
-    QNetworkRequest req(request.url);
-    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *reply = network_->get(req);
-    album_cover_replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumCoverReceived(reply, request.album_id, request.url, request.filename); });
+  QNetworkRequest req(request.url);
+  req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
 
-    ++album_covers_requests_active_;
-
-  }
+  return network_->get(req);
 
 }
 
 void SpotifyRequest::AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename) {
 
-  if (album_cover_replies_.contains(reply)) {
-    album_cover_replies_.removeAll(reply);
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    reply->deleteLater();
-  }
-  else {
-    AlbumCoverFinishCheck();
-    return;
-  }
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
 
   --album_covers_requests_active_;
   ++album_covers_requests_received_;
@@ -1352,12 +1248,6 @@ void SpotifyRequest::FinishCheck() {
 
   if (
       !finished_ &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1368,11 +1258,17 @@ void SpotifyRequest::FinishCheck() {
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0
   ) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
-    if (no_results_ && songs_.isEmpty()) {
+    if (IsQuery()) {
+      if (!songs_.isEmpty()) Q_EMIT SongsSynced(query_id_, songs_);
+      if (!no_results_ && songs_synced_ == 0 && errors_.isEmpty()) {
+        Q_EMIT Results(query_id_, SongMap(), tr("Data missing error"));
+      }
+      else {
+        Q_EMIT Results(query_id_, SongMap(), ErrorsToHTML(errors_));
+      }
+    }
+    else if (no_results_ && songs_.isEmpty()) {
       if (IsSearch())
         Q_EMIT Results(query_id_, SongMap(), tr("No match."));
       else
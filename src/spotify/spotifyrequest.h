@@ -29,19 +29,18 @@
 #include <QList>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
 #include <QJsonObject>
-#include <QTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "spotifybaserequest.h"
 
 class QNetworkReply;
+class StreamingRequestScheduler;
 class NetworkAccessManager;
 class SpotifyService;
 
@@ -94,14 +93,14 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
  Q_SIGNALS:
   void Results(int id, SongMap songs, QString error);
+  void SongsSynced(const int id, const SongMap &songs);
+  void PartialResults(const int id, const SongMap &songs);
   void UpdateStatus(int id, QString text);
   void ProgressSetMaximum(int id, int max);
   void UpdateProgress(int id, int max);
   void StreamURLFinished(QUrl original_url, QUrl url, Song::FileType, QString error = QString());
 
  private Q_SLOTS:
-  void FlushRequests();
-
   void ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
 
   void AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
@@ -115,8 +114,6 @@ class SpotifyRequest : public SpotifyBaseRequest {
   void AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename);
 
  private:
-  void StartRequests();
-
   bool IsQuery() const { return (type_ == Type::FavouriteArtists || type_ == Type::FavouriteAlbums || type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (type_ == Type::SearchArtists || type_ == Type::SearchAlbums || type_ == Type::SearchSongs); }
 
@@ -130,30 +127,32 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
   void AddArtistsRequest(const int offset = 0, const int limit = 0);
   void AddArtistsSearchRequest(const int offset = 0);
-  void FlushArtistsRequests();
+  QNetworkReply *SendArtistsRequest(const Request &request);
   void AddAlbumsRequest(const int offset = 0, const int limit = 0);
   void AddAlbumsSearchRequest(const int offset = 0);
-  void FlushAlbumsRequests();
+  QNetworkReply *SendAlbumsRequest(const Request &request);
   void AddSongsRequest(const int offset = 0, const int limit = 0);
   void AddSongsSearchRequest(const int offset = 0);
-  void FlushSongsRequests();
+  QNetworkReply *SendSongsRequest(const Request &request);
 
   void ArtistsFinishCheck(const int limit = 0, const int offset = 0, const int artists_received = 0);
   void AlbumsFinishCheck(const Artist &artist, const int limit = 0, const int offset = 0, const int albums_total = 0, const int albums_received = 0);
   void SongsFinishCheck(const Artist &artist, const Album &album, const int limit = 0, const int offset = 0, const int songs_total = 0, const int songs_received = 0);
 
   void AddArtistAlbumsRequest(const Artist &artist, const int offset = 0);
-  void FlushArtistAlbumsRequests();
+  QNetworkReply *SendArtistAlbumsRequest(const ArtistAlbumsRequest &request);
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
-  void FlushAlbumSongsRequests();
+  QNetworkReply *SendAlbumSongsRequest(const AlbumSongsRequest &request);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+  void InsertSongs(const SongList &songs);
+  bool SetCachedAlbumCover(Song &song) const;
 
   void GetAlbumCoversCheck();
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
-  void FlushAlbumCoverRequests();
+  QNetworkReply *SendAlbumCoverRequest(const AlbumCoverRequest &request);
   void AlbumCoverFinishCheck();
 
   int GetProgress(const int count, const int total);
@@ -164,7 +163,7 @@ class SpotifyRequest : public SpotifyBaseRequest {
  private:
   SpotifyService *service_;
   const SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_flush_requests_;
+  StreamingRequestScheduler *scheduler_;
 
   const Type type_;
   bool fetchalbums_;
@@ -175,14 +174,6 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
   bool finished_;
 
-  QQueue<Request> artists_requests_queue_;
-  QQueue<Request> albums_requests_queue_;
-  QQueue<Request> songs_requests_queue_;
-
-  QQueue<ArtistAlbumsRequest> artist_albums_requests_queue_;
-  QQueue<AlbumSongsRequest> album_songs_requests_queue_;
-  QQueue<AlbumCoverRequest> album_cover_requests_queue_;
-
   QMap<QString, ArtistAlbumsRequest> artist_albums_requests_pending_;
   QMap<QString, AlbumSongsRequest> album_songs_requests_pending_;
   QMultiMap<QString, QString> album_covers_requests_sent_;
@@ -222,10 +213,9 @@ class SpotifyRequest : public SpotifyBaseRequest {
   int album_covers_requests_received_;
 
   SongMap songs_;
+  int songs_synced_;
   QStringList errors_;
   bool no_results_;
-  QList<QNetworkReply*> replies_;
-  QList<QNetworkReply*> album_cover_replies_;
 
 };
 
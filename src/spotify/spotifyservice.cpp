@@ -521,10 +521,12 @@ void SpotifyService::GetArtists() {
   ResetArtistsRequest();
   artists_request_.reset(new SpotifyRequest(this, network_, SpotifyBaseRequest::Type::FavouriteArtists, this), [](SpotifyRequest *request) { request->deleteLater(); });
   QObject::connect(&*artists_request_, &SpotifyRequest::Results, this, &SpotifyService::ArtistsResultsReceived);
+  QObject::connect(&*artists_request_, &SpotifyRequest::SongsSynced, this, &SpotifyService::ArtistsSyncedReceived);
   QObject::connect(&*artists_request_, &SpotifyRequest::UpdateStatus, this, &SpotifyService::ArtistsUpdateStatusReceived);
   QObject::connect(&*artists_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::ArtistsProgressSetMaximumReceived);
   QObject::connect(&*artists_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::ArtistsUpdateProgressReceived);
 
+  artists_collection_backend_->BeginSyncAsync();
   artists_request_->Process();
 
 }
@@ -532,11 +534,21 @@ void SpotifyService::GetArtists() {
 void SpotifyService::ArtistsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT ArtistsResults(songs, error);
+  Q_UNUSED(songs);
+
+  artists_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT ArtistsSyncFinished(error);
   ResetArtistsRequest();
 
 }
 
+void SpotifyService::ArtistsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  artists_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void SpotifyService::ArtistsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT ArtistsUpdateStatus(text);
@@ -573,10 +585,12 @@ void SpotifyService::GetAlbums() {
   ResetAlbumsRequest();
   albums_request_.reset(new SpotifyRequest(this, network_, SpotifyBaseRequest::Type::FavouriteAlbums, this), [](SpotifyRequest *request) { request->deleteLater(); });
   QObject::connect(&*albums_request_, &SpotifyRequest::Results, this, &SpotifyService::AlbumsResultsReceived);
+  QObject::connect(&*albums_request_, &SpotifyRequest::SongsSynced, this, &SpotifyService::AlbumsSyncedReceived);
   QObject::connect(&*albums_request_, &SpotifyRequest::UpdateStatus, this, &SpotifyService::AlbumsUpdateStatusReceived);
   QObject::connect(&*albums_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::AlbumsProgressSetMaximumReceived);
   QObject::connect(&*albums_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::AlbumsUpdateProgressReceived);
 
+  albums_collection_backend_->BeginSyncAsync();
   albums_request_->Process();
 
 }
@@ -584,11 +598,21 @@ void SpotifyService::GetAlbums() {
 void SpotifyService::AlbumsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT AlbumsResults(songs, error);
+  Q_UNUSED(songs);
+
+  albums_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT AlbumsSyncFinished(error);
   ResetAlbumsRequest();
 
 }
 
+void SpotifyService::AlbumsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  albums_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void SpotifyService::AlbumsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT AlbumsUpdateStatus(text);
@@ -625,10 +649,12 @@ void SpotifyService::GetSongs() {
   ResetSongsRequest();
   songs_request_.reset(new SpotifyRequest(this, network_, SpotifyBaseRequest::Type::FavouriteSongs, this), [](SpotifyRequest *request) { request->deleteLater(); });
   QObject::connect(&*songs_request_, &SpotifyRequest::Results, this, &SpotifyService::SongsResultsReceived);
+  QObject::connect(&*songs_request_, &SpotifyRequest::SongsSynced, this, &SpotifyService::SongsSyncedReceived);
   QObject::connect(&*songs_request_, &SpotifyRequest::UpdateStatus, this, &SpotifyService::SongsUpdateStatusReceived);
   QObject::connect(&*songs_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::SongsProgressSetMaximumReceived);
   QObject::connect(&*songs_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::SongsUpdateProgressReceived);
 
+  songs_collection_backend_->BeginSyncAsync();
   songs_request_->Process();
 
 }
@@ -636,11 +662,21 @@ void SpotifyService::GetSongs() {
 void SpotifyService::SongsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT SongsResults(songs, error);
+  Q_UNUSED(songs);
+
+  songs_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT SongsSyncFinished(error);
   ResetSongsRequest();
 
 }
 
+void SpotifyService::SongsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  songs_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void SpotifyService::SongsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT SongsUpdateStatus(text);
@@ -690,6 +726,16 @@ void SpotifyService::StartSearch() {
 }
 
 void SpotifyService::CancelSearch() {
+
+  timer_search_delay_->stop();
+
+  // Abort the replies of a superseded search right away instead of letting it finish in the background.
+  if (search_request_) {
+    QObject::disconnect(search_request_.get(), nullptr, this, nullptr);
+    QObject::disconnect(this, nullptr, search_request_.get(), nullptr);
+    search_request_.reset();
+  }
+
 }
 
 void SpotifyService::SendSearch() {
@@ -714,6 +760,7 @@ void SpotifyService::SendSearch() {
   search_request_.reset(new SpotifyRequest(this, network_, type, this), [](SpotifyRequest *request) { request->deleteLater(); });
 
   QObject::connect(search_request_.get(), &SpotifyRequest::Results, this, &SpotifyService::SearchResultsReceived);
+  QObject::connect(search_request_.get(), &SpotifyRequest::PartialResults, this, &SpotifyService::SearchPartialResults);
   QObject::connect(search_request_.get(), &SpotifyRequest::UpdateStatus, this, &SpotifyService::SearchUpdateStatus);
   QObject::connect(search_request_.get(), &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::SearchProgressSetMaximum);
   QObject::connect(search_request_.get(), &SpotifyRequest::UpdateProgress, this, &SpotifyService::SearchUpdateProgress);
@@ -0,0 +1,315 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QMetaObject>
+#include <QPointer>
+#include <QTimer>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "core/logging.h"
+#include "streamingrequestscheduler.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+const QList<int> StreamingRequestScheduler::kLatencyBuckets = QList<int>() << 50 << 100 << 250 << 500 << 1000 << 2500 << 5000 << 10000;
+
+namespace {
+constexpr int kDefaultMaxConcurrency = 8;
+// A reply slower than this factor of the average latency is a sign that the server is getting busy, and stops the concurrency from increasing.
+constexpr double kLatencyFactor = 2.0;
+constexpr double kLatencySmoothing = 0.2;
+constexpr double kDecreaseFactor = 0.5;
+constexpr int kMaxRetries = 3;
+constexpr qint64 kInitialBackoffMs = 1000;
+constexpr qint64 kMaxBackoffMs = 120000;
+}  // namespace
+
+StreamingRequestScheduler::StreamingRequestScheduler(QObject *parent) : QObject(parent) {
+
+  clock_.start();
+
+}
+
+void StreamingRequestScheduler::AddEndpoint(const QString &endpoint, const int initial_concurrency, const int max_concurrency) {
+
+  if (endpoints_.contains(endpoint)) return;
+
+  Endpoint &data = endpoints_[endpoint];
+  data.max_concurrency = std::max(1, max_concurrency);
+  data.concurrency = std::clamp(static_cast<double>(initial_concurrency), 1.0, static_cast<double>(data.max_concurrency));
+  data.latency_histogram.fill(0, static_cast<int>(kLatencyBuckets.count()) + 1);
+
+}
+
+bool StreamingRequestScheduler::CanStart(const QString &endpoint) const {
+
+  if (!endpoints_.contains(endpoint)) return active(endpoint) < 1;
+
+  const Endpoint &data = endpoints_[endpoint];
+
+  return clock_.elapsed() >= data.blocked_until && data.active < static_cast<int>(std::floor(data.concurrency));
+
+}
+
+qint64 StreamingRequestScheduler::BlockedFor(const QString &endpoint) const {
+
+  if (!endpoints_.contains(endpoint)) return 0;
+
+  return std::max(0LL, endpoints_[endpoint].blocked_until - clock_.elapsed());
+
+}
+
+void StreamingRequestScheduler::Queue(const QString &endpoint, QObject *context, const SendFunction &send, const FinishedFunction &finished) {
+
+  if (!endpoints_.contains(endpoint)) {
+    AddEndpoint(endpoint, 1, kDefaultMaxConcurrency);
+  }
+
+  Request request;
+  request.endpoint = endpoint;
+  request.context = context;
+  request.send = send;
+  request.finished = finished;
+  endpoints_[endpoint].queue << request;
+
+  Flush(endpoint);
+
+}
+
+void StreamingRequestScheduler::Flush(const QString &endpoint) {
+
+  if (!endpoints_.contains(endpoint)) return;
+
+  endpoints_[endpoint].flush_scheduled = false;
+
+  // The send functions can queue new requests, so the endpoint is looked up again for every request.
+  while (!endpoints_[endpoint].queue.isEmpty() && CanStart(endpoint)) {
+    Request request = endpoints_[endpoint].queue.takeFirst();
+    if (!request.context) continue;
+    QNetworkReply *reply = request.send();
+    if (!reply) continue;
+
+    ++endpoints_[endpoint].active;
+    request.started = clock_.elapsed();
+    requests_.insert(reply, request);
+
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]() { ReplyFinished(reply); });
+    // Replies that are aborted and deleted without being finished still have to give back their slot.
+    QObject::connect(reply, &QObject::destroyed, this, &StreamingRequestScheduler::RequestDestroyed);
+  }
+
+  // Running requests flush the queue when they finish, a throttled endpoint without running requests is flushed once the server accepts requests again.
+  Endpoint &data = endpoints_[endpoint];
+  if (!data.queue.isEmpty() && data.active <= 0 && !data.flush_scheduled) {
+    data.flush_scheduled = true;
+    QTimer::singleShot(BlockedFor(endpoint), this, [this, endpoint]() { Flush(endpoint); });
+  }
+
+}
+
+void StreamingRequestScheduler::Abort(QObject *context) {
+
+  QStringList endpoints;
+  for (QHash<QString, Endpoint>::iterator it = endpoints_.begin(); it != endpoints_.end(); ++it) {
+    if (it->queue.removeIf([context](const Request &request) { return request.context == context; }) > 0) {
+      endpoints << it.key();
+    }
+  }
+
+  QList<QObject*> replies;
+  for (QHash<QObject*, Request>::const_iterator it = requests_.constBegin(); it != requests_.constEnd(); ++it) {
+    if (it->context == context) replies << it.key();
+  }
+
+  for (QObject *object : std::as_const(replies)) {
+    const Request request = requests_.take(object);
+    if (endpoints_.contains(request.endpoint)) {
+      --endpoints_[request.endpoint].active;
+      if (!endpoints.contains(request.endpoint)) endpoints << request.endpoint;
+    }
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(object);
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    QObject::disconnect(reply, nullptr, context, nullptr);
+    if (reply->isRunning()) reply->abort();
+    reply->deleteLater();
+  }
+
+  // The slots given back can be used by the requests of others.
+  for (const QString &endpoint : std::as_const(endpoints)) {
+    Flush(endpoint);
+  }
+
+}
+
+void StreamingRequestScheduler::RequestDestroyed(QObject *object) {
+
+  if (!requests_.contains(object)) return;
+
+  const Request request = requests_.take(object);
+  if (endpoints_.contains(request.endpoint)) {
+    --endpoints_[request.endpoint].active;
+    QMetaObject::invokeMethod(this, [this, endpoint = request.endpoint]() { Flush(endpoint); }, Qt::QueuedConnection);
+  }
+
+}
+
+void StreamingRequestScheduler::ReplyFinished(QNetworkReply *reply) {
+
+  if (!requests_.contains(reply)) return;
+
+  QObject::disconnect(reply, nullptr, this, nullptr);
+
+  Request request = requests_.take(reply);
+  --endpoints_[request.endpoint].active;
+
+  const bool retry = UpdateEndpoint(request, reply);
+
+  if (!request.context) {
+    reply->deleteLater();
+  }
+  else if (retry && request.retries < kMaxRetries) {
+    // The retries are counted per request, so one request that keeps failing does not use up the retries of the others.
+    QObject::disconnect(reply, nullptr, request.context, nullptr);
+    reply->deleteLater();
+    ++request.retries;
+    endpoints_[request.endpoint].queue.prepend(request);
+  }
+  else {
+    request.finished(reply);
+  }
+
+  Flush(request.endpoint);
+
+}
+
+bool StreamingRequestScheduler::UpdateEndpoint(const Request &request, QNetworkReply *reply) {
+
+  Endpoint &data = endpoints_[request.endpoint];
+
+  if (reply->error() == QNetworkReply::OperationCanceledError) return false;
+
+  const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+  if (http_status_code == 429 || http_status_code >= 500) {
+    data.concurrency = std::max(1.0, data.concurrency * kDecreaseFactor);
+    ++data.failures;
+    ++data.throttled;
+    const QByteArray retry_after = reply->rawHeader("Retry-After").trimmed();
+    qint64 delay = ParseRetryAfter(retry_after);
+    // Back off exponentially unless the server said when to retry.
+    if (delay <= 0 && retry_after != "0") {
+      delay = kInitialBackoffMs << std::min(data.failures - 1, 16);
+    }
+    delay = std::min(delay, kMaxBackoffMs);
+    data.blocked_until = std::max(data.blocked_until, clock_.elapsed() + delay);
+    qLog(Debug) << "Request to" << request.endpoint << "failed with HTTP code" << http_status_code << "concurrency lowered to" << static_cast<int>(data.concurrency) << "waiting" << delay << "ms";
+    return true;
+  }
+
+  // Network errors without a reply from the server say nothing about how busy the server is.
+  if (http_status_code == 0) return false;
+
+  data.failures = 0;
+
+  const qint64 latency = clock_.elapsed() - request.started;
+  const qsizetype bucket = std::upper_bound(kLatencyBuckets.begin(), kLatencyBuckets.end(), latency) - kLatencyBuckets.begin();
+  ++data.latency_histogram[bucket];
+
+  if (data.latency_average <= 0.0 || static_cast<double>(latency) <= data.latency_average * kLatencyFactor) {
+    // Additive increase, about one more request for each round of replies.
+    data.concurrency = std::min(static_cast<double>(data.max_concurrency), data.concurrency + (1.0 / data.concurrency));
+  }
+  data.latency_average = data.latency_average <= 0.0 ? static_cast<double>(latency) : (data.latency_average * (1.0 - kLatencySmoothing)) + (static_cast<double>(latency) * kLatencySmoothing);
+
+  return false;
+
+}
+
+double StreamingRequestScheduler::concurrency(const QString &endpoint) const {
+
+  return endpoints_.contains(endpoint) ? endpoints_[endpoint].concurrency : 1.0;
+
+}
+
+int StreamingRequestScheduler::active(const QString &endpoint) const {
+
+  return endpoints_.contains(endpoint) ? endpoints_[endpoint].active : 0;
+
+}
+
+int StreamingRequestScheduler::queued(const QString &endpoint) const {
+
+  return endpoints_.contains(endpoint) ? static_cast<int>(endpoints_[endpoint].queue.count()) : 0;
+
+}
+
+QList<int> StreamingRequestScheduler::latency_histogram(const QString &endpoint) const {
+
+  return endpoints_.contains(endpoint) ? endpoints_[endpoint].latency_histogram : QList<int>();
+
+}
+
+QString StreamingRequestScheduler::Statistics() const {
+
+  QStringList lines;
+  QStringList endpoints = endpoints_.keys();
+  std::sort(endpoints.begin(), endpoints.end());
+  for (const QString &endpoint : std::as_const(endpoints)) {
+    const Endpoint &data = endpoints_[endpoint];
+    QStringList buckets;
+    for (qsizetype i = 0; i < data.latency_histogram.count(); ++i) {
+      buckets << (i < kLatencyBuckets.count() ? QStringLiteral("<%1ms: %2").arg(kLatencyBuckets[i]).arg(data.latency_histogram[i]) : QStringLiteral(">=%1ms: %2").arg(kLatencyBuckets.last()).arg(data.latency_histogram[i]));
+    }
+    lines << QStringLiteral("%1: concurrency %2, active %3, queued %4, throttled %5, %6").arg(endpoint).arg(data.concurrency, 0, 'f', 1).arg(data.active).arg(data.queue.count()).arg(data.throttled).arg(buckets.join(", "_L1));
+  }
+
+  return lines.join(u'\n');
+
+}
+
+qint64 StreamingRequestScheduler::ParseRetryAfter(const QByteArray &value) {
+
+  const QByteArray trimmed_value = value.trimmed();
+  if (trimmed_value.isEmpty()) return 0;
+
+  // Either a number of seconds or a HTTP date.
+  bool ok = false;
+  const qint64 seconds = trimmed_value.toLongLong(&ok);
+  if (ok) return std::max(0LL, seconds * 1000LL);
+
+  const QDateTime datetime = QDateTime::fromString(QString::fromLatin1(trimmed_value), Qt::RFC2822Date);
+  if (!datetime.isValid()) return 0;
+
+  return std::max(0LL, QDateTime::currentDateTimeUtc().msecsTo(datetime));
+
+}
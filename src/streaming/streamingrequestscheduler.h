@@ -0,0 +1,113 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMINGREQUESTSCHEDULER_H
+#define STREAMINGREQUESTSCHEDULER_H
+
+#include <functional>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QNetworkReply;
+
+// Queues and sends the requests of a streaming service, and decides how many requests can run per endpoint.
+// The concurrency of an endpoint is increased additively while replies are fast, and halved when the server throttles (HTTP 429) or fails (HTTP 5xx).
+// A throttled endpoint does not start new requests until the delay from the Retry-After header has passed, and the throttled request is sent again.
+class StreamingRequestScheduler : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit StreamingRequestScheduler(QObject *parent = nullptr);
+
+  // Creates the reply of a queued request once the endpoint can start it, or returns nullptr to skip the request.
+  using SendFunction = std::function<QNetworkReply*()>;
+  // Called with the finished reply, which the receiver deletes.
+  using FinishedFunction = std::function<void(QNetworkReply*)>;
+
+  // Upper bounds in milliseconds of the latency histogram buckets, the last bucket has no upper bound.
+  static const QList<int> kLatencyBuckets;
+
+  // Sets the concurrency the endpoint starts with and the maximum it can be increased to, unless the endpoint is already known.
+  void AddEndpoint(const QString &endpoint, const int initial_concurrency, const int max_concurrency);
+
+  // Queues a request for the endpoint, the request is dropped when context is destroyed.
+  // Throttled requests are queued again without calling finished, until they run out of retries.
+  void Queue(const QString &endpoint, QObject *context, const SendFunction &send, const FinishedFunction &finished);
+  // Drops the queued requests of context and aborts its running requests.
+  void Abort(QObject *context);
+
+  bool CanStart(const QString &endpoint) const;
+  // Returns the milliseconds until a throttled endpoint accepts requests again.
+  qint64 BlockedFor(const QString &endpoint) const;
+
+  double concurrency(const QString &endpoint) const;
+  int active(const QString &endpoint) const;
+  int queued(const QString &endpoint) const;
+  QList<int> latency_histogram(const QString &endpoint) const;
+  QString Statistics() const;
+
+  static qint64 ParseRetryAfter(const QByteArray &value);
+
+ private:
+  class Request {
+   public:
+    Request() : started(0), retries(0) {}
+    QString endpoint;
+    QPointer<QObject> context;
+    SendFunction send;
+    FinishedFunction finished;
+    qint64 started;
+    int retries;
+  };
+
+  class Endpoint {
+   public:
+    Endpoint() : concurrency(1.0), max_concurrency(1), active(0), latency_average(0.0), blocked_until(0), failures(0), throttled(0), flush_scheduled(false) {}
+    double concurrency;
+    int max_concurrency;
+    int active;
+    double latency_average;
+    qint64 blocked_until;
+    int failures;
+    int throttled;
+    bool flush_scheduled;
+    QList<int> latency_histogram;
+    QList<Request> queue;
+  };
+
+  void Flush(const QString &endpoint);
+  void ReplyFinished(QNetworkReply *reply);
+  void RequestDestroyed(QObject *object);
+  // Updates the concurrency of the endpoint from the reply, returns true if the request was throttled and should be sent again.
+  bool UpdateEndpoint(const Request &request, QNetworkReply *reply);
+
+ private:
+  QElapsedTimer clock_;
+  QHash<QString, Endpoint> endpoints_;
+  QHash<QObject*, Request> requests_;
+};
+
+#endif  // STREAMINGREQUESTSCHEDULER_H
@@ -33,6 +33,9 @@
 #include <QApplication>
 #include <QWidget>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QPersistentModelIndex>
+#include <QRect>
 #include <QPair>
 #include <QList>
 #include <QMap>
@@ -64,6 +67,7 @@
 #include <QShowEvent>
 #include <QHideEvent>
 
+#include "core/logging.h"
 #include "core/song.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
@@ -90,6 +94,7 @@ namespace {
 constexpr int kSwapModelsTimeoutMsec = 250;
 constexpr int kDelayedSearchTimeoutMs = 200;
 constexpr int kArtHeight = 32;
+constexpr int kMaxConcurrentAlbumCoverTasks = 4;
 }  // namespace
 
 StreamingSearchView::StreamingSearchView(QWidget *parent)
@@ -109,7 +114,8 @@ StreamingSearchView::StreamingSearchView(QWidget *parent)
       search_type_(StreamingSearchView::SearchType::Artists),
       search_error_(false),
       last_search_id_(0),
-      searches_next_id_(1) {
+      searches_next_id_(1),
+      search_results_received_(false) {
 
   ui_->setupUi(this);
 
@@ -198,6 +204,7 @@ void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPt
   QObject::connect(&*service_, &StreamingService::SearchUpdateStatus, this, &StreamingSearchView::UpdateStatus);
   QObject::connect(&*service_, &StreamingService::SearchProgressSetMaximum, this, &StreamingSearchView::ProgressSetMaximum);
   QObject::connect(&*service_, &StreamingService::SearchUpdateProgress, this, &StreamingSearchView::UpdateProgress);
+  QObject::connect(&*service_, &StreamingService::SearchPartialResults, this, &StreamingSearchView::SearchPartialResults);
   QObject::connect(&*service_, &StreamingService::SearchResults, this, &StreamingSearchView::SearchDone);
 
   QObject::connect(&*albumcover_loader_, &AlbumCoverLoader::AlbumCoverLoaded, this, &StreamingSearchView::AlbumCoverLoaded);
@@ -388,7 +395,9 @@ void StreamingSearchView::TextEdited(const QString &text) {
   const QString trimmed(text.trimmed());
 
   search_error_ = false;
-  cover_loader_tasks_.clear();
+  search_results_received_ = false;
+  search_timer_.start();
+  CancelAlbumCovers();
 
   // Add results to the back model, switch models after some delay.
   back_model_->Clear();
@@ -416,7 +425,7 @@ void StreamingSearchView::TextEdited(const QString &text) {
 
 void StreamingSearchView::SwapModels() {
 
-  cover_loader_tasks_.clear();
+  CancelAlbumCovers();
 
   std::swap(front_model_, back_model_);
   std::swap(front_proxy_, back_proxy_);
@@ -484,12 +493,49 @@ void StreamingSearchView::SearchAsync(const int id, const QString &query, const
 
 }
 
+StreamingSearchView::ResultList StreamingSearchView::ResultsFromSongs(const SongMap &songs, PendingState *state) const {
+
+  ResultList results;
+  results.reserve(songs.count());
+  for (SongMap::const_iterator it = songs.constBegin(); it != songs.constEnd(); ++it) {
+    // Skip songs that were already added from partial results.
+    if (state->song_ids_.contains(it.key())) continue;
+    state->song_ids_.insert(it.key());
+    Result result;
+    result.metadata_ = it.value();
+    result.pixmap_cache_key_ = PixmapCacheKey(result);
+    results << result;
+  }
+
+  return results;
+
+}
+
+void StreamingSearchView::SearchPartialResults(const int service_id, const SongMap &songs) {
+
+  if (!pending_searches_.contains(service_id)) return;
+
+  PendingState &state = pending_searches_[service_id];
+  if (state.orig_id_ != last_search_id_) return;
+
+  const ResultList results = ResultsFromSongs(songs, &state);
+  if (results.isEmpty()) return;
+
+  if (!search_results_received_) {
+    search_results_received_ = true;
+    qLog(Debug) << "First" << results.count() << "search results received after" << search_timer_.elapsed() << "ms";
+  }
+
+  current_model_->AddResults(results);
+
+}
+
 void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs, const QString &error) {
 
   if (!pending_searches_.contains(service_id)) return;
 
   // Map back to the original id.
-  const PendingState state = pending_searches_.take(service_id);
+  PendingState state = pending_searches_.take(service_id);
   const int search_id = state.orig_id_;
 
   if (songs.isEmpty()) {
@@ -497,20 +543,11 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
     return;
   }
 
-  ResultList results;
-  results.reserve(songs.count());
-  for (const Song &song : songs) {
-    Result result;
-    result.metadata_ = song;
-    results << result;
-  }
-
-  // Load cached pixmaps into the results
-  for (StreamingSearchView::ResultList::iterator it = results.begin(); it != results.end(); ++it) {
-    it->pixmap_cache_key_ = PixmapCacheKey(*it);
+  if (search_id == last_search_id_) {
+    qLog(Debug) << "Search finished with" << songs.count() << "results after" << search_timer_.elapsed() << "ms";
   }
 
-  AddResults(search_id, results);
+  AddResults(search_id, ResultsFromSongs(songs, &state));
 
 }
 
@@ -529,12 +566,14 @@ void StreamingSearchView::CancelSearch(const int id) {
 
 void StreamingSearchView::AddResults(const int id, const StreamingSearchView::ResultList &results) {
 
-  if (id != last_search_id_ || results.isEmpty()) return;
+  if (id != last_search_id_) return;
 
   ui_->label_status->clear();
   ui_->progressbar->reset();
   ui_->progressbar->hide();
-  current_model_->AddResults(results);
+  if (!results.isEmpty()) {
+    current_model_->AddResults(results);
+  }
 
 }
 
@@ -699,7 +738,7 @@ void StreamingSearchView::SetGroupBy(const CollectionModel::Grouping g) {
   // Clear requests: changing "group by" on the models will cause all the items to be removed/added again,
   // so all the QModelIndex here will become invalid. New requests will be created for those
   // songs when they will be displayed again anyway (when StreamingSearchItemDelegate::paint will call LazyLoadAlbumCover)
-  cover_loader_tasks_.clear();
+  CancelAlbumCovers();
 
   // Update the models
   front_model_->SetGroupBy(g, true);
@@ -852,21 +891,69 @@ void StreamingSearchView::LazyLoadAlbumCover(const QModelIndex &proxy_index) {
     item_album->setData(cached_pixmap, Qt::DecorationRole);
   }
   else {
+    cover_loader_queue_ << QPersistentModelIndex(source_index);
+    LoadAlbumCovers();
+  }
+
+}
+
+bool StreamingSearchView::IsVisible(const QModelIndex &source_index) const {
+
+  const QModelIndex proxy_index = front_proxy_->mapFromSource(source_index);
+  if (!proxy_index.isValid()) return false;
+
+  return ui_->results->viewport()->rect().intersects(ui_->results->visualRect(proxy_index));
+
+}
+
+void StreamingSearchView::LoadAlbumCovers() {
+
+  while (cover_loader_tasks_.count() < kMaxConcurrentAlbumCoverTasks && !cover_loader_queue_.isEmpty()) {
+
+    // Albums that were scrolled out of view while waiting are loaded after the visible ones.
+    qint64 i = 0;
+    for (qint64 j = 0; j < cover_loader_queue_.count(); ++j) {
+      if (cover_loader_queue_[j].isValid() && IsVisible(cover_loader_queue_[j])) {
+        i = j;
+        break;
+      }
+    }
+    const QPersistentModelIndex source_index = cover_loader_queue_.takeAt(i);
+    if (!source_index.isValid()) continue;
+
+    QStandardItem *item_song = front_model_->itemFromIndex(source_index);
+    if (!item_song) continue;
+    while (item_song->rowCount() > 0) {
+      item_song = item_song->child(0);
+    }
+    const StreamingSearchView::Result result = item_song->data(StreamingSearchModel::Role_Result).value<StreamingSearchView::Result>();
+
     AlbumCoverLoaderOptions cover_loader_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
     cover_loader_options.desired_scaled_size = QSize(kArtHeight, kArtHeight);
-    quint64 loader_id = albumcover_loader_->LoadImageAsync(cover_loader_options, result.metadata_);
+    const quint64 loader_id = albumcover_loader_->LoadImageAsync(cover_loader_options, result.metadata_);
     cover_loader_tasks_[loader_id] = qMakePair(source_index, result.pixmap_cache_key_);
+
   }
 
 }
 
+void StreamingSearchView::CancelAlbumCovers() {
+
+  if (albumcover_loader_ && !cover_loader_tasks_.isEmpty()) {
+    albumcover_loader_->CancelTasks(QSet<quint64>(cover_loader_tasks_.keyBegin(), cover_loader_tasks_.keyEnd()));
+  }
+  cover_loader_queue_.clear();
+  cover_loader_tasks_.clear();
+
+}
+
 void StreamingSearchView::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &albumcover_result) {
 
   if (!cover_loader_tasks_.contains(id)) return;
 
-  QPair<QModelIndex, QString> cover_loader_task = cover_loader_tasks_.take(id);
-  QModelIndex idx = cover_loader_task.first;
-  QString key = cover_loader_task.second;
+  const QPair<QPersistentModelIndex, QString> cover_loader_task = cover_loader_tasks_.take(id);
+  const QPersistentModelIndex idx = cover_loader_task.first;
+  const QString key = cover_loader_task.second;
 
   if (albumcover_result.success && !albumcover_result.image_scaled.isNull()) {
     QPixmap pixmap = QPixmap::fromImage(albumcover_result.image_scaled);
@@ -881,4 +968,6 @@ void StreamingSearchView::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoa
     }
   }
 
+  LoadAlbumCovers();
+
 }
@@ -37,6 +37,8 @@
 #include <QImage>
 #include <QPixmap>
 #include <QMetaType>
+#include <QElapsedTimer>
+#include <QPersistentModelIndex>
 
 #include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
@@ -94,6 +96,8 @@ class StreamingSearchView : public QWidget {
     PendingState(int orig_id, const QStringList &tokens) : orig_id_(orig_id), tokens_(tokens) {}
     int orig_id_;
     QStringList tokens_;
+    // Songs already added to the model from partial results.
+    QSet<QString> song_ids_;
 
     bool operator<(const PendingState &b) const {
       return orig_id_ < b.orig_id_;
@@ -132,9 +136,13 @@ class StreamingSearchView : public QWidget {
   void SearchError(const int id, const QString &error);
   void CancelSearch(const int id);
 
+  ResultList ResultsFromSongs(const SongMap &songs, PendingState *state) const;
   QString PixmapCacheKey(const Result &result) const;
   bool FindCachedPixmap(const Result &result, QPixmap *pixmap) const;
   int LoadAlbumCoverAsync(const Result &result);
+  bool IsVisible(const QModelIndex &source_index) const;
+  void LoadAlbumCovers();
+  void CancelAlbumCovers();
 
  Q_SIGNALS:
   void AddToPlaylist(QMimeData*);
@@ -147,6 +155,7 @@ class StreamingSearchView : public QWidget {
   void SwapModels();
   void TextEdited(const QString &text);
   void StartSearch(const QString &query);
+  void SearchPartialResults(const int service_id, const SongMap &songs);
   void SearchDone(const int service_id, const SongMap &songs, const QString &error);
 
   void UpdateStatus(const int service_id, const QString &text);
@@ -210,7 +219,13 @@ class StreamingSearchView : public QWidget {
   QMap<int, DelayedSearch> delayed_searches_;
   QMap<int, PendingState> pending_searches_;
 
-  QMap<quint64, QPair<QModelIndex, QString>> cover_loader_tasks_;
+  // Time since the search text was edited, to log the time until the first results are shown.
+  QElapsedTimer search_timer_;
+  bool search_results_received_;
+
+  // Album covers waiting to be loaded, the ones visible in the viewport are loaded first.
+  QList<QPersistentModelIndex> cover_loader_queue_;
+  QMap<quint64, QPair<QPersistentModelIndex, QString>> cover_loader_tasks_;
 };
 Q_DECLARE_METATYPE(StreamingSearchView::Result)
 Q_DECLARE_METATYPE(StreamingSearchView::ResultList)
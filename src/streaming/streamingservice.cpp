@@ -21,6 +21,7 @@
 #include <QString>
 
 #include "streamingservice.h"
+#include "streamingrequestscheduler.h"
 #include "core/song.h"
 
 StreamingService::StreamingService(const Song::Source source, const QString &name, const QString &url_scheme, const QString &settings_group, QObject *parent)
@@ -28,4 +29,5 @@ StreamingService::StreamingService(const Song::Source source, const QString &nam
       source_(source),
       name_(name),
       url_scheme_(url_scheme),
-      settings_group_(settings_group) {}
+      settings_group_(settings_group),
+      request_scheduler_(new StreamingRequestScheduler(this)) {}
@@ -35,6 +35,7 @@
 class CollectionBackend;
 class CollectionModel;
 class CollectionFilter;
+class StreamingRequestScheduler;
 
 class StreamingService : public QObject {
   Q_OBJECT
@@ -70,6 +71,8 @@ class StreamingService : public QObject {
   virtual CollectionFilter *albums_collection_filter_model() { return nullptr; }
   virtual CollectionFilter *songs_collection_filter_model() { return nullptr; }
 
+  StreamingRequestScheduler *request_scheduler() const { return request_scheduler_; }
+
  public Q_SLOTS:
   virtual void Configure() {}
   virtual void GetArtists() {}
@@ -98,22 +101,27 @@ class StreamingService : public QObject {
   void ProgressSetMaximum(const int max);
   void UpdateProgress(const int max);
 
+  // The *SyncFinished signals are emitted instead of the *Results signals when the service has written the songs to its collection itself.
   void ArtistsResults(const SongMap &songs, const QString &error);
   void ArtistsUpdateStatus(const QString &text);
   void ArtistsProgressSetMaximum(const int max);
   void ArtistsUpdateProgress(const int max);
+  void ArtistsSyncFinished(const QString &error);
 
   void AlbumsResults(const SongMap &songs, const QString &error);
   void AlbumsUpdateStatus(const QString &text);
   void AlbumsProgressSetMaximum(const int max);
   void AlbumsUpdateProgress(const int max);
+  void AlbumsSyncFinished(const QString &error);
 
   void SongsResults(const SongMap &songs, const QString &error);
   void SongsUpdateStatus(const QString &text);
   void SongsProgressSetMaximum(const int max);
   void SongsUpdateProgress(const int max);
+  void SongsSyncFinished(const QString &error);
 
   void SearchResults(const int id, const SongMap &songs, const QString &error);
+  void SearchPartialResults(const int id, const SongMap &songs);
   void SearchUpdateStatus(const int id, const QString &text);
   void SearchProgressSetMaximum(const int id, const int max);
   void SearchUpdateProgress(const int id, const int max);
@@ -137,6 +145,7 @@ class StreamingService : public QObject {
   QString name_;
   QString url_scheme_;
   QString settings_group_;
+  StreamingRequestScheduler *request_scheduler_;
 };
 
 using StreamingServicePtr = SharedPtr<StreamingService>;
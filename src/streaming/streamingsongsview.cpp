@@ -67,6 +67,7 @@ StreamingSongsView::StreamingSongsView(const StreamingServicePtr service, const
   QObject::connect(ui_->close, &QPushButton::clicked, this, &StreamingSongsView::AbortGetSongs);
   QObject::connect(ui_->abort, &QPushButton::clicked, this, &StreamingSongsView::AbortGetSongs);
   QObject::connect(&*service_, &StreamingService::SongsResults, this, &StreamingSongsView::SongsFinished);
+  QObject::connect(&*service_, &StreamingService::SongsSyncFinished, this, &StreamingSongsView::SongsSyncFinished);
   QObject::connect(&*service_, &StreamingService::SongsUpdateStatus, ui_->status, &QLabel::setText);
   QObject::connect(&*service_, &StreamingService::SongsProgressSetMaximum, ui_->progressbar, &QProgressBar::setMaximum);
   QObject::connect(&*service_, &StreamingService::SongsUpdateProgress, ui_->progressbar, &QProgressBar::setValue);
@@ -135,3 +136,19 @@ void StreamingSongsView::SongsFinished(const SongMap &songs, const QString &erro
   }
 
 }
+
+void StreamingSongsView::SongsSyncFinished(const QString &error) {
+
+  if (error.isEmpty()) {
+    ui_->stacked->setCurrentWidget(ui_->streamingcollection_page);
+    ui_->status->clear();
+  }
+  else {
+    ui_->status->setText(error);
+    ui_->progressbar->setValue(0);
+    ui_->progressbar->hide();
+    ui_->abort->hide();
+    ui_->close->show();
+  }
+
+}
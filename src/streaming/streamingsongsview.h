@@ -56,6 +56,7 @@ class StreamingSongsView : public QWidget {
   void GetSongs();
   void AbortGetSongs();
   void SongsFinished(const SongMap &songs, const QString &error);
+  void SongsSyncFinished(const QString &error);
 
  Q_SIGNALS:
   void OpenSettingsDialog(const Song::Source source);
@@ -80,6 +80,7 @@ StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const Sh
     QObject::connect(ui_->artists_collection->button_close(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetArtists);
     QObject::connect(ui_->artists_collection->button_abort(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetArtists);
     QObject::connect(&*service_, &StreamingService::ArtistsResults, this, &StreamingTabsView::ArtistsFinished);
+    QObject::connect(&*service_, &StreamingService::ArtistsSyncFinished, this, &StreamingTabsView::ArtistsSyncFinished);
     QObject::connect(&*service_, &StreamingService::ArtistsUpdateStatus, ui_->artists_collection->status(), &QLabel::setText);
     QObject::connect(&*service_, &StreamingService::ArtistsProgressSetMaximum, ui_->artists_collection->progressbar(), &QProgressBar::setMaximum);
     QObject::connect(&*service_, &StreamingService::ArtistsUpdateProgress, ui_->artists_collection->progressbar(), &QProgressBar::setValue);
@@ -112,6 +113,7 @@ StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const Sh
     QObject::connect(ui_->albums_collection->button_close(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetAlbums);
     QObject::connect(ui_->albums_collection->button_abort(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetAlbums);
     QObject::connect(&*service_, &StreamingService::AlbumsResults, this, &StreamingTabsView::AlbumsFinished);
+    QObject::connect(&*service_, &StreamingService::AlbumsSyncFinished, this, &StreamingTabsView::AlbumsSyncFinished);
     QObject::connect(&*service_, &StreamingService::AlbumsUpdateStatus, ui_->albums_collection->status(), &QLabel::setText);
     QObject::connect(&*service_, &StreamingService::AlbumsProgressSetMaximum, ui_->albums_collection->progressbar(), &QProgressBar::setMaximum);
     QObject::connect(&*service_, &StreamingService::AlbumsUpdateProgress, ui_->albums_collection->progressbar(), &QProgressBar::setValue);
@@ -144,6 +146,7 @@ StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const Sh
     QObject::connect(ui_->songs_collection->button_close(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetSongs);
     QObject::connect(ui_->songs_collection->button_abort(), &QPushButton::clicked, this, &StreamingTabsView::AbortGetSongs);
     QObject::connect(&*service_, &StreamingService::SongsResults, this, &StreamingTabsView::SongsFinished);
+    QObject::connect(&*service_, &StreamingService::SongsSyncFinished, this, &StreamingTabsView::SongsSyncFinished);
     QObject::connect(&*service_, &StreamingService::SongsUpdateStatus, ui_->songs_collection->status(), &QLabel::setText);
     QObject::connect(&*service_, &StreamingService::SongsProgressSetMaximum, ui_->songs_collection->progressbar(), &QProgressBar::setMaximum);
     QObject::connect(&*service_, &StreamingService::SongsUpdateProgress, ui_->songs_collection->progressbar(), &QProgressBar::setValue);
@@ -274,6 +277,22 @@ void StreamingTabsView::ArtistsFinished(const SongMap &songs, const QString &err
 
 }
 
+void StreamingTabsView::ArtistsSyncFinished(const QString &error) {
+
+  if (error.isEmpty()) {
+    ui_->artists_collection->stacked()->setCurrentWidget(ui_->artists_collection->streamingcollection_page());
+    ui_->artists_collection->status()->clear();
+  }
+  else {
+    ui_->artists_collection->status()->setText(error);
+    ui_->artists_collection->progressbar()->setValue(0);
+    ui_->artists_collection->progressbar()->hide();
+    ui_->artists_collection->button_abort()->hide();
+    ui_->artists_collection->button_close()->show();
+  }
+
+}
+
 void StreamingTabsView::GetAlbums() {
 
   if (!service_->authenticated() && service_->oauth()) {
@@ -316,6 +335,22 @@ void StreamingTabsView::AlbumsFinished(const SongMap &songs, const QString &erro
 
 }
 
+void StreamingTabsView::AlbumsSyncFinished(const QString &error) {
+
+  if (error.isEmpty()) {
+    ui_->albums_collection->stacked()->setCurrentWidget(ui_->albums_collection->streamingcollection_page());
+    ui_->albums_collection->status()->clear();
+  }
+  else {
+    ui_->albums_collection->status()->setText(error);
+    ui_->albums_collection->progressbar()->setValue(0);
+    ui_->albums_collection->progressbar()->hide();
+    ui_->albums_collection->button_abort()->hide();
+    ui_->albums_collection->button_close()->show();
+  }
+
+}
+
 void StreamingTabsView::GetSongs() {
 
   if (!service_->authenticated() && service_->oauth()) {
@@ -358,6 +393,22 @@ void StreamingTabsView::SongsFinished(const SongMap &songs, const QString &error
 
 }
 
+void StreamingTabsView::SongsSyncFinished(const QString &error) {
+
+  if (error.isEmpty()) {
+    ui_->songs_collection->stacked()->setCurrentWidget(ui_->songs_collection->streamingcollection_page());
+    ui_->songs_collection->status()->clear();
+  }
+  else {
+    ui_->songs_collection->status()->setText(error);
+    ui_->songs_collection->progressbar()->setValue(0);
+    ui_->songs_collection->progressbar()->hide();
+    ui_->songs_collection->button_abort()->hide();
+    ui_->songs_collection->button_close()->show();
+  }
+
+}
+
 void StreamingTabsView::Configure() {
   Q_EMIT OpenSettingsDialog(service_->source());
 }
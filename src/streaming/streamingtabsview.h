@@ -66,8 +66,11 @@ class StreamingTabsView : public QWidget {
   void AbortGetAlbums();
   void AbortGetSongs();
   void ArtistsFinished(const SongMap &songs, const QString &error);
+  void ArtistsSyncFinished(const QString &error);
   void AlbumsFinished(const SongMap &songs, const QString &error);
+  void AlbumsSyncFinished(const QString &error);
   void SongsFinished(const SongMap &songs, const QString &error);
+  void SongsSyncFinished(const QString &error);
 
  Q_SIGNALS:
   void OpenSettingsDialog(const Song::Source source);
@@ -21,10 +21,12 @@
 
 #include <QObject>
 #include <QDir>
+#include <QFileInfo>
 #include <QMimeDatabase>
 #include <QByteArray>
 #include <QByteArrayList>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QDateTime>
@@ -44,6 +46,7 @@
 #include "core/networktimeouts.h"
 #include "utilities/imageutils.h"
 #include "constants/timeconstants.h"
+#include "streaming/streamingrequestscheduler.h"
 #include "subsonicservice.h"
 #include "subsonicurlhandler.h"
 #include "subsonicbaserequest.h"
@@ -52,9 +55,12 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
-constexpr int kMaxConcurrentAlbumCoverRequests = 1;
+constexpr int kConcurrentAlbumsRequests = 3;
+constexpr int kConcurrentAlbumSongsRequests = 3;
+constexpr int kConcurrentAlbumCoverRequests = 1;
+constexpr int kMaxConcurrentRequests = 8;
+constexpr int kMaxConcurrentAlbumCoverRequests = 4;
+constexpr int kSyncBatchSize = 500;
 }  // namespace
 
 SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *url_handler, QObject *parent)
@@ -63,7 +69,10 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
       url_handler_(url_handler),
       network_(new QNetworkAccessManager(this)),
       timeouts_(new NetworkTimeouts(30000, this)),
+      scheduler_(service->request_scheduler()),
       finished_(false),
+      incremental_(false),
+      last_modified_(0),
       albums_requests_active_(0),
       album_songs_requests_active_(0),
       album_songs_requested_(0),
@@ -75,6 +84,10 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
 
   network_->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
 
+  scheduler_->AddEndpoint(u"albums"_s, kConcurrentAlbumsRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumsongs"_s, kConcurrentAlbumSongsRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumcovers"_s, kConcurrentAlbumCoverRequests, kMaxConcurrentAlbumCoverRequests);
+
 }
 
 SubsonicRequest::~SubsonicRequest() {
@@ -86,22 +99,18 @@ SubsonicRequest::~SubsonicRequest() {
     reply->deleteLater();
   }
 
-  while (!album_cover_replies_.isEmpty()) {
-    QNetworkReply *reply = album_cover_replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
+  scheduler_->Abort(this);
 
 }
 
 void SubsonicRequest::Reset() {
 
   finished_ = false;
+  incremental_ = false;
+  last_modified_ = 0;
+
+  scheduler_->Abort(this);
 
-  albums_requests_queue_.clear();
-  album_songs_requests_queue_.clear();
-  album_cover_requests_queue_.clear();
   album_songs_requests_pending_.clear();
   album_covers_requests_sent_.clear();
 
@@ -114,11 +123,14 @@ void SubsonicRequest::Reset() {
   album_covers_received_ = 0;
 
   songs_.clear();
+  album_mtimes_.clear();
+  albums_seen_.clear();
+  sync_album_ids_.clear();
+  sync_songs_.clear();
   cover_urls_.clear();
   errors_.clear();
   no_results_ = false;
   replies_.clear();
-  album_cover_replies_.clear();
 
 }
 
@@ -126,6 +138,67 @@ void SubsonicRequest::GetAlbums() {
 
   Q_EMIT UpdateStatus(tr("Retrieving albums..."));
   Q_EMIT UpdateProgress(0);
+
+  // Only the modification time of the collection is needed for the next sync, not the whole index.
+  GetIndexes(QDateTime::currentMSecsSinceEpoch());
+
+}
+
+void SubsonicRequest::GetAlbumsIncremental(const qint64 last_modified, const QMap<QString, qint64> &album_mtimes) {
+
+  incremental_ = true;
+  album_mtimes_ = album_mtimes;
+
+  Q_EMIT UpdateStatus(tr("Checking for changes..."));
+  Q_EMIT UpdateProgress(0);
+
+  GetIndexes(last_modified);
+
+}
+
+void SubsonicRequest::GetIndexes(const qint64 if_modified_since) {
+
+  ParamList params;
+  if (if_modified_since > 0) params << Param(u"ifModifiedSince"_s, QString::number(if_modified_since));
+
+  QNetworkReply *reply = CreateGetRequest(u"getIndexes"_s, params);
+  replies_ << reply;
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, if_modified_since]() { IndexesReplyReceived(reply, if_modified_since); });
+  timeouts_->AddReply(reply);
+
+}
+
+void SubsonicRequest::IndexesReplyReceived(QNetworkReply *reply, const qint64 if_modified_since) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  QByteArray data = GetReplyData(reply);
+
+  if (finished_) return;
+
+  if (!data.isEmpty()) {
+    const QJsonObject json_obj = ExtractJsonObj(data);
+    if (json_obj.contains("indexes"_L1) && json_obj["indexes"_L1].isObject()) {
+      const QJsonObject obj_indexes = json_obj["indexes"_L1].toObject();
+      if (obj_indexes["lastModified"_L1].type() == QJsonValue::String) {
+        last_modified_ = obj_indexes["lastModified"_L1].toString().toLongLong();
+      }
+      else {
+        last_modified_ = obj_indexes["lastModified"_L1].toInteger();
+      }
+    }
+  }
+
+  if (incremental_ && if_modified_since > 0 && last_modified_ > 0 && last_modified_ <= if_modified_since) {
+    qLog(Debug) << "Subsonic: Collection is not modified since" << if_modified_since;
+    finished_ = true;
+    Q_EMIT SyncFinished(QString());
+    return;
+  }
+
   AddAlbumsRequest();
 
 }
@@ -135,35 +208,27 @@ void SubsonicRequest::AddAlbumsRequest(const int offset, const int size) {
   Request request;
   request.size = size;
   request.offset = offset;
-  albums_requests_queue_.enqueue(request);
-  if (albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  ++albums_requests_active_;
 
-}
-
-void SubsonicRequest::FlushAlbumsRequests() {
+  scheduler_->Queue(u"albums"_s, this, [this, request]() { return SendAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumsReplyReceived(reply, request.offset, request.size); });
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+}
 
-    Request request = albums_requests_queue_.dequeue();
-    ++albums_requests_active_;
+QNetworkReply *SubsonicRequest::SendAlbumsRequest(const Request &request) {
 
-    ParamList params = ParamList() << Param(u"type"_s, u"alphabeticalByName"_s);
-    if (request.size > 0) params << Param(u"size"_s, QString::number(request.size));
-    if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
+  ParamList params = ParamList() << Param(u"type"_s, u"alphabeticalByName"_s);
+  if (request.size > 0) params << Param(u"size"_s, QString::number(request.size));
+  if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
-    QNetworkReply *reply = CreateGetRequest(u"getAlbumList2"_s, params);
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.offset, request.size); });
-    timeouts_->AddReply(reply);
+  QNetworkReply *reply = CreateGetRequest(u"getAlbumList2"_s, params);
+  timeouts_->AddReply(reply);
 
-  }
+  return reply;
 
 }
 
 void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -278,6 +343,12 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
     if (obj_album.contains("album"_L1)) album = obj_album["album"_L1].toString();
     else if (obj_album.contains("name"_L1)) album = obj_album["name"_L1].toString();
 
+    if (incremental_) {
+      albums_seen_.insert(album_id);
+      const qint64 album_mtime = AlbumModificationTime(obj_album);
+      if (album_mtime > 0 && album_mtimes_.contains(album_id) && album_mtimes_.value(album_id) == album_mtime) continue;
+    }
+
     if (album_songs_requests_pending_.contains(album_id)) continue;
 
     Request request;
@@ -302,9 +373,22 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
     }
   }
 
-  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
 
-  if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
+    if (incremental_) {
+      // Remove the albums that are no longer on the server, unless the album list could be incomplete.
+      QStringList removed_album_ids;
+      if (errors_.isEmpty()) {
+        for (QMap<QString, qint64>::const_iterator it = album_mtimes_.constBegin(); it != album_mtimes_.constEnd(); ++it) {
+          if (!albums_seen_.contains(it.key())) removed_album_ids << it.key();
+        }
+      }
+      album_mtimes_.clear();
+      albums_seen_.clear();
+      if (!removed_album_ids.isEmpty()) {
+        Q_EMIT SongsSynced(removed_album_ids, SongMap());
+      }
+    }
 
     for (QHash<QString, Request>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       const Request request = it.value();
@@ -331,31 +415,24 @@ void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QStri
   request.album_id = album_id;
   request.album_artist = album_artist;
   request.offset = offset;
-  album_songs_requests_queue_.enqueue(request);
   ++album_songs_requested_;
-  if (album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  ++album_songs_requests_active_;
 
-}
+  scheduler_->Queue(u"albumsongs"_s, this, [this, request]() { return SendAlbumSongsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist); });
 
-void SubsonicRequest::FlushAlbumSongsRequests() {
+}
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+QNetworkReply *SubsonicRequest::SendAlbumSongsRequest(const Request &request) {
 
-    Request request = album_songs_requests_queue_.dequeue();
-    ++album_songs_requests_active_;
-    QNetworkReply *reply = CreateGetRequest(u"getAlbum"_s, ParamList() << Param(u"id"_s, request.album_id));
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist); });
-    timeouts_->AddReply(reply);
+  QNetworkReply *reply = CreateGetRequest(u"getAlbum"_s, ParamList() << Param(u"id"_s, request.album_id));
+  timeouts_->AddReply(reply);
 
-  }
+  return reply;
 
 }
 
 void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -431,6 +508,7 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
   if (obj_album.contains("created"_L1)) {
     created = QDateTime::fromString(obj_album["created"_L1].toString(), Qt::ISODate).toSecsSinceEpoch();
   }
+  const qint64 album_mtime = AlbumModificationTime(obj_album);
 
   bool compilation = false;
   bool multidisc = false;
@@ -451,12 +529,22 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) {
       song.set_disc(0);
     }
-    songs_.insert(song.song_id(), song);
+    // Used to detect changed albums on the next incremental sync.
+    if (album_mtime > 0) song.set_mtime(album_mtime);
+  }
+
+  if (incremental_) {
+    AddSyncedAlbum(album_id, songs);
+  }
+  else {
+    for (const Song &song : std::as_const(songs)) {
+      songs_.insert(song.song_id(), song);
+    }
   }
 
   SongsFinishCheck();
@@ -467,13 +555,14 @@ void SubsonicRequest::SongsFinishCheck() {
 
   if (finished_) return;
 
-  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (incremental_ && album_songs_requests_active_ <= 0) {
+    FlushSyncedSongs();
+  }
 
   if (
       download_album_covers() &&
-      album_songs_requests_queue_.isEmpty() &&
       album_songs_requests_active_ <= 0 &&
-      album_cover_requests_queue_.isEmpty() &&
+      album_covers_requests_active_ <= 0 &&
       album_covers_received_ <= 0 &&
       album_covers_requests_sent_.isEmpty() &&
       album_songs_received_ >= album_songs_requested_
@@ -485,10 +574,67 @@ void SubsonicRequest::SongsFinishCheck() {
 
 }
 
+qint64 SubsonicRequest::AlbumModificationTime(const QJsonObject &json_obj) {
+
+  // Not all servers report when an album was changed, fall back to when it was added.
+  QString timestamp;
+  if (json_obj.contains("changed"_L1)) timestamp = json_obj["changed"_L1].toString();
+  if (timestamp.isEmpty() && json_obj.contains("created"_L1)) timestamp = json_obj["created"_L1].toString();
+  if (timestamp.isEmpty()) return 0;
+
+  const QDateTime datetime = QDateTime::fromString(timestamp, Qt::ISODate);
+  if (!datetime.isValid()) return 0;
+
+  return datetime.toSecsSinceEpoch();
+
+}
+
+void SubsonicRequest::AddSyncedAlbum(const QString &album_id, const SongList &songs) {
+
+  sync_album_ids_ << album_id;
+
+  for (Song song : songs) {
+    if (download_album_covers() && !song.art_automatic().isEmpty() && !SetCachedAlbumCover(song)) {
+      // Written with the remote cover URL for now, and again when the cover is downloaded.
+      songs_.insert(song.song_id(), song);
+    }
+    sync_songs_.insert(song.song_id(), song);
+  }
+
+  if (sync_songs_.count() >= kSyncBatchSize) {
+    FlushSyncedSongs();
+  }
+
+}
+
+void SubsonicRequest::FlushSyncedSongs() {
+
+  if (sync_album_ids_.isEmpty() && sync_songs_.isEmpty()) return;
+
+  Q_EMIT SongsSynced(sync_album_ids_, sync_songs_);
+
+  sync_album_ids_.clear();
+  sync_songs_.clear();
+
+}
+
+bool SubsonicRequest::SetCachedAlbumCover(Song &song) const {
+
+  const QUrlQuery cover_url_query(song.art_automatic());
+  if (!cover_url_query.hasQueryItem(u"id"_s)) return false;
+
+  const QString filename = Song::ImageCacheDir(Song::Source::Subsonic) + QLatin1Char('/') + cover_url_query.queryItemValue(u"id"_s) + ".jpg"_L1;
+  if (!QFileInfo::exists(filename)) return false;
+
+  song.set_art_automatic(QUrl::fromLocalFile(filename));
+
+  return true;
+
+}
+
 QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_obj, const QString &artist_id_requested, const QString &album_id_requested, const QString &album_artist, const qint64 album_created) {
 
   Q_UNUSED(artist_id_requested);
-  Q_UNUSED(album_id_requested);
 
   if (
       !json_obj.contains("id"_L1) ||
@@ -519,6 +665,7 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_obj, cons
       album_id = QString::number(json_obj["albumId"_L1].toInt());
     }
   }
+  if (album_id.isEmpty()) album_id = album_id_requested;
 
   QString artist_id;
   if (json_obj.contains("artistId"_L1)) {
@@ -685,7 +832,6 @@ void SubsonicRequest::GetAlbumCovers() {
   for (const Song &song : songs) {
     if (!song.art_automatic().isEmpty()) AddAlbumCoverRequest(song);
   }
-  FlushAlbumCoverRequests();
 
   if (album_covers_requested_ == 1) Q_EMIT UpdateStatus(tr("Retrieving album cover for %1 album...").arg(album_covers_requested_));
   else Q_EMIT UpdateStatus(tr("Retrieving album covers for %1 albums...").arg(album_covers_requested_));
@@ -728,48 +874,35 @@ void SubsonicRequest::AddAlbumCoverRequest(const Song &song) {
 
   album_covers_requests_sent_.insert(cover_id, song.song_id());
   ++album_covers_requested_;
+  ++album_covers_requests_active_;
 
-  album_cover_requests_queue_.enqueue(request);
+  scheduler_->Queue(u"albumcovers"_s, this, [this, request]() { return SendAlbumCoverRequest(request); }, [this, request](QNetworkReply *reply) { AlbumCoverReceived(reply, request); });
 
 }
 
-void SubsonicRequest::FlushAlbumCoverRequests() {
-
-  while (!album_cover_requests_queue_.isEmpty() && album_covers_requests_active_ < kMaxConcurrentAlbumCoverRequests) {
+QNetworkReply *SubsonicRequest::SendAlbumCoverRequest(const AlbumCoverRequest &request) {
 
-    AlbumCoverRequest request = album_cover_requests_queue_.dequeue();
-    ++album_covers_requests_active_;
+  QNetworkRequest req(request.url);
+  req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+  req.setAttribute(QNetworkRequest::Http2AllowedAttribute, http2());
 
-    QNetworkRequest req(request.url);
-    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    req.setAttribute(QNetworkRequest::Http2AllowedAttribute, http2());
-
-    if (!verify_certificate()) {
-      QSslConfiguration sslconfig = QSslConfiguration::defaultConfiguration();
-      sslconfig.setPeerVerifyMode(QSslSocket::VerifyNone);
-      req.setSslConfiguration(sslconfig);
-    }
+  if (!verify_certificate()) {
+    QSslConfiguration sslconfig = QSslConfiguration::defaultConfiguration();
+    sslconfig.setPeerVerifyMode(QSslSocket::VerifyNone);
+    req.setSslConfiguration(sslconfig);
+  }
 
-    QNetworkReply *reply = network_->get(req);
-    album_cover_replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumCoverReceived(reply, request); });
-    timeouts_->AddReply(reply);
+  QNetworkReply *reply = network_->get(req);
+  timeouts_->AddReply(reply);
 
-  }
+  return reply;
 
 }
 
 void SubsonicRequest::AlbumCoverReceived(QNetworkReply *reply, const AlbumCoverRequest &request) {
 
-  if (album_cover_replies_.contains(reply)) {
-    album_cover_replies_.removeAll(reply);
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    reply->deleteLater();
-  }
-  else {
-    AlbumCoverFinishCheck();
-    return;
-  }
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
 
   --album_covers_requests_active_;
   ++album_covers_received_;
@@ -848,10 +981,6 @@ void SubsonicRequest::AlbumCoverReceived(QNetworkReply *reply, const AlbumCoverR
 
 void SubsonicRequest::AlbumCoverFinishCheck() {
 
-  if (!album_cover_requests_queue_.isEmpty() && album_covers_requests_active_ < kMaxConcurrentAlbumCoverRequests) {
-    FlushAlbumCoverRequests();
-  }
-
   FinishCheck();
 
 }
@@ -860,9 +989,6 @@ void SubsonicRequest::FinishCheck() {
 
   if (
       !finished_ &&
-      albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
       albums_requests_active_ <= 0 &&
@@ -872,7 +998,14 @@ void SubsonicRequest::FinishCheck() {
       album_covers_received_ >= album_covers_requested_
   ) {
     finished_ = true;
-    if (no_results_ && songs_.isEmpty()) {
+    if (incremental_) {
+      FlushSyncedSongs();
+      if (!songs_.isEmpty()) {
+        Q_EMIT SongsSynced(QStringList(), songs_);
+      }
+      Q_EMIT SyncFinished(ErrorsToHTML(errors_));
+    }
+    else if (no_results_ && songs_.isEmpty()) {
       Q_EMIT Results(SongMap(), QString());
     }
     else {
@@ -30,7 +30,6 @@
 #include <QHash>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -45,6 +44,7 @@ class QNetworkReply;
 class SubsonicService;
 class SubsonicUrlHandler;
 class NetworkTimeouts;
+class StreamingRequestScheduler;
 
 class SubsonicRequest : public SubsonicBaseRequest {
   Q_OBJECT
@@ -56,8 +56,13 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void ReloadSettings();
 
   void GetAlbums();
+  // Only retrieves the songs of albums that were added or changed since the last sync, and writes them to the collection in batches.
+  // album_mtimes are the modification times of the albums in the collection, last_modified is the time of the last sync as reported by the server.
+  void GetAlbumsIncremental(const qint64 last_modified, const QMap<QString, qint64> &album_mtimes);
   void Reset();
 
+  qint64 last_modified() const { return last_modified_; }
+
  private:
   struct Request {
     explicit Request() : offset(0), size(0) {}
@@ -78,31 +83,40 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
  Q_SIGNALS:
   void Results(const SongMap &songs, const QString &error);
+  void SongsSynced(const QStringList &album_ids, const SongMap &songs);
+  void SyncFinished(const QString &error);
   void UpdateStatus(const QString &text);
   void ProgressSetMaximum(const int max);
   void UpdateProgress(const int progress);
 
  private Q_SLOTS:
+  void IndexesReplyReceived(QNetworkReply *reply, const qint64 if_modified_since);
   void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist);
   void AlbumCoverReceived(QNetworkReply *reply, const SubsonicRequest::AlbumCoverRequest &request);
 
  private:
+  void GetIndexes(const qint64 if_modified_since);
 
   void AddAlbumsRequest(const int offset = 0, const int size = 500);
-  void FlushAlbumsRequests();
+  QNetworkReply *SendAlbumsRequest(const Request &request);
 
   void AlbumsFinishCheck(const int offset = 0, const int size = 0, const int albums_received = 0);
   void SongsFinishCheck();
 
   void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset = 0);
-  void FlushAlbumSongsRequests();
+  QNetworkReply *SendAlbumSongsRequest(const Request &request);
+
+  static qint64 AlbumModificationTime(const QJsonObject &json_obj);
+  void AddSyncedAlbum(const QString &album_id, const SongList &songs);
+  void FlushSyncedSongs();
+  bool SetCachedAlbumCover(Song &song) const;
 
   QString ParseSong(Song &song, const QJsonObject &json_obj, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const qint64 album_created = 0);
 
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
-  void FlushAlbumCoverRequests();
+  QNetworkReply *SendAlbumCoverRequest(const AlbumCoverRequest &request);
   void AlbumCoverFinishCheck();
 
   void FinishCheck();
@@ -113,12 +127,11 @@ class SubsonicRequest : public SubsonicBaseRequest {
   SubsonicUrlHandler *url_handler_;
   QNetworkAccessManager *network_;
   NetworkTimeouts *timeouts_;
+  StreamingRequestScheduler *scheduler_;
 
   bool finished_;
-
-  QQueue<Request> albums_requests_queue_;
-  QQueue<Request> album_songs_requests_queue_;
-  QQueue<AlbumCoverRequest> album_cover_requests_queue_;
+  bool incremental_;
+  qint64 last_modified_;
 
   QHash<QString, Request> album_songs_requests_pending_;
   QMultiMap<QString, QString> album_covers_requests_sent_;
@@ -134,11 +147,16 @@ class SubsonicRequest : public SubsonicBaseRequest {
   int album_covers_received_;
 
   SongMap songs_;
+
+  // Incremental sync
+  QMap<QString, qint64> album_mtimes_;
+  QSet<QString> albums_seen_;
+  QStringList sync_album_ids_;
+  SongMap sync_songs_;
   QMap<QString, QUrl> cover_urls_;
   QStringList errors_;
   bool no_results_;
   QList<QNetworkReply*> replies_;
-  QList<QNetworkReply*> album_cover_replies_;
 };
 
 #endif  // SUBSONICREQUEST_H
@@ -26,7 +26,9 @@
 #include <QObject>
 #include <QByteArray>
 #include <QList>
+#include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QVariant>
 #include <QUrl>
 #include <QUrlQuery>
@@ -83,6 +85,8 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
       verify_certificate_(false),
       download_album_covers_(true),
       auth_method_(SubsonicSettings::AuthMethod::MD5),
+      last_modified_(0),
+      songs_request_incremental_(false),
       ping_redirects_(0) {
 
   url_handlers->Register(url_handler_);
@@ -92,6 +96,8 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
   collection_backend_->Init(database, task_manager, Song::Source::Subsonic, QLatin1String(kSongsTable));
   collection_model_ = new CollectionModel(collection_backend_, albumcover_loader, this);
 
+  QObject::connect(&*collection_backend_, &CollectionBackend::GotAlbumModificationTimes, this, &SubsonicService::AlbumModificationTimesReceived);
+
   SubsonicService::ReloadSettings();
 
 }
@@ -129,6 +135,8 @@ void SubsonicService::ReloadSettings() {
   verify_certificate_ = s.value(SubsonicSettings::kVerifyCertificate, false).toBool();
   download_album_covers_ = s.value(SubsonicSettings::kDownloadAlbumCovers, true).toBool();
   auth_method_ = static_cast<SubsonicSettings::AuthMethod>(s.value(SubsonicSettings::kAuthMethod, static_cast<int>(SubsonicSettings::AuthMethod::MD5)).toInt());
+  last_modified_ = s.value(SubsonicSettings::kLastModified, 0).toLongLong();
+  last_modified_server_ = s.value(SubsonicSettings::kLastModifiedServer).toString();
 
   s.endGroup();
 
@@ -400,6 +408,8 @@ void SubsonicService::ResetSongsRequest() {
     songs_request_.reset();
   }
 
+  songs_request_incremental_ = false;
+
 }
 
 void SubsonicService::GetSongs() {
@@ -420,25 +430,85 @@ void SubsonicService::GetSongs() {
   QObject::connect(&*songs_request_, &SubsonicRequest::UpdateStatus, this, &SubsonicService::SongsUpdateStatus);
   QObject::connect(&*songs_request_, &SubsonicRequest::ProgressSetMaximum, this, &SubsonicService::SongsProgressSetMaximum);
   QObject::connect(&*songs_request_, &SubsonicRequest::UpdateProgress, this, &SubsonicService::SongsUpdateProgress);
+  QObject::connect(&*songs_request_, &SubsonicRequest::SongsSynced, this, &SubsonicService::SongsSynced);
+  QObject::connect(&*songs_request_, &SubsonicRequest::SyncFinished, this, &SubsonicService::SongsSyncFinishedReceived);
+
+  // Only sync the changes if the collection was synced before, the albums in the collection are needed to find out what changed.
+  songs_request_incremental_ = true;
+  collection_backend_->GetAlbumModificationTimesAsync();
+
+}
 
-  songs_request_->GetAlbums();
+void SubsonicService::AlbumModificationTimesReceived(const QMap<QString, qint64> &album_mtimes) {
+
+  if (!songs_request_ || !songs_request_incremental_) return;
+
+  if (album_mtimes.isEmpty()) {
+    songs_request_incremental_ = false;
+    songs_request_->GetAlbums();
+  }
+  else {
+    songs_request_->GetAlbumsIncremental(last_modified_server_ == last_modified_server() ? last_modified_ : 0, album_mtimes);
+  }
 
 }
 
 void SubsonicService::DeleteSongs() {
 
   collection_backend_->DeleteAllAsync();
+  SaveLastModified(0);
 
 }
 
 void SubsonicService::SongsResultsReceived(const SongMap &songs, const QString &error) {
 
+  if (songs_request_ && !songs.isEmpty() && error.isEmpty()) {
+    SaveLastModified(songs_request_->last_modified());
+  }
+
   Q_EMIT SongsResults(songs, error);
 
   ResetSongsRequest();
 
 }
 
+void SubsonicService::SongsSynced(const QStringList &album_ids, const SongMap &songs) {
+
+  collection_backend_->UpdateSongsByAlbumIDAsync(album_ids, songs);
+
+}
+
+void SubsonicService::SongsSyncFinishedReceived(const QString &error) {
+
+  if (songs_request_ && error.isEmpty()) {
+    SaveLastModified(songs_request_->last_modified());
+  }
+
+  Q_EMIT SongsSyncFinished(error);
+
+  ResetSongsRequest();
+
+}
+
+QString SubsonicService::last_modified_server() const {
+
+  return server_url_.toString() + u'|' + username_;
+
+}
+
+void SubsonicService::SaveLastModified(const qint64 last_modified) {
+
+  last_modified_ = last_modified;
+  last_modified_server_ = last_modified > 0 ? last_modified_server() : QString();
+
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  s.setValue(SubsonicSettings::kLastModified, last_modified_);
+  s.setValue(SubsonicSettings::kLastModifiedServer, last_modified_server_);
+  s.endGroup();
+
+}
+
 void SubsonicService::PingError(const QString &error, const QVariant &debug) {
 
   if (!error.isEmpty()) errors_ << error;
@@ -104,9 +104,14 @@ class SubsonicService : public StreamingService {
   void HandlePingSSLErrors(const QList<QSslError> &ssl_errors);
   void HandlePingReply(QNetworkReply *reply, const QUrl &url, const QString &username, const QString &password, const SubsonicSettings::AuthMethod auth_method);
   void SongsResultsReceived(const SongMap &songs, const QString &error);
+  void AlbumModificationTimesReceived(const QMap<QString, qint64> &album_mtimes);
+  void SongsSynced(const QStringList &album_ids, const SongMap &songs);
+  void SongsSyncFinishedReceived(const QString &error);
 
  private:
   void PingError(const QString &error = QString(), const QVariant &debug = QVariant());
+  QString last_modified_server() const;
+  void SaveLastModified(const qint64 last_modified);
 
   ScopedPtr<QNetworkAccessManager> network_;
   SubsonicUrlHandler *url_handler_;
@@ -124,6 +129,10 @@ class SubsonicService : public StreamingService {
   bool verify_certificate_;
   bool download_album_covers_;
   SubsonicSettings::AuthMethod auth_method_;
+  qint64 last_modified_;
+  QString last_modified_server_;
+
+  bool songs_request_incremental_;
 
   QStringList errors_;
   int ping_redirects_;
@@ -0,0 +1,158 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QHash>
+#include <QCache>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#include "core/song.h"
+#include "embeddedcovercache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+const qint64 EmbeddedCoverCache::kDefaultMaxSizeKB = 65536;
+
+EmbeddedCoverCache::EmbeddedCoverCache(const qint64 max_size_kb) {
+
+  data_.setMaxCost(max_size_kb);
+
+}
+
+QString EmbeddedCoverCache::AlbumKey(const Song &song) {
+
+  if (song.effective_album().isEmpty() || !song.url().isLocalFile()) return QString();
+
+  // Include the directory, so that different albums with the same name never share a cover.
+  return song.AlbumKey() + u'|' + QFileInfo(song.url().toLocalFile()).path();
+
+}
+
+QDateTime EmbeddedCoverCache::FileModificationTime(const QString &filename) {
+
+  const QFileInfo fileinfo(filename);
+  if (!fileinfo.exists()) return QDateTime();
+
+  return fileinfo.lastModified();
+
+}
+
+bool EmbeddedCoverCache::DataForEntry(const Entry &entry, QByteArray &data) const {
+
+  const QByteArray *cached_data = data_.object(entry.data_hash);
+  if (!cached_data) return false;
+
+  data = *cached_data;
+
+  return true;
+
+}
+
+bool EmbeddedCoverCache::Lookup(const QString &filename, QByteArray &data) {
+
+  const QDateTime mtime = FileModificationTime(filename);
+  if (!mtime.isValid()) return false;
+
+  QMutexLocker l(&mutex_);
+
+  if (!files_.contains(filename)) return false;
+
+  const Entry entry = files_.value(filename);
+  if (entry.mtime == mtime && DataForEntry(entry, data)) {
+    return true;
+  }
+
+  files_.remove(filename);
+
+  return false;
+
+}
+
+void EmbeddedCoverCache::Insert(const QString &filename, const QString &album_key, QByteArray &data) {
+
+  if (data.isEmpty()) return;
+
+  const QDateTime mtime = FileModificationTime(filename);
+  if (!mtime.isValid()) return;
+
+  Entry entry;
+  entry.filename = filename;
+  entry.mtime = mtime;
+  entry.album_key = album_key;
+  entry.data_hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+  QMutexLocker l(&mutex_);
+
+  // Tracks of the same album with the same picture share the data of the album entry.
+  bool shared = false;
+  if (!album_key.isEmpty() && albums_.contains(album_key)) {
+    const Entry album_entry = albums_.value(album_key);
+    shared = album_entry.data_hash == entry.data_hash && album_entry.mtime == FileModificationTime(album_entry.filename) && DataForEntry(album_entry, data);
+  }
+
+  if (!shared) {
+    if (!data_.contains(entry.data_hash)) {
+      data_.insert(entry.data_hash, new QByteArray(data), qMax(1LL, static_cast<qint64>(data.size()) / 1024LL));
+    }
+    if (!album_key.isEmpty()) {
+      albums_.insert(album_key, entry);
+    }
+  }
+
+  files_.insert(filename, entry);
+
+}
+
+void EmbeddedCoverCache::Invalidate(const QString &filename) {
+
+  QMutexLocker l(&mutex_);
+
+  if (files_.contains(filename)) {
+    const Entry entry = files_.take(filename);
+    if (!entry.album_key.isEmpty()) {
+      albums_.remove(entry.album_key);
+    }
+  }
+
+  for (QHash<QString, Entry>::iterator it = albums_.begin(); it != albums_.end();) {
+    if (it.value().filename == filename) {
+      it = albums_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+}
+
+void EmbeddedCoverCache::Clear() {
+
+  QMutexLocker l(&mutex_);
+
+  files_.clear();
+  albums_.clear();
+  data_.clear();
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EMBEDDEDCOVERCACHE_H
+#define EMBEDDEDCOVERCACHE_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QHash>
+#include <QCache>
+#include <QByteArray>
+#include <QString>
+#include <QDateTime>
+
+class Song;
+
+// Caches cover data extracted from audio file tags, so that a file only has to be parsed once.
+// Picture data is stored by content hash, file and album entries only reference it and are validated against the modification time of the file the picture was extracted from.
+// Files are always read before their first lookup hits, the album entry only lets tracks with the same picture share one copy of the data.
+class EmbeddedCoverCache {
+ public:
+  explicit EmbeddedCoverCache(const qint64 max_size_kb = kDefaultMaxSizeKB);
+
+  static const qint64 kDefaultMaxSizeKB;
+
+  // Returns a key identifying the album of the song, or an empty string if the song has no album.
+  static QString AlbumKey(const Song &song);
+
+  bool Lookup(const QString &filename, QByteArray &data);
+  // Sets data to the cached copy if the album entry has the same picture.
+  void Insert(const QString &filename, const QString &album_key, QByteArray &data);
+  void Invalidate(const QString &filename);
+  void Clear();
+
+ private:
+  class Entry {
+   public:
+    QString filename;
+    QDateTime mtime;
+    QString album_key;
+    QByteArray data_hash;
+  };
+
+  static QDateTime FileModificationTime(const QString &filename);
+  bool DataForEntry(const Entry &entry, QByteArray &data) const;
+
+ private:
+  mutable QMutex mutex_;
+  QHash<QString, Entry> files_;
+  QHash<QString, Entry> albums_;
+  QCache<QByteArray, QByteArray> data_;
+};
+
+#endif  // EMBEDDEDCOVERCACHE_H
@@ -179,7 +179,7 @@ void TagReaderClient::ProcessRequest(TagReaderRequestPtr request) {
   }
   else if (TagReaderLoadCoverDataRequestPtr load_cover_data_request = dynamic_pointer_cast<TagReaderLoadCoverDataRequest>(request)) {
     QByteArray cover_data;
-    result = LoadCoverDataBlocking(load_cover_data_request->filename, cover_data);
+    result = LoadCoverDataBlocking(load_cover_data_request->filename, cover_data, load_cover_data_request->album_key);
     if (result.success()) {
       if (TagReaderLoadCoverDataReplyPtr load_cover_data_reply = qSharedPointerDynamicCast<TagReaderLoadCoverDataReply>(reply)) {
         load_cover_data_reply->set_data(cover_data);
@@ -188,7 +188,7 @@ void TagReaderClient::ProcessRequest(TagReaderRequestPtr request) {
   }
   else if (TagReaderLoadCoverImageRequestPtr load_cover_image_request = dynamic_pointer_cast<TagReaderLoadCoverImageRequest>(request)) {
     QImage cover_image;
-    result = LoadCoverImageBlocking(load_cover_image_request->filename, cover_image);
+    result = LoadCoverImageBlocking(load_cover_image_request->filename, cover_image, load_cover_image_request->album_key);
     if (result.success()) {
       if (TagReaderLoadCoverImageReplyPtr load_cover_image_reply = qSharedPointerDynamicCast<TagReaderLoadCoverImageReply>(reply)) {
         load_cover_image_reply->set_image(cover_image);
@@ -259,7 +259,13 @@ TagReaderReadFileReplyPtr TagReaderClient::ReadFileAsync(const QString &filename
 
 TagReaderResult TagReaderClient::WriteFileBlocking(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options, const SaveTagCoverData &save_tag_cover_data) {
 
-  return tagreader_.WriteFile(filename, song, save_tags_options, save_tag_cover_data);
+  const TagReaderResult result = tagreader_.WriteFile(filename, song, save_tags_options, save_tag_cover_data);
+
+  if (save_tags_options & SaveTagsOption::Cover) {
+    embedded_cover_cache_.Invalidate(filename);
+  }
+
+  return result;
 
 }
 
@@ -282,16 +288,25 @@ TagReaderReplyPtr TagReaderClient::WriteFileAsync(const QString &filename, const
 
 }
 
-TagReaderResult TagReaderClient::LoadCoverDataBlocking(const QString &filename, QByteArray &data) {
+TagReaderResult TagReaderClient::LoadCoverDataBlocking(const QString &filename, QByteArray &data, const QString &album_key) {
+
+  if (embedded_cover_cache_.Lookup(filename, data)) {
+    return TagReaderResult::ErrorCode::Success;
+  }
+
+  const TagReaderResult result = tagreader_.LoadEmbeddedCover(filename, data);
+  if (result.success()) {
+    embedded_cover_cache_.Insert(filename, album_key, data);
+  }
 
-  return tagreader_.LoadEmbeddedCover(filename, data);
+  return result;
 
 }
 
-TagReaderResult TagReaderClient::LoadCoverImageBlocking(const QString &filename, QImage &image) {
+TagReaderResult TagReaderClient::LoadCoverImageBlocking(const QString &filename, QImage &image, const QString &album_key) {
 
   QByteArray data;
-  TagReaderResult result = LoadCoverDataBlocking(filename, data);
+  TagReaderResult result = LoadCoverDataBlocking(filename, data, album_key);
   if (result.error_code == TagReaderResult::ErrorCode::Success && !image.loadFromData(data)) {
     result.error_code = TagReaderResult::ErrorCode::Unsupported;
     result.error_text = QObject::tr("Failed to load image from data for %1").arg(filename);
@@ -301,7 +316,7 @@ TagReaderResult TagReaderClient::LoadCoverImageBlocking(const QString &filename,
 
 }
 
-TagReaderLoadCoverDataReplyPtr TagReaderClient::LoadCoverDataAsync(const QString &filename) {
+TagReaderLoadCoverDataReplyPtr TagReaderClient::LoadCoverDataAsync(const QString &filename, const QString &album_key) {
 
   Q_ASSERT(QThread::currentThread() != thread());
 
@@ -310,6 +325,7 @@ TagReaderLoadCoverDataReplyPtr TagReaderClient::LoadCoverDataAsync(const QString
   TagReaderLoadCoverDataRequestPtr request = TagReaderLoadCoverDataRequest::Create(filename);
   request->reply = reply;
   request->filename = filename;
+  request->album_key = album_key;
 
   EnqueueRequest(request);
 
@@ -317,7 +333,7 @@ TagReaderLoadCoverDataReplyPtr TagReaderClient::LoadCoverDataAsync(const QString
 
 }
 
-TagReaderLoadCoverImageReplyPtr TagReaderClient::LoadCoverImageAsync(const QString &filename) {
+TagReaderLoadCoverImageReplyPtr TagReaderClient::LoadCoverImageAsync(const QString &filename, const QString &album_key) {
 
   Q_ASSERT(QThread::currentThread() != thread());
 
@@ -326,6 +342,7 @@ TagReaderLoadCoverImageReplyPtr TagReaderClient::LoadCoverImageAsync(const QStri
   TagReaderLoadCoverImageRequestPtr request = TagReaderLoadCoverImageRequest::Create(filename);
   request->reply = reply;
   request->filename = filename;
+  request->album_key = album_key;
 
   EnqueueRequest(request);
 
@@ -335,7 +352,11 @@ TagReaderLoadCoverImageReplyPtr TagReaderClient::LoadCoverImageAsync(const QStri
 
 TagReaderResult TagReaderClient::SaveCoverBlocking(const QString &filename, const SaveTagCoverData &save_tag_cover_data) {
 
-  return tagreader_.SaveEmbeddedCover(filename, save_tag_cover_data);
+  const TagReaderResult result = tagreader_.SaveEmbeddedCover(filename, save_tag_cover_data);
+
+  embedded_cover_cache_.Invalidate(filename);
+
+  return result;
 
 }
 
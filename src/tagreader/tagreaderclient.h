@@ -43,6 +43,7 @@
 #include "tagreaderloadcoverimagereply.h"
 #include "savetagsoptions.h"
 #include "savetagcoverdata.h"
+#include "embeddedcovercache.h"
 
 class QThread;
 class Song;
@@ -70,10 +71,11 @@ class TagReaderClient : public QObject {
   TagReaderResult WriteFileBlocking(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options = SaveTagsOption::Tags, const SaveTagCoverData &save_tag_cover_data = SaveTagCoverData());
   TagReaderReplyPtr WriteFileAsync(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options = SaveTagsOption::Tags, const SaveTagCoverData &save_tag_cover_data = SaveTagCoverData());
 
-  TagReaderResult LoadCoverDataBlocking(const QString &filename, QByteArray &data);
-  TagReaderResult LoadCoverImageBlocking(const QString &filename, QImage &image);
-  TagReaderLoadCoverDataReplyPtr LoadCoverDataAsync(const QString &filename);
-  TagReaderLoadCoverImageReplyPtr LoadCoverImageAsync(const QString &filename);
+  // The album key is optional, when set, tracks of the same album with the same cover share the cached data.
+  TagReaderResult LoadCoverDataBlocking(const QString &filename, QByteArray &data, const QString &album_key = QString());
+  TagReaderResult LoadCoverImageBlocking(const QString &filename, QImage &image, const QString &album_key = QString());
+  TagReaderLoadCoverDataReplyPtr LoadCoverDataAsync(const QString &filename, const QString &album_key = QString());
+  TagReaderLoadCoverImageReplyPtr LoadCoverImageAsync(const QString &filename, const QString &album_key = QString());
 
   TagReaderResult SaveCoverBlocking(const QString &filename, const SaveTagCoverData &save_tag_cover_data);
   TagReaderReplyPtr SaveCoverAsync(const QString &filename, const SaveTagCoverData &save_tag_cover_data);
@@ -110,6 +112,7 @@ class TagReaderClient : public QObject {
   mutable QMutex mutex_requests_;
   TagReaderTagLib tagreader_;
   TagReaderGME gmereader_;
+  EmbeddedCoverCache embedded_cover_cache_;
   mutex_protected<bool> abort_;
   mutex_protected<bool> processing_;
 };
@@ -31,6 +31,8 @@ class TagReaderLoadCoverDataRequest : public TagReaderRequest {
  public:
   explicit TagReaderLoadCoverDataRequest(const QString &_filename);
   static SharedPtr<TagReaderLoadCoverDataRequest> Create(const QString &filename) { return make_shared<TagReaderLoadCoverDataRequest>(filename); }
+
+  QString album_key;
 };
 
 using TagReaderLoadCoverDataRequestPtr = SharedPtr<TagReaderLoadCoverDataRequest>;
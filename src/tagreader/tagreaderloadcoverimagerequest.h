@@ -31,6 +31,8 @@ class TagReaderLoadCoverImageRequest : public TagReaderRequest {
  public:
   explicit TagReaderLoadCoverImageRequest(const QString &_filename);
   static SharedPtr<TagReaderLoadCoverImageRequest> Create(const QString &filename) { return make_shared<TagReaderLoadCoverImageRequest>(filename); }
+
+  QString album_key;
 };
 
 using TagReaderLoadCoverImageRequestPtr = SharedPtr<TagReaderLoadCoverImageRequest>;
@@ -27,6 +27,7 @@
 #include <QByteArrayList>
 #include <QString>
 #include <QUrl>
+#include <QFileInfo>
 #include <QImage>
 #include <QImageReader>
 #include <QNetworkRequest>
@@ -34,7 +35,6 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -43,6 +43,7 @@
 #include "constants/timeconstants.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
+#include "streaming/streamingrequestscheduler.h"
 #include "tidalservice.h"
 #include "tidalurlhandler.h"
 #include "tidalbaserequest.h"
@@ -52,13 +53,11 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr char kResourcesUrl[] = "https://resources.tidal.com";
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
-constexpr int kMaxConcurrentAlbumCoverRequests = 1;
-constexpr int kFlushRequestsDelay = 200;
+// Concurrency each endpoint starts with, the request scheduler adjusts it to how fast the server replies.
+constexpr int kConcurrentRequests = 3;
+constexpr int kConcurrentAlbumCoverRequests = 1;
+constexpr int kMaxConcurrentRequests = 8;
+constexpr int kMaxConcurrentAlbumCoverRequests = 4;
 }  // namespace
 
 TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
@@ -66,7 +65,7 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       service_(service),
       url_handler_(url_handler),
       network_(network),
-      timer_flush_requests_(new QTimer(this)),
+      scheduler_(service->request_scheduler()),
       query_type_(query_type),
       fetchalbums_(service->fetchalbums()),
       coversize_(service->coversize()),
@@ -102,27 +101,18 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       album_covers_requests_received_(0),
       need_login_(false) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &TidalRequest::FlushRequests);
+  scheduler_->AddEndpoint(u"artists"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"songs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"artistalbums"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumsongs"_s, kConcurrentRequests, kMaxConcurrentRequests);
+  scheduler_->AddEndpoint(u"albumcovers"_s, kConcurrentAlbumCoverRequests, kMaxConcurrentAlbumCoverRequests);
 
 }
 
 TidalRequest::~TidalRequest() {
 
-  while (!replies_.isEmpty()) {
-    QNetworkReply *reply = replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
-
-  while (!album_cover_replies_.isEmpty()) {
-    QNetworkReply *reply = album_cover_replies_.takeFirst();
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    if (reply->isRunning()) reply->abort();
-    reply->deleteLater();
-  }
+  scheduler_->Abort(this);
 
 }
 
@@ -175,50 +165,6 @@ void TidalRequest::Process() {
 
 }
 
-void TidalRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
-void TidalRequest::FlushRequests() {
-
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
-
-}
-
 void TidalRequest::Search(const int query_id, const QString &search_text) {
   query_id_ = query_id;
   search_text_ = search_text;
@@ -237,39 +183,25 @@ void TidalRequest::AddArtistsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  artists_requests_queue_.enqueue(request);
-
   ++artists_requests_total_;
+  ++artists_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artists"_s, this, [this, request]() { return SendArtistsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void TidalRequest::FlushArtistsRequests() {
-
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
-
-    Request request = artists_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (query_type_ == Type::SearchArtists) parameters << Param(u"query"_s, search_text_);
-    if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteArtists) {
-      reply = CreateRequest(QStringLiteral("users/%1/favorites/artists").arg(service_->user_id()), parameters);
-    }
-    if (query_type_ == Type::SearchArtists) {
-      reply = CreateRequest(u"search/artists"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
-
-    ++artists_requests_active_;
+QNetworkReply *TidalRequest::SendArtistsRequest(const Request &request) {
 
+  ParamList parameters;
+  if (query_type_ == Type::SearchArtists) parameters << Param(u"query"_s, search_text_);
+  if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
+  if (query_type_ == Type::SearchArtists) {
+    return CreateRequest(u"search/artists"_s, parameters);
   }
 
+  return CreateRequest(QStringLiteral("users/%1/favorites/artists").arg(service_->user_id()), parameters);
+
 }
 
 void TidalRequest::GetAlbums() {
@@ -285,39 +217,25 @@ void TidalRequest::AddAlbumsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  albums_requests_queue_.enqueue(request);
-
   ++albums_requests_total_;
+  ++albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albums"_s, this, [this, request]() { return SendAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void TidalRequest::FlushAlbumsRequests() {
-
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
-
-    Request request = albums_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (query_type_ == Type::SearchAlbums) parameters << Param(u"query"_s, search_text_);
-    if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteAlbums) {
-      reply = CreateRequest(QStringLiteral("users/%1/favorites/albums").arg(service_->user_id()), parameters);
-    }
-    if (query_type_ == Type::SearchAlbums) {
-      reply = CreateRequest(u"search/albums"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
-
-    ++albums_requests_active_;
+QNetworkReply *TidalRequest::SendAlbumsRequest(const Request &request) {
 
+  ParamList parameters;
+  if (query_type_ == Type::SearchAlbums) parameters << Param(u"query"_s, search_text_);
+  if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
+  if (query_type_ == Type::SearchAlbums) {
+    return CreateRequest(u"search/albums"_s, parameters);
   }
 
+  return CreateRequest(QStringLiteral("users/%1/favorites/albums").arg(service_->user_id()), parameters);
+
 }
 
 void TidalRequest::GetSongs() {
@@ -333,39 +251,25 @@ void TidalRequest::AddSongsRequest(const int offset, const int limit) {
   Request request;
   request.limit = limit;
   request.offset = offset;
-  songs_requests_queue_.enqueue(request);
-
   ++songs_requests_total_;
+  ++songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"songs"_s, this, [this, request]() { return SendSongsRequest(request); }, [this, request](QNetworkReply *reply) { SongsReplyReceived(reply, request.limit, request.offset); });
 
 }
 
-void TidalRequest::FlushSongsRequests() {
-
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
-
-    Request request = songs_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (query_type_ == Type::SearchSongs) parameters << Param(u"query"_s, search_text_);
-    if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = nullptr;
-    if (query_type_ == Type::FavouriteSongs) {
-      reply = CreateRequest(QStringLiteral("users/%1/favorites/tracks").arg(service_->user_id()), parameters);
-    }
-    if (query_type_ == Type::SearchSongs) {
-      reply = CreateRequest(u"search/tracks"_s, parameters);
-    }
-    if (!reply) continue;
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
-
-    ++songs_requests_active_;
+QNetworkReply *TidalRequest::SendSongsRequest(const Request &request) {
 
+  ParamList parameters;
+  if (query_type_ == Type::SearchSongs) parameters << Param(u"query"_s, search_text_);
+  if (request.limit > 0) parameters << Param(u"limit"_s, QString::number(request.limit));
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
+  if (query_type_ == Type::SearchSongs) {
+    return CreateRequest(u"search/tracks"_s, parameters);
   }
 
+  return CreateRequest(QStringLiteral("users/%1/favorites/tracks").arg(service_->user_id()), parameters);
+
 }
 
 void TidalRequest::ArtistsSearch() {
@@ -412,8 +316,6 @@ void TidalRequest::AddSongsSearchRequest(const int offset) {
 
 void TidalRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -539,7 +441,7 @@ void TidalRequest::ArtistsFinishCheck(const int limit, const int offset, const i
     }
   }
 
-  if (artists_requests_queue_.isEmpty() && artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
+  if (artists_requests_active_ <= 0) {  // Artist query is finished, get all albums for all artists.
 
     // Get artist albums
     const QList<ArtistAlbumsRequest> requests = artist_albums_requests_pending_.values();
@@ -573,29 +475,19 @@ void TidalRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
   ArtistAlbumsRequest request;
   request.artist = artist;
   request.offset = offset;
-  artist_albums_requests_queue_.enqueue(request);
-
   ++artist_albums_requests_total_;
+  ++artist_albums_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"artistalbums"_s, this, [this, request]() { return SendArtistAlbumsRequest(request); }, [this, request](QNetworkReply *reply) { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
 
 }
 
-void TidalRequest::FlushArtistAlbumsRequests() {
+QNetworkReply *TidalRequest::SendArtistAlbumsRequest(const ArtistAlbumsRequest &request) {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  ParamList parameters;
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
 
-    const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
-
-    ParamList parameters;
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
-    replies_ << reply;
-
-    ++artist_albums_requests_active_;
-
-  }
+  return CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
 
 }
 
@@ -610,8 +502,6 @@ void TidalRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artist
 
 void TidalRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_requested, const int limit_requested, const int offset_requested, const bool auto_login) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -802,11 +692,8 @@ void TidalRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
   }
 
   if (
-      artists_requests_queue_.isEmpty() &&
       artists_requests_active_ <= 0 &&
-      albums_requests_queue_.isEmpty() &&
       albums_requests_active_ <= 0 &&
-      artist_albums_requests_queue_.isEmpty() &&
       artist_albums_requests_active_ <= 0
       ) { // Artist albums query is finished, get all songs for all albums.
 
@@ -849,28 +736,19 @@ void TidalRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
   request.artist = artist;
   request.album = album;
   request.offset = offset;
-  album_songs_requests_queue_.enqueue(request);
-
   ++album_songs_requests_total_;
+  ++album_songs_requests_active_;
 
-  StartRequests();
+  scheduler_->Queue(u"albumsongs"_s, this, [this, request]() { return SendAlbumSongsRequest(request); }, [this, request](QNetworkReply *reply) { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
 
 }
 
-void TidalRequest::FlushAlbumSongsRequests() {
-
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+QNetworkReply *TidalRequest::SendAlbumSongsRequest(const AlbumSongsRequest &request) {
 
-    AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
-    ParamList parameters;
-    if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
-    QNetworkReply *reply = CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
-    replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
+  ParamList parameters;
+  if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
 
-    ++album_songs_requests_active_;
-
-  }
+  return CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
 
 }
 
@@ -887,8 +765,6 @@ void TidalRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist &a
 
 void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested, const bool auto_login) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
@@ -968,11 +844,11 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
   }
+  InsertSongs(songs);
 
   if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
@@ -1162,18 +1038,55 @@ void TidalRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Arti
 
 }
 
+void TidalRequest::InsertSongs(const SongList &songs) {
+
+  if (!IsQuery()) {
+    SongMap page_songs;
+    for (const Song &song : songs) {
+      if (!songs_.contains(song.song_id())) {
+        page_songs.insert(song.song_id(), song);
+      }
+      songs_.insert(song.song_id(), song);
+    }
+    // Search results are shown page by page, the complete result is still sent with Results() when the search is finished.
+    if (IsSearch() && !page_songs.isEmpty()) {
+      Q_EMIT PartialResults(query_id_, page_songs);
+    }
+    return;
+  }
+
+  // Favourites are written to the collection page by page, only songs that are still missing an album cover are kept until the covers are downloaded.
+  SongMap synced_songs;
+  for (Song song : songs) {
+    if (service_->download_album_covers() && song.art_automatic().isValid() && !SetCachedAlbumCover(song)) {
+      songs_.insert(song.song_id(), song);
+    }
+    synced_songs.insert(song.song_id(), song);
+  }
+
+  if (synced_songs.isEmpty()) return;
+
+  Q_EMIT SongsSynced(query_id_, synced_songs);
+
+}
+
+bool TidalRequest::SetCachedAlbumCover(Song &song) const {
+
+  const QString filename = CoverUtils::CoverFilePath(CoverOptions(), song.source(), song.effective_albumartist(), song.effective_album(), song.album_id(), QString(), song.art_automatic());
+  if (filename.isEmpty() || !QFileInfo::exists(filename)) return false;
+
+  song.set_art_automatic(QUrl::fromLocalFile(filename));
+
+  return true;
+
+}
+
 void TidalRequest::GetAlbumCoversCheck() {
 
   if (
       !finished_ &&
       service_->download_album_covers() &&
       IsQuery() &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1200,8 +1113,6 @@ void TidalRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
-
 }
 
 void TidalRequest::AddAlbumCoverRequest(const Song &song) {
@@ -1219,40 +1130,25 @@ void TidalRequest::AddAlbumCoverRequest(const Song &song) {
 
   album_covers_requests_sent_.insert(song.album_id(), song.song_id());
   ++album_covers_requests_total_;
+  ++album_covers_requests_active_;
 
-  album_cover_requests_queue_.enqueue(request);
+  scheduler_->Queue(u"albumcovers"_s, this, [this, request]() { return SendAlbumCoverRequest(request); }, [this, request](QNetworkReply *reply) { AlbumCoverReceived(reply, request.album_id, request.url, request.filename); });
 
 }
 
-void TidalRequest::FlushAlbumCoverRequests() {
-
-  while (!album_cover_requests_queue_.isEmpty() && album_covers_requests_active_ < kMaxConcurrentAlbumCoverRequests) {
+QNetworkReply *TidalRequest::SendAlbumCoverRequest(const AlbumCoverRequest &request) {
 
-    AlbumCoverRequest request = album_cover_requests_queue_.dequeue();
+  QNetworkRequest req(request.url);
+  req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
 
-    QNetworkRequest req(request.url);
-    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *reply = network_->get(req);
-    album_cover_replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumCoverReceived(reply, request.album_id, request.url, request.filename); });
-
-    ++album_covers_requests_active_;
-
-  }
+  return network_->get(req);
 
 }
 
 void TidalRequest::AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename) {
 
-  if (album_cover_replies_.contains(reply)) {
-    album_cover_replies_.removeAll(reply);
-    QObject::disconnect(reply, nullptr, this, nullptr);
-    reply->deleteLater();
-  }
-  else {
-    AlbumCoverFinishCheck();
-    return;
-  }
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
 
   --album_covers_requests_active_;
   ++album_covers_requests_received_;
@@ -1340,12 +1236,6 @@ void TidalRequest::FinishCheck() {
   if (
       !finished_ &&
       !need_login_ &&
-      artists_requests_queue_.isEmpty() &&
-      albums_requests_queue_.isEmpty() &&
-      songs_requests_queue_.isEmpty() &&
-      artist_albums_requests_queue_.isEmpty() &&
-      album_songs_requests_queue_.isEmpty() &&
-      album_cover_requests_queue_.isEmpty() &&
       artist_albums_requests_pending_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
@@ -1356,11 +1246,13 @@ void TidalRequest::FinishCheck() {
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0
   ) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
-    if (songs_.isEmpty()) {
+    if (IsQuery()) {
+      // Write the songs again with the downloaded album covers.
+      if (!songs_.isEmpty()) Q_EMIT SongsSynced(query_id_, songs_);
+      Q_EMIT Results(query_id_, SongMap(), ErrorsToHTML(errors_));
+    }
+    else if (songs_.isEmpty()) {
       if (errors_.isEmpty()) {
         if (IsSearch()) {
           Q_EMIT Results(query_id_, SongMap(), tr("No match."));
@@ -30,7 +30,6 @@
 #include <QHash>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -43,7 +42,7 @@
 #include "tidalbaserequest.h"
 
 class QNetworkReply;
-class QTimer;
+class StreamingRequestScheduler;
 class NetworkAccessManager;
 class TidalService;
 class TidalUrlHandler;
@@ -102,6 +101,8 @@ class TidalRequest : public TidalBaseRequest {
   void LoginSuccess();
   void LoginFailure(const QString &failure_reason);
   void Results(const int id, const SongMap &songs = SongMap(), const QString &error = QString());
+  void SongsSynced(const int id, const SongMap &songs);
+  void PartialResults(const int id, const SongMap &songs);
   void UpdateStatus(const int id, const QString &text);
   void UpdateProgress(const int id, const int max);
   void StreamURLFinished(const QUrl &media_url, const QUrl &url, const Song::FileType filetype, const QString &error = QString());
@@ -126,9 +127,6 @@ class TidalRequest : public TidalBaseRequest {
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (query_type_ == Type::SearchArtists || query_type_ == Type::SearchAlbums || query_type_ == Type::SearchSongs); }
 
-  void StartRequests();
-  void FlushRequests();
-
   void GetArtists();
   void GetAlbums();
   void GetSongs();
@@ -139,30 +137,32 @@ class TidalRequest : public TidalBaseRequest {
 
   void AddArtistsRequest(const int offset = 0, const int limit = 0);
   void AddArtistsSearchRequest(const int offset = 0);
-  void FlushArtistsRequests();
+  QNetworkReply *SendArtistsRequest(const Request &request);
   void AddAlbumsRequest(const int offset = 0, const int limit = 0);
   void AddAlbumsSearchRequest(const int offset = 0);
-  void FlushAlbumsRequests();
+  QNetworkReply *SendAlbumsRequest(const Request &request);
   void AddSongsRequest(const int offset = 0, const int limit = 0);
   void AddSongsSearchRequest(const int offset = 0);
-  void FlushSongsRequests();
+  QNetworkReply *SendSongsRequest(const Request &request);
 
   void ArtistsFinishCheck(const int limit = 0, const int offset = 0, const int artists_received = 0);
   void AlbumsFinishCheck(const Artist &artist, const int limit = 0, const int offset = 0, const int albums_total = 0, const int albums_received = 0);
   void SongsFinishCheck(const Artist &artist, const Album &album, const int limit = 0, const int offset = 0, const int songs_total = 0, const int songs_received = 0);
 
   void AddArtistAlbumsRequest(const Artist &artist, const int offset = 0);
-  void FlushArtistAlbumsRequests();
+  QNetworkReply *SendArtistAlbumsRequest(const ArtistAlbumsRequest &request);
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
-  void FlushAlbumSongsRequests();
+  QNetworkReply *SendAlbumSongsRequest(const AlbumSongsRequest &request);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+  void InsertSongs(const SongList &songs);
+  bool SetCachedAlbumCover(Song &song) const;
 
   void GetAlbumCoversCheck();
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
-  void FlushAlbumCoverRequests();
+  QNetworkReply *SendAlbumCoverRequest(const AlbumCoverRequest &request);
   void AlbumCoverFinishCheck();
 
   int GetProgress(const int count, const int total);
@@ -174,7 +174,7 @@ class TidalRequest : public TidalBaseRequest {
   TidalService *service_;
   TidalUrlHandler *url_handler_;
   SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_flush_requests_;
+  StreamingRequestScheduler *scheduler_;
 
   const Type query_type_;
   const bool fetchalbums_;
@@ -185,14 +185,6 @@ class TidalRequest : public TidalBaseRequest {
 
   bool finished_;
 
-  QQueue<Request> artists_requests_queue_;
-  QQueue<Request> albums_requests_queue_;
-  QQueue<Request> songs_requests_queue_;
-
-  QQueue<ArtistAlbumsRequest> artist_albums_requests_queue_;
-  QQueue<AlbumSongsRequest> album_songs_requests_queue_;
-  QQueue<AlbumCoverRequest> album_cover_requests_queue_;
-
   QHash<QString, ArtistAlbumsRequest> artist_albums_requests_pending_;
   QHash<QString, AlbumSongsRequest> album_songs_requests_pending_;
   QMultiMap<QString, QString> album_covers_requests_sent_;
@@ -234,8 +226,6 @@ class TidalRequest : public TidalBaseRequest {
   SongMap songs_;
   QStringList errors_;
   bool need_login_;
-  QList<QNetworkReply*> replies_;
-  QList<QNetworkReply*> album_cover_replies_;
 };
 
 #endif  // TIDALREQUEST_H
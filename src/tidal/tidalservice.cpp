@@ -747,10 +747,12 @@ void TidalService::GetArtists() {
   artists_request_.reset(new TidalRequest(this, url_handler_, network_, TidalBaseRequest::Type::FavouriteArtists, this), [](TidalRequest *request) { request->deleteLater(); });
   QObject::connect(&*artists_request_, &TidalRequest::RequestLogin, this, &TidalService::SendLogin);
   QObject::connect(&*artists_request_, &TidalRequest::Results, this, &TidalService::ArtistsResultsReceived);
+  QObject::connect(&*artists_request_, &TidalRequest::SongsSynced, this, &TidalService::ArtistsSyncedReceived);
   QObject::connect(&*artists_request_, &TidalRequest::UpdateStatus, this, &TidalService::ArtistsUpdateStatusReceived);
   QObject::connect(&*artists_request_, &TidalRequest::UpdateProgress, this, &TidalService::ArtistsUpdateProgressReceived);
   QObject::connect(this, &TidalService::LoginComplete, &*artists_request_, &TidalRequest::LoginComplete);
 
+  artists_collection_backend_->BeginSyncAsync();
   artists_request_->Process();
 
 }
@@ -758,11 +760,22 @@ void TidalService::GetArtists() {
 void TidalService::ArtistsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT ArtistsResults(songs, error);
+  Q_UNUSED(songs);
+
+  // The songs were already written page by page, remove the ones that are no longer favourites unless some pages could be missing.
+  artists_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT ArtistsSyncFinished(error);
   ResetArtistsRequest();
 
 }
 
+void TidalService::ArtistsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  artists_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void TidalService::ArtistsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT ArtistsUpdateStatus(text);
@@ -802,10 +815,12 @@ void TidalService::GetAlbums() {
   albums_request_.reset(new TidalRequest(this, url_handler_, network_, TidalBaseRequest::Type::FavouriteAlbums, this), [](TidalRequest *request) { request->deleteLater(); });
   QObject::connect(&*albums_request_, &TidalRequest::RequestLogin, this, &TidalService::SendLogin);
   QObject::connect(&*albums_request_, &TidalRequest::Results, this, &TidalService::AlbumsResultsReceived);
+  QObject::connect(&*albums_request_, &TidalRequest::SongsSynced, this, &TidalService::AlbumsSyncedReceived);
   QObject::connect(&*albums_request_, &TidalRequest::UpdateStatus, this, &TidalService::AlbumsUpdateStatusReceived);
   QObject::connect(&*albums_request_, &TidalRequest::UpdateProgress, this, &TidalService::AlbumsUpdateProgressReceived);
   QObject::connect(this, &TidalService::LoginComplete, &*albums_request_, &TidalRequest::LoginComplete);
 
+  albums_collection_backend_->BeginSyncAsync();
   albums_request_->Process();
 
 }
@@ -813,11 +828,21 @@ void TidalService::GetAlbums() {
 void TidalService::AlbumsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT AlbumsResults(songs, error);
+  Q_UNUSED(songs);
+
+  albums_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT AlbumsSyncFinished(error);
   ResetAlbumsRequest();
 
 }
 
+void TidalService::AlbumsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  albums_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void TidalService::AlbumsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT AlbumsUpdateStatus(text);
@@ -857,10 +882,12 @@ void TidalService::GetSongs() {
   songs_request_.reset(new TidalRequest(this, url_handler_, network_, TidalBaseRequest::Type::FavouriteSongs, this), [](TidalRequest *request) { request->deleteLater(); });
   QObject::connect(&*songs_request_, &TidalRequest::RequestLogin, this, &TidalService::SendLogin);
   QObject::connect(&*songs_request_, &TidalRequest::Results, this, &TidalService::SongsResultsReceived);
+  QObject::connect(&*songs_request_, &TidalRequest::SongsSynced, this, &TidalService::SongsSyncedReceived);
   QObject::connect(&*songs_request_, &TidalRequest::UpdateStatus, this, &TidalService::SongsUpdateStatusReceived);
   QObject::connect(&*songs_request_, &TidalRequest::UpdateProgress, this, &TidalService::SongsUpdateProgressReceived);
   QObject::connect(this, &TidalService::LoginComplete, &*songs_request_, &TidalRequest::LoginComplete);
 
+  songs_collection_backend_->BeginSyncAsync();
   songs_request_->Process();
 
 }
@@ -868,11 +895,21 @@ void TidalService::GetSongs() {
 void TidalService::SongsResultsReceived(const int id, const SongMap &songs, const QString &error) {
 
   Q_UNUSED(id);
-  Q_EMIT SongsResults(songs, error);
+  Q_UNUSED(songs);
+
+  songs_collection_backend_->EndSyncAsync(error.isEmpty());
+  Q_EMIT SongsSyncFinished(error);
   ResetSongsRequest();
 
 }
 
+void TidalService::SongsSyncedReceived(const int id, const SongMap &songs) {
+
+  Q_UNUSED(id);
+  songs_collection_backend_->UpsertSongsBySongIDAsync(songs);
+
+}
+
 void TidalService::SongsUpdateStatusReceived(const int id, const QString &text) {
   Q_UNUSED(id);
   Q_EMIT SongsUpdateStatus(text);
@@ -924,6 +961,16 @@ void TidalService::StartSearch() {
 }
 
 void TidalService::CancelSearch() {
+
+  timer_search_delay_->stop();
+
+  // Abort the replies of a superseded search right away instead of letting it finish in the background.
+  if (search_request_) {
+    QObject::disconnect(&*search_request_, nullptr, this, nullptr);
+    QObject::disconnect(this, nullptr, &*search_request_, nullptr);
+    search_request_.reset();
+  }
+
 }
 
 void TidalService::SendSearch() {
@@ -949,6 +996,7 @@ void TidalService::SendSearch() {
 
   QObject::connect(&*search_request_, &TidalRequest::RequestLogin, this, &TidalService::SendLogin);
   QObject::connect(&*search_request_, &TidalRequest::Results, this, &TidalService::SearchResultsReceived);
+  QObject::connect(&*search_request_, &TidalRequest::PartialResults, this, &TidalService::SearchPartialResults);
   QObject::connect(&*search_request_, &TidalRequest::UpdateStatus, this, &TidalService::SearchUpdateStatus);
   QObject::connect(&*search_request_, &TidalRequest::UpdateProgress, this, &TidalService::SearchUpdateProgress);
   QObject::connect(this, &TidalService::LoginComplete, &*search_request_, &TidalRequest::LoginComplete);
@@ -36,6 +36,8 @@
 #include <QByteArray>
 #include <QDir>
 #include <QFileInfo>
+#include <QStorageInfo>
+#include <QElapsedTimer>
 #include <QList>
 #include <QMap>
 #include <QVariant>
@@ -46,6 +48,7 @@
 #include "core/logging.h"
 #include "core/signalchecker.h"
 #include "core/settings.h"
+#include "utilities/fileutils.h"
 #include "transcoder.h"
 
 using std::make_shared;
@@ -53,6 +56,13 @@ using namespace Qt::Literals::StringLiterals;
 
 int Transcoder::JobFinishedEvent::sEventType = -1;
 
+namespace {
+
+// Encoders writing to the same removable device at once.
+constexpr int kMaxRemovableDeviceJobs = 2;
+
+}  // namespace
+
 TranscoderPreset::TranscoderPreset(const Song::FileType filetype, const QString &name, const QString &extension, const QString &codec_mimetype, const QString &muxer_mimetype)
     : filetype_(filetype),
       name_(name),
@@ -176,8 +186,8 @@ GstElement *Transcoder::CreateElementForMimeType(GstElementFactoryListType eleme
 
 }
 
-Transcoder::JobFinishedEvent::JobFinishedEvent(JobState *state, bool success)
-    : QEvent(static_cast<QEvent::Type>(sEventType)), state_(state), success_(success) {}
+Transcoder::JobFinishedEvent::JobFinishedEvent(JobState *state, const int run, bool success)
+    : QEvent(static_cast<QEvent::Type>(sEventType)), state_(state), run_(run), success_(success) {}
 
 void Transcoder::JobState::PostFinished(const bool success) {
 
@@ -185,13 +195,14 @@ void Transcoder::JobState::PostFinished(const bool success) {
     Q_EMIT parent_->LogLine(tr("Successfully written %1").arg(QDir::toNativeSeparators(job_.output)));
   }
 
-  QCoreApplication::postEvent(parent_, new Transcoder::JobFinishedEvent(this, success));
+  QCoreApplication::postEvent(parent_, new Transcoder::JobFinishedEvent(this, run_, success));
 
 }
 
 Transcoder::Transcoder(QObject *parent, const QString &settings_postfix)
     : QObject(parent),
       max_threads_(QThread::idealThreadCount()),
+      max_jobs_per_device_(0),
       settings_postfix_(settings_postfix) {
 
   if (JobFinishedEvent::sEventType == -1)
@@ -314,6 +325,19 @@ void Transcoder::AddJob(const QString &input, const TranscoderPreset &preset, co
   job.input = input;
   job.preset = preset;
   job.output = output;
+
+  const QString output_path = QFileInfo(output).absolutePath();
+  const QStorageInfo storage(output_path);
+  if (storage.isValid()) {
+    job.device = storage.device();
+    if (max_jobs_per_device_ > 0) {
+      job.max_device_jobs = max_jobs_per_device_;
+    }
+    else if (Utilities::IsRemovableFilesystem(output_path)) {
+      job.max_device_jobs = kMaxRemovableDeviceJobs;
+    }
+  }
+
   queued_jobs_ << job;
 
 }
@@ -324,7 +348,7 @@ void Transcoder::Start() {
 
   Q_FOREVER {
     StartJobStatus status = MaybeStartNextJob();
-    if (status == StartJobStatus::AllThreadsBusy || status == StartJobStatus::NoMoreJobs) break;
+    if (status == StartJobStatus::AllThreadsBusy || status == StartJobStatus::AllDevicesBusy || status == StartJobStatus::NoMoreJobs) break;
   }
 
 }
@@ -334,13 +358,25 @@ Transcoder::StartJobStatus Transcoder::MaybeStartNextJob() {
   if (current_jobs_.count() >= max_threads()) return StartJobStatus::AllThreadsBusy;
   if (queued_jobs_.isEmpty()) {
     if (current_jobs_.isEmpty()) {
+      // Don't keep pipelines around between batches, the encoder settings might change in between.
+      idle_jobs_.clear();
       Q_EMIT AllJobsComplete();
     }
 
     return StartJobStatus::NoMoreJobs;
   }
 
-  Job job = queued_jobs_.takeFirst();
+  // Take the first job that can be written to its output device, jobs for a device that is busy wait while other jobs encode.
+  qint64 index = -1;
+  for (qint64 i = 0; i < queued_jobs_.count(); ++i) {
+    if (CanStartJob(queued_jobs_[i])) {
+      index = i;
+      break;
+    }
+  }
+  if (index == -1) return StartJobStatus::AllDevicesBusy;
+
+  Job job = queued_jobs_.takeAt(index);
   if (StartJob(job)) {
     return StartJobStatus::StartedSuccessfully;
   }
@@ -350,6 +386,16 @@ Transcoder::StartJobStatus Transcoder::MaybeStartNextJob() {
 
 }
 
+bool Transcoder::CanStartJob(const Job &job) const {
+
+  if (job.max_device_jobs <= 0) return true;
+
+  const qint64 device_jobs = std::count_if(current_jobs_.begin(), current_jobs_.end(), [&job](const SharedPtr<JobState> &state) { return state->job_.device == job.device; });
+
+  return device_jobs < job.max_device_jobs;
+
+}
+
 void Transcoder::NewPadCallback(GstElement *element, GstPad *pad, gpointer data) {
 
   Q_UNUSED(element)
@@ -407,10 +453,41 @@ void Transcoder::JobState::ReportError(GstMessage *msg) const {
 
 bool Transcoder::StartJob(const Job &job) {
 
-  SharedPtr<JobState> state = make_shared<JobState>(job, this);
-
   Q_EMIT LogLine(tr("Starting %1").arg(QDir::toNativeSeparators(job.input)));
 
+  // Reuse the pipeline of a finished job with the same preset, so the encoder and muxer don't have to be created again.
+  SharedPtr<JobState> state = TakeIdlePipeline(job.preset);
+  if (state) {
+    state->job_ = job;
+    ++state->run_;
+  }
+  else {
+    state = make_shared<JobState>(job, this);
+    if (!CreatePipeline(&*state)) return false;
+  }
+
+  // Set properties
+  g_object_set(state->src_element_, "location", job.input.toUtf8().constData(), nullptr);
+  g_object_set(state->sink_element_, "location", job.output.toUtf8().constData(), nullptr);
+
+  gst_bus_set_sync_handler(gst_pipeline_get_bus(GST_PIPELINE(state->pipeline_)), BusCallbackSync, &*state, nullptr);
+
+  // Start the pipeline
+  state->timer_.start();
+  gst_element_set_state(state->pipeline_, GST_STATE_PLAYING);
+
+  // GStreamer now transcodes in another thread, so we can return now and do something else.
+  // Keep the JobState object around.  It'll post an event to our event loop when it finishes.
+  current_jobs_ << state;
+
+  return true;
+
+}
+
+bool Transcoder::CreatePipeline(JobState *state) {
+
+  const Job &job = state->job_;
+
   // Create the pipeline.
   // This should be a scoped_ptr, but scoped_ptr doesn't support custom destructors.
   state->pipeline_ = gst_pipeline_new("pipeline");
@@ -443,24 +520,27 @@ bool Transcoder::StartJob(const Job &job) {
   else if (codec) gst_element_link_many(convert, resample, codec, sink, nullptr);
   else if (muxer) gst_element_link_many(convert, resample, muxer, sink, nullptr);
 
-  // Set properties
-  g_object_set(src, "location", job.input.toUtf8().constData(), nullptr);
-  g_object_set(sink, "location", job.output.toUtf8().constData(), nullptr);
-
   // Set callbacks
+  state->src_element_ = src;
   state->convert_element_ = convert;
+  state->sink_element_ = sink;
 
-  CHECKED_GCONNECT(decode, "pad-added", &NewPadCallback, state.get());
-  gst_bus_set_sync_handler(gst_pipeline_get_bus(GST_PIPELINE(state->pipeline_)), BusCallbackSync, state.get(), nullptr);
+  CHECKED_GCONNECT(decode, "pad-added", &NewPadCallback, state);
 
-  // Start the pipeline
-  gst_element_set_state(state->pipeline_, GST_STATE_PLAYING);
+  return true;
 
-  // GStreamer now transcodes in another thread, so we can return now and do something else.
-  // Keep the JobState object around.  It'll post an event to our event loop when it finishes.
-  current_jobs_ << state;
+}
 
-  return true;
+SharedPtr<Transcoder::JobState> Transcoder::TakeIdlePipeline(const TranscoderPreset &preset) {
+
+  for (qint64 i = 0; i < idle_jobs_.count(); ++i) {
+    const TranscoderPreset &idle_preset = idle_jobs_[i]->job_.preset;
+    if (idle_preset.codec_mimetype_ == preset.codec_mimetype_ && idle_preset.muxer_mimetype_ == preset.muxer_mimetype_) {
+      return idle_jobs_.takeAt(i);
+    }
+  }
+
+  return SharedPtr<JobState>();
 
 }
 
@@ -481,21 +561,31 @@ bool Transcoder::event(QEvent *e) {
     // Find this job in the list
     JobStateList::iterator it = current_jobs_.begin();
     for (; it != current_jobs_.end(); ++it) {
-      if (it->get() == finished_event->state_) break;
+      if (it->get() == finished_event->state_ && (*it)->run_ == finished_event->run_) break;
     }
     if (it == current_jobs_.end()) {
       // Couldn't find it, maybe GStreamer gave us an event after we'd destroyed the pipeline?
       return true;
     }
 
-    QString input = (*it)->job_.input;
-    QString output = (*it)->job_.output;
+    SharedPtr<JobState> state = *it;
+    QString input = state->job_.input;
+    QString output = state->job_.output;
+
+    if (finished_event->success_) {
+      Q_EMIT LogLine(tr("Encoded %1 at %2x realtime").arg(QDir::toNativeSeparators(input)).arg(static_cast<double>(state->Speed()), 0, 'f', 1));
+    }
 
     // Remove event handlers from the gstreamer pipeline, so they don't get called after the pipeline is shutting down
-    gst_bus_set_sync_handler(gst_pipeline_get_bus(GST_PIPELINE(finished_event->state_->pipeline_)), nullptr, nullptr, nullptr);
+    gst_bus_set_sync_handler(gst_pipeline_get_bus(GST_PIPELINE(state->pipeline_)), nullptr, nullptr, nullptr);
 
-    // Remove it from the list - this will also destroy the GStreamer pipeline
+    // Remove it from the list, the GStreamer pipeline is kept for the next job with the same preset.
+    // Going back to the ready state closes the output file and resets the elements, failed pipelines are destroyed.
     current_jobs_.erase(it);
+    if (finished_event->success_ && idle_jobs_.count() < max_threads() && gst_element_set_state(state->pipeline_, GST_STATE_READY) != GST_STATE_CHANGE_FAILURE) {
+      idle_jobs_ << state;
+    }
+    state.reset();
 
     // Emit the finished signal
     Q_EMIT JobComplete(input, output, finished_event->success_);
@@ -514,6 +604,7 @@ void Transcoder::Cancel() {
 
   // Remove all pending jobs
   queued_jobs_.clear();
+  idle_jobs_.clear();
 
   // Stop the running ones
   JobStateList::iterator it = current_jobs_.begin();
@@ -555,6 +646,32 @@ QMap<QString, float> Transcoder::GetProgress() const {
 
 }
 
+float Transcoder::JobState::Speed() const {
+
+  if (!pipeline_ || !timer_.isValid()) return 0.0F;
+
+  gint64 position = 0;
+  gst_element_query_position(pipeline_, GST_FORMAT_TIME, &position);
+
+  const qint64 elapsed = timer_.nsecsElapsed();
+  if (position <= 0 || elapsed <= 0) return 0.0F;
+
+  return static_cast<float>(position) / static_cast<float>(elapsed);
+
+}
+
+QMap<QString, float> Transcoder::GetSpeed() const {
+
+  QMap<QString, float> ret;
+
+  for (const auto &state : current_jobs_) {
+    ret[state->job_.input] = state->Speed();
+  }
+
+  return ret;
+
+}
+
 void Transcoder::SetElementProperties(const QString &name, GObject *object) {
 
   Settings s;
@@ -34,7 +34,9 @@
 #include <QMetaType>
 #include <QSet>
 #include <QString>
+#include <QByteArray>
 #include <QEvent>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
@@ -61,13 +63,20 @@ class Transcoder : public QObject {
   static QList<TranscoderPreset> GetAllPresets();
   static Song::FileType PickBestFormat(const QList<Song::FileType> &supported);
 
+  // Number of files encoded at the same time.
   int max_threads() const { return max_threads_; }
   void set_max_threads(int count) { max_threads_ = count; }
 
+  // Number of files written to the same device at the same time, 0 picks a limit based on the filesystem type.
+  int max_jobs_per_device() const { return max_jobs_per_device_; }
+  void set_max_jobs_per_device(const int count) { max_jobs_per_device_ = count; }
+
   static QString GetFile(const QString &input, const TranscoderPreset &preset, const QString &output = QString());
   void AddJob(const QString &input, const TranscoderPreset &preset, const QString &output);
 
   QMap<QString, float> GetProgress() const;
+  // Encode speed of the running jobs, as a multiple of realtime.
+  QMap<QString, float> GetSpeed() const;
   qint64 QueuedJobsCount() const { return queued_jobs_.count(); }
 
  public Q_SLOTS:
@@ -85,9 +94,12 @@ class Transcoder : public QObject {
  private:
   // The description of a file to transcode - lives in the main thread.
   struct Job {
+    Job() : max_device_jobs(0) {}
     QString input;
     QString output;
     TranscoderPreset preset;
+    QByteArray device;
+    int max_device_jobs;
   };
 
   // State held by a job and shared across gstreamer callbacks - lives in the job's thread.
@@ -96,27 +108,37 @@ class Transcoder : public QObject {
         : job_(job),
           parent_(parent),
           pipeline_(nullptr),
-          convert_element_(nullptr) {}
+          src_element_(nullptr),
+          convert_element_(nullptr),
+          sink_element_(nullptr),
+          run_(0) {}
     ~JobState();
 
     void PostFinished(const bool success);
     void ReportError(GstMessage *msg) const;
+    float Speed() const;
 
     Job job_;
     Transcoder *parent_;
     GstElement *pipeline_;
+    GstElement *src_element_;
     GstElement *convert_element_;
+    GstElement *sink_element_;
+    // Increased each time the pipeline is reused for another job, so a late event from the previous job is ignored.
+    int run_;
+    QElapsedTimer timer_;
    private:
     Q_DISABLE_COPY(JobState)
   };
 
   // Event passed from a GStreamer callback to the Transcoder when a job finishes.
   struct JobFinishedEvent : public QEvent {
-    explicit JobFinishedEvent(JobState *state, bool success);
+    explicit JobFinishedEvent(JobState *state, const int run, bool success);
 
     static int sEventType;
 
     JobState *state_;
+    int run_;
     bool success_;
    private:
     Q_DISABLE_COPY(JobFinishedEvent)
@@ -127,10 +149,14 @@ class Transcoder : public QObject {
     FailedToStart,
     NoMoreJobs,
     AllThreadsBusy,
+    AllDevicesBusy,
   };
 
   StartJobStatus MaybeStartNextJob();
+  bool CanStartJob(const Job &job) const;
   bool StartJob(const Job &job);
+  bool CreatePipeline(JobState *state);
+  SharedPtr<JobState> TakeIdlePipeline(const TranscoderPreset &preset);
 
   GstElement *CreateElement(const QString &factory_name, GstElement *bin = nullptr, const QString &name = QString());
   GstElement *CreateElementForMimeType(GstElementFactoryListType element_type, const QString &mime_type, GstElement *bin = nullptr);
@@ -143,8 +169,10 @@ class Transcoder : public QObject {
   using JobStateList = QList<SharedPtr<JobState>>;
 
   int max_threads_;
+  int max_jobs_per_device_;
   QList<Job> queued_jobs_;
   JobStateList current_jobs_;
+  JobStateList idle_jobs_;
   QString settings_postfix_;
 };
 
@@ -22,11 +22,18 @@
 
 #include <memory>
 
+#ifdef Q_OS_LINUX
+#  include <unistd.h>
+#  include <sys/ioctl.h>
+#  include <linux/fs.h>
+#endif
+
 #include <QByteArray>
 #include <QString>
 #include <QIODevice>
 #include <QDir>
 #include <QFile>
+#include <QStorageInfo>
 
 #include "core/logging.h"
 #include "includes/scoped_ptr.h"
@@ -83,6 +90,45 @@ bool Copy(QIODevice *source, QIODevice *destination) {
 
 }
 
+bool CopyLocalFile(const QString &source, const QString &destination) {
+
+#ifdef Q_OS_LINUX
+  {
+    QFile source_file(source);
+    QFile destination_file(destination);
+    if (source_file.open(QIODevice::ReadOnly) && destination_file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+      // Clone the file when source and destination are on the same reflink capable filesystem, otherwise let the kernel copy the data.
+#ifdef FICLONE
+      bool success = ioctl(destination_file.handle(), FICLONE, source_file.handle()) == 0;
+#else
+      bool success = false;
+#endif
+      if (!success) {
+        qint64 remaining = source_file.size();
+        while (remaining > 0) {
+          const ssize_t copied = copy_file_range(source_file.handle(), nullptr, destination_file.handle(), nullptr, static_cast<size_t>(remaining), 0);
+          if (copied <= 0) break;
+          remaining -= copied;
+        }
+        success = remaining == 0;
+      }
+      if (success) {
+        destination_file.setPermissions(source_file.permissions());
+        return true;
+      }
+      // Not supported between these filesystems, fall back to a regular copy.
+      destination_file.remove();
+    }
+    else if (destination_file.exists()) {
+      return false;
+    }
+  }
+#endif  // Q_OS_LINUX
+
+  return QFile::copy(source, destination);
+
+}
+
 bool CopyRecursive(const QString &source, const QString &destination) {
 
   // Make the destination directory
@@ -101,7 +147,7 @@ bool CopyRecursive(const QString &source, const QString &destination) {
 
   const QStringList children_files = dir.entryList(QDir::NoDotAndDotDot | QDir::Files);
   for (const QString &child : children_files) {
-    if (!QFile::copy(source + QLatin1Char('/') + child, dest_path + QLatin1Char('/') + child)) {
+    if (!CopyLocalFile(source + QLatin1Char('/') + child, dest_path + QLatin1Char('/') + child)) {
       qLog(Warning) << "Failed to copy file" << source + QLatin1Char('/') + child << "to" << dest_path;
       return false;
     }
@@ -132,4 +178,14 @@ bool RemoveRecursive(const QString &path) {
 
 }
 
+bool IsRemovableFilesystem(const QString &path) {
+
+  const QStorageInfo storage(path);
+  if (!storage.isValid()) return false;
+
+  const QByteArray filesystem_type = storage.fileSystemType();
+  return filesystem_type == "vfat" || filesystem_type == "exfat" || filesystem_type == "msdos" || filesystem_type.contains("mtp") || filesystem_type.contains("gvfs");
+
+}
+
 }  // namespace Utilities
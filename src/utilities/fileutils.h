@@ -29,9 +29,13 @@ namespace Utilities {
 
 QByteArray ReadDataFromFile(const QString &filename);
 bool Copy(QIODevice *source, QIODevice *destination);
+bool CopyLocalFile(const QString &source, const QString &destination);
 bool CopyRecursive(const QString &source, const QString &destination);
 bool RemoveRecursive(const QString &path);
 
+// True for flash drives, SD cards and MTP or GVFS mounts, which get slower when accessed by several threads at once.
+bool IsRemovableFilesystem(const QString &path);
+
 }  // namespace Utilities
 
 #endif  // FILEUTILS_H
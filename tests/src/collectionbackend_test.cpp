@@ -20,9 +20,12 @@
  */
 
 #include <memory>
+#include <optional>
 
 #include <gtest/gtest.h>
 
+#include <QList>
+#include <QUrl>
 #include <QFileInfo>
 #include <QSignalSpy>
 #include <QThread>
@@ -182,6 +185,18 @@ TEST_F(SingleSong, GetAllArtists) {
 
 }
 
+TEST_F(SingleSong, GetAllColumnValues) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  const QHash<int, QStringList> values = backend_->GetAllColumnValues(QStringList() << u"artist"_s << u"album"_s << u"genre"_s);
+  ASSERT_EQ(1, values.count());
+  ASSERT_TRUE(values.contains(1));
+  EXPECT_EQ(QStringList() << song_.artist() << song_.album() << QString(), values[1]);
+
+}
+
 TEST_F(SingleSong, GetAllAlbums) {
 
   AddDummySong();
@@ -244,6 +259,47 @@ TEST_F(SingleSong, GetSongById) {
 
 }
 
+TEST_F(SingleSong, UpdatePlayStatistics) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  QSignalSpy spy(&*backend_, &CollectionBackend::SongsStatisticsChanged);
+
+  CollectionLastPlayed lastplayed1;
+  lastplayed1.artist = u"artist"_s;
+  lastplayed1.album = u"ALBUM"_s;
+  lastplayed1.title = u"title"_s;
+  lastplayed1.lastplayed = 1000;
+  CollectionLastPlayed lastplayed2;
+  lastplayed2.artist = u"Artist"_s;
+  lastplayed2.title = u"Title"_s;
+  lastplayed2.lastplayed = 2000;
+  CollectionLastPlayed lastplayed3;
+  lastplayed3.artist = u"Artist"_s;
+  lastplayed3.album = u"Other album"_s;
+  lastplayed3.title = u"Title"_s;
+  lastplayed3.lastplayed = 3000;
+  backend_->UpdateLastPlayed(CollectionLastPlayedList() << lastplayed1 << lastplayed2 << lastplayed3);
+
+  ASSERT_EQ(1, spy.count());
+  EXPECT_EQ(2000, backend_->GetSongById(1).lastplayed());
+
+  CollectionPlayCount playcount;
+  playcount.artist = u"ARTIST"_s;
+  playcount.title = u"TITLE"_s;
+  playcount.playcount = 42;
+  backend_->UpdatePlayCount(CollectionPlayCountList() << playcount);
+
+  ASSERT_EQ(2, spy.count());
+  EXPECT_EQ(42U, backend_->GetSongById(1).playcount());
+
+  // Nothing changed, so no songs are reported.
+  backend_->UpdatePlayCount(CollectionPlayCountList() << playcount);
+  EXPECT_EQ(2, spy.count());
+
+}
+
 TEST_F(SingleSong, FindSongsInDirectory) {
 
   AddDummySong();
@@ -284,6 +340,69 @@ TEST_F(SingleSong, UpdateSong) {
 
 }
 
+TEST_F(SingleSong, SongPathsChanged) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song moved_song(song_);
+  moved_song.set_id(1);
+  Song new_song = MakeDummySong(1);
+  new_song.set_title(u"New"_s);
+
+  QSignalSpy added_spy(&*backend_, &CollectionBackend::SongsAdded);
+  QSignalSpy changed_spy(&*backend_, &CollectionBackend::SongsChanged);
+
+  backend_->SongPathsChanged(SongList() << moved_song << new_song, QList<QFileInfo>() << QFileInfo(u"/tmp/moved/bar.flac"_s) << QFileInfo(u"/tmp/moved/new.flac"_s), std::optional<int>());
+
+  ASSERT_EQ(1, changed_spy.size());
+  ASSERT_EQ(1, added_spy.size());
+
+  SongList songs_changed = *(reinterpret_cast<SongList*>(changed_spy[0][0].data()));
+  ASSERT_EQ(1, songs_changed.size());
+  EXPECT_EQ(1, songs_changed[0].id());
+
+  const Song song = backend_->GetSongById(1);
+  EXPECT_EQ(QUrl::fromLocalFile(u"/tmp/moved/bar.flac"_s), song.url());
+  EXPECT_EQ(u"bar.flac"_s, song.basefilename());
+  EXPECT_EQ(u"Title"_s, song.title());
+
+  SongList songs_added = *(reinterpret_cast<SongList*>(added_spy[0][0].data()));
+  ASSERT_EQ(1, songs_added.size());
+  EXPECT_EQ(QUrl::fromLocalFile(u"/tmp/moved/new.flac"_s), songs_added[0].url());
+
+}
+
+TEST_F(SingleSong, SongPathsChangedSkipsRemovedSongs) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song moved_song(song_);
+  moved_song.set_id(1);
+  // This song was removed from the collection while it was moved.
+  Song removed_song = MakeDummySong(1);
+  removed_song.set_id(2);
+  // The directory of this song was removed while it was moved.
+  Song removed_dir_song(song_);
+  removed_dir_song.set_id(1);
+  removed_dir_song.set_directory_id(2);
+
+  QSignalSpy changed_spy(&*backend_, &CollectionBackend::SongsChanged);
+
+  backend_->SongPathsChanged(SongList() << removed_song << removed_dir_song, QList<QFileInfo>() << QFileInfo(u"/tmp/moved/removed.flac"_s) << QFileInfo(u"/tmp/moved/removed_dir.flac"_s), std::optional<int>());
+  EXPECT_EQ(0, changed_spy.size());
+  EXPECT_EQ(song_.url(), backend_->GetSongById(1).url());
+
+  backend_->SongPathsChanged(SongList() << removed_song << moved_song, QList<QFileInfo>() << QFileInfo(u"/tmp/moved/removed.flac"_s) << QFileInfo(u"/tmp/moved/bar.flac"_s), std::optional<int>());
+  ASSERT_EQ(1, changed_spy.size());
+  SongList songs_changed = *(reinterpret_cast<SongList*>(changed_spy[0][0].data()));
+  ASSERT_EQ(1, songs_changed.size());
+  EXPECT_EQ(1, songs_changed[0].id());
+  EXPECT_FALSE(backend_->GetSongById(2).is_valid());
+
+}
+
 TEST_F(SingleSong, DeleteSongs) {
 
   AddDummySong();
@@ -431,6 +550,51 @@ TEST_F(TestUrls, TestUrls) {
 
 }
 
+TEST_F(TestUrls, GetSongsByUrlsStoredInOtherEncoding) {
+
+  const QList<QUrl> urls = QUrl::fromStringList(QStringList() << u"file:///mnt/music/02 - Björn Afzelius - Det räcker nu.flac"_s
+                                                              << u"file:///mnt/music/Test !#$%&'()-@^_`{}~..flac"_s);
+  SongList songs;
+  for (const QUrl &url : urls) {
+    Song song(Song::Source::Collection);
+    song.set_directory_id(1);
+    song.set_title(u"Test Title"_s);
+    song.set_album(u"Test Album"_s);
+    song.set_artist(u"Test Artist"_s);
+    song.set_url(url);
+    song.set_length_nanosec(kNsecPerSec);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+    songs << song;
+  }
+
+  backend_->AddOrUpdateSongs(songs);
+  if (HasFatalFailure()) return;
+
+  // Older versions stored the URLs decoded, where the stored URL doesn't parse back to the same URL.
+  {
+    QSqlDatabase db(database_->Connect());
+    for (const QUrl &url : urls) {
+      QSqlQuery q(db);
+      q.prepare(QStringLiteral("UPDATE %1 SET url = :decoded_url WHERE url = :url").arg(QLatin1String(CollectionLibrary::kSongsTable)));
+      q.bindValue(u":decoded_url"_s, QString::fromUtf8(url.toEncoded(QUrl::FullyDecoded)));
+      q.bindValue(u":url"_s, url.toString(QUrl::FullyEncoded));
+      ASSERT_TRUE(q.exec());
+      ASSERT_EQ(1, q.numRowsAffected());
+    }
+  }
+
+  const QHash<QUrl, SongList> songs_by_url = backend_->GetSongsByUrls(QList<QUrl>() << urls << QUrl(u"file:///mnt/music/missing.flac"_s));
+  ASSERT_EQ(2, songs_by_url.count());
+  for (qint64 i = 0; i < 2; ++i) {
+    ASSERT_EQ(1, songs_by_url.value(urls[i]).count());
+    EXPECT_EQ(u"Test Title"_s, songs_by_url.value(urls[i]).first().title());
+  }
+
+}
+
 class UpdateSongsBySongID : public CollectionBackendTest {
  protected:
   void SetUp() override {
@@ -609,4 +773,160 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
 
 }
 
+class UpdateSongsByAlbumID : public CollectionBackendTest {
+ protected:
+  void SetUp() override {
+    CollectionBackendTest::SetUp();
+    backend_->AddDirectory(u"/mnt/music"_s);
+  }
+
+  static Song MakeSong(const QString &song_id, const QString &album_id) {
+
+    Song song(Song::Source::Collection);
+    song.set_song_id(song_id);
+    song.set_album_id(album_id);
+    song.set_directory_id(1);
+    song.set_title(u"Test Title "_s + song_id);
+    song.set_album(u"Test Album "_s + album_id);
+    song.set_artist(u"Test Artist"_s);
+    song.set_url(QUrl(u"file:///music/"_s + song_id));
+    song.set_length_nanosec(kNsecPerSec);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+
+    return song;
+
+  }
+};
+
+TEST_F(UpdateSongsByAlbumID, UpdateSongsByAlbumID) {
+
+  {  // Add two albums
+    SongMap songs;
+    songs.insert(u"song1"_s, MakeSong(u"song1"_s, u"album1"_s));
+    songs.insert(u"song2"_s, MakeSong(u"song2"_s, u"album1"_s));
+    songs.insert(u"song3"_s, MakeSong(u"song3"_s, u"album2"_s));
+
+    QSignalSpy spy(&*backend_, &CollectionBackend::SongsAdded);
+
+    backend_->UpdateSongsByAlbumID(QStringList() << u"album1"_s << u"album2"_s, songs);
+
+    ASSERT_EQ(1, spy.count());
+    EXPECT_EQ(spy[0][0].value<SongList>().count(), 3);
+  }
+
+  {  // Sync only the first album, songs of other albums are left alone
+    SongMap songs;
+    Song song1 = MakeSong(u"song1"_s, u"album1"_s);
+    song1.set_mtime(2);
+    songs.insert(u"song1"_s, song1);
+    songs.insert(u"song4"_s, MakeSong(u"song4"_s, u"album1"_s));
+
+    QSignalSpy spy1(&*backend_, &CollectionBackend::SongsDeleted);
+    QSignalSpy spy2(&*backend_, &CollectionBackend::SongsAdded);
+    QSignalSpy spy3(&*backend_, &CollectionBackend::SongsChanged);
+
+    backend_->UpdateSongsByAlbumID(QStringList() << u"album1"_s, songs);
+
+    ASSERT_EQ(1, spy1.count());
+    ASSERT_EQ(1, spy2.count());
+    ASSERT_EQ(1, spy3.count());
+
+    const SongList deleted_songs = spy1[0][0].value<SongList>();
+    ASSERT_EQ(deleted_songs.count(), 1);
+    EXPECT_EQ(deleted_songs[0].song_id(), u"song2"_s);
+
+    const SongList added_songs = spy2[0][0].value<SongList>();
+    ASSERT_EQ(added_songs.count(), 1);
+    EXPECT_EQ(added_songs[0].song_id(), u"song4"_s);
+
+    const SongList changed_songs = spy3[0][0].value<SongList>();
+    ASSERT_EQ(changed_songs.count(), 1);
+    EXPECT_EQ(changed_songs[0].song_id(), u"song1"_s);
+
+    EXPECT_EQ(backend_->GetAllSongs().count(), 3);
+  }
+
+  {  // Remove an album
+    QSignalSpy spy(&*backend_, &CollectionBackend::SongsDeleted);
+
+    backend_->UpdateSongsByAlbumID(QStringList() << u"album2"_s, SongMap());
+
+    ASSERT_EQ(1, spy.count());
+    const SongList deleted_songs = spy[0][0].value<SongList>();
+    ASSERT_EQ(deleted_songs.count(), 1);
+    EXPECT_EQ(deleted_songs[0].song_id(), u"song3"_s);
+  }
+
+  {  // Album modification times
+    QSignalSpy spy(&*backend_, &CollectionBackend::GotAlbumModificationTimes);
+
+    backend_->GetAlbumModificationTimes();
+
+    ASSERT_EQ(1, spy.count());
+    const QMap<QString, qint64> album_mtimes = spy[0][0].value<QMap<QString, qint64>>();
+    ASSERT_EQ(album_mtimes.count(), 1);
+    EXPECT_EQ(album_mtimes.value(u"album1"_s), 1);
+  }
+
+}
+
+TEST_F(UpdateSongsByAlbumID, SyncBySongID) {
+
+  {  // First sync, written in two pages
+    backend_->BeginSync();
+
+    SongMap page1;
+    page1.insert(u"song1"_s, MakeSong(u"song1"_s, u"album1"_s));
+    page1.insert(u"song2"_s, MakeSong(u"song2"_s, u"album1"_s));
+    SongMap page2;
+    page2.insert(u"song3"_s, MakeSong(u"song3"_s, u"album2"_s));
+
+    QSignalSpy spy(&*backend_, &CollectionBackend::SongsAdded);
+
+    backend_->UpsertSongsBySongID(page1);
+    backend_->UpsertSongsBySongID(page2);
+    backend_->EndSync(true);
+
+    ASSERT_EQ(2, spy.count());
+    EXPECT_EQ(backend_->GetAllSongs().count(), 3);
+  }
+
+  {  // Second sync, songs that were not written are swept
+    backend_->BeginSync();
+
+    SongMap page;
+    page.insert(u"song1"_s, MakeSong(u"song1"_s, u"album1"_s));
+    page.insert(u"song3"_s, MakeSong(u"song3"_s, u"album2"_s));
+
+    QSignalSpy spy1(&*backend_, &CollectionBackend::SongsDeleted);
+    QSignalSpy spy2(&*backend_, &CollectionBackend::SongsAdded);
+    QSignalSpy spy3(&*backend_, &CollectionBackend::SongsChanged);
+
+    backend_->UpsertSongsBySongID(page);
+    backend_->EndSync(true);
+
+    EXPECT_EQ(0, spy2.count());
+    EXPECT_EQ(0, spy3.count());
+    ASSERT_EQ(1, spy1.count());
+    const SongList deleted_songs = spy1[0][0].value<SongList>();
+    ASSERT_EQ(deleted_songs.count(), 1);
+    EXPECT_EQ(deleted_songs[0].song_id(), u"song2"_s);
+  }
+
+  {  // Nothing is removed when the sync did not complete
+    backend_->BeginSync();
+
+    QSignalSpy spy(&*backend_, &CollectionBackend::SongsDeleted);
+
+    backend_->EndSync(false);
+
+    EXPECT_EQ(0, spy.count());
+    EXPECT_EQ(backend_->GetAllSongs().count(), 2);
+  }
+
+}
+
 } // namespace
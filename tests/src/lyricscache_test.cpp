@@ -0,0 +1,248 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <QString>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "includes/scoped_ptr.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "core/networkaccessmanager.h"
+#include "lyrics/lyricssearchrequest.h"
+#include "lyrics/lyricssearchresult.h"
+#include "lyrics/lyricscache.h"
+#include "lyrics/lyricsprovider.h"
+#include "lyrics/lyricsproviders.h"
+#include "lyrics/lyricsfetcher.h"
+#include "test_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_unique;
+using std::make_shared;
+
+namespace {
+
+class LyricsCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    lyrics_cache_ = make_unique<LyricsCache>(database_);
+  }
+
+  static LyricsSearchRequest MakeRequest(const QString &artist, const QString &album, const QString &title) {
+    LyricsSearchRequest request;
+    request.artist = artist;
+    request.album = album;
+    request.title = title;
+    return request;
+  }
+
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<LyricsCache> lyrics_cache_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(LyricsCacheTest, NormalizeKey) {
+
+  ASSERT_EQ(LyricsCache::NormalizeKey(u"Don't  Stop Me Now!"_s), u"dont stop me now"_s);
+  ASSERT_EQ(LyricsCache::NormalizeKey(u"Beyoncé"_s), u"beyonce"_s);
+  ASSERT_EQ(LyricsCache::NormalizeKey(u" - "_s), QString());
+
+}
+
+TEST_F(LyricsCacheTest, Miss) {
+
+  ASSERT_EQ(lyrics_cache_->Lookup(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Don't Stop Me Now"_s)).status, LyricsCache::Status::Miss);
+
+}
+
+TEST_F(LyricsCacheTest, Found) {
+
+  lyrics_cache_->Insert(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Don't Stop Me Now"_s), u"lrclib"_s, u"Tonight I'm gonna have myself a real good time"_s);
+
+  const LyricsCache::Entry entry = lyrics_cache_->Lookup(MakeRequest(u"queen"_s, u"jazz"_s, u"Dont stop me now"_s));
+  ASSERT_EQ(entry.status, LyricsCache::Status::Found);
+  ASSERT_EQ(entry.provider, u"lrclib"_s);
+  ASSERT_EQ(entry.lyrics, u"Tonight I'm gonna have myself a real good time"_s);
+
+  ASSERT_EQ(lyrics_cache_->Lookup(MakeRequest(u"Queen"_s, u"Live Killers"_s, u"Don't Stop Me Now"_s)).status, LyricsCache::Status::Miss);
+
+}
+
+TEST_F(LyricsCacheTest, NotFound) {
+
+  lyrics_cache_->Insert(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Mustapha"_s), QString(), QString());
+
+  const LyricsCache::Entry entry = lyrics_cache_->Lookup(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Mustapha"_s));
+  ASSERT_EQ(entry.status, LyricsCache::Status::NotFound);
+  ASSERT_TRUE(entry.lyrics.isEmpty());
+
+}
+
+TEST_F(LyricsCacheTest, NotFoundExpires) {
+
+  const LyricsSearchRequest request = MakeRequest(u"Queen"_s, u"Jazz"_s, u"Mustapha"_s);
+  lyrics_cache_->Insert(request, QString(), QString());
+  lyrics_cache_->Insert(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Don't Stop Me Now"_s), u"lrclib"_s, u"Tonight I'm gonna have myself a real good time"_s);
+
+  {
+    QSqlDatabase db(database_->Connect());
+    QSqlQuery q(db);
+    q.prepare(u"UPDATE lyrics_cache SET time = :time"_s);
+    q.bindValue(u":time"_s, QDateTime::currentSecsSinceEpoch() - (4LL * 24LL * 60LL * 60LL));
+    ASSERT_TRUE(q.exec());
+  }
+
+  // Searches without results are repeated after a while, found lyrics are kept.
+  ASSERT_EQ(lyrics_cache_->Lookup(request).status, LyricsCache::Status::Miss);
+  ASSERT_EQ(lyrics_cache_->Lookup(MakeRequest(u"Queen"_s, u"Jazz"_s, u"Don't Stop Me Now"_s)).status, LyricsCache::Status::Found);
+
+  lyrics_cache_->Insert(request, QString(), QString());
+  ASSERT_EQ(lyrics_cache_->Lookup(request).status, LyricsCache::Status::NotFound);
+
+}
+
+// Answers from the lyrics providers thread, "Found" titles have lyrics and "Offline" titles fail like a network error.
+class FakeLyricsProvider : public LyricsProvider {
+ public:
+  explicit FakeLyricsProvider(const SharedPtr<NetworkAccessManager> network) : LyricsProvider(u"Fake"_s, true, false, network, nullptr), searches_(0) {}
+
+  bool StartSearchAsync(const int id, const LyricsSearchRequest &request) override {
+    ++searches_;
+    QMetaObject::invokeMethod(this, [this, id, request]() { StartSearch(id, request); }, Qt::QueuedConnection);
+    return true;
+  }
+
+  void Error(const QString &error, const QVariant &debug = QVariant()) override {
+    Q_UNUSED(error)
+    Q_UNUSED(debug)
+  }
+
+  int searches() const { return searches_; }
+
+ protected:
+  void StartSearch(const int id, const LyricsSearchRequest &request) override {
+    if (request.title.startsWith("Offline"_L1)) {
+      Q_EMIT SearchFinished(id, LyricsSearchResults(), false);
+    }
+    else if (request.title.startsWith("Found"_L1)) {
+      LyricsSearchResult result(u"Lyrics for "_s + request.title);
+      result.artist = request.artist;
+      result.title = request.title;
+      Q_EMIT SearchFinished(id, LyricsSearchResults() << result);
+    }
+    else {
+      Q_EMIT SearchFinished(id);
+    }
+  }
+
+ private:
+  std::atomic<int> searches_;
+};
+
+class LyricsPrefetchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    lyrics_cache_ = make_shared<LyricsCache>(database_);
+    lyrics_providers_ = make_shared<LyricsProviders>();
+    provider_ = new FakeLyricsProvider(lyrics_providers_->network());
+    lyrics_providers_->AddProvider(provider_);
+    lyrics_fetcher_ = make_unique<LyricsFetcher>(lyrics_providers_);
+    lyrics_fetcher_->set_lyrics_cache(lyrics_cache_);
+  }
+
+  void TearDown() override {
+    lyrics_fetcher_.reset();
+  }
+
+  static Song MakeSong(const QString &title) {
+    Song song;
+    song.set_artist(u"Artist"_s);
+    song.set_album(u"Album"_s);
+    song.set_title(title);
+    return song;
+  }
+
+  LyricsCache::Status CacheStatus(const QString &title) const {
+    LyricsSearchRequest request;
+    request.artist = u"Artist"_s;
+    request.album = u"Album"_s;
+    request.title = title;
+    return lyrics_cache_->Lookup(request).status;
+  }
+
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<LyricsCache> lyrics_cache_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<LyricsProviders> lyrics_providers_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  FakeLyricsProvider *provider_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<LyricsFetcher> lyrics_fetcher_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(LyricsPrefetchTest, PrefetchCachesResults) {
+
+  // The queue is searched in order, so the last song being cached means the failed one was handled.
+  lyrics_fetcher_->Prefetch(SongList() << MakeSong(u"Offline"_s) << MakeSong(u"Found 1"_s) << MakeSong(u"Missing"_s));
+
+  ASSERT_TRUE(WaitFor([this]() { return CacheStatus(u"Missing"_s) == LyricsCache::Status::NotFound; }));
+  ASSERT_EQ(CacheStatus(u"Found 1"_s), LyricsCache::Status::Found);
+  ASSERT_EQ(CacheStatus(u"Offline"_s), LyricsCache::Status::Miss);
+  ASSERT_EQ(provider_->searches(), 3);
+
+}
+
+TEST_F(LyricsPrefetchTest, PrefetchSkipsCachedSongs) {
+
+  lyrics_fetcher_->Prefetch(SongList() << MakeSong(u"Found 1"_s));
+  ASSERT_TRUE(WaitFor([this]() { return CacheStatus(u"Found 1"_s) == LyricsCache::Status::Found; }));
+  ASSERT_EQ(provider_->searches(), 1);
+
+  Song song_with_lyrics = MakeSong(u"Found 2"_s);
+  song_with_lyrics.set_lyrics(u"Embedded lyrics"_s);
+
+  lyrics_fetcher_->Prefetch(SongList() << MakeSong(u"Found 1"_s) << song_with_lyrics << MakeSong(u"Found 3"_s));
+  ASSERT_TRUE(WaitFor([this]() { return CacheStatus(u"Found 3"_s) == LyricsCache::Status::Found; }));
+  ASSERT_EQ(CacheStatus(u"Found 2"_s), LyricsCache::Status::Miss);
+  ASSERT_EQ(provider_->searches(), 2);
+
+}
+
+TEST_F(LyricsPrefetchTest, NewPrefetchReplacesQueue) {
+
+  SongList songs;
+  for (int i = 0; i < 20; ++i) {
+    songs << MakeSong(u"Found "_s + QString::number(i));
+  }
+  lyrics_fetcher_->Prefetch(songs);
+  lyrics_fetcher_->Prefetch(SongList() << MakeSong(u"Missing"_s));
+
+  ASSERT_TRUE(WaitFor([this]() { return CacheStatus(u"Missing"_s) == LyricsCache::Status::NotFound; }));
+  ASSERT_EQ(CacheStatus(u"Found 19"_s), LyricsCache::Status::Miss);
+  ASSERT_EQ(provider_->searches(), 2);
+
+}
+
+}  // namespace
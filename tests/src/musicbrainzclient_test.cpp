@@ -0,0 +1,246 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "includes/shared_ptr.h"
+#include "core/networkaccessmanager.h"
+#include "musicbrainz/acoustidclient.h"
+#include "musicbrainz/musicbrainzclient.h"
+
+#include "test_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+namespace {
+
+// Minimal HTTP server, the handler gets the path and body of each request and returns the response body.
+class FakeServer : public QTcpServer {
+ public:
+  using Handler = std::function<QByteArray(const QByteArray &path, const QByteArray &body)>;
+
+  explicit FakeServer(const Handler &handler) : handler_(handler) {
+
+    QObject::connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { ReadRequests(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+
+  }
+
+  QString url(const QString &path) const { return u"http://127.0.0.1:%1%2"_s.arg(serverPort()).arg(path); }
+  const QList<QByteArray> &paths() const { return paths_; }
+  const QList<qint64> &times() const { return times_; }
+
+  // Status lines used for the next replies instead of 200 OK.
+  void AddStatus(const QByteArray &status) { statuses_ << status; }
+
+ private:
+  void ReadRequests(QTcpSocket *socket) {
+
+    QByteArray &buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+
+    while (true) {
+      const qint64 header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) return;
+      const QList<QByteArray> header_lines = buffer.left(header_end).split('\n');
+      qint64 content_length = 0;
+      for (const QByteArray &line : header_lines) {
+        if (line.toLower().startsWith("content-length:")) {
+          content_length = line.mid(15).trimmed().toLongLong();
+        }
+      }
+      if (buffer.size() < header_end + 4 + content_length) return;
+      const QByteArray path = header_lines.first().split(' ').value(1);
+      const QByteArray body = buffer.mid(header_end + 4, content_length);
+      buffer.remove(0, header_end + 4 + content_length);
+
+      if (!clock_.isValid()) clock_.start();
+      paths_ << path;
+      times_ << clock_.elapsed();
+
+      const QByteArray data = handler_(path, body);
+      const QByteArray status = statuses_.isEmpty() ? QByteArray("200 OK") : statuses_.takeFirst();
+      socket->write("HTTP/1.1 " + status + "\r\nCache-Control: no-store\r\nContent-Length: " + QByteArray::number(data.size()) + "\r\n\r\n" + data);
+    }
+
+  }
+
+  Handler handler_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  QList<QByteArray> paths_;
+  QList<qint64> times_;
+  QList<QByteArray> statuses_;
+  QElapsedTimer clock_;
+};
+
+QByteArray RecordingXml(const QByteArray &mbid) {
+
+  return "<metadata><recording id=\"" + mbid + "\"><title>Title " + mbid + "</title><length>180000</length>"
+         "<artist-credit><name-credit><artist><name>Artist</name></artist></name-credit></artist-credit>"
+         "<release-list><release><title>Album</title><status>Official</status><date>2001</date>"
+         "<medium-list><medium><track-list offset=\"2\"/></medium></medium-list></release></release-list>"
+         "</recording></metadata>";
+
+}
+
+TEST(AcoustidClientTest, LooksUpFingerprintsInBatch) {
+
+  FakeServer server([](const QByteArray&, const QByteArray &body) {
+    const QUrlQuery query(QString::fromUtf8(body));
+    // The third fingerprint has no match and is missing from the response.
+    EXPECT_EQ(query.queryItemValue(u"fingerprint.0"_s), u"AAA"_s);
+    EXPECT_EQ(query.queryItemValue(u"fingerprint.2"_s), u"CCC"_s);
+    EXPECT_EQ(query.queryItemValue(u"duration.1"_s), u"200"_s);
+    return QByteArray("{\"status\":\"ok\",\"fingerprints\":["
+                      "{\"index\":\"1\",\"results\":[{\"recordings\":[{\"id\":\"b1\",\"sources\":1},{\"id\":\"b2\",\"sources\":5}]}]},"
+                      "{\"index\":0,\"results\":[{\"recordings\":[{\"id\":\"a1\",\"sources\":2}]}]}]}");
+  });
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  AcoustidClient client(make_shared<NetworkAccessManager>());
+  client.SetUrl(QUrl(server.url(u"/v2/lookup"_s)));
+
+  QMap<int, QStringList> results;
+  QObject::connect(&client, &AcoustidClient::Finished, &client, [&results](const int id, const QStringList &mbid_list) { results.insert(id, mbid_list); });
+
+  client.Start(10, u"AAA"_s, 100000);
+  client.Start(11, u"BBB"_s, 200000);
+  client.Start(12, u"CCC"_s, 300000);
+
+  ASSERT_TRUE(WaitFor([&results]() { return results.count() == 3; }));
+  ASSERT_EQ(server.paths().count(), 1);
+  ASSERT_EQ(results[10], QStringList() << u"a1"_s);
+  ASSERT_EQ(results[11], QStringList() << u"b2"_s << u"b1"_s);
+  ASSERT_TRUE(results[12].isEmpty());
+
+}
+
+TEST(MusicBrainzClientTest, DeduplicatesAndCachesRecordings) {
+
+  FakeServer server([](const QByteArray &path, const QByteArray&) {
+    return RecordingXml(QUrl(QString::fromLatin1(path)).path().section(u'/', -1).toLatin1());
+  });
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  MusicBrainzClient client(make_shared<NetworkAccessManager>());
+  client.SetUrl(QUrl(server.url(u"/ws/2/"_s)));
+
+  QMap<int, MusicBrainzClient::ResultList> results;
+  QObject::connect(&client, &MusicBrainzClient::Finished, &client, [&results](const int id, const MusicBrainzClient::ResultList &result) { results.insert(id, result); });
+
+  client.Start(0, QStringList() << u"a"_s << u"b"_s);
+  client.Start(1, QStringList() << u"b"_s);
+  client.Start(2, QStringList() << u"a"_s);
+
+  ASSERT_TRUE(WaitFor([&results]() { return results.count() == 3; }));
+  ASSERT_EQ(server.paths().count(), 2);
+  // Requests are sent at most once per second.
+  ASSERT_GE(server.times()[1] - server.times()[0], 900);
+
+  ASSERT_EQ(results[0].count(), 2);
+  ASSERT_EQ(results[0][0].title_, u"Title a"_s);
+  ASSERT_EQ(results[0][1].title_, u"Title b"_s);
+  ASSERT_EQ(results[0][0].album_, u"Album"_s);
+  ASSERT_EQ(results[0][0].track_, 3);
+  ASSERT_EQ(results[0][0].year_, 2001);
+  ASSERT_EQ(results[1].count(), 1);
+  ASSERT_EQ(results[2].count(), 1);
+
+  // Cached for the rest of the session.
+  client.Start(3, QStringList() << u"b"_s << u"a"_s);
+  ASSERT_TRUE(WaitFor([&results]() { return results.contains(3); }));
+  ASSERT_EQ(server.paths().count(), 2);
+  ASSERT_EQ(results[3][0].title_, u"Title b"_s);
+
+}
+
+TEST(MusicBrainzClientTest, RetriesTransientErrors) {
+
+  FakeServer server([](const QByteArray &path, const QByteArray&) {
+    return RecordingXml(QUrl(QString::fromLatin1(path)).path().section(u'/', -1).toLatin1());
+  });
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+  server.AddStatus("503 Service Unavailable");
+
+  MusicBrainzClient client(make_shared<NetworkAccessManager>());
+  client.SetUrl(QUrl(server.url(u"/ws/2/"_s)));
+
+  QMap<int, MusicBrainzClient::ResultList> results;
+  QMap<int, QString> errors;
+  QObject::connect(&client, &MusicBrainzClient::Finished, &client, [&results, &errors](const int id, const MusicBrainzClient::ResultList &result, const QString &error) {
+    results.insert(id, result);
+    errors.insert(id, error);
+  });
+
+  // The first reply is rate limited, the recording is requested again after a delay.
+  client.Start(0, QStringList() << u"a"_s);
+  ASSERT_TRUE(WaitFor([&results]() { return results.contains(0); }));
+  ASSERT_EQ(server.paths().count(), 2);
+  ASSERT_TRUE(errors[0].isEmpty());
+  ASSERT_EQ(results[0].count(), 1);
+  ASSERT_EQ(results[0][0].title_, u"Title a"_s);
+
+}
+
+TEST(MusicBrainzClientTest, CachesMissingRecordings) {
+
+  FakeServer server([](const QByteArray&, const QByteArray&) { return QByteArray(); });
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+  server.AddStatus("404 Not Found");
+
+  MusicBrainzClient client(make_shared<NetworkAccessManager>());
+  client.SetUrl(QUrl(server.url(u"/ws/2/"_s)));
+
+  QMap<int, QString> errors;
+  QObject::connect(&client, &MusicBrainzClient::Finished, &client, [&errors](const int id, const MusicBrainzClient::ResultList&, const QString &error) { errors.insert(id, error); });
+
+  client.Start(0, QStringList() << u"missing"_s);
+  ASSERT_TRUE(WaitFor([&errors]() { return errors.contains(0); }));
+  ASSERT_FALSE(errors[0].isEmpty());
+
+  // A missing recording is not requested again.
+  client.Start(1, QStringList() << u"missing"_s);
+  ASSERT_TRUE(WaitFor([&errors]() { return errors.contains(1); }));
+  ASSERT_EQ(server.paths().count(), 1);
+  ASSERT_FALSE(errors[1].isEmpty());
+
+}
+
+}  // namespace
@@ -0,0 +1,125 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QTimer>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "test_utils.h"
+#include "core/networkaccessmanager.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr int kResponseDelay = 500;
+
+// Answers every request with the same body after a delay, so identical requests overlap.
+class FakeServer : public QTcpServer {
+ public:
+  explicit FakeServer() : requests_(0) {
+
+    QObject::connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { ReadRequest(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+
+  }
+
+  QUrl url(const QString &path) const { return QUrl(u"http://127.0.0.1:%1%2"_s.arg(serverPort()).arg(path)); }
+  int requests() const { return requests_; }
+
+ private:
+  void ReadRequest(QTcpSocket *socket) {
+
+    if (!socket->readAll().contains("\r\n\r\n")) return;
+
+    ++requests_;
+    QTimer::singleShot(kResponseDelay, socket, [socket]() {
+      const QByteArray data = "cover image";
+      socket->write("HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nCache-Control: no-store\r\nContent-Length: " + QByteArray::number(data.size()) + "\r\n\r\n" + data);
+    });
+
+  }
+
+  int requests_;
+};
+
+TEST(NetworkAccessManagerTest, CoalescesIdenticalRequests) {
+
+  FakeServer server;
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  NetworkAccessManager network;
+  QList<QNetworkReply*> replies;
+  for (int i = 0; i < 3; ++i) {
+    replies << network.get(QNetworkRequest(server.url(u"/cover.jpg"_s)));
+  }
+  replies << network.get(QNetworkRequest(server.url(u"/other.jpg"_s)));
+
+  ASSERT_TRUE(WaitFor([&replies]() { return std::all_of(replies.begin(), replies.end(), [](QNetworkReply *reply) { return reply->isFinished(); }); }));
+  ASSERT_EQ(server.requests(), 2);
+
+  for (QNetworkReply *reply : std::as_const(replies)) {
+    ASSERT_EQ(reply->error(), QNetworkReply::NoError);
+    ASSERT_EQ(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    ASSERT_EQ(reply->header(QNetworkRequest::ContentTypeHeader).toString(), u"image/jpeg"_s);
+    ASSERT_EQ(reply->readAll(), QByteArray("cover image"));
+    reply->deleteLater();
+  }
+
+}
+
+TEST(NetworkAccessManagerTest, AbortedRequestIsSentAgain) {
+
+  FakeServer server;
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  NetworkAccessManager network;
+  QNetworkReply *reply1 = network.get(QNetworkRequest(server.url(u"/cover.jpg"_s)));
+  QNetworkReply *reply2 = network.get(QNetworkRequest(server.url(u"/cover.jpg"_s)));
+  reply1->abort();
+  ASSERT_EQ(reply1->error(), QNetworkReply::OperationCanceledError);
+  ASSERT_FALSE(reply2->isFinished());
+
+  ASSERT_TRUE(WaitFor([reply2]() { return reply2->isFinished(); }));
+  ASSERT_EQ(reply2->error(), QNetworkReply::NoError);
+  ASSERT_EQ(reply2->readAll(), QByteArray("cover image"));
+
+  reply1->deleteLater();
+  reply2->deleteLater();
+
+}
+
+}  // namespace
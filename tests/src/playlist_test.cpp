@@ -20,6 +20,8 @@
  */
 
 #include <memory>
+#include <tuple>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -27,11 +29,19 @@
 
 #include "collection/collectionplaylistitem.h"
 #include "playlist/playlist.h"
+#include "playlist/playlistdelegates.h"
+#include "queue/queue.h"
 #include "mock_settingsprovider.h"
 #include "mock_playlistitem.h"
 
 #include <QtDebug>
 #include <QUndoStack>
+#include <QElapsedTimer>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QImage>
+#include <QUrl>
 
 using ::testing::Return;
 
@@ -544,4 +554,239 @@ TEST_F(PlaylistTest, CollectionIdMapMulti) {
 }
 
 
+TEST_F(PlaylistTest, SortByAlbum) {
+
+  PlaylistItemPtrList items;
+  const QList<std::tuple<QString, QString, int, int>> songs = {
+    { u"B2"_s, u"b album"_s, 1, 2 },
+    { u"A3"_s, u"A album"_s, 2, 1 },
+    { u"B1"_s, u"B album"_s, 1, 1 },
+    { u"A1"_s, u"a album"_s, 1, 1 },
+    { u"A2"_s, u"A album"_s, 1, 2 },
+  };
+  for (const std::tuple<QString, QString, int, int> &song_data : songs) {
+    Song song;
+    song.Init(std::get<0>(song_data), u"Artist"_s, std::get<1>(song_data), 123);
+    song.set_disc(std::get<2>(song_data));
+    song.set_track(std::get<3>(song_data));
+    items << std::make_shared<CollectionPlaylistItem>(song);
+  }
+  playlist_.InsertItems(items);
+
+  playlist_.sort(static_cast<int>(Playlist::Column::Album), Qt::AscendingOrder);
+  ASSERT_EQ(5, playlist_.rowCount(QModelIndex()));
+  EXPECT_EQ(u"A1"_s, playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ(u"A2"_s, playlist_.item_at(1)->Metadata().title());
+  EXPECT_EQ(u"A3"_s, playlist_.item_at(2)->Metadata().title());
+  EXPECT_EQ(u"B1"_s, playlist_.item_at(3)->Metadata().title());
+  EXPECT_EQ(u"B2"_s, playlist_.item_at(4)->Metadata().title());
+
+  playlist_.sort(static_cast<int>(Playlist::Column::Title), Qt::DescendingOrder);
+  EXPECT_EQ(u"B2"_s, playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ(u"A1"_s, playlist_.item_at(4)->Metadata().title());
+
+  playlist_.undo_stack()->undo();
+  EXPECT_EQ(u"A1"_s, playlist_.item_at(0)->Metadata().title());
+
+}
+
+TEST_F(PlaylistTest, SortLargePlaylistInBackground) {
+
+  // More than the number of items sorted in the GUI thread.
+  constexpr int kPlaylistSize = 6000;
+
+  PlaylistItemPtrList items;
+  items.reserve(kPlaylistSize);
+  for (int i = kPlaylistSize - 1; i >= 0; --i) {
+    Song song;
+    song.Init(u"Title %1"_s.arg(i, 5, 10, u'0'), u"Artist"_s, u"Album"_s, 123);
+    items << std::make_shared<CollectionPlaylistItem>(song);
+  }
+  playlist_.InsertItems(items);
+  ASSERT_EQ(kPlaylistSize, playlist_.rowCount(QModelIndex()));
+
+  playlist_.sort(static_cast<int>(Playlist::Column::Title), Qt::AscendingOrder);
+
+  // The result is applied when the background sort finishes.
+  ASSERT_TRUE(WaitFor([this]() { return playlist_.item_at(0)->Metadata().title() == u"Title 00000"_s; }));
+  ASSERT_EQ(kPlaylistSize, playlist_.rowCount(QModelIndex()));
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    ASSERT_EQ(u"Title %1"_s.arg(i, 5, 10, u'0'), playlist_.item_at(i)->Metadata().title());
+  }
+
+  playlist_.undo_stack()->undo();
+  EXPECT_EQ(u"Title %1"_s.arg(kPlaylistSize - 1, 5, 10, u'0'), playlist_.item_at(0)->Metadata().title());
+
+}
+
+TEST_F(PlaylistTest, QueuePositions) {
+
+  playlist_.InsertItems(PlaylistItemPtrList() << MakeMockItemP(u"One"_s) << MakeMockItemP(u"Two"_s) << MakeMockItemP(u"Three"_s) << MakeMockItemP(u"Four"_s));
+
+  playlist_.queue()->ToggleTracks(QModelIndexList() << playlist_.index(3, 0) << playlist_.index(1, 0));
+  EXPECT_EQ(0, playlist_.data(playlist_.index(3, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(1, playlist_.data(playlist_.index(1, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(-1, playlist_.data(playlist_.index(0, 0), Playlist::Role_QueuePosition).toInt());
+
+  // Removing a row before the queued rows moves them up
+  playlist_.removeRow(0);
+  EXPECT_EQ(1, playlist_.data(playlist_.index(0, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(0, playlist_.data(playlist_.index(2, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_FALSE(playlist_.queue()->ContainsSourceRow(1));
+
+  // Dequeueing the first item moves the rest of the queue up
+  playlist_.queue()->ToggleTracks(QModelIndexList() << playlist_.index(2, 0));
+  EXPECT_EQ(0, playlist_.data(playlist_.index(0, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(-1, playlist_.data(playlist_.index(2, 0), Playlist::Role_QueuePosition).toInt());
+
+}
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests.
+TEST_F(PlaylistTest, DISABLED_QueuePositionScrollBenchmark) {
+
+  constexpr int kPlaylistSize = 50000;
+  constexpr int kQueueSize = 5000;
+  constexpr int kVisibleRows = 50;
+  constexpr int kQueueStep = kPlaylistSize / kQueueSize;
+
+  PlaylistItemPtrList items;
+  items.reserve(kPlaylistSize);
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    Song song;
+    song.Init(QStringLiteral("Title %1").arg(i), u"Artist"_s, u"Album"_s, 123);
+    items << std::make_shared<CollectionPlaylistItem>(song);
+  }
+  playlist_.InsertItems(items);
+  ASSERT_EQ(kPlaylistSize, playlist_.rowCount(QModelIndex()));
+
+  QModelIndexList queue_indexes;
+  queue_indexes.reserve(kQueueSize);
+  for (int row = 0; row < kPlaylistSize; row += kQueueStep) {
+    queue_indexes << playlist_.index(row, 0);
+  }
+  playlist_.queue()->ToggleTracks(queue_indexes);
+  ASSERT_EQ(kQueueSize, playlist_.queue()->ItemCount());
+
+  // Scroll through the whole playlist a page at a time, asking for the queue position of every visible cell like the queued item delegate does when painting.
+  QElapsedTimer timer;
+  timer.start();
+  for (int first_row = 0; first_row < kPlaylistSize; first_row += kVisibleRows) {
+    for (int row = first_row; row < qMin(first_row + kVisibleRows, kPlaylistSize); ++row) {
+      for (int column = 0; column < Playlist::ColumnCount; ++column) {
+        const int queue_position = playlist_.data(playlist_.index(row, column), Playlist::Role_QueuePosition).toInt();
+        if (column == 0) {
+          ASSERT_EQ(row % kQueueStep == 0 ? row / kQueueStep : -1, queue_position);
+        }
+      }
+    }
+  }
+
+  RecordProperty("elapsed_ms", static_cast<int>(timer.elapsed()));
+
+}
+
+TEST_F(PlaylistTest, DisplayCacheInvalidatedOnChange) {
+
+  Song song;
+  song.Init(u"Title"_s, u"Artist"_s, u"Album"_s, 123);
+  PlaylistItemPtr item = std::make_shared<CollectionPlaylistItem>(song);
+  playlist_.InsertItems(PlaylistItemPtrList() << item);
+
+  const QModelIndex title_index = playlist_.index(0, static_cast<int>(Playlist::Column::Title));
+  const qulonglong key = playlist_.data(title_index, Playlist::Role_DisplayCacheKey).toULongLong();
+  EXPECT_EQ(u"Title"_s, playlist_.data(title_index).toString());
+  EXPECT_EQ(key, playlist_.data(title_index, Playlist::Role_DisplayCacheKey).toULongLong());
+
+  Song new_song = song;
+  new_song.set_title(u"New title"_s);
+  playlist_.UpdateItemMetadata(item, new_song, false);
+
+  EXPECT_EQ(u"New title"_s, playlist_.data(title_index).toString());
+  EXPECT_NE(key, playlist_.data(title_index, Playlist::Role_DisplayCacheKey).toULongLong());
+
+}
+
+TEST_F(PlaylistTest, UpdateItemsInBatches) {
+
+  SongList partial_songs;
+  for (const QString &name : {u"a"_s, u"b"_s, u"c"_s}) {
+    Song song(Song::Source::LocalFile);
+    song.set_url(QUrl::fromLocalFile(u"/music/%1.flac"_s.arg(name)));
+    song.set_title(name);
+    song.set_valid(true);
+    partial_songs << song;
+  }
+  playlist_.InsertSongs(partial_songs);
+  ASSERT_EQ(3, playlist_.rowCount(QModelIndex()));
+
+  SongList loaded_songs;
+  for (const Song &partial_song : std::as_const(partial_songs)) {
+    Song song = partial_song;
+    song.set_title(partial_song.title().toUpper());
+    song.set_filetype(Song::FileType::FLAC);
+    song.set_init_from_file(true);
+    loaded_songs << song;
+  }
+
+  playlist_.UpdateItems(SongList() << loaded_songs[1]);
+  EXPECT_EQ(u"a"_s, playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ(u"B"_s, playlist_.item_at(1)->Metadata().title());
+  EXPECT_EQ(u"c"_s, playlist_.item_at(2)->Metadata().title());
+
+  playlist_.UpdateItems(SongList() << loaded_songs[2] << loaded_songs[0]);
+  EXPECT_EQ(u"A"_s, playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ(u"B"_s, playlist_.item_at(1)->Metadata().title());
+  EXPECT_EQ(u"C"_s, playlist_.item_at(2)->Metadata().title());
+
+}
+
+TEST_F(PlaylistTest, DISABLED_RepaintBenchmark) {
+
+  constexpr int kPlaylistSize = 100000;
+  constexpr int kVisibleColumns = 20;
+  constexpr int kFrames = 600;
+  constexpr int kTargetFps = 60;
+
+  PlaylistItemPtrList items;
+  items.reserve(kPlaylistSize);
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    Song song;
+    song.Init(QStringLiteral("Title %1").arg(i), QStringLiteral("Artist %1").arg(i % 1000), QStringLiteral("Album %1").arg(i % 5000), 123);
+    song.set_track(i % 20 + 1);
+    song.set_year(1970 + i % 50);
+    items << std::make_shared<CollectionPlaylistItem>(song);
+  }
+  playlist_.InsertItems(items);
+  ASSERT_EQ(kPlaylistSize, playlist_.rowCount(QModelIndex()));
+
+  QTreeView view;
+  view.setUniformRowHeights(true);
+  view.setRootIsDecorated(false);
+  view.setItemDelegate(new PlaylistDelegateBase(&view));
+  view.setItemDelegateForColumn(static_cast<int>(Playlist::Column::Length), new LengthItemDelegate(&view));
+  view.setItemDelegateForColumn(static_cast<int>(Playlist::Column::Filesize), new SizeItemDelegate(&view));
+  view.setItemDelegateForColumn(static_cast<int>(Playlist::Column::Filetype), new FileTypeItemDelegate(&view));
+  view.setItemDelegateForColumn(static_cast<int>(Playlist::Column::DateCreated), new DateItemDelegate(&view));
+  view.setModel(&playlist_);
+  for (int column = kVisibleColumns; column < Playlist::ColumnCount; ++column) {
+    view.header()->hideSection(column);
+  }
+  view.resize(1920, 1080);
+
+  QImage image(view.size(), QImage::Format_ARGB32_Premultiplied);
+
+  // Scroll a few rows per frame, like smooth scrolling does, and repaint the whole viewport every frame.
+  QElapsedTimer timer;
+  timer.start();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    view.verticalScrollBar()->setValue(frame * 3);
+    view.render(&image);
+  }
+  const qint64 elapsed = timer.elapsed();
+
+  RecordProperty("elapsed_ms", static_cast<int>(elapsed));
+  EXPECT_LE(elapsed, kFrames * 1000 / kTargetFps) << "Repainting " << kVisibleColumns << " columns of a " << kPlaylistSize << " row playlist is slower than " << kTargetFps << " fps";
+
+}
+
 }  // namespace
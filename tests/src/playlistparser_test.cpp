@@ -0,0 +1,370 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QDir>
+#include <QBuffer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "test_utils.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionlibrary.h"
+#include "tagreader/tagreaderclient.h"
+#include "playlistparsers/m3uparser.h"
+#include "playlistparsers/xspfparser.h"
+#include "playlistparsers/playlistparser.h"
+#include "playlist/playlistfileloader.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class PlaylistParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    backend_ = make_shared<CollectionBackend>();
+    backend_->Init(database_, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    // Songs are only added to existing directories, this one gets ID 1.
+    backend_->AddDirectory(u"/music"_s);
+  }
+
+  static Song MakeCollectionSong(const QString &filename, const QString &title) {
+
+    Song song(Song::Source::Collection);
+    song.set_directory_id(1);
+    song.set_title(title);
+    song.set_artist(u"Artist"_s);
+    song.set_album(u"Album"_s);
+    song.set_url(QUrl::fromLocalFile(filename));
+    song.set_length_nanosec(kNsecPerSec);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+    return song;
+
+  }
+
+  SongList LoadM3U(const QByteArray &data) const {
+
+    M3UParser parser(SharedPtr<TagReaderClient>(), backend_);
+    QByteArray playlist_data = data;
+    QBuffer buffer(&playlist_data);
+    buffer.open(QIODevice::ReadOnly);
+    return parser.Load(&buffer, QString(), QDir(u"/music"_s));
+
+  }
+
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<CollectionBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistParserTest, M3UEntriesInOrder) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeCollectionSong(u"/music/a.flac"_s, u"A"_s) << MakeCollectionSong(u"/music/c.flac"_s, u"C"_s));
+
+  const SongList songs = LoadM3U("#EXTM3U\n"
+                                 "c.flac\n"
+                                 "http://example.com/stream.mp3\n"
+                                 "/music/missing.flac\n"
+                                 "#EXTINF:123,Artist - Playlist title\n"
+                                 "/music/a.flac\n");
+
+  ASSERT_EQ(4, songs.count());
+  EXPECT_EQ(u"C"_s, songs[0].title());
+  EXPECT_EQ(Song::Source::Collection, songs[0].source());
+  EXPECT_TRUE(songs[1].is_stream());
+  EXPECT_EQ(QUrl(u"http://example.com/stream.mp3"_s), songs[1].url());
+  EXPECT_FALSE(songs[2].is_collection_song());
+  EXPECT_EQ(Song::Source::Collection, songs[3].source());
+  EXPECT_EQ(u"Playlist title"_s, songs[3].title());
+
+}
+
+TEST_F(PlaylistParserTest, M3UFindsSongsStoredInOtherEncoding) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeCollectionSong(u"/music/Track #1.flac"_s, u"Track 1"_s));
+
+  // Store the URL decoded, the '#' then reads back as a fragment.
+  {
+    const QUrl url = QUrl::fromLocalFile(u"/music/Track #1.flac"_s);
+    QSqlDatabase db(database_->Connect());
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("UPDATE %1 SET url = :decoded_url WHERE url = :url").arg(QLatin1String(CollectionLibrary::kSongsTable)));
+    q.bindValue(u":decoded_url"_s, QString::fromUtf8(url.toEncoded(QUrl::FullyDecoded)));
+    q.bindValue(u":url"_s, url.toString(QUrl::FullyEncoded));
+    ASSERT_TRUE(q.exec());
+    ASSERT_EQ(1, q.numRowsAffected());
+  }
+
+  const SongList songs = LoadM3U("/music/Track #1.flac\n");
+  ASSERT_EQ(1, songs.count());
+  EXPECT_EQ(Song::Source::Collection, songs[0].source());
+  EXPECT_EQ(u"Track 1"_s, songs[0].title());
+
+}
+
+TEST_F(PlaylistParserTest, M3ULoadsInChunks) {
+
+  QByteArray data;
+  for (int i = 0; i < 2500; ++i) {
+    data.append(u"/music/%1.flac\r\n"_s.arg(i).toUtf8());
+  }
+  QBuffer buffer(&data);
+  buffer.open(QIODevice::ReadOnly);
+
+  M3UParser parser(SharedPtr<TagReaderClient>(), backend_);
+  QList<int> chunk_sizes;
+  int next_entry = 0;
+  EXPECT_TRUE(parser.LoadChunks(&buffer, QString(), QDir(u"/music"_s), true, [&chunk_sizes, &next_entry](const SongList &songs) {
+    chunk_sizes << static_cast<int>(songs.count());
+    for (const Song &song : songs) {
+      EXPECT_EQ(QUrl::fromLocalFile(u"/music/%1.flac"_s.arg(next_entry++)), song.url());
+    }
+    return true;
+  }));
+  EXPECT_EQ(QList<int>() << 1000 << 1000 << 500, chunk_sizes);
+
+  // Loading stops when the callback returns false.
+  buffer.seek(0);
+  chunk_sizes.clear();
+  EXPECT_FALSE(parser.LoadChunks(&buffer, QString(), QDir(u"/music"_s), true, [&chunk_sizes](const SongList &songs) {
+    chunk_sizes << static_cast<int>(songs.count());
+    return false;
+  }));
+  EXPECT_EQ(QList<int>() << 1000, chunk_sizes);
+
+}
+
+TEST_F(PlaylistParserTest, XSPFLoadsInChunks) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeCollectionSong(u"/music/1.flac"_s, u"Collection title"_s));
+
+  QByteArray data = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><playlist version=\"1\" xmlns=\"http://xspf.org/ns/0/\"><trackList>";
+  for (int i = 0; i < 2500; ++i) {
+    data.append(u"<track><location>file:///music/%1.flac</location><title>Title %1</title></track>"_s.arg(i).toUtf8());
+  }
+  data.append("</trackList></playlist>");
+  QBuffer buffer(&data);
+  buffer.open(QIODevice::ReadOnly);
+
+  XSPFParser parser(SharedPtr<TagReaderClient>(), backend_);
+  QList<int> chunk_sizes;
+  int next_entry = 0;
+  EXPECT_TRUE(parser.LoadChunks(&buffer, QString(), QDir(u"/music"_s), true, [&chunk_sizes, &next_entry](const SongList &songs) {
+    chunk_sizes << static_cast<int>(songs.count());
+    for (const Song &song : songs) {
+      EXPECT_EQ(QUrl::fromLocalFile(u"/music/%1.flac"_s.arg(next_entry)), song.url());
+      // The title in the playlist overrides the one in the collection.
+      EXPECT_EQ(u"Title %1"_s.arg(next_entry), song.title());
+      EXPECT_EQ(next_entry == 1, song.is_collection_song());
+      ++next_entry;
+    }
+    return true;
+  }));
+  EXPECT_EQ(QList<int>() << 1000 << 1000 << 500, chunk_sizes);
+
+  // Loading stops when the callback returns false.
+  buffer.seek(0);
+  chunk_sizes.clear();
+  EXPECT_FALSE(parser.LoadChunks(&buffer, QString(), QDir(u"/music"_s), true, [&chunk_sizes](const SongList &songs) {
+    chunk_sizes << static_cast<int>(songs.count());
+    return false;
+  }));
+  EXPECT_EQ(QList<int>() << 1000, chunk_sizes);
+
+}
+
+TEST_F(PlaylistParserTest, LoadFileResolvesEntriesRelativeToTheFile) {
+
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  backend_->AddOrUpdateSongs(SongList() << MakeCollectionSong(dir.filePath(u"a.flac"_s), u"A"_s) << MakeCollectionSong(dir.filePath(u"sub/b.flac"_s), u"B"_s));
+
+  QFile file(dir.filePath(u"playlist.m3u"_s));
+  ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+  file.write("#EXTM3U\na.flac\nsub/b.flac\n");
+  file.close();
+
+  // The file is mapped into memory and parsed from the mapping.
+  M3UParser parser(SharedPtr<TagReaderClient>(), backend_);
+  ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+  SongList songs;
+  EXPECT_TRUE(parser.LoadFile(&file, true, [&songs](const SongList &chunk) {
+    songs << chunk;
+    return true;
+  }));
+  file.close();
+
+  ASSERT_EQ(2, songs.count());
+  EXPECT_EQ(u"A"_s, songs[0].title());
+  EXPECT_EQ(u"B"_s, songs[1].title());
+  EXPECT_EQ(Song::Source::Collection, songs[1].source());
+
+  // An empty file can't be mapped, it is read as is.
+  QFile empty_file(dir.filePath(u"empty.m3u"_s));
+  ASSERT_TRUE(empty_file.open(QIODevice::WriteOnly));
+  empty_file.close();
+  ASSERT_TRUE(empty_file.open(QIODevice::ReadOnly));
+  int chunks = 0;
+  EXPECT_TRUE(parser.LoadFile(&empty_file, true, [&chunks](const SongList&) {
+    ++chunks;
+    return true;
+  }));
+  EXPECT_EQ(0, chunks);
+
+}
+
+class PlaylistFileLoaderTest : public PlaylistParserTest {
+ protected:
+  void SetUp() override {
+
+    PlaylistParserTest::SetUp();
+    ASSERT_TRUE(dir_.isValid());
+    filename_ = dir_.filePath(u"playlist.m3u"_s);
+    QFile file(filename_);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    for (int i = 0; i < kPlaylistSize; ++i) {
+      file.write(u"/music/%1.flac\n"_s.arg(i).toUtf8());
+    }
+    file.close();
+
+  }
+
+  static constexpr int kPlaylistSize = 5000;
+
+  QTemporaryDir dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QString filename_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistFileLoaderTest, LoadsAllChunks) {
+
+  PlaylistParser parser(SharedPtr<TagReaderClient>(), backend_);
+  PlaylistFileLoader loader(&parser);
+
+  SongList songs;
+  bool finished = false;
+  QObject::connect(&loader, &PlaylistFileLoader::ChunkLoaded, &loader, [&songs](const int id, const SongList &chunk) {
+    EXPECT_EQ(1, id);
+    songs << chunk;
+  });
+  QObject::connect(&loader, &PlaylistFileLoader::LoadFinished, &loader, [&finished]() { finished = true; });
+
+  loader.Load(1, filename_);
+  EXPECT_TRUE(loader.IsLoading(1));
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }));
+  // Chunks are queued before the load is finished.
+  ASSERT_TRUE(WaitFor([&songs]() { return songs.count() == kPlaylistSize; }));
+  EXPECT_FALSE(loader.IsRunning());
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    ASSERT_EQ(QUrl::fromLocalFile(u"/music/%1.flac"_s.arg(i)), songs[i].url());
+  }
+
+}
+
+TEST_F(PlaylistFileLoaderTest, CancelStopsChunks) {
+
+  PlaylistParser parser(SharedPtr<TagReaderClient>(), backend_);
+  PlaylistFileLoader loader(&parser);
+
+  int chunks = 0;
+  bool finished = false;
+  QObject::connect(&loader, &PlaylistFileLoader::ChunkLoaded, &loader, [&loader, &chunks]() {
+    ++chunks;
+    loader.Cancel(1);
+  });
+  QObject::connect(&loader, &PlaylistFileLoader::LoadFinished, &loader, [&finished]() { finished = true; });
+
+  loader.Load(1, filename_);
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }));
+  // Give chunks that were already queued a chance to arrive.
+  EXPECT_FALSE(WaitFor([&chunks]() { return chunks > 1; }, 500));
+  EXPECT_EQ(1, chunks);
+  EXPECT_FALSE(loader.IsLoading(1));
+  EXPECT_FALSE(loader.IsRunning());
+
+}
+
+TEST_F(PlaylistFileLoaderTest, DestroyWaitsForCancelledLoads) {
+
+  // Like the playlist manager, the parser is destroyed right after the loader.
+  PlaylistParser *parser = new PlaylistParser(SharedPtr<TagReaderClient>(), backend_);
+  PlaylistFileLoader *loader = new PlaylistFileLoader(parser);
+  loader->Load(1, filename_);
+  loader->Cancel(1);
+  EXPECT_FALSE(loader->IsLoading(1));
+  EXPECT_TRUE(loader->IsRunning());
+
+  loader->CancelAll();
+  EXPECT_FALSE(loader->IsRunning());
+
+  loader->Load(2, filename_);
+  delete loader;
+  delete parser;
+
+}
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests.
+TEST_F(PlaylistParserTest, DISABLED_LargeM3UBenchmark) {
+
+  constexpr int kPlaylistSize = 50000;
+
+  SongList collection_songs;
+  QByteArray data = "#EXTM3U\n";
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    const QString filename = u"/music/Artist %1/Album %2/%3 - Title.flac"_s.arg(i % 500).arg(i % 5000).arg(i);
+    collection_songs << MakeCollectionSong(filename, u"Title %1"_s.arg(i));
+    data.append(filename.toUtf8() + '\n');
+  }
+  backend_->AddOrUpdateSongs(collection_songs);
+
+  QElapsedTimer timer;
+  timer.start();
+  const SongList songs = LoadM3U(data);
+  const qint64 elapsed = timer.elapsed();
+
+  ASSERT_EQ(kPlaylistSize, songs.count());
+  for (int i = 0; i < kPlaylistSize; ++i) {
+    ASSERT_EQ(u"Title %1"_s.arg(i), songs[i].title());
+  }
+
+  RecordProperty("elapsed_ms", static_cast<int>(elapsed));
+
+}
+
+}  // namespace
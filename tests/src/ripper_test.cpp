@@ -0,0 +1,191 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <gst/gst.h>
+
+#include <QString>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test_utils.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "tagreader/tagreaderclient.h"
+#include "transcoder/transcoder.h"
+#include "ripper/ripper.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr int kTracks = 4;
+constexpr int kTimeout = 60000;
+
+// Stands in for the CD drive, each track is a short tone.
+GstElement *CreateFakeSource(const int track_number, const int buffers = 50) {
+
+  GstElement *source = gst_element_factory_make("audiotestsrc", nullptr);
+  g_object_set(source, "num-buffers", buffers, "freq", 220.0 * track_number, nullptr);
+  return source;
+
+}
+
+class RipperTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    gst_init(nullptr, nullptr);
+  }
+
+  void SetUp() override {
+
+    preset_ = Transcoder::PresetForFileType(Song::FileType::FLAC);
+    GstElementFactory *factory = gst_element_factory_find("flacenc");
+    if (!factory) {
+      GTEST_SKIP() << "No FLAC encoder installed.";
+    }
+    gst_object_unref(factory);
+    ASSERT_TRUE(output_dir_.isValid());
+    tagreader_client_ = make_shared<TagReaderClient>();
+
+  }
+
+  QString OutputFilename(const int track_number) const {
+    return output_dir_.filePath(u"Artist/Album/%1 - Track.flac"_s.arg(track_number, 2, 10, u'0'));
+  }
+
+  static Song TrackSong(const int track_number, const QString &title) {
+
+    Song song(Song::Source::CDDA);
+    song.set_track(track_number);
+    song.set_title(title);
+    song.set_artist(u"Artist"_s);
+    song.set_album(u"Album"_s);
+    return song;
+
+  }
+
+  TranscoderPreset preset_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QTemporaryDir output_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<TagReaderClient> tagreader_client_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(RipperTest, RipsTracksWithMetadataFromLookup) {
+
+  Ripper ripper(tagreader_client_);
+  ripper.set_source_factory([](const int track_number) { return CreateFakeSource(track_number); });
+  ripper.set_max_encoders(2);
+  for (int track_number = 1; track_number <= kTracks; ++track_number) {
+    ripper.AddTrack(TrackSong(track_number, u"Track %1"_s.arg(track_number)), OutputFilename(track_number), preset_);
+  }
+
+  bool finished = false;
+  SongList songs;
+  QObject::connect(&ripper, &Ripper::Finished, &ripper, [&finished, &songs](const SongList &ripped_songs) {
+    finished = true;
+    songs = ripped_songs;
+  });
+
+  ripper.Start();
+
+  // The lookup finishes while the disc is being read, the tags written at the end come from it.
+  SongList lookup_songs;
+  for (int track_number = 1; track_number <= kTracks; ++track_number) {
+    lookup_songs << TrackSong(track_number, u"Title %1"_s.arg(track_number));
+  }
+  ripper.SetTracksMetadata(lookup_songs);
+
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }, kTimeout));
+  ASSERT_EQ(kTracks, songs.count());
+
+  for (int track_number = 1; track_number <= kTracks; ++track_number) {
+    ASSERT_TRUE(QFile::exists(OutputFilename(track_number)));
+    Song song;
+    ASSERT_TRUE(tagreader_client_->ReadFileBlocking(OutputFilename(track_number), &song).success());
+    EXPECT_EQ(u"Title %1"_s.arg(track_number), song.title());
+    EXPECT_EQ(track_number, song.track());
+    EXPECT_EQ(u"Album"_s, song.album());
+    EXPECT_EQ(Song::FileType::FLAC, song.filetype());
+  }
+
+}
+
+TEST_F(RipperTest, UnreadableTrackIsSkipped) {
+
+  Ripper ripper(tagreader_client_);
+  ripper.set_source_factory([](const int track_number) { return track_number == 2 ? nullptr : CreateFakeSource(track_number); });
+  for (int track_number = 1; track_number <= 3; ++track_number) {
+    ripper.AddTrack(TrackSong(track_number, u"Track %1"_s.arg(track_number)), OutputFilename(track_number), preset_);
+  }
+
+  bool finished = false;
+  SongList songs;
+  QObject::connect(&ripper, &Ripper::Finished, &ripper, [&finished, &songs](const SongList &ripped_songs) {
+    finished = true;
+    songs = ripped_songs;
+  });
+
+  ripper.Start();
+
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }, kTimeout));
+  ASSERT_EQ(2, songs.count());
+  EXPECT_EQ(1, songs[0].track());
+  EXPECT_EQ(3, songs[1].track());
+  EXPECT_FALSE(QFile::exists(OutputFilename(2)));
+
+}
+
+TEST_F(RipperTest, CancelRemovesPartialOutput) {
+
+  Ripper ripper(tagreader_client_);
+  // The second track is long enough to still be encoding when the ripping is cancelled.
+  ripper.set_source_factory([](const int track_number) { return CreateFakeSource(track_number, track_number == 2 ? 10000 : 50); });
+  ripper.set_max_encoders(1);
+  for (int track_number = 1; track_number <= 2; ++track_number) {
+    ripper.AddTrack(TrackSong(track_number, u"Track %1"_s.arg(track_number)), OutputFilename(track_number), preset_);
+  }
+
+  bool finished = false;
+  bool cancelled = false;
+  int progress = 0;
+  QObject::connect(&ripper, &Ripper::Finished, &ripper, [&finished]() { finished = true; });
+  QObject::connect(&ripper, &Ripper::Cancelled, &ripper, [&cancelled]() { cancelled = true; });
+  QObject::connect(&ripper, &Ripper::Progress, &ripper, [&progress](const int percent) { progress = percent; });
+
+  ripper.Start();
+
+  // Both tracks are read and the first one is encoded.
+  ASSERT_TRUE(WaitFor([this, &progress]() { return progress >= 75 && QFile::exists(OutputFilename(2)); }, kTimeout));
+  ripper.Cancel();
+
+  EXPECT_TRUE(cancelled);
+  EXPECT_FALSE(ripper.running());
+  EXPECT_TRUE(QFile::exists(OutputFilename(1)));
+  EXPECT_FALSE(QFile::exists(OutputFilename(2)));
+
+  // Nothing that was still running finishes after cancelling.
+  EXPECT_FALSE(WaitFor([&finished]() { return finished; }, 1000));
+
+}
+
+}  // namespace
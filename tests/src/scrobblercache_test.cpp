@@ -0,0 +1,125 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <QStandardPaths>
+
+#include "core/song.h"
+#include "scrobbler/scrobblercache.h"
+#include "scrobbler/scrobblercacheitem.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+class ScrobblerCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    QStandardPaths::setTestModeEnabled(true);
+    const QString cache_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(cache_path);
+    filename_ = cache_path + u"/scrobblercache_test.json"_s;
+    RemoveFiles();
+  }
+
+  void TearDown() override {
+    RemoveFiles();
+  }
+
+  void RemoveFiles() const {
+    QFile::remove(filename_);
+    QFile::remove(filename_ + u".journal"_s);
+  }
+
+  static Song MakeSong(const QString &title) {
+    Song song;
+    song.set_artist(u"Artist"_s);
+    song.set_title(title);
+    song.set_length_nanosec(180000000000LL);
+    return song;
+  }
+
+  QString filename_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(ScrobblerCacheTest, JournalIsReplayed) {
+
+  {
+    ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+    cache.Add(MakeSong(u"Title 1"_s), 1000);
+    ScrobblerCacheItemPtr cache_item = cache.Add(MakeSong(u"Title 2"_s), 1001);
+    cache.Add(MakeSong(u"Title 3"_s), 1002);
+    cache.Flush(ScrobblerCacheItemPtrList() << cache_item);
+    ASSERT_EQ(cache.Count(), 2);
+    ASSERT_FALSE(QFile::exists(filename_));
+    ASSERT_TRUE(QFile::exists(filename_ + u".journal"_s));
+  }
+
+  // The journal is merged into the snapshot when the cache is read again.
+  ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+  ASSERT_EQ(cache.Count(), 2);
+  ASSERT_EQ(cache.List()[0]->metadata.title, u"Title 1"_s);
+  ASSERT_EQ(cache.List()[1]->metadata.title, u"Title 3"_s);
+  ASSERT_TRUE(QFile::exists(filename_));
+  ASSERT_FALSE(QFile::exists(filename_ + u".journal"_s));
+
+  // Scrobbles added after the snapshot keep unique IDs.
+  ScrobblerCacheItemPtr cache_item = cache.Add(MakeSong(u"Title 4"_s), 1003);
+  ASSERT_NE(cache_item->id, cache.List()[0]->id);
+  ASSERT_NE(cache_item->id, cache.List()[1]->id);
+
+}
+
+TEST_F(ScrobblerCacheTest, IgnoresIncompleteRecord) {
+
+  {
+    ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+    cache.Add(MakeSong(u"Title 1"_s), 1000);
+  }
+
+  QFile journal(filename_ + u".journal"_s);
+  ASSERT_TRUE(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+  journal.write("{\"op\":\"add\",\"id\":2,\"timestamp\":");
+  journal.close();
+
+  ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+  ASSERT_EQ(cache.Count(), 1);
+
+}
+
+TEST_F(ScrobblerCacheTest, EmptyCacheRemovesFiles) {
+
+  {
+    ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+    cache.Flush(ScrobblerCacheItemPtrList() << cache.Add(MakeSong(u"Title 1"_s), 1000));
+    ASSERT_EQ(cache.Count(), 0);
+  }
+
+  ScrobblerCache cache(u"scrobblercache_test.json"_s, nullptr);
+  ASSERT_EQ(cache.Count(), 0);
+  ASSERT_FALSE(QFile::exists(filename_));
+  ASSERT_FALSE(QFile::exists(filename_ + u".journal"_s));
+
+}
+
+}  // namespace
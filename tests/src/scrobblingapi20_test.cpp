@@ -0,0 +1,253 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QMap>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QStandardPaths>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/taskmanager.h"
+#include "core/networkaccessmanager.h"
+#include "scrobbler/scrobblersettingsservice.h"
+#include "scrobbler/scrobblingapi20.h"
+#include "scrobbler/scrobblercache.h"
+#include "scrobbler/scrobblercacheitem.h"
+
+#include "test_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+namespace {
+
+constexpr char kCacheFile[] = "scrobblingapi20_test.cache";
+constexpr int kResponseDelay = 1000;
+// The backlog is drained in several rounds of delayed replies.
+constexpr int kTimeout = 30000;
+
+// Answers track.scrobble requests like the Last.fm API, after a delay so requests overlap.
+class FakeScrobblingServer : public QTcpServer {
+ public:
+  explicit FakeScrobblingServer(const QString &limited_title) : limited_title_(limited_title), requests_(0), active_(0), max_active_(0) {
+
+    QObject::connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { ReadRequests(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+
+  }
+
+  QString url() const { return u"http://127.0.0.1:%1/2.0/"_s.arg(serverPort()); }
+  int requests() const { return requests_; }
+  int max_active() const { return max_active_; }
+
+ private:
+  void ReadRequests(QTcpSocket *socket) {
+
+    QByteArray &buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+
+    while (true) {
+      const qint64 header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) return;
+      qint64 content_length = 0;
+      const QList<QByteArray> header_lines = buffer.left(header_end).split('\n');
+      for (const QByteArray &line : header_lines) {
+        if (line.toLower().startsWith("content-length:")) {
+          content_length = line.mid(15).trimmed().toLongLong();
+        }
+      }
+      if (buffer.size() < header_end + 4 + content_length) return;
+      const QByteArray body = buffer.mid(header_end + 4, content_length);
+      buffer.remove(0, header_end + 4 + content_length);
+      HandleRequest(socket, body);
+    }
+
+  }
+
+  void HandleRequest(QTcpSocket *socket, const QByteArray &body) {
+
+    ++requests_;
+    ++active_;
+    max_active_ = std::max(max_active_, active_);
+
+    QMap<QString, QString> params;
+    const QList<QByteArray> pairs = body.split('&');
+    for (const QByteArray &pair : pairs) {
+      const qint64 pos = pair.indexOf('=');
+      if (pos < 0) continue;
+      params.insert(QUrl::fromPercentEncoding(pair.left(pos)), QUrl::fromPercentEncoding(pair.mid(pos + 1)));
+    }
+
+    QJsonArray array_scrobble;
+    int ignored = 0;
+    for (int i = 0; params.contains(u"track[%1]"_s.arg(i)); ++i) {
+      const QString title = params.value(u"track[%1]"_s.arg(i));
+      const bool limited = title == limited_title_;
+      if (limited) ++ignored;
+      QJsonObject obj_ignoredmessage;
+      obj_ignoredmessage.insert("code"_L1, limited ? "5"_L1 : "0"_L1);
+      obj_ignoredmessage.insert("#text"_L1, limited ? "Daily scrobble limit exceeded"_L1 : ""_L1);
+      QJsonObject obj_scrobble;
+      obj_scrobble.insert("artist"_L1, QJsonObject{{u"#text"_s, params.value(u"artist[%1]"_s.arg(i))}});
+      obj_scrobble.insert("album"_L1, QJsonObject{{u"#text"_s, QString()}});
+      obj_scrobble.insert("albumArtist"_L1, QJsonObject{{u"#text"_s, QString()}});
+      obj_scrobble.insert("track"_L1, QJsonObject{{u"#text"_s, title}});
+      obj_scrobble.insert("timestamp"_L1, params.value(u"timestamp[%1]"_s.arg(i)));
+      obj_scrobble.insert("ignoredMessage"_L1, obj_ignoredmessage);
+      array_scrobble.append(obj_scrobble);
+    }
+
+    QJsonObject obj_attr;
+    obj_attr.insert("accepted"_L1, static_cast<int>(array_scrobble.count()) - ignored);
+    obj_attr.insert("ignored"_L1, ignored);
+    QJsonObject obj_scrobbles;
+    obj_scrobbles.insert("@attr"_L1, obj_attr);
+    obj_scrobbles.insert("scrobble"_L1, array_scrobble);
+    QJsonObject json_obj;
+    json_obj.insert("scrobbles"_L1, obj_scrobbles);
+    const QByteArray data = QJsonDocument(json_obj).toJson(QJsonDocument::Compact);
+
+    QTimer::singleShot(kResponseDelay, socket, [this, socket, data]() {
+      --active_;
+      socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(data.size()) + "\r\n\r\n" + data);
+    });
+
+  }
+
+  const QString limited_title_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  int requests_;
+  int active_;
+  int max_active_;
+};
+
+class TestScrobbler : public ScrobblingAPI20 {
+ public:
+  explicit TestScrobbler(const QString &api_url, const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network)
+      : ScrobblingAPI20(u"Test"_s, u"ScrobblingAPI20Test"_s, QString(), api_url, true, QLatin1String(kCacheFile), make_shared<ScrobblerSettingsService>(), task_manager, network) {
+
+    enabled_ = true;
+    username_ = u"user"_s;
+    session_key_ = u"session"_s;
+
+  }
+
+  ScrobblerCache *cache() const { return cache_; }
+};
+
+class ScrobblingAPI20Test : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    QStandardPaths::setTestModeEnabled(true);
+    const QString cache_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(cache_path);
+    filename_ = cache_path + u'/' + QLatin1String(kCacheFile);
+    RemoveFiles();
+    task_manager_ = make_shared<TaskManager>();
+    network_ = make_shared<NetworkAccessManager>();
+  }
+
+  void TearDown() override {
+    RemoveFiles();
+  }
+
+  void RemoveFiles() const {
+    QFile::remove(filename_);
+    QFile::remove(filename_ + u".journal"_s);
+  }
+
+  static void AddScrobbles(ScrobblerCache *cache, const int count) {
+    for (int i = 0; i < count; ++i) {
+      Song song;
+      song.set_artist(u"Artist"_s);
+      song.set_title(u"Title %1"_s.arg(i));
+      song.set_length_nanosec(180000000000LL);
+      cache->Add(song, 1700000000ULL + static_cast<quint64>(i) * 180ULL);
+    }
+  }
+
+  QString filename_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<TaskManager> task_manager_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<NetworkAccessManager> network_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(ScrobblingAPI20Test, SubmitsSmallCacheInOneRequest) {
+
+  FakeScrobblingServer server(QString());
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  TestScrobbler scrobbler(server.url(), task_manager_, network_);
+  AddScrobbles(scrobbler.cache(), 10);
+  scrobbler.Submit();
+  ASSERT_TRUE(task_manager_->GetTasks().isEmpty());
+
+  ASSERT_TRUE(WaitFor([&scrobbler]() { return scrobbler.cache()->Count() == 0; }, kTimeout));
+  ASSERT_EQ(server.requests(), 1);
+
+}
+
+TEST_F(ScrobblingAPI20Test, DrainsBacklogWithParallelRequests) {
+
+  // The last scrobble is ignored because of the daily limit, only it should stay in the cache.
+  FakeScrobblingServer server(u"Title 399"_s);
+  ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+
+  TestScrobbler scrobbler(server.url(), task_manager_, network_);
+  AddScrobbles(scrobbler.cache(), 400);
+  scrobbler.Submit();
+  ASSERT_EQ(task_manager_->GetTasks().count(), 1);
+
+  ASSERT_TRUE(WaitFor([&server, &scrobbler]() { return server.requests() == 8 && !scrobbler.submitted(); }, kTimeout));
+  ASSERT_GT(server.max_active(), 1);
+  ASSERT_LE(server.max_active(), 4);
+
+  ASSERT_EQ(scrobbler.cache()->Count(), 1);
+  ASSERT_EQ(scrobbler.cache()->List().first()->metadata.title, u"Title 399"_s);
+  ASSERT_FALSE(scrobbler.cache()->List().first()->sent);
+
+  const QList<TaskManager::Task> tasks = task_manager_->GetTasks();
+  ASSERT_EQ(tasks.count(), 1);
+  ASSERT_EQ(tasks.first().progress, 399ULL);
+  ASSERT_EQ(tasks.first().progress_max, 400ULL);
+
+}
+
+}  // namespace
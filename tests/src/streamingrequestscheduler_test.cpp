@@ -0,0 +1,262 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QTimer>
+#include <QDateTime>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "test_utils.h"
+#include "streaming/streamingrequestscheduler.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Answers with the HTTP code from the status parameter for the first failures requests to a path, and with 200 after that.
+// A failures parameter of -1 fails every request, retry_after is sent as the Retry-After header and delay holds back the reply.
+class FakeServer : public QTcpServer {
+ public:
+  explicit FakeServer() : requests_(0), active_(0), max_active_(0) {
+
+    QObject::connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { ReadRequests(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+
+  }
+
+  QUrl url(const QString &path, const int status = 200, const int failures = 0, const QString &retry_after = QString(), const int delay = 0) const {
+
+    QUrlQuery url_query;
+    url_query.addQueryItem(u"status"_s, QString::number(status));
+    url_query.addQueryItem(u"failures"_s, QString::number(failures));
+    if (!retry_after.isNull()) url_query.addQueryItem(u"retry_after"_s, retry_after);
+    url_query.addQueryItem(u"delay"_s, QString::number(delay));
+    QUrl url(u"http://127.0.0.1:%1%2"_s.arg(serverPort()).arg(path));
+    url.setQuery(url_query);
+    return url;
+
+  }
+
+  int requests() const { return requests_; }
+  int requests(const QString &path) const { return path_requests_.value(path); }
+  int max_active() const { return max_active_; }
+
+ private:
+  void ReadRequests(QTcpSocket *socket) {
+
+    QByteArray &buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+
+    while (true) {
+      const qint64 header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) return;
+      const QByteArray request_line = buffer.left(buffer.indexOf("\r\n"));
+      buffer.remove(0, header_end + 4);
+      const QList<QByteArray> parts = request_line.split(' ');
+      if (parts.count() < 2) continue;
+      HandleRequest(socket, QUrl(QString::fromLatin1(parts[1])));
+    }
+
+  }
+
+  void HandleRequest(QTcpSocket *socket, const QUrl &url) {
+
+    const QUrlQuery url_query(url);
+    const int hits = path_requests_[url.path()]++;
+    const int failures = url_query.queryItemValue(u"failures"_s).toInt();
+    const int status = failures < 0 || hits < failures ? url_query.queryItemValue(u"status"_s).toInt() : 200;
+
+    QByteArray headers = "HTTP/1.1 " + QByteArray::number(status) + " Status\r\nContent-Length: 0\r\n";
+    if (status != 200 && url_query.hasQueryItem(u"retry_after"_s)) {
+      headers += "Retry-After: " + url_query.queryItemValue(u"retry_after"_s).toLatin1() + "\r\n";
+    }
+    headers += "\r\n";
+
+    ++requests_;
+    ++active_;
+    max_active_ = std::max(max_active_, active_);
+    QTimer::singleShot(url_query.queryItemValue(u"delay"_s).toInt(), socket, [this, socket, headers]() {
+      --active_;
+      socket->write(headers);
+    });
+
+  }
+
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  QHash<QString, int> path_requests_;
+  int requests_;
+  int active_;
+  int max_active_;
+};
+
+class StreamingRequestSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(server_.listen(QHostAddress::LocalHost));
+    scheduler_.AddEndpoint(u"albums"_s, 2, 4);
+  }
+
+  // Queues a request and records the HTTP code it finished with in results_.
+  void Queue(const QUrl &url, const QString &endpoint = u"albums"_s) {
+
+    scheduler_.Queue(endpoint, &context_, [this, url]() { return network_.get(QNetworkRequest(url)); }, [this, url](QNetworkReply *reply) {
+      results_.insert(url.path(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+      reply->deleteLater();
+    });
+
+  }
+
+  FakeServer server_;
+  QNetworkAccessManager network_;
+  StreamingRequestScheduler scheduler_;
+  QObject context_;
+  QHash<QString, int> results_;
+};
+
+TEST_F(StreamingRequestSchedulerTest, LimitsActiveRequests) {
+
+  for (int i = 0; i < 4; ++i) {
+    Queue(server_.url(u"/album%1"_s.arg(i), 200, 0, QString(), 200));
+  }
+  ASSERT_EQ(scheduler_.active(u"albums"_s), 2);
+  ASSERT_EQ(scheduler_.queued(u"albums"_s), 2);
+  ASSERT_FALSE(scheduler_.CanStart(u"albums"_s));
+
+  ASSERT_TRUE(WaitFor([this]() { return results_.count() == 4; }));
+  ASSERT_EQ(server_.max_active(), 2);
+  ASSERT_EQ(scheduler_.active(u"albums"_s), 0);
+  ASSERT_EQ(scheduler_.queued(u"albums"_s), 0);
+
+}
+
+TEST_F(StreamingRequestSchedulerTest, IncreasesConcurrency) {
+
+  // Replies with a steady latency, so every reply counts as fast.
+  for (int i = 0; i < 20; ++i) {
+    Queue(server_.url(u"/album%1"_s.arg(i), 200, 0, QString(), 100));
+  }
+
+  ASSERT_TRUE(WaitFor([this]() { return results_.count() == 20; }));
+  ASSERT_DOUBLE_EQ(scheduler_.concurrency(u"albums"_s), 4.0);
+
+  const QList<int> histogram = scheduler_.latency_histogram(u"albums"_s);
+  ASSERT_EQ(histogram.count(), StreamingRequestScheduler::kLatencyBuckets.count() + 1);
+  ASSERT_EQ(std::accumulate(histogram.begin(), histogram.end(), 0), 20);
+
+}
+
+TEST_F(StreamingRequestSchedulerTest, ThrottledRequestIsSentAgain) {
+
+  Queue(server_.url(u"/album"_s, 503, 1, u"0"_s));
+
+  ASSERT_TRUE(WaitFor([this]() { return results_.count() == 1; }));
+  ASSERT_EQ(results_.value(u"/album"_s), 200);
+  ASSERT_EQ(server_.requests(u"/album"_s), 2);
+
+}
+
+TEST_F(StreamingRequestSchedulerTest, RetriesAreCountedPerRequest) {
+
+  // A request that always fails uses up only its own retries, the other request still succeeds after being throttled as often.
+  Queue(server_.url(u"/failing"_s, 429, -1, u"0"_s));
+  Queue(server_.url(u"/throttled"_s, 429, 3, u"0"_s));
+
+  ASSERT_TRUE(WaitFor([this]() { return results_.count() == 2; }));
+  ASSERT_EQ(results_.value(u"/failing"_s), 429);
+  ASSERT_EQ(server_.requests(u"/failing"_s), 4);
+  ASSERT_EQ(results_.value(u"/throttled"_s), 200);
+  ASSERT_EQ(server_.requests(u"/throttled"_s), 4);
+
+}
+
+TEST_F(StreamingRequestSchedulerTest, ThrottledEndpointWaitsForRetryAfter) {
+
+  Queue(server_.url(u"/album1"_s, 429, 1, u"30"_s));
+  Queue(server_.url(u"/album2"_s, 200, 0, QString(), 500));
+
+  ASSERT_TRUE(WaitFor([this]() { return server_.requests(u"/album1"_s) == 1 && results_.contains(u"/album2"_s); }));
+
+  ASSERT_FALSE(scheduler_.CanStart(u"albums"_s));
+  ASSERT_GT(scheduler_.BlockedFor(u"albums"_s), 28000);
+  ASSERT_LE(scheduler_.BlockedFor(u"albums"_s), 30000);
+  ASSERT_DOUBLE_EQ(scheduler_.concurrency(u"albums"_s), 1.0);
+  ASSERT_EQ(scheduler_.queued(u"albums"_s), 1);
+  ASSERT_FALSE(results_.contains(u"/album1"_s));
+
+  // Other endpoints of the same service are not throttled.
+  ASSERT_TRUE(scheduler_.CanStart(u"songs"_s));
+
+  scheduler_.Abort(&context_);
+  ASSERT_EQ(scheduler_.queued(u"albums"_s), 0);
+
+}
+
+TEST_F(StreamingRequestSchedulerTest, AbortDropsRequestsOfContext) {
+
+  for (int i = 0; i < 3; ++i) {
+    Queue(server_.url(u"/album%1"_s.arg(i), 200, 0, QString(), 1000));
+  }
+  ASSERT_EQ(scheduler_.active(u"albums"_s), 2);
+
+  scheduler_.Abort(&context_);
+  ASSERT_EQ(scheduler_.active(u"albums"_s), 0);
+  ASSERT_EQ(scheduler_.queued(u"albums"_s), 0);
+
+  ASSERT_FALSE(WaitFor([this]() { return !results_.isEmpty(); }, 1500));
+
+}
+
+TEST(StreamingRequestSchedulerParseTest, ParseRetryAfter) {
+
+  ASSERT_EQ(StreamingRequestScheduler::ParseRetryAfter(""), 0);
+  ASSERT_EQ(StreamingRequestScheduler::ParseRetryAfter("120"), 120000);
+  ASSERT_EQ(StreamingRequestScheduler::ParseRetryAfter(" 5 "), 5000);
+  ASSERT_EQ(StreamingRequestScheduler::ParseRetryAfter("invalid"), 0);
+
+  const QDateTime datetime = QDateTime::currentDateTimeUtc().addSecs(60);
+  const qint64 delay = StreamingRequestScheduler::ParseRetryAfter(datetime.toString(Qt::RFC2822Date).toLatin1());
+  ASSERT_GT(delay, 58000);
+  ASSERT_LE(delay, 60000);
+
+  ASSERT_EQ(StreamingRequestScheduler::ParseRetryAfter(QDateTime::currentDateTimeUtc().addSecs(-60).toString(Qt::RFC2822Date).toLatin1()), 0);
+
+}
+
+}  // namespace
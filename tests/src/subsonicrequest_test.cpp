@@ -0,0 +1,321 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QDateTime>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "includes/scoped_ptr.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/settings.h"
+#include "core/taskmanager.h"
+#include "core/memorydatabase.h"
+#include "core/urlhandlers.h"
+#include "tagreader/tagreaderclient.h"
+#include "covermanager/albumcoverloader.h"
+#include "constants/subsonicsettings.h"
+#include "subsonic/subsonicservice.h"
+#include "subsonic/subsonicurlhandler.h"
+#include "subsonic/subsonicrequest.h"
+#include "test_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+using std::make_unique;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr qint64 kLastSync = 1000;
+
+// Answers getIndexes, getAlbumList2 and getAlbum like a Subsonic server with one song per album.
+class FakeSubsonicServer : public QTcpServer {
+ public:
+  explicit FakeSubsonicServer() : last_modified_(0) {
+
+    QObject::connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { ReadRequests(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+
+  }
+
+  QUrl url() const { return QUrl(u"http://127.0.0.1:%1"_s.arg(serverPort())); }
+
+  void set_last_modified(const qint64 last_modified) { last_modified_ = last_modified; }
+  void AddAlbum(const QString &album_id, const QString &changed) { albums_.insert(album_id, changed); }
+
+  int requests(const QString &resource) const { return requests_.value(resource); }
+  QString if_modified_since() const { return if_modified_since_; }
+  QSet<QString> requested_albums() const { return requested_albums_; }
+
+ private:
+  void ReadRequests(QTcpSocket *socket) {
+
+    QByteArray &buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+
+    while (true) {
+      const qint64 header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) return;
+      const QByteArray request_line = buffer.left(buffer.indexOf("\r\n"));
+      buffer.remove(0, header_end + 4);
+      const QList<QByteArray> parts = request_line.split(' ');
+      if (parts.count() < 2) continue;
+      HandleRequest(socket, QUrl(QString::fromLatin1(parts[1])));
+    }
+
+  }
+
+  void HandleRequest(QTcpSocket *socket, const QUrl &url) {
+
+    QString resource = url.path().section(u'/', -1);
+    resource.chop(5);  // .view
+    requests_[resource]++;
+
+    const QUrlQuery url_query(url);
+    QJsonObject json_response;
+    json_response.insert("status"_L1, "ok"_L1);
+    json_response.insert("version"_L1, "1.16.1"_L1);
+
+    if (resource == "getIndexes"_L1) {
+      if_modified_since_ = url_query.queryItemValue(u"ifModifiedSince"_s);
+      json_response.insert("indexes"_L1, QJsonObject{{u"lastModified"_s, last_modified_}, {u"index"_s, QJsonArray()}});
+    }
+    else if (resource == "getAlbumList2"_L1) {
+      QJsonArray array_albums;
+      if (url_query.queryItemValue(u"offset"_s).toInt() == 0) {
+        for (QMap<QString, QString>::const_iterator it = albums_.constBegin(); it != albums_.constEnd(); ++it) {
+          array_albums.append(AlbumObject(it.key(), it.value()));
+        }
+      }
+      json_response.insert("albumList2"_L1, QJsonObject{{u"album"_s, array_albums}});
+    }
+    else if (resource == "getAlbum"_L1) {
+      const QString album_id = url_query.queryItemValue(u"id"_s);
+      requested_albums_.insert(album_id);
+      QJsonObject obj_song;
+      obj_song.insert("id"_L1, album_id + "-1"_L1);
+      obj_song.insert("title"_L1, "Title"_L1);
+      obj_song.insert("album"_L1, album_id);
+      obj_song.insert("albumId"_L1, album_id);
+      obj_song.insert("artist"_L1, "Artist"_L1);
+      obj_song.insert("track"_L1, 1);
+      obj_song.insert("size"_L1, 1000);
+      obj_song.insert("suffix"_L1, "mp3"_L1);
+      obj_song.insert("duration"_L1, 180);
+      obj_song.insert("type"_L1, "music"_L1);
+      QJsonObject obj_album = AlbumObject(album_id, albums_.value(album_id));
+      obj_album.insert("song"_L1, QJsonArray() << obj_song);
+      json_response.insert("album"_L1, obj_album);
+    }
+
+    const QByteArray data = QJsonDocument(QJsonObject{{u"subsonic-response"_s, json_response}}).toJson(QJsonDocument::Compact);
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(data.size()) + "\r\n\r\n" + data);
+
+  }
+
+  static QJsonObject AlbumObject(const QString &album_id, const QString &changed) {
+
+    QJsonObject obj_album;
+    obj_album.insert("id"_L1, album_id);
+    obj_album.insert("name"_L1, album_id);
+    obj_album.insert("artist"_L1, "Artist"_L1);
+    obj_album.insert("created"_L1, "2020-01-01T00:00:00Z"_L1);
+    obj_album.insert("changed"_L1, changed);
+    return obj_album;
+
+  }
+
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  qint64 last_modified_;
+  QMap<QString, QString> albums_;
+  QMap<QString, int> requests_;
+  QString if_modified_since_;
+  QSet<QString> requested_albums_;
+};
+
+class SubsonicRequestTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+
+    ASSERT_TRUE(server_.listen(QHostAddress::LocalHost));
+
+    // Keep the settings of the service out of the users configuration.
+    ASSERT_TRUE(settings_dir_.isValid());
+    QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, settings_dir_.path());
+    {
+      Settings s;
+      s.beginGroup(SubsonicSettings::kSettingsGroup);
+      s.setValue(SubsonicSettings::kUrl, server_.url());
+      s.setValue(SubsonicSettings::kUsername, u"user"_s);
+      s.setValue(SubsonicSettings::kPassword, QByteArray("password").toBase64());
+      s.setValue(SubsonicSettings::kAuthMethod, static_cast<int>(SubsonicSettings::AuthMethod::Hex));
+      s.setValue(SubsonicSettings::kDownloadAlbumCovers, false);
+      s.endGroup();
+    }
+
+    task_manager_ = make_shared<TaskManager>();
+    database_ = make_shared<MemoryDatabase>(task_manager_);
+    service_ = make_unique<SubsonicService>(task_manager_, database_, make_shared<UrlHandlers>(), make_shared<AlbumCoverLoader>(make_shared<TagReaderClient>()));
+    request_ = make_unique<SubsonicRequest>(&*service_, new SubsonicUrlHandler(&*service_));
+
+  }
+
+  void TearDown() override {
+    request_.reset();
+    service_.reset();
+  }
+
+  static qint64 Timestamp(const QString &datetime) {
+    return QDateTime::fromString(datetime, Qt::ISODate).toSecsSinceEpoch();
+  }
+
+  FakeSubsonicServer server_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QTemporaryDir settings_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<TaskManager> task_manager_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<SubsonicService> service_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<SubsonicRequest> request_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(SubsonicRequestTest, UnmodifiedCollectionIsNotRequested) {
+
+  server_.set_last_modified(kLastSync);
+  server_.AddAlbum(u"album1"_s, u"2026-01-01T00:00:00Z"_s);
+
+  bool finished = false;
+  QString error;
+  QObject::connect(&*request_, &SubsonicRequest::SyncFinished, &*request_, [&finished, &error](const QString &sync_error) {
+    finished = true;
+    error = sync_error;
+  });
+
+  QMap<QString, qint64> album_mtimes;
+  album_mtimes.insert(u"album1"_s, Timestamp(u"2026-01-01T00:00:00Z"_s));
+  request_->GetAlbumsIncremental(kLastSync, album_mtimes);
+
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }));
+  EXPECT_TRUE(error.isEmpty());
+  EXPECT_EQ(QString::number(kLastSync), server_.if_modified_since());
+  EXPECT_EQ(1, server_.requests(u"getIndexes"_s));
+  EXPECT_EQ(0, server_.requests(u"getAlbumList2"_s));
+  EXPECT_EQ(0, server_.requests(u"getAlbum"_s));
+
+}
+
+TEST_F(SubsonicRequestTest, OnlyChangedAlbumsAreRequested) {
+
+  server_.set_last_modified(kLastSync + 1000);
+  server_.AddAlbum(u"album1"_s, u"2026-01-01T00:00:00Z"_s);
+  server_.AddAlbum(u"album2"_s, u"2026-02-01T00:00:00Z"_s);
+  server_.AddAlbum(u"album3"_s, u"2026-03-01T00:00:00Z"_s);
+
+  bool finished = false;
+  QString error;
+  QStringList synced_album_ids;
+  SongMap synced_songs;
+  QObject::connect(&*request_, &SubsonicRequest::SongsSynced, &*request_, [&synced_album_ids, &synced_songs](const QStringList &album_ids, const SongMap &songs) {
+    synced_album_ids << album_ids;
+    synced_songs.insert(songs);
+  });
+  QObject::connect(&*request_, &SubsonicRequest::SyncFinished, &*request_, [&finished, &error](const QString &sync_error) {
+    finished = true;
+    error = sync_error;
+  });
+
+  // album2 changed on the server, album3 is new and album4 was removed.
+  QMap<QString, qint64> album_mtimes;
+  album_mtimes.insert(u"album1"_s, Timestamp(u"2026-01-01T00:00:00Z"_s));
+  album_mtimes.insert(u"album2"_s, Timestamp(u"2025-12-01T00:00:00Z"_s));
+  album_mtimes.insert(u"album4"_s, Timestamp(u"2025-12-01T00:00:00Z"_s));
+  request_->GetAlbumsIncremental(kLastSync, album_mtimes);
+
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }));
+  EXPECT_TRUE(error.isEmpty());
+  EXPECT_EQ(kLastSync + 1000, request_->last_modified());
+  EXPECT_EQ(1, server_.requests(u"getAlbumList2"_s));
+  EXPECT_EQ(2, server_.requests(u"getAlbum"_s));
+  EXPECT_EQ(QSet<QString>({u"album2"_s, u"album3"_s}), server_.requested_albums());
+
+  EXPECT_EQ(3, synced_album_ids.count());
+  EXPECT_TRUE(synced_album_ids.contains(u"album2"_s));
+  EXPECT_TRUE(synced_album_ids.contains(u"album3"_s));
+  EXPECT_TRUE(synced_album_ids.contains(u"album4"_s));
+  ASSERT_EQ(2, synced_songs.count());
+  EXPECT_EQ(Timestamp(u"2026-02-01T00:00:00Z"_s), synced_songs.value(u"album2-1"_s).mtime());
+  EXPECT_EQ(Timestamp(u"2026-03-01T00:00:00Z"_s), synced_songs.value(u"album3-1"_s).mtime());
+
+}
+
+TEST_F(SubsonicRequestTest, FullSyncRequestsAllAlbums) {
+
+  server_.set_last_modified(kLastSync);
+  server_.AddAlbum(u"album1"_s, u"2026-01-01T00:00:00Z"_s);
+  server_.AddAlbum(u"album2"_s, u"2026-02-01T00:00:00Z"_s);
+  server_.AddAlbum(u"album3"_s, u"2026-03-01T00:00:00Z"_s);
+
+  bool finished = false;
+  QString error;
+  SongMap songs;
+  QObject::connect(&*request_, &SubsonicRequest::Results, &*request_, [&finished, &error, &songs](const SongMap &result_songs, const QString &result_error) {
+    finished = true;
+    error = result_error;
+    songs = result_songs;
+  });
+
+  request_->GetAlbums();
+
+  ASSERT_TRUE(WaitFor([&finished]() { return finished; }));
+  EXPECT_TRUE(error.isEmpty());
+  EXPECT_EQ(kLastSync, request_->last_modified());
+  EXPECT_EQ(3, server_.requests(u"getAlbum"_s));
+  ASSERT_EQ(3, songs.count());
+  for (const Song &song : std::as_const(songs)) {
+    EXPECT_TRUE(song.is_valid());
+    EXPECT_EQ(Song::Source::Subsonic, song.source());
+  }
+
+}
+
+}  // namespace
@@ -0,0 +1,209 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QTemporaryDir>
+
+#include "test_utils.h"
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionlibrary.h"
+#include "playlist/playlist.h"
+#include "playlist/tagcompletionindex.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+TEST(TagCompletionModelTest, SetValuesSortsCaseInsensitively) {
+
+  TagCompletionModel model;
+  model.SetValues(QStringList() << u"beta"_s << u"Gamma"_s << u"Alpha"_s);
+
+  ASSERT_EQ(model.stringList(), QStringList() << u"Alpha"_s << u"beta"_s << u"Gamma"_s);
+
+}
+
+TEST(TagCompletionModelTest, AddValueKeepsOrder) {
+
+  TagCompletionModel model;
+  model.SetValues(QStringList() << u"Alpha"_s << u"Gamma"_s);
+
+  model.AddValue(u"beta"_s);
+  model.AddValue(u"Zeta"_s);
+  model.AddValue(u"aardvark"_s);
+
+  ASSERT_EQ(model.stringList(), QStringList() << u"aardvark"_s << u"Alpha"_s << u"beta"_s << u"Gamma"_s << u"Zeta"_s);
+
+}
+
+TEST(TagCompletionModelTest, RemoveValueMatchesCase) {
+
+  TagCompletionModel model;
+  model.SetValues(QStringList() << u"ABBA"_s << u"Beatles"_s << u"abba"_s);
+
+  model.RemoveValue(u"Abba"_s);
+  ASSERT_EQ(model.stringList().count(), 3);
+
+  model.RemoveValue(u"abba"_s);
+  ASSERT_EQ(model.stringList(), QStringList() << u"ABBA"_s << u"Beatles"_s);
+
+  model.RemoveValue(u"Beatles"_s);
+  ASSERT_EQ(model.stringList(), QStringList() << u"ABBA"_s);
+
+}
+
+class TagCompletionIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The index loads in another thread, so it needs a database file rather than a per connection memory database.
+    ASSERT_TRUE(dir_.isValid());
+    database_ = make_shared<Database>(nullptr, nullptr, dir_.filePath(u"strawberry.db"_s));
+    backend_ = make_shared<CollectionBackend>();
+    backend_->Init(database_, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend_->AddDirectory(u"/music"_s);
+  }
+
+  void TearDown() override {
+    index_.reset();
+    backend_.reset();
+    database_->Close();
+  }
+
+  static Song MakeSong(const QString &filename, const QString &artist, const QString &genre = QString()) {
+
+    Song song(Song::Source::Collection);
+    song.set_directory_id(1);
+    song.set_title(filename);
+    song.set_artist(artist);
+    song.set_genre(genre);
+    song.set_url(QUrl::fromLocalFile(u"/music/"_s + filename));
+    song.set_length_nanosec(kNsecPerSec);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+    return song;
+
+  }
+
+  void CreateIndex() {
+    index_.reset(new TagCompletionIndex(backend_));
+    ASSERT_TRUE(WaitFor([this]() { return index_->is_loaded(); }));
+  }
+
+  Song CollectionSong(const QString &filename) const {
+    return backend_->GetSongByUrl(QUrl::fromLocalFile(u"/music/"_s + filename));
+  }
+
+  QStringList Values(const Playlist::Column column) const {
+    return index_->model(column)->stringList();
+  }
+
+  QTemporaryDir dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<CollectionBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<TagCompletionIndex> index_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(TagCompletionIndexTest, LoadsExistingSongs) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Beatles"_s, u"Rock"_s) << MakeSong(u"2.flac"_s, u"ABBA"_s, u"Pop"_s) << MakeSong(u"3.flac"_s, u"Beatles"_s));
+
+  CreateIndex();
+
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s << u"Beatles"_s);
+  ASSERT_EQ(Values(Playlist::Column::Genre), QStringList() << u"Pop"_s << u"Rock"_s);
+  ASSERT_TRUE(Values(Playlist::Column::Composer).isEmpty());
+  ASSERT_EQ(index_->model(Playlist::Column::Title), nullptr);
+
+}
+
+TEST_F(TagCompletionIndexTest, AddsNewValues) {
+
+  CreateIndex();
+  ASSERT_TRUE(Values(Playlist::Column::Artist).isEmpty());
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Beatles"_s) << MakeSong(u"2.flac"_s, u"Beatles"_s));
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"Beatles"_s);
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"3.flac"_s, u"ABBA"_s));
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s << u"Beatles"_s);
+
+}
+
+TEST_F(TagCompletionIndexTest, ChangedSongKeepsSharedValue) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Beatles"_s) << MakeSong(u"2.flac"_s, u"Beatles"_s));
+  CreateIndex();
+
+  Song song = CollectionSong(u"1.flac"_s);
+  ASSERT_NE(song.id(), -1);
+  song.set_artist(u"ABBA"_s);
+  backend_->AddOrUpdateSongs(SongList() << song);
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s << u"Beatles"_s);
+
+  song = CollectionSong(u"2.flac"_s);
+  song.set_artist(u"ABBA"_s);
+  backend_->AddOrUpdateSongs(SongList() << song);
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s);
+
+}
+
+TEST_F(TagCompletionIndexTest, DeletedSongsRemoveUnusedValues) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Beatles"_s) << MakeSong(u"2.flac"_s, u"Beatles"_s) << MakeSong(u"3.flac"_s, u"ABBA"_s));
+  CreateIndex();
+
+  backend_->DeleteSongs(SongList() << CollectionSong(u"1.flac"_s));
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s << u"Beatles"_s);
+
+  backend_->DeleteSongs(SongList() << CollectionSong(u"2.flac"_s));
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s);
+
+  backend_->MarkSongsUnavailable(SongList() << CollectionSong(u"3.flac"_s));
+  ASSERT_TRUE(Values(Playlist::Column::Artist).isEmpty());
+
+}
+
+TEST_F(TagCompletionIndexTest, ValuesDifferingInCaseAreCountedSeparately) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"ABBA"_s) << MakeSong(u"2.flac"_s, u"abba"_s));
+  CreateIndex();
+  ASSERT_EQ(Values(Playlist::Column::Artist).count(), 2);
+
+  backend_->DeleteSongs(SongList() << CollectionSong(u"2.flac"_s));
+  ASSERT_EQ(Values(Playlist::Column::Artist), QStringList() << u"ABBA"_s);
+
+}
+
+}  // namespace
@@ -28,6 +28,9 @@
 #include <QCryptographicHash>
 #include <QThread>
 #include <QEventLoop>
+#include <QBuffer>
+#include <QImage>
+#include <QColor>
 
 #include "core/logging.h"
 #include "core/song.h"
@@ -121,9 +124,9 @@ class TagReaderTest : public ::testing::Test {
 
   }
 
-  QImage ReadCoverFromFile(const QString &filename) const {
+  QImage ReadCoverFromFile(const QString &filename, const QString &album_key = QString()) const {
 
-    TagReaderLoadCoverImageReplyPtr reply = tagreader_client_->LoadCoverImageAsync(filename);
+    TagReaderLoadCoverImageReplyPtr reply = tagreader_client_->LoadCoverImageAsync(filename, album_key);
     QEventLoop loop;
     QObject::connect(&*reply, &TagReaderLoadCoverImageReply::Finished, &loop, &QEventLoop::quit);
     loop.exec();
@@ -2430,4 +2433,44 @@ TEST_F(TagReaderTest, TestMP4AudioFileCover) {
 
 }
 
+TEST_F(TagReaderTest, TestEmbeddedCoverCache) {
+
+  TemporaryResource r1(u":/audio/strawberry.flac"_s);
+  TemporaryResource r2(u":/audio/strawberry.flac"_s);
+  const QString album_key = u"Strawberry|Strawberry"_s;
+  const QString cover_filename = u":/pictures/strawberry.png"_s;
+
+  QImage original_image;
+  EXPECT_TRUE(original_image.load(cover_filename));
+
+  EXPECT_TRUE(WriteCoverToFile(r1.fileName(), cover_filename).success());
+
+  {  // The second file has no cover, it must not get the cover of another track of the album.
+    EXPECT_EQ(ReadCoverFromFile(r1.fileName(), album_key), original_image);
+    EXPECT_TRUE(ReadCoverFromFile(r2.fileName(), album_key).isNull());
+  }
+
+  {  // Once read, both files with the same cover are served from the cache.
+    EXPECT_TRUE(WriteCoverToFile(r2.fileName(), cover_filename).success());
+    EXPECT_EQ(ReadCoverFromFile(r2.fileName(), album_key), original_image);
+    EXPECT_EQ(ReadCoverFromFile(r1.fileName(), album_key), original_image);
+    EXPECT_EQ(ReadCoverFromFile(r2.fileName(), album_key), original_image);
+  }
+
+  {  // Saving a new cover must invalidate the cached one.
+    QImage red_image(16, 16, QImage::Format_RGB32);
+    red_image.fill(Qt::red);
+    QByteArray red_image_data;
+    QBuffer buffer(&red_image_data);
+    buffer.open(QIODevice::WriteOnly);
+    red_image.save(&buffer, "PNG");
+    buffer.close();
+    EXPECT_TRUE(WriteCoverToFile(r1.fileName(), SaveTagCoverData(red_image_data, u"image/png"_s)).success());
+    const QImage new_image = ReadCoverFromFile(r1.fileName(), album_key);
+    EXPECT_FALSE(new_image.isNull());
+    EXPECT_EQ(new_image.pixelColor(0, 0), QColor(Qt::red));
+  }
+
+}
+
 }  // namespace
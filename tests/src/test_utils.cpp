@@ -27,6 +27,8 @@
 #include <QVariant>
 #include <QString>
 #include <QUrl>
+#include <QTimer>
+#include <QEventLoop>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -62,6 +64,20 @@ void PrintTo(const ::QUrl &url, std::ostream &os) {
   os << url.toString().toStdString();
 }
 
+bool WaitFor(const std::function<bool()> &done, const int timeout_msec) {
+
+  QEventLoop loop;
+  QTimer timer;
+  QObject::connect(&timer, &QTimer::timeout, &loop, [&loop, &done]() {
+    if (done()) loop.quit();
+  });
+  timer.start(20);
+  QTimer::singleShot(timeout_msec, &loop, &QEventLoop::quit);
+  loop.exec();
+  return done();
+
+}
+
 TemporaryResource::TemporaryResource(const QString &filename, QObject *parent) : QTemporaryFile(parent) {
 
   setFileTemplate(QDir::tempPath() + u"/strawberry_test-XXXXXX."_s + filename.section(u'.', -1, -1));
@@ -22,6 +22,7 @@
 #define TEST_UTILS_H
 
 #include <iostream>
+#include <functional>
 
 #include <QMetaType>
 #include <QModelIndex>
@@ -51,6 +52,9 @@ void PrintTo(const ::QString& str, std::ostream& os);
 void PrintTo(const ::QVariant& var, std::ostream& os);
 void PrintTo(const ::QUrl& url, std::ostream& os);
 
+// Runs an event loop until done returns true or the timeout expires, returns the last result of done.
+bool WaitFor(const std::function<bool()> &done, const int timeout_msec = 15000);
+
 #define EXPOSE_SIGNAL0(n) \
     void Emit##n() { emit n(); }
 #define EXPOSE_SIGNAL1(n, t1) \
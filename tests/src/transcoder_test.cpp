@@ -0,0 +1,151 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <gst/gst.h>
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+
+#include "test_utils.h"
+#include "includes/shared_ptr.h"
+#include "constants/timeconstants.h"
+#include "core/song.h"
+#include "tagreader/tagreaderclient.h"
+#include "transcoder/transcoder.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr int kBenchmarkTimeout = 60000;
+// Each input is transcoded this many times per preset.
+constexpr int kJobsPerInput = 2;
+
+class TranscoderTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    gst_init(nullptr, nullptr);
+  }
+
+  void SetUp() override {
+    tagreader_client_ = make_shared<TagReaderClient>();
+    ASSERT_TRUE(output_dir_.isValid());
+  }
+
+  void AddInputs(const QStringList &extensions) {
+    for (const QString &extension : extensions) {
+      SharedPtr<TemporaryResource> input = make_shared<TemporaryResource>(u":/audio/strawberry."_s + extension);
+      Song song;
+      ASSERT_TRUE(tagreader_client_->ReadFileBlocking(input->fileName(), &song).success());
+      input_lengths_.insert(input->fileName(), song.length_nanosec());
+      inputs_ << input;
+    }
+  }
+
+  // Transcodes every input kJobsPerInput times, with fewer threads than jobs so pipelines are reused.
+  // Returns the inputs of the outputs that were written.
+  QMap<QString, QString> Transcode(Transcoder &transcoder, const TranscoderPreset &preset, const int timeout_msec) {
+    int complete = 0;
+    QMap<QString, QString> succeeded;
+    const QMetaObject::Connection connection = QObject::connect(&transcoder, &Transcoder::JobComplete, &transcoder, [&complete, &succeeded](const QString &input, const QString &output, const bool success) {
+      ++complete;
+      if (success) {
+        succeeded.insert(output, input);
+      }
+    });
+
+    const int jobs = static_cast<int>(inputs_.count()) * kJobsPerInput;
+    for (int i = 0; i < jobs; ++i) {
+      const SharedPtr<TemporaryResource> &input = inputs_[i % inputs_.count()];
+      transcoder.AddJob(input->fileName(), preset, output_dir_.filePath(u"%1-%2.%3"_s.arg(preset.name_).arg(i).arg(preset.extension_)));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    transcoder.Start();
+    EXPECT_TRUE(WaitFor([&complete, jobs]() { return complete == jobs; }, timeout_msec)) << preset.name_;
+    RecordProperty((u"elapsed_ms_"_s + preset.name_).toStdString(), static_cast<int>(timer.elapsed()));
+    QObject::disconnect(connection);
+    return succeeded;
+  }
+
+  // Every output of a reused pipeline must be a complete file of its own.
+  void VerifyOutputs(const TranscoderPreset &preset, const QMap<QString, QString> &outputs) {
+    for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
+      Song song;
+      ASSERT_TRUE(tagreader_client_->ReadFileBlocking(it.key(), &song).success()) << it.key();
+      EXPECT_EQ(preset.filetype_, song.filetype()) << it.key();
+      EXPECT_NEAR(input_lengths_.value(it.value()), song.length_nanosec(), kNsecPerSec) << it.key();
+    }
+  }
+
+  SharedPtr<TagReaderClient> tagreader_client_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QList<SharedPtr<TemporaryResource>> inputs_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QMap<QString, qint64> input_lengths_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QTemporaryDir output_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+// WAV and FLAC encoders are always available.
+TEST_F(TranscoderTest, ReusedPipelinesWriteCompleteFiles) {
+
+  AddInputs(QStringList() << u"flac"_s << u"wav"_s);
+  if (HasFatalFailure()) return;
+
+  Transcoder transcoder(nullptr, u"_test"_s);
+  transcoder.set_max_threads(2);
+
+  for (const Song::FileType filetype : {Song::FileType::WAV, Song::FileType::FLAC}) {
+    const TranscoderPreset preset = Transcoder::PresetForFileType(filetype);
+    const QMap<QString, QString> outputs = Transcode(transcoder, preset, 15000);
+    EXPECT_EQ(inputs_.count() * kJobsPerInput, outputs.count()) << preset.name_;
+    VerifyOutputs(preset, outputs);
+  }
+
+}
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests.
+// Converts the test audio to every preset, presets without an installed encoder fail to start and are reported as such.
+TEST_F(TranscoderTest, DISABLED_TranscodeToEachPresetBenchmark) {
+
+  // Formats that can be decoded with the base and good plugins.
+  AddInputs(QStringList() << u"flac"_s << u"wav"_s << u"ogg"_s << u"opus"_s);
+  if (HasFatalFailure()) return;
+
+  Transcoder transcoder(nullptr, u"_test"_s);
+  transcoder.set_max_threads(2);
+
+  const QList<TranscoderPreset> presets = Transcoder::GetAllPresets();
+  for (const TranscoderPreset &preset : presets) {
+    const QMap<QString, QString> outputs = Transcode(transcoder, preset, kBenchmarkTimeout);
+    VerifyOutputs(preset, outputs);
+  }
+
+}
+
+}  // namespace
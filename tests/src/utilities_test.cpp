@@ -25,6 +25,8 @@
 #include <QString>
 #include <QDateTime>
 #include <QRegularExpression>
+#include <QFile>
+#include <QTemporaryDir>
 #include <QtDebug>
 
 #include "test_utils.h"
@@ -35,6 +37,7 @@
 #include "utilities/cryptutils.h"
 #include "utilities/colorutils.h"
 #include "utilities/transliterate.h"
+#include "utilities/fileutils.h"
 #include "core/logging.h"
 #include "core/temporaryfile.h"
 
@@ -264,3 +267,26 @@ TEST(UtilitiesTest, TemporaryFile) {
   EXPECT_TRUE(regex_temp_filename.match(temp_file.filename()).hasMatch());
 
 }
+
+TEST(UtilitiesTest, CopyLocalFile) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+
+  const QString source = temp_dir.filePath(u"source.flac"_s);
+  const QString destination = temp_dir.filePath(u"destination.flac"_s);
+  const QByteArray data(3 * 1024 * 1024 + 17, 'x');
+  {
+    QFile file(source);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(file.write(data), data.size());
+  }
+
+  ASSERT_TRUE(Utilities::CopyLocalFile(source, destination));
+  EXPECT_EQ(Utilities::ReadDataFromFile(destination), data);
+
+  // Existing files are not overwritten, like QFile::copy.
+  EXPECT_FALSE(Utilities::CopyLocalFile(source, destination));
+  EXPECT_FALSE(Utilities::CopyLocalFile(temp_dir.filePath(u"missing.flac"_s), temp_dir.filePath(u"other.flac"_s)));
+
+}